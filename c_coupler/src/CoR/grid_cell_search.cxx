@@ -10,9 +10,20 @@
 #include "grid_cell_search.h"
 #include "remap_utils_nearest_points.h"
 #include "quick_sort.h"
+#include "remap_operator_c_interface.h"
 #include <math.h>
 
 
+/* The buffers and the distance threshold used by the threads that compute remapping weights concurrently,
+   because the ones of H2D_grid_cell_search_engine are shared by all threads */
+static __thread long *thread_search_local_index_buffer = NULL;
+static __thread long *thread_search_global_index_buffer = NULL;
+static __thread double *thread_search_dist_buffer = NULL;
+static __thread long thread_search_buffers_size = 0;
+static __thread const H2D_grid_cell_search_engine *thread_dist_threshold_search_engine = NULL;
+static __thread double thread_dist_threshold;
+
+
 
 void seperate_cells_in_children_tiles(int num_cells, H2D_grid_cell_search_cell **cells, double center_lon, double center_lat, 
                                       double dlon, double dlat, int *num_cells_in_children, long *local_index_buffer, bool is_sphere_grid)
@@ -693,9 +704,58 @@ void H2D_grid_cell_search_engine::recursively_search_initial_boundary(double cen
 }
 
 
-void H2D_grid_cell_search_engine::sort_nearest_points(int num_found_points)
+void release_thread_grid_cell_search_buffers()
 {
-	sort_grid_nearest_points(dist_buffer, local_index_buffer, global_index_buffer, num_found_points, remap_grid);
+	if (thread_search_buffers_size > 0) {
+		delete [] thread_search_local_index_buffer;
+		delete [] thread_search_global_index_buffer;
+		delete [] thread_search_dist_buffer;
+	}
+	thread_search_local_index_buffer = NULL;
+	thread_search_global_index_buffer = NULL;
+	thread_search_dist_buffer = NULL;
+	thread_search_buffers_size = 0;
+	thread_dist_threshold_search_engine = NULL;
+}
+
+
+void H2D_grid_cell_search_engine::get_search_buffers(long **local_index_buffer, long **global_index_buffer, double **dist_buffer) const
+{
+	if (!is_computing_remap_weights_in_thread()) {
+		*local_index_buffer = this->local_index_buffer;
+		*global_index_buffer = this->global_index_buffer;
+		*dist_buffer = this->dist_buffer;
+		return;
+	}
+
+	if (thread_search_buffers_size < num_cells) {
+		release_thread_grid_cell_search_buffers();
+		thread_search_local_index_buffer = new long [num_cells];
+		thread_search_global_index_buffer = new long [num_cells];
+		thread_search_dist_buffer = new double [num_cells];
+		thread_search_buffers_size = num_cells;
+	}
+	*local_index_buffer = thread_search_local_index_buffer;
+	*global_index_buffer = thread_search_global_index_buffer;
+	*dist_buffer = thread_search_dist_buffer;
+}
+
+
+double H2D_grid_cell_search_engine::get_dist_threshold()
+{
+	if (is_computing_remap_weights_in_thread() && thread_dist_threshold_search_engine == this)
+		return thread_dist_threshold;
+	return dist_threshold;
+}
+
+
+void H2D_grid_cell_search_engine::set_dist_threshold(double dist_threshold)
+{
+	if (is_computing_remap_weights_in_thread()) {
+		thread_dist_threshold_search_engine = this;
+		thread_dist_threshold = dist_threshold;
+	}
+	else this->dist_threshold = dist_threshold;
 }
 
 
@@ -707,15 +767,18 @@ void H2D_grid_cell_search_engine::search_nearest_points_var_number(int num_requi
 bool H2D_grid_cell_search_engine::search_nearest_points_var_distance(double dist_threshold, long dst_cell_index, double dst_point_lon, double dst_point_lat, int &num_found_points, long *found_points_indx, double *found_points_dist, bool early_quit)
 {
     bool have_the_same_point;
+    long *local_index_buffer, *global_index_buffer;
+    double *dist_buffer;
 
 
     EXECUTION_REPORT(REPORT_ERROR, -1, root_tile != NULL, "Software error1 in H2D_grid_cell_search_engine::search_nearest_points_var_distance");
     
-    this->dist_threshold = dist_threshold;
+    get_search_buffers(&local_index_buffer, &global_index_buffer, &dist_buffer);
+    set_dist_threshold(dist_threshold);
     num_found_points = 0;
     have_the_same_point = root_tile->search_points_within_distance(dist_threshold, dst_point_lon, dst_point_lat, num_found_points, local_index_buffer, dist_buffer, early_quit);
 
-	sort_nearest_points(num_found_points);
+	sort_grid_nearest_points(dist_buffer, local_index_buffer, global_index_buffer, num_found_points, remap_grid);
 //    do_quick_sort(dist_buffer, local_index_buffer, 0, num_found_points-1);
     
     if (have_the_same_point && early_quit) {
@@ -738,6 +801,11 @@ bool H2D_grid_cell_search_engine::search_nearest_points_var_distance(double dist
 
 void H2D_grid_cell_search_engine::search_overlapping_cells(int &num_overlapping_cells, long *overlapping_cells_index, const H2D_grid_cell_search_cell *dst_cell, bool accurately_match, bool early_quit) const
 {
+    long *local_index_buffer, *global_index_buffer;
+    double *dist_buffer;
+
+
+    get_search_buffers(&local_index_buffer, &global_index_buffer, &dist_buffer);
     EXECUTION_REPORT(REPORT_ERROR, -1, root_tile != NULL, "Software error1 in H2D_grid_cell_search_engine::search_overlapping_cells");
 
     num_overlapping_cells = 0;
@@ -797,8 +865,11 @@ int H2D_grid_cell_search_engine::search_cell_of_locating_point(double point_lon,
 {
     int num_overlapping_cells;
     H2D_grid_cell_search_cell *temp_cell;
+    long *local_index_buffer, *global_index_buffer;
+    double *dist_buffer;
 
 
+    get_search_buffers(&local_index_buffer, &global_index_buffer, &dist_buffer);
     temp_cell = new H2D_grid_cell_search_cell(0, point_lon, point_lat, true, 0, NULL, NULL, EDGE_TYPE_LATLON, is_sphere_grid);
 
     search_overlapping_cells(num_overlapping_cells, local_index_buffer, temp_cell, accurately_match, true);
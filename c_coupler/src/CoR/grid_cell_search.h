@@ -138,12 +138,15 @@ class H2D_grid_cell_search_engine
         bool search_nearest_points_var_distance(double, long, double, double, int&, long*, double*, bool);
         void search_overlapping_cells(int&, long*, const H2D_grid_cell_search_cell*, bool, bool) const;
         int search_cell_of_locating_point(double, double, bool) const;
-		double get_dist_threshold() { return dist_threshold; }
-		void set_dist_threshold(double dist_threshold) { this->dist_threshold = dist_threshold;}
+		double get_dist_threshold();
+		void set_dist_threshold(double);
         const H2D_grid_cell_search_cell* get_cell(int) const;
         void update(const bool*);
-		void sort_nearest_points(int);
+		void get_search_buffers(long**, long**, double**) const;
 };
 
+
+extern void release_thread_grid_cell_search_buffers();
+
 #endif
 
@@ -15,6 +15,7 @@
 #include <string.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <limits.h>
 
 
 IO_netcdf::IO_netcdf(int ncfile_id)
@@ -955,85 +956,169 @@ bool IO_netcdf::get_file_field_string_attribute(const char *field_name, const ch
 }
 
 
+void IO_netcdf::read_file_field_slice(int file_id, int variable_id, nc_type nc_var_type, size_t *starts, size_t *counts, char *data_array, const char *field_name)
+{
+    switch(nc_var_type) {
+        case NC_SHORT:
+            rcode = nc_get_vara_short(file_id, variable_id, starts, counts, (short*)data_array);
+            break;
+        case NC_INT:
+            rcode = nc_get_vara_int(file_id, variable_id, starts, counts, (int*)data_array);
+            break;
+        case NC_FLOAT:
+            rcode = nc_get_vara_float(file_id, variable_id, starts, counts, (float*)data_array);
+            break;
+        case NC_DOUBLE:
+            rcode = nc_get_vara_double(file_id, variable_id, starts, counts, (double*)data_array);
+            break;
+        default:
+            EXECUTION_REPORT(REPORT_ERROR, -1, false, "software error in IO_netcdf::read_file_field: the data type of the variable \"%s\" is not supported", field_name);
+            break;
+    }
+    report_nc_error();
+}
+
+
+/* The root process inquires the variable and broadcasts its size and data type. A small variable is then read by 
+   the root process and broadcast as a whole. A large variable is split into slabs along its first dimension, which 
+   are read independently by a limited number of processes spread over the communicator, and then allgathered, so 
+   that the disk bandwidth of the root process does not serialize the reading. The data is transferred in units of 
+   values or slabs (as derived datatypes) rather than bytes, so that the counts and displacements of MPI do not 
+   overflow for a variable larger than 2GB */
 void IO_netcdf::read_file_field(const char *field_name, void **data_array_ptr, int *field_size, char *data_type, MPI_Comm comm, bool is_root_proc)
 {
-    int i, variable_id, *dim_ids, *dim_size, total_size, have_field = 1;
+    int i, variable_id, num_dims = 0, file_id = -1, num_procs = 1, proc_id = 0, num_reading_procs = 1;
+    long field_info[4] = {0, 0, 0, 0};
     size_t dim_len;
     nc_type nc_var_type;
     char *data_array = NULL;
-    int num_dims = 0;
+    MPI_Datatype value_type, slab_type;
+
 
     *data_array_ptr = NULL;
     *field_size = -1;
     
     if (is_root_proc) {
-        rcode = nc_open(file_name, NC_NOWRITE, &ncfile_id);
+        rcode = nc_open(file_name, NC_NOWRITE, &file_id);
         report_nc_error();
-        rcode = nc_inq_varid(ncfile_id, field_name, &variable_id);
+        rcode = nc_inq_varid(file_id, field_name, &variable_id);
         if (rcode != NC_NOERR) {
-            rcode = nc_close(ncfile_id);
+            rcode = nc_close(file_id);
             report_nc_error();
-            have_field = 0;
         }
         else {
-            rcode = nc_inq_varndims(ncfile_id, variable_id, &num_dims);
+            rcode = nc_inq_vartype(file_id, variable_id, &nc_var_type);
+            report_nc_error();
+            datatype_from_netcdf_to_application(nc_var_type, data_type, field_name);
+            EXECUTION_REPORT_ERROR_OPTIONALLY(REPORT_ERROR, -1, strlen(data_type) < 16, "Software error IO_netcdf::read_file_field");
+            rcode = nc_inq_varndims(file_id, variable_id, &num_dims);
             report_nc_error();
-            dim_ids = new int [num_dims];
-            dim_size = new int [num_dims];
-            rcode = nc_inq_vardimid(ncfile_id, variable_id, dim_ids);
+            int *dim_ids = new int [num_dims];
+            rcode = nc_inq_vardimid(file_id, variable_id, dim_ids);
             report_nc_error();
+            field_info[0] = 1;
+            field_info[1] = 1;
+            field_info[2] = 1;
+            field_info[3] = nc_var_type;
             for (i = 0; i < num_dims; i ++) {
-                rcode = nc_inq_dimlen(ncfile_id, dim_ids[i], &dim_len);
+                rcode = nc_inq_dimlen(file_id, dim_ids[i], &dim_len);
                 report_nc_error();
-                dim_size[i] = dim_len;
+                field_info[1] *= dim_len;
+                if (i == 0)
+                    field_info[2] = dim_len;
             }
-            rcode = nc_inq_vartype(ncfile_id, variable_id, &nc_var_type);
-            report_nc_error();
-            datatype_from_netcdf_to_application(nc_var_type, data_type, field_name);
-			EXECUTION_REPORT_ERROR_OPTIONALLY(REPORT_ERROR, -1, strlen(data_type) < 16, "Software error IO_netcdf::read_file_field");
-
-            total_size = 1;
-            for (i = 0; i < num_dims; i ++)
-                total_size *= dim_size[i];
-            data_array = new char [total_size*get_data_type_size(data_type)];
-            switch(nc_var_type) {
-                case NC_SHORT:
-                    rcode = nc_get_var_short(ncfile_id, variable_id, (short*)data_array);
-                    break;
-                case NC_INT:
-                    rcode = nc_get_var_int(ncfile_id, variable_id, (int*)data_array);
-                    break;
-                case NC_FLOAT:
-                    rcode = nc_get_var_float(ncfile_id, variable_id, (float*)data_array);
-                    break;
-                case NC_DOUBLE:
-                    rcode = nc_get_var_double(ncfile_id, variable_id, (double*)data_array);
-                    break;
-                default:
-                    EXECUTION_REPORT(REPORT_ERROR, -1, false, "software error in IO_netcdf::read_file_field: data type %s is not supported", data_type);
-                    break;
-            }
-            report_nc_error();
-            *field_size = total_size;
             delete [] dim_ids;
-            delete [] dim_size;
-            rcode = nc_close(ncfile_id);
-            report_nc_error();
         }
     }
 
     if (comm != MPI_COMM_NULL) {
-        MPI_Bcast(&have_field, 1, MPI_INT, 0, comm);
-        if (have_field == 0)
+        MPI_Bcast(field_info, 4, MPI_LONG, 0, comm);
+        if (field_info[0] == 0)
             return;
-        MPI_Bcast(field_size, 1, MPI_INT, 0, comm);
         MPI_Bcast(data_type, 16, MPI_CHAR, 0, comm);
-		if (*field_size > 0) {
-	        if (data_array == NULL)
-	            data_array = new char [(*field_size)*get_data_type_size(data_type)];
-	        MPI_Bcast(data_array, (*field_size)*get_data_type_size(data_type), MPI_CHAR, 0, comm);
-		}
+        MPI_Comm_size(comm, &num_procs);
+        MPI_Comm_rank(comm, &proc_id);
+        if (field_info[1]*get_data_type_size(data_type) >= IO_NETCDF_MIN_SIZE_FOR_PARALLEL_READ) {
+            num_reading_procs = num_procs < IO_NETCDF_MAX_NUM_READING_PROCS? num_procs : IO_NETCDF_MAX_NUM_READING_PROCS;
+            if (num_reading_procs > field_info[2])
+                num_reading_procs = field_info[2];
+        }
     }
+    else if (field_info[0] == 0)
+        return;
+
+    *field_size = field_info[1];
+    nc_var_type = (nc_type) field_info[3];
+    if (*field_size > 0)
+        data_array = new char [((long)(*field_size))*get_data_type_size(data_type)];
+
+    /* recv_counts and displs are in slabs */
+    int proc_id_interval = num_procs / num_reading_procs;
+    long slab_size = field_info[2] > 0? (field_info[1]/field_info[2]) * get_data_type_size(data_type) : 0;
+    int *recv_counts = new int [num_procs];
+    int *displs = new int [num_procs];
+    for (i = 0; i < num_procs; i ++) {
+        recv_counts[i] = 0;
+        displs[i] = 0;
+        if (i % proc_id_interval == 0 && i < proc_id_interval*num_reading_procs) {
+            int reading_proc_id = i / proc_id_interval;
+            displs[i] = reading_proc_id * (field_info[2]/num_reading_procs) + (reading_proc_id < field_info[2]%num_reading_procs? reading_proc_id : field_info[2]%num_reading_procs);
+            recv_counts[i] = field_info[2]/num_reading_procs + (reading_proc_id < field_info[2]%num_reading_procs? 1 : 0);
+        }
+    }
+    if (slab_size == 0)
+        recv_counts[proc_id] = 0;
+
+    if (recv_counts[proc_id] > 0) {
+        if (!is_root_proc) {
+            rcode = nc_open(file_name, NC_NOWRITE, &file_id);
+            report_nc_error();
+            rcode = nc_inq_varid(file_id, field_name, &variable_id);
+            report_nc_error();
+            rcode = nc_inq_varndims(file_id, variable_id, &num_dims);
+            report_nc_error();
+        }
+        size_t *starts = new size_t [num_dims+1];
+        size_t *counts = new size_t [num_dims+1];
+        int *dim_ids = new int [num_dims+1];
+        rcode = nc_inq_vardimid(file_id, variable_id, dim_ids);
+        report_nc_error();
+        for (i = 0; i < num_dims; i ++) {
+            starts[i] = 0;
+            rcode = nc_inq_dimlen(file_id, dim_ids[i], &counts[i]);
+            report_nc_error();
+        }
+        if (num_dims > 0) {
+            starts[0] = displs[proc_id];
+            counts[0] = recv_counts[proc_id];
+        }
+        read_file_field_slice(file_id, variable_id, nc_var_type, starts, counts, data_array+displs[proc_id]*slab_size, field_name);
+        delete [] starts;
+        delete [] counts;
+        delete [] dim_ids;
+    }
+    if (file_id != -1) {
+        rcode = nc_close(file_id);
+        report_nc_error();
+    }
+
+    if (comm != MPI_COMM_NULL && *field_size > 0) {
+        MPI_Type_contiguous(get_data_type_size(data_type), MPI_CHAR, &value_type);
+        if (num_reading_procs == 1) {
+            MPI_Type_commit(&value_type);
+            MPI_Bcast(data_array, *field_size, value_type, 0, comm);
+        }
+        else {
+            EXECUTION_REPORT(REPORT_ERROR, -1, field_info[1]/field_info[2] <= INT_MAX, "C-Coupler does not support reading the variable \"%s\" in parallel, because each slab along its first dimension has more than %d values", field_name, INT_MAX);
+            MPI_Type_contiguous(field_info[1]/field_info[2], value_type, &slab_type);
+            MPI_Type_commit(&slab_type);
+            EXECUTION_REPORT(REPORT_ERROR, -1, MPI_Allgatherv(MPI_IN_PLACE, 0, MPI_DATATYPE_NULL, data_array, recv_counts, displs, slab_type, comm) == MPI_SUCCESS);
+            MPI_Type_free(&slab_type);
+        }
+        MPI_Type_free(&value_type);
+    }
+    delete [] recv_counts;
+    delete [] displs;
 
     *data_array_ptr = data_array;
 }
@@ -1041,11 +1126,10 @@ void IO_netcdf::read_file_field(const char *field_name, void **data_array_ptr, i
 
 void IO_netcdf::read_remap_weights(Remap_weight_of_strategy_class *remap_weights, Remap_strategy_class *remap_strategy, bool read_weight_values)
 {
-    double *area, *weight_values;
+    double *weight_values;
     int var_id;
     unsigned long grid_size, num_weights, i;
     long *indexes_src, *indexes_dst;
-    int *tmp_indexes_src, *tmp_indexes_dst;
     Remap_operator_basis *duplicated_remap_operator;
     Remap_weight_of_operator_instance_class *remap_operator_instance;
     Remap_weight_sparse_matrix *weight_sparse_matrix;
@@ -1075,7 +1159,6 @@ void IO_netcdf::read_remap_weights(Remap_weight_of_strategy_class *remap_weights
         report_nc_error();
         EXECUTION_REPORT(REPORT_ERROR, -1, grid_size == remap_weights->get_data_grid_src()->get_grid_size() && remap_weights->get_data_grid_src()->get_area_or_volumn() != NULL, 
                      "the src grid in netcdf file does not match the src grid of remap operator\n");
-        area = new double [grid_size];
         rcode = nc_inq_varid(ncfile_id, "area_a", &var_id);
         report_nc_error();
         rcode = nc_get_var_double(ncfile_id, var_id, remap_weights->get_data_grid_src()->get_area_or_volumn());
@@ -1086,7 +1169,6 @@ void IO_netcdf::read_remap_weights(Remap_weight_of_strategy_class *remap_weights
         report_nc_error();
         EXECUTION_REPORT(REPORT_ERROR, -1, grid_size == remap_weights->get_data_grid_dst()->get_grid_size() && remap_weights->get_data_grid_dst()->get_area_or_volumn() != NULL, 
                      "the dst grid in netcdf file does not match the dst grid of remap operator\n");
-        area = new double [grid_size];
         rcode = nc_inq_varid(ncfile_id, "area_b", &var_id);
         if (rcode == NC_NOERR) {
             rcode = nc_get_var_double(ncfile_id, var_id, remap_weights->get_data_grid_dst()->get_area_or_volumn());
@@ -1099,24 +1181,22 @@ void IO_netcdf::read_remap_weights(Remap_weight_of_strategy_class *remap_weights
         if (read_weight_values) {
             indexes_src = new long [num_weights];
             indexes_dst = new long [num_weights];
-            tmp_indexes_src = new int [num_weights];
-            tmp_indexes_dst = new int [num_weights];
             weight_values = new double [num_weights];
             rcode = nc_inq_varid(ncfile_id, "col", &var_id);
             report_nc_error();
-            rcode = nc_get_var_int(ncfile_id, var_id, tmp_indexes_src);
+            rcode = nc_get_var_long(ncfile_id, var_id, indexes_src);
             report_nc_error();
             rcode = nc_inq_varid(ncfile_id, "row", &var_id);
             report_nc_error();
-            rcode = nc_get_var_int(ncfile_id, var_id, tmp_indexes_dst);
+            rcode = nc_get_var_long(ncfile_id, var_id, indexes_dst);
             report_nc_error();
             rcode = nc_inq_varid(ncfile_id, "S", &var_id);
             report_nc_error();
             rcode = nc_get_var_double(ncfile_id, var_id, weight_values);
             report_nc_error();
             for (i = 0; i < num_weights; i ++) {
-                indexes_src[i] = tmp_indexes_src[i] - 1;
-                indexes_dst[i] = tmp_indexes_dst[i] - 1;
+                indexes_src[i] --;
+                indexes_dst[i] --;
             }
             duplicated_remap_operator = remap_strategy->get_remap_operator(0)->duplicate_remap_operator(false);
             weight_sparse_matrix = new Remap_weight_sparse_matrix(remap_strategy->get_remap_operator(0),
@@ -1130,12 +1210,6 @@ void IO_netcdf::read_remap_weights(Remap_weight_of_strategy_class *remap_weights
                                                                      0, remap_strategy->get_remap_operator(0),
                                                                      duplicated_remap_operator);
         remap_weights->add_remap_weight_of_operator_instance(remap_operator_instance, remap_weights->get_data_grid_src(), remap_weights->get_data_grid_dst(), remap_strategy->get_remap_operator(0), remap_strategy->get_remap_operator(0)->get_src_grid(), remap_strategy->get_remap_operator(0)->get_dst_grid());
-
-        if (read_weight_values) {
-            delete [] tmp_indexes_src;
-            delete [] tmp_indexes_dst;
-        }
-        delete [] area;
     }
 }
 
@@ -1164,4 +1238,4 @@ bool IO_netcdf::get_field_datatype(const char *field_name, char *var_data_type)
     datatype_from_netcdf_to_application(nc_data_type, var_data_type, field_name);
     rcode = nc_close(ncfile_id);
     report_nc_error();
-}
+}
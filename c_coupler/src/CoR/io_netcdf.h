@@ -24,6 +24,10 @@
 #define SCRIP_MASK_LABEL                "grid_imask"
 
 
+#define IO_NETCDF_MIN_SIZE_FOR_PARALLEL_READ    ((long)(4*1024*1024))
+#define IO_NETCDF_MAX_NUM_READING_PROCS         32
+
+
 class IO_netcdf: public IO_basis
 {
     private:
@@ -38,6 +42,7 @@ class IO_netcdf: public IO_basis
         void datatype_from_netcdf_to_application(nc_type, char*, const char*);
         void datatype_from_application_to_netcdf(const char*, nc_type*);
         void report_nc_error();
+        void read_file_field_slice(int, int, nc_type, size_t*, size_t*, char*, const char*);
 
     public:
         IO_netcdf(int);
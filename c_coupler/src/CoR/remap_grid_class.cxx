@@ -20,8 +20,14 @@
 #include <string.h>
 
 
+/* The id of the next grid to be created. The ids are never reused, so that they can identify a grid (and its decomposition) 
+    even after another grid is allocated at the address of a deleted one */
+static long next_remap_grid_id = 0;
+
+
 void Remap_grid_class::initialize_grid_class_data()
 {
+    this->grid_id = next_remap_grid_id ++;
     strcpy(this->grid_name, "\0");
     strcpy(this->coord_label, "\0");
     strcpy(this->coord_unit, "\0");
@@ -69,6 +69,7 @@ class Remap_grid_class
     private:
         friend class Runtime_remap_function;
         friend class Remap_operator_grid;
+        long grid_id;
         char decomp_name[NAME_STR_SIZE];
         char grid_name[NAME_STR_SIZE];
         char coord_label[NAME_STR_SIZE];
@@ -161,6 +162,7 @@ class Remap_grid_class
 
         /* Functions of getting grid properties or data */
         long get_grid_size() const { return grid_size; }
+        long get_grid_id() const { return grid_id; }
         int get_num_dimensions() const { return num_dimensions; }
         int get_num_vertexes() const { return num_vertexes; }
 		int set_num_vertexes(int num_vertexes) { return this->num_vertexes = num_vertexes; }
@@ -8,6 +8,7 @@
 
 
 #include "cor_global_data.h"
+#include "global_data.h"
 #include "remap_grid_class.h"
 #include "remap_common_utils.h"
 #include "remap_grid_data_class.h"
@@ -177,7 +178,8 @@ Remap_grid_data_class::~Remap_grid_data_class()
 Remap_grid_data_class *Remap_grid_data_class::duplicate_grid_data_field(Remap_grid_class *associative_grid, 
                                                                         int num_points_per_cell, 
                                                                         bool copy_data, 
-                                                                        bool interchange_data)
+                                                                        bool interchange_data,
+                                                                        int buffer_pool_mark)
 {
     Remap_data_field *duplicated_data_field;
     Remap_grid_data_class *duplicated_grid_data_field;
@@ -194,7 +196,7 @@ Remap_grid_data_class *Remap_grid_data_class::duplicate_grid_data_field(Remap_gr
     }
     EXECUTION_REPORT(REPORT_ERROR, -1, associative_grid->get_whole_grid() == NULL, "remap software error2 duplicate_grid_data_field\n");
 
-    duplicated_data_field = grid_data_field->duplicate_remap_data_field(associative_grid->get_grid_size()*num_points_per_cell, copy_data);
+    duplicated_data_field = grid_data_field->duplicate_remap_data_field(associative_grid->get_grid_size()*num_points_per_cell, copy_data, buffer_pool_mark);
     duplicated_grid_data_field = new Remap_grid_data_class(associative_grid, duplicated_data_field);
 
     if (copy_data && coord_value_grid != NULL) {
@@ -214,18 +216,53 @@ Remap_grid_data_class *Remap_grid_data_class::duplicate_grid_data_field(Remap_gr
     dimension must be a grid with certain size */
 void Remap_grid_data_class::interchange_grid_data(Remap_grid_class *interchange_grid)
 {
-    int i, j, k, num_sized_grids_interchange;
-    Remap_grid_class *sized_grids_interchange[256], *sized_grids_src[256];
-    Remap_grid_class *interchanged_sized_grids_of_grid_data[256];
-    Remap_grid_class *interchanged_grid_of_grid_data, *src_grid_of_grid_data;
-    Remap_data_field *duplicated_data_field;
-    
+    Grid_data_interchange_plan *interchange_plan;
+
 
     /* The grid data with only one sized sub grid (also means logical 1D grid data) 
         can not be interchanged */
     if (sized_grids.size() <= 1)
         return;
+
+    interchange_plan = generate_interchange_plan(interchange_grid);
+    apply_interchange_plan(interchange_plan);
+    delete interchange_plan;
+}
+
+
+/* Same as above, but the interchange plan is searched from (or added into) interchange_plans, so that the
+    grids are only analyzed when the field layout or interchange_grid is met for the first time. The plans are 
+    keyed by the ids of interchange_grid and of the sized grids of the grid data, which are never reused */
+void Remap_grid_data_class::interchange_grid_data(Remap_grid_class *interchange_grid, std::map<std::vector<long>, Grid_data_interchange_plan*> &interchange_plans)
+{
+    std::vector<long> interchange_plan_key;
+    std::map<std::vector<long>, Grid_data_interchange_plan*>::iterator iter;
+
+
+    if (sized_grids.size() <= 1)
+        return;
+
+    interchange_plan_key.push_back(interchange_grid->get_grid_id());
+    for (int i = 0; i < sized_grids.size(); i ++)
+        interchange_plan_key.push_back(sized_grids[i]->get_grid_id());
+    iter = interchange_plans.find(interchange_plan_key);
+    if (iter == interchange_plans.end())
+        iter = interchange_plans.insert(std::make_pair(interchange_plan_key, generate_interchange_plan(interchange_grid))).first;
+    apply_interchange_plan(iter->second);
+}
+
+
+Grid_data_interchange_plan *Remap_grid_data_class::generate_interchange_plan(Remap_grid_class *interchange_grid)
+{
+    int i, j, k, num_sized_grids_interchange, num_sized_sub_grids_src, num_sized_sub_grids_interchange;
+    Remap_grid_class *sized_grids_interchange[256], *sized_grids_src[256];
+    Remap_grid_class *interchanged_sized_grids_of_grid_data[256];
+    Remap_grid_class *interchanged_grid_of_grid_data, *src_grid_of_grid_data;
+    Remap_grid_class *sized_sub_grids_src[256], *sized_sub_grids_interchange[256];
+    int index_interchange_table_src_to_dst[256];
+    Grid_data_interchange_plan *interchange_plan = new Grid_data_interchange_plan;
     
+
     /* Check the remap software and extract the common sized sub grids between the 
          grid of grid data and interchange grid, and then generate a accurate interchange 
          grid to do interchange */
@@ -252,20 +289,49 @@ void Remap_grid_data_class::interchange_grid_data(Remap_grid_class *interchange_
     EXECUTION_REPORT(REPORT_ERROR, -1, src_grid_of_grid_data->is_similar_grid_with(interchanged_grid_of_grid_data), 
                  "remap software error2 in interchange_grid_data\n\n");
 
-    if (src_grid_of_grid_data->is_the_same_grid_with(interchanged_grid_of_grid_data)) {
-        delete interchanged_grid_of_grid_data;
-        delete src_grid_of_grid_data;
-        return;
+    interchange_plan->is_identity = src_grid_of_grid_data->is_the_same_grid_with(interchanged_grid_of_grid_data);
+    if (!interchange_plan->is_identity) {
+        src_grid_of_grid_data->get_sized_sub_grids(&num_sized_sub_grids_src, sized_sub_grids_src);
+        interchanged_grid_of_grid_data->get_sized_sub_grids(&num_sized_sub_grids_interchange, sized_sub_grids_interchange);
+        src_grid_of_grid_data->get_grid_index_interchange_table(interchanged_grid_of_grid_data, index_interchange_table_src_to_dst);
+        for (i = 0; i < num_sized_sub_grids_src; i ++) {
+            interchange_plan->sub_grid_sizes_src.push_back(sized_sub_grids_src[i]->get_grid_size());
+            interchange_plan->index_interchange_table_src_to_dst.push_back(index_interchange_table_src_to_dst[i]);
+        }
+        for (i = 0; i < num_sized_sub_grids_interchange; i ++)
+            interchange_plan->sub_grid_sizes_interchange.push_back(sized_sub_grids_interchange[i]->get_grid_size());
+        interchange_plan->grid_size = src_grid_of_grid_data->get_grid_size();
+        for (i = 0; i < k; i ++)
+            interchange_plan->interchanged_sized_grids.push_back(interchanged_sized_grids_of_grid_data[i]);
     }
 
-    /* Duplicate a grid data as temporary buffer and then interchange the grid data */
-    duplicated_data_field = grid_data_field->duplicate_remap_data_field(0, true);
-    duplicated_data_field->interchange_remap_data_field(grid_data_field, src_grid_of_grid_data, interchanged_grid_of_grid_data);
-    reset_sized_grids(sized_grids.size(), interchanged_sized_grids_of_grid_data);
-
-    delete duplicated_data_field;
     delete src_grid_of_grid_data;
     delete interchanged_grid_of_grid_data;
+
+    return interchange_plan;
+}
+
+
+void Remap_grid_data_class::apply_interchange_plan(Grid_data_interchange_plan *interchange_plan)
+{
+    long data_buf_size;
+    void *data_buf_copy;
+
+
+    if (interchange_plan->is_identity)
+        return;
+
+    /* Copy the grid data into a temporary buffer and then interchange the grid data from the copy */
+    data_buf_size = grid_data_field->required_data_size*get_data_type_size(grid_data_field->data_type_in_application);
+    if (memory_manager != NULL)
+        data_buf_copy = memory_manager->get_buffer_pool()->allocate_buf(data_buf_size, BUF_MARK_REMAP_INTERCHANGE);
+    else data_buf_copy = new char [data_buf_size];
+    memcpy(data_buf_copy, grid_data_field->data_buf, data_buf_size);
+    grid_data_field->interchange_data_buf(data_buf_copy, grid_data_field->data_buf, interchange_plan->sub_grid_sizes_src.size(), &(interchange_plan->sub_grid_sizes_src[0]), &(interchange_plan->sub_grid_sizes_interchange[0]), &(interchange_plan->index_interchange_table_src_to_dst[0]), interchange_plan->grid_size);
+    if (memory_manager != NULL)
+        memory_manager->get_buffer_pool()->release_buf(data_buf_copy);
+    else delete [] (char*) data_buf_copy;
+    reset_sized_grids(interchange_plan->interchanged_sized_grids.size(), &(interchange_plan->interchanged_sized_grids[0]));
 }
 
 
@@ -460,8 +526,7 @@ void Remap_grid_data_class::evaluate_error(Remap_grid_data_class *first_field_da
 
 void Remap_grid_data_class::change_datatype_in_application(const char* new_datatype)
 {
-	if (grid_data_field->data_buf != NULL)
-	    delete [] grid_data_field->data_buf;
+	grid_data_field->release_data_buf();
     strcpy(grid_data_field->data_type_in_application, new_datatype);
 	if (grid_data_field->required_data_size > 0)
 	    grid_data_field->data_buf = new char [grid_data_field->required_data_size*get_data_type_size(new_datatype)];
@@ -504,8 +569,7 @@ void Remap_grid_data_class::empty_data()
 	EXECUTION_REPORT_ERROR_OPTIONALLY(REPORT_ERROR, -1, get_grid_data_field() != NULL, "Software error in Remap_grid_data_class::empty_data");
 	if (get_grid_data_field()->required_data_size > 0) {
 		EXECUTION_REPORT_ERROR_OPTIONALLY(REPORT_ERROR, -1, get_grid_data_field()->data_buf != NULL, "Software error in Remap_grid_data_class::empty_data");
-		delete [] get_grid_data_field()->data_buf;
-		get_grid_data_field()->data_buf = NULL;
+		get_grid_data_field()->release_data_buf();
 	}
 	get_grid_data_field()->required_data_size = 0;
 	get_grid_data_field()->read_data_size = 0;
@@ -13,6 +13,8 @@
 
 #include "common_utils.h"
 #include "remap_statement_operand.h"
+#include <vector>
+#include <map>
 
 
 class Remap_grid_class;
@@ -22,6 +24,20 @@ class Remap_operator_grid;
 class IO_basis;
 
 
+/* The dimension permutation for interchanging a grid data according to an interchange grid. It can be cached 
+   (keyed by the ids of the interchange grid and of the sized grids of the grid data) and applied again without 
+   analyzing the grids */
+struct Grid_data_interchange_plan
+{
+    std::vector<Remap_grid_class*> interchanged_sized_grids;
+    std::vector<long> sub_grid_sizes_src;
+    std::vector<long> sub_grid_sizes_interchange;
+    std::vector<int> index_interchange_table_src_to_dst;
+    long grid_size;
+    bool is_identity;
+};
+
+
 class Remap_grid_data_class
 {
     private:
@@ -49,8 +65,11 @@ class Remap_grid_data_class
 		void reset_coord_value_grid(Remap_grid_class *coord_value_grid) { this->coord_value_grid = coord_value_grid; }
         bool is_unit_degree();
         Remap_data_field *get_grid_data_field() const { return grid_data_field; }
-        Remap_grid_data_class *duplicate_grid_data_field(Remap_grid_class*, int, bool, bool);
+        Remap_grid_data_class *duplicate_grid_data_field(Remap_grid_class*, int, bool, bool, int buffer_pool_mark = 0);
         void interchange_grid_data(Remap_grid_class*);
+        void interchange_grid_data(Remap_grid_class*, std::map<std::vector<long>, Grid_data_interchange_plan*>&);
+        Grid_data_interchange_plan *generate_interchange_plan(Remap_grid_class*);
+        void apply_interchange_plan(Grid_data_interchange_plan*);
         void reset_sized_grids(int, Remap_grid_class**);
         bool match_remap_grid_data(const char*);
         void transfer_field_attributes_to_another(Remap_grid_data_class*);
@@ -208,6 +208,19 @@ void Remap_operator_basis::copy_remap_operator_basic_data(Remap_operator_basis *
 }
 
 
+void Remap_operator_basis::do_remap_values_caculation_of_levels(double *data_values_src, double *data_values_dst, int dst_array_size, int num_levels, long src_level_stride, long dst_level_stride)
+{
+    for (int k = 0; k < num_levels; k ++)
+        do_remap_values_caculation(data_values_src+k*src_level_stride, data_values_dst+k*dst_level_stride, dst_array_size);
+}
+
+
+void Remap_operator_basis::do_remap_float_values_caculation_of_levels(float *data_values_src, float *data_values_dst, int dst_array_size, int num_levels, long src_level_stride, long dst_level_stride)
+{
+    EXECUTION_REPORT(REPORT_ERROR, -1, false, "Software error in Remap_operator_basis::do_remap_float_values_caculation_of_levels: remap operator \"%s\" does not support float values", operator_name);
+}
+
+
 void Remap_operator_basis::change_remap_operator_info(const char *operator_name, Remap_grid_class *grid_src, Remap_grid_class *grid_dst)
 {
     strcpy(this->operator_name, operator_name);
@@ -247,3 +260,206 @@ Remap_operator_basis *Remap_operator_basis::gather(int comp_id)
 	return overall_remap_operator;
 }
 
+
+
+void Remap_weights_thread_buffer::add_weights(long *indexes_src_grid, long index_dst_grid, double *weight_values, int num_weights, int weights_group_index, bool is_real_weight)
+{
+    Remap_weights_thread_record record;
+
+
+    record.dst_cell_index = current_dst_cell_index;
+    record.index_dst_grid = index_dst_grid;
+    record.weights_offset = this->weight_values.size();
+    record.num_weights = num_weights;
+    record.weights_group_index = weights_group_index;
+    record.is_real_weight = is_real_weight;
+    records.push_back(record);
+    for (int i = 0; i < num_weights; i ++) {
+        this->indexes_src_grid.push_back(indexes_src_grid[i]);
+        this->weight_values.push_back(weight_values[i]);
+    }
+}
+
+
+void Remap_weights_thread_buffer::discard_weights_of_dst_cell(long dst_cell_index)
+{
+    while (records.size() > 0 && records.back().dst_cell_index == dst_cell_index) {
+        indexes_src_grid.resize(records.back().weights_offset);
+        weight_values.resize(records.back().weights_offset);
+        records.pop_back();
+    }
+}
+
+
+void Remap_operator_basis::calculate_remap_weights_of_one_dst_cell(long dst_cell_index)
+{
+    bool dst_cell_mask;
+
+
+    get_cell_mask_of_dst_grid(dst_cell_index, &dst_cell_mask);
+    if (!dst_cell_mask)
+        return;
+    initialize_computing_remap_weights_of_one_cell();
+    compute_remap_weights_of_one_dst_cell(dst_cell_index);
+    finalize_computing_remap_weights_of_one_cell();
+}
+
+
+/* The dst cells are computed by several threads when num_remap_weights_threads is larger than 1. The 
+    weights are appended to the sparse matrixes in the order of dst cells, so that they are the same as
+    the weights computed by one thread */
+void Remap_operator_basis::calculate_remap_weights_of_dst_cells()
+{
+    long dst_cell_index = 0, num_dst_cells = dst_grid->get_grid_size();
+    int num_threads = 1;
+    double time1, time2;
+
+
+    if (comp_comm_group_mgt_mgr != NULL)
+        num_threads = comp_comm_group_mgt_mgr->get_num_remap_weights_threads();
+
+    wtime(&time1);
+    while (dst_cell_index < num_dst_cells) {
+        if (num_threads > 1 && num_dst_cells-dst_cell_index > REMAP_WEIGHTS_THREAD_CHUNK_SIZE) {
+            long first_serial_dst_cell_index = calculate_remap_weights_of_dst_cells_in_threads(dst_cell_index, num_threads);
+            if (first_serial_dst_cell_index == -1)
+                num_threads = 1;
+            else dst_cell_index = first_serial_dst_cell_index;
+            if (dst_cell_index == num_dst_cells)
+                break;
+        }
+        calculate_remap_weights_of_one_dst_cell(dst_cell_index++);
+    }
+    wtime(&time2);
+
+    if (num_dst_cells > REMAP_WEIGHTS_THREAD_CHUNK_SIZE)
+        EXECUTION_REPORT_LOG(REPORT_LOG, -1, true, "Time for calculating the %s remapping weights of %ld dst cells with %d threads is %lf", operator_name, num_dst_cells, num_threads, time2-time1);
+}
+
+
+static void *remap_weights_thread_entry(void *thread_arg)
+{
+    Remap_weights_threads_info *threads_info = ((std::pair<Remap_weights_threads_info*, int>*) thread_arg)->first;
+    int thread_index = ((std::pair<Remap_weights_threads_info*, int>*) thread_arg)->second;
+
+
+    threads_info->remap_operator->compute_remap_weights_of_chunks_in_thread(threads_info, thread_index);
+    return NULL;
+}
+
+
+/* The chunks of dst cells are handed out in order. When a dst cell requires to enlarge the src subdomain 
+    grid, the threads stop at the chunks after it, and the weights from it on are discarded */
+void Remap_operator_basis::compute_remap_weights_of_chunks_in_thread(Remap_weights_threads_info *threads_info, int thread_index)
+{
+    Remap_operator_basis *thread_remap_operator = threads_info->thread_remap_operators[thread_index];
+    long chunk_index, first_serial_dst_cell_index, chunk_start, chunk_end, dst_cell_index;
+
+
+    while (true) {
+        pthread_mutex_lock(&threads_info->mutex);
+        chunk_index = threads_info->next_chunk_index ++;
+        first_serial_dst_cell_index = threads_info->first_serial_dst_cell_index;
+        pthread_mutex_unlock(&threads_info->mutex);
+        if (chunk_index >= threads_info->num_chunks)
+            break;
+        chunk_start = threads_info->first_dst_cell_index + chunk_index*REMAP_WEIGHTS_THREAD_CHUNK_SIZE;
+        chunk_end = chunk_start + REMAP_WEIGHTS_THREAD_CHUNK_SIZE;
+        if (chunk_end > threads_info->first_dst_cell_index+threads_info->num_dst_cells)
+            chunk_end = threads_info->first_dst_cell_index + threads_info->num_dst_cells;
+        if (chunk_start > first_serial_dst_cell_index)
+            break;
+        Remap_weights_thread_buffer *chunk_buffer = new Remap_weights_thread_buffer;
+        threads_info->chunk_buffers[chunk_index] = chunk_buffer;
+        set_remap_weights_thread_buffer(chunk_buffer);
+        for (dst_cell_index = chunk_start; dst_cell_index < chunk_end; dst_cell_index ++) {
+            chunk_buffer->current_dst_cell_index = dst_cell_index;
+            thread_remap_operator->calculate_remap_weights_of_one_dst_cell(dst_cell_index);
+            if (does_remap_weights_cell_require_serial_computing()) {
+                chunk_buffer->discard_weights_of_dst_cell(dst_cell_index);
+                pthread_mutex_lock(&threads_info->mutex);
+                if (dst_cell_index < threads_info->first_serial_dst_cell_index)
+                    threads_info->first_serial_dst_cell_index = dst_cell_index;
+                pthread_mutex_unlock(&threads_info->mutex);
+                break;
+            }
+        }
+    }
+
+    set_remap_weights_thread_buffer(NULL);
+    release_thread_grid_cell_search_buffers();
+}
+
+
+/* Return the first dst cell whose weights are not computed, or -1 when this operator can not compute
+    remapping weights in threads */
+long Remap_operator_basis::calculate_remap_weights_of_dst_cells_in_threads(long first_dst_cell_index, int num_threads)
+{
+    Remap_weights_threads_info threads_info;
+    std::vector<pthread_t> threads;
+    std::vector<std::pair<Remap_weights_threads_info*, int> > threads_args;
+    pthread_attr_t thread_attr;
+    pthread_t thread;
+    long i;
+    int j;
+
+
+    threads_info.remap_operator = this;
+    for (j = 0; j < num_threads; j ++) {
+        Remap_operator_basis *thread_remap_operator = get_thread_remap_operator();
+        if (thread_remap_operator == NULL)
+            break;
+        threads_info.thread_remap_operators.push_back(thread_remap_operator);
+    }
+    if (threads_info.thread_remap_operators.size() < num_threads) {
+        for (j = 0; j < threads_info.thread_remap_operators.size(); j ++)
+            if (threads_info.thread_remap_operators[j] != this)
+                delete threads_info.thread_remap_operators[j];
+        return -1;
+    }
+
+    threads_info.first_dst_cell_index = first_dst_cell_index;
+    threads_info.num_dst_cells = dst_grid->get_grid_size() - first_dst_cell_index;
+    threads_info.num_chunks = (threads_info.num_dst_cells+REMAP_WEIGHTS_THREAD_CHUNK_SIZE-1) / REMAP_WEIGHTS_THREAD_CHUNK_SIZE;
+    threads_info.next_chunk_index = 0;
+    threads_info.first_serial_dst_cell_index = dst_grid->get_grid_size();
+    threads_info.chunk_buffers.resize(threads_info.num_chunks, NULL);
+    pthread_mutex_init(&threads_info.mutex, NULL);
+
+    /* Computing the weights of a dst cell uses large arrays on the stack */
+    threads_args.resize(num_threads);
+    pthread_attr_init(&thread_attr);
+    pthread_attr_setstacksize(&thread_attr, REMAP_WEIGHTS_THREAD_STACK_SIZE);
+    for (j = 1; j < num_threads; j ++) {
+        threads_args[j] = std::make_pair(&threads_info, j);
+        if (pthread_create(&thread, &thread_attr, remap_weights_thread_entry, &threads_args[j]) != 0)
+            break;
+        threads.push_back(thread);
+    }
+    pthread_attr_destroy(&thread_attr);
+    EXECUTION_REPORT(REPORT_WARNING, -1, threads.size() == num_threads-1, "Only %d of %d threads are started for calculating the %s remapping weights", (int)threads.size()+1, num_threads, operator_name);
+    compute_remap_weights_of_chunks_in_thread(&threads_info, 0);
+    for (j = 0; j < threads.size(); j ++)
+        pthread_join(threads[j], NULL);
+    pthread_mutex_destroy(&threads_info.mutex);
+
+    for (i = 0; i < threads_info.num_chunks; i ++) {
+        Remap_weights_thread_buffer *chunk_buffer = threads_info.chunk_buffers[i];
+        if (chunk_buffer == NULL)
+            continue;
+        for (j = 0; j < chunk_buffer->records.size(); j ++) {
+            Remap_weights_thread_record *record = &(chunk_buffer->records[j]);
+            if (record->dst_cell_index >= threads_info.first_serial_dst_cell_index)
+                break;
+            if (record->num_weights == 0)
+                current_runtime_remap_operator->get_remap_weights_group(record->weights_group_index)->add_weights(NULL, record->index_dst_grid, NULL, 0, record->is_real_weight);
+            else current_runtime_remap_operator->get_remap_weights_group(record->weights_group_index)->add_weights(&(chunk_buffer->indexes_src_grid[record->weights_offset]), record->index_dst_grid, &(chunk_buffer->weight_values[record->weights_offset]), record->num_weights, record->is_real_weight);
+        }
+        delete chunk_buffer;
+    }
+    for (j = 0; j < num_threads; j ++)
+        if (threads_info.thread_remap_operators[j] != this)
+            delete threads_info.thread_remap_operators[j];
+
+    return threads_info.first_serial_dst_cell_index;
+}
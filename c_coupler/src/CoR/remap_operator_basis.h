@@ -15,6 +15,7 @@
 #include "remap_weight_sparse_matrix.h"
 #include "remap_weight_of_strategy_class.h"
 #include <vector>
+#include <pthread.h>
 
 
 #define REMAP_OPERATOR_NAME_BILINEAR               "bilinear"
@@ -25,11 +26,56 @@
 #define REMAP_OPERATOR_NAME_SMOOTH                 "smooth"
 #define REMAP_OPERATOR_NAME_REGRID                 "regrid"
 
+#define REMAP_WEIGHTS_THREAD_CHUNK_SIZE            256
+#define REMAP_WEIGHTS_THREAD_STACK_SIZE            (64*1024*1024)
+
+
+struct Remap_weights_thread_record
+{
+    long dst_cell_index;
+    long index_dst_grid;
+    long weights_offset;
+    int num_weights;
+    int weights_group_index;
+    bool is_real_weight;
+};
+
+
+/* The remapping weights computed by a thread for a chunk of dst cells, kept in the order of computing */
+struct Remap_weights_thread_buffer
+{
+    long current_dst_cell_index;
+    std::vector<Remap_weights_thread_record> records;
+    std::vector<long> indexes_src_grid;
+    std::vector<double> weight_values;
+
+    void add_weights(long*, long, double*, int, int, bool);
+    void discard_weights_of_dst_cell(long);
+};
+
+
+class Remap_operator_basis;
+
+
+struct Remap_weights_threads_info
+{
+    Remap_operator_basis *remap_operator;
+    std::vector<Remap_operator_basis*> thread_remap_operators;
+    std::vector<Remap_weights_thread_buffer*> chunk_buffers;
+    long first_dst_cell_index;
+    long num_dst_cells;
+    long num_chunks;
+    long next_chunk_index;
+    long first_serial_dst_cell_index;
+    pthread_mutex_t mutex;
+};
+
 
 class Remap_operator_basis
 {
     private:
         void register_remap_grids(int, Remap_grid_class **);
+        long calculate_remap_weights_of_dst_cells_in_threads(long, int);
         
     protected:
         friend class Remap_weight_of_operator_instance_class;
@@ -49,6 +95,10 @@ class Remap_operator_basis
         long size_index_src_cells_overlap_with_dst_cells;
         bool enable_extrapolate;
 
+        void calculate_remap_weights_of_dst_cells();
+        void calculate_remap_weights_of_one_dst_cell(long);
+        virtual Remap_operator_basis *get_thread_remap_operator() { return NULL; }
+
     public:
         Remap_operator_basis(const char*, const char*, int, bool, bool, bool, int, Remap_grid_class **);
         Remap_operator_basis();
@@ -57,6 +107,9 @@ class Remap_operator_basis
         virtual void set_parameter(const char*, const char*) = 0;
         virtual int check_parameter(const char*, const char*, char*) = 0;
         virtual void do_remap_values_caculation(double*, double*, int) = 0;
+        virtual void do_remap_values_caculation_of_levels(double*, double*, int, int, long, long);
+        virtual bool is_float_remap_values_supported() { return false; }
+        virtual void do_remap_float_values_caculation_of_levels(float*, float*, int, int, long, long);
         virtual void calculate_remap_weights() = 0;
         virtual Remap_operator_basis *duplicate_remap_operator(bool) = 0;
         virtual void compute_remap_weights_of_one_dst_cell(long) = 0;
@@ -83,6 +136,7 @@ class Remap_operator_basis
         void set_dst_grid(Remap_grid_class *new_dst_grid) { dst_grid = new_dst_grid; }
 		Remap_operator_basis *gather(int);
 		bool get_extrapolate_enabled() { return enable_extrapolate; }
+		void compute_remap_weights_of_chunks_in_thread(Remap_weights_threads_info*, int);
 };
 
 
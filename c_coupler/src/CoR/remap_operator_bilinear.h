@@ -25,6 +25,7 @@ class Remap_operator_bilinear: public Remap_operator_basis
         double iterative_threshold_distance;
 
         void compute_remap_weights_of_one_dst_cell(long);
+        Remap_operator_basis *get_thread_remap_operator();
         int search_nearnest_src_points_for_bilinear(double*, long, double&, double&);
         int search_at_least_16_nearnest_src_points_for_bilinear(double*, long, long, double&, double&);
         int compute_quadrant_of_src_point(double*, double*);
@@ -46,6 +47,9 @@ class Remap_operator_bilinear: public Remap_operator_basis
         int check_parameter(const char*, const char*, char*);
         void calculate_remap_weights();
         void do_remap_values_caculation(double*, double*, int);
+        void do_remap_values_caculation_of_levels(double*, double*, int, int, long, long);
+        bool is_float_remap_values_supported() { return true; }
+        void do_remap_float_values_caculation_of_levels(float*, float*, int, int, long, long);
         Remap_operator_basis *duplicate_remap_operator(bool);
 		void initialize();
 };
@@ -8,18 +8,24 @@
 
 
 #include "cor_global_data.h"
+#include "global_data.h"
 #include "remap_operator_c_interface.h"
 #include "remap_grid_class.h"
 #include "quick_sort.h"
 #include "remap_common_utils.h"
 #include "remap_utils_nearest_points.h"
 #include "grid_cell_search.h"
+#include "remap_operator_basis.h"
 #include <math.h>
 
 
-bool have_fetched_dst_grid_cell_coord_values;
-bool using_rotated_grid_data;
-long last_dst_cell_index;
+/* The status of computing the remapping weights of one dst cell is kept for each thread, so that
+   several threads can compute the weights of different dst cells at the same time */
+__thread bool have_fetched_dst_grid_cell_coord_values;
+__thread bool using_rotated_grid_data;
+__thread long last_dst_cell_index;
+static __thread Remap_weights_thread_buffer *current_remap_weights_thread_buffer = NULL;
+static __thread bool remap_weights_cell_require_serial_computing = false;
 
 
 void get_cell_mask_of_grid(Remap_operator_grid *grid, long cell_index, bool *mask_value)
@@ -223,10 +229,52 @@ void clear_remap_weight_info_in_sparse_matrix()
 
 void add_remap_weights_to_sparse_matrix(long *indexes_src_grid, long index_dst_grid, double *weight_values, int num_weights, int weights_group_index, bool is_real_weight)
 {
+    if (current_remap_weights_thread_buffer != NULL) {
+        current_remap_weights_thread_buffer->add_weights(indexes_src_grid, index_dst_grid, weight_values, num_weights, weights_group_index, is_real_weight);
+        return;
+    }
     current_runtime_remap_operator->get_remap_weights_group(weights_group_index)->add_weights(indexes_src_grid, index_dst_grid, weight_values, num_weights, is_real_weight);
 }
 
 
+/* When the buffer is not NULL, the calling thread computes remapping weights together with other threads,
+   and the weights it computes are kept in the buffer instead of the sparse matrixes */
+void set_remap_weights_thread_buffer(Remap_weights_thread_buffer *buffer)
+{
+    current_remap_weights_thread_buffer = buffer;
+    remap_weights_cell_require_serial_computing = false;
+}
+
+
+bool is_computing_remap_weights_in_thread()
+{
+    return current_remap_weights_thread_buffer != NULL;
+}
+
+
+bool does_remap_weights_cell_require_serial_computing()
+{
+    bool require_serial_computing = remap_weights_cell_require_serial_computing;
+
+
+    remap_weights_cell_require_serial_computing = false;
+    return require_serial_computing;
+}
+
+
+/* Enlarging the src subdomain grid changes the grids shared by all threads. A thread therefore only 
+   marks the current dst cell, which will be computed again serially after the threads finish */
+bool confirm_or_enlarge_src_subdomain_grid_for_remapping(long dst_cell_index, double radius)
+{
+    if (!is_computing_remap_weights_in_thread())
+        return current_distributed_H2D_weights_generator->confirm_or_enlarge_current_src_subdomain_grid_for_remapping(dst_cell_index, radius);
+
+    if (current_distributed_H2D_weights_generator->should_enlarge_src_subdomain_grid_for_remapping(dst_cell_index, radius))
+        remap_weights_cell_require_serial_computing = true;
+    return false;
+}
+
+
 double compute_difference_of_two_coord_values(double coord_value1, double coord_value2, int dim_id)
 {
     if (is_coord_unit_degree[dim_id])
@@ -14,6 +14,9 @@
 #include "grid_cell_search.h"
 
 
+struct Remap_weights_thread_buffer;
+
+
 extern void get_cell_mask_of_src_grid(long, bool*);
 extern void get_cell_mask_of_dst_grid(long, bool*);
 extern void get_cell_center_coord_values_of_src_grid(long, double*);
@@ -45,6 +48,11 @@ extern long get_size_of_dst_grid();
 
 extern H2D_grid_cell_search_engine *get_current_grid2D_search_engine(bool);
 
+extern void set_remap_weights_thread_buffer(Remap_weights_thread_buffer*);
+extern bool is_computing_remap_weights_in_thread();
+extern bool does_remap_weights_cell_require_serial_computing();
+extern bool confirm_or_enlarge_src_subdomain_grid_for_remapping(long, double);
+
 
 #endif
 
@@ -86,22 +86,17 @@ void Remap_operator_conserv_2D::compute_remap_weights_of_one_dst_cell(long cell_
 
 void Remap_operator_conserv_2D::calculate_remap_weights()
 {
-    long cell_index_dst;
-    bool dst_cell_mask;
-
-
     calculate_grids_overlaping();
     clear_remap_weight_info_in_sparse_matrix();
+    calculate_remap_weights_of_dst_cells();
+}
 
-    for (cell_index_dst = 0; cell_index_dst < dst_grid->get_grid_size(); cell_index_dst ++) {
-        get_cell_mask_of_dst_grid(cell_index_dst, &dst_cell_mask);
-        if (!dst_cell_mask)
-            continue;
-        initialize_computing_remap_weights_of_one_cell();
-        compute_remap_weights_of_one_dst_cell(cell_index_dst);
-        clear_src_grid_cell_visiting_info();
-        finalize_computing_remap_weights_of_one_cell();
-    }
+
+/* The weights of a dst cell only depend on local arrays and on its own segment of the overlapping src cells,
+    so that all threads can share this operator */
+Remap_operator_basis *Remap_operator_conserv_2D::get_thread_remap_operator()
+{
+    return this;
 }
 
 
@@ -126,6 +121,18 @@ void Remap_operator_conserv_2D::do_remap_values_caculation(double *data_values_s
 }
 
 
+void Remap_operator_conserv_2D::do_remap_values_caculation_of_levels(double *data_values_src, double *data_values_dst, int dst_array_size, int num_levels, long src_level_stride, long dst_level_stride)
+{
+    remap_weights_groups[0]->remap_values_of_levels(data_values_src, data_values_dst, dst_array_size, num_levels, src_level_stride, dst_level_stride);
+}
+
+
+void Remap_operator_conserv_2D::do_remap_float_values_caculation_of_levels(float *data_values_src, float *data_values_dst, int dst_array_size, int num_levels, long src_level_stride, long dst_level_stride)
+{
+    remap_weights_groups[0]->remap_values_of_levels(data_values_src, data_values_dst, dst_array_size, num_levels, src_level_stride, dst_level_stride);
+}
+
+
 Remap_operator_basis *Remap_operator_conserv_2D::duplicate_remap_operator(bool fully_copy)
 {
     Remap_operator_conserv_2D *duplicated_remap_operator = new Remap_operator_conserv_2D();
@@ -122,9 +122,19 @@ void Remap_operator_distwgt::calculate_remap_weights()
 {    
     threshold_distance = 1.0/6000.0;
     clear_remap_weight_info_in_sparse_matrix();
-    
-    for (long dst_cell_index = 0; dst_cell_index < dst_grid->get_grid_size(); dst_cell_index ++)
-        compute_remap_weights_of_one_dst_cell(dst_cell_index);
+    calculate_remap_weights_of_dst_cells();
+}
+
+
+/* Each thread uses a duplicated operator with its own arrays of the found nearest points */
+Remap_operator_basis *Remap_operator_distwgt::get_thread_remap_operator()
+{
+    Remap_operator_distwgt *thread_remap_operator = (Remap_operator_distwgt*) duplicate_remap_operator(false);
+    thread_remap_operator->found_nearest_points_distance = new double [src_grid->get_grid_size()];
+    thread_remap_operator->found_nearest_points_src_indexes = new long [src_grid->get_grid_size()];
+    thread_remap_operator->weigt_values_of_one_dst_cell = new double [num_nearest_points];
+
+    return thread_remap_operator;
 }
 
 
@@ -145,6 +155,18 @@ void Remap_operator_distwgt::do_remap_values_caculation(double *data_values_src,
 }
 
 
+void Remap_operator_distwgt::do_remap_values_caculation_of_levels(double *data_values_src, double *data_values_dst, int dst_array_size, int num_levels, long src_level_stride, long dst_level_stride)
+{
+    remap_weights_groups[0]->remap_values_of_levels(data_values_src, data_values_dst, dst_array_size, num_levels, src_level_stride, dst_level_stride);
+}
+
+
+void Remap_operator_distwgt::do_remap_float_values_caculation_of_levels(float *data_values_src, float *data_values_dst, int dst_array_size, int num_levels, long src_level_stride, long dst_level_stride)
+{
+    remap_weights_groups[0]->remap_values_of_levels(data_values_src, data_values_dst, dst_array_size, num_levels, src_level_stride, dst_level_stride);
+}
+
+
 Remap_operator_basis *Remap_operator_distwgt::duplicate_remap_operator(bool fully_copy)
 {
     Remap_operator_distwgt *duplicated_remap_operator = new Remap_operator_distwgt();
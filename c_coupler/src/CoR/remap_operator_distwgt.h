@@ -25,6 +25,7 @@ class Remap_operator_distwgt: public Remap_operator_basis
         double threshold_distance;
 
         void compute_remap_weights_of_one_dst_cell(long);
+        Remap_operator_basis *get_thread_remap_operator();
 
     public:
         Remap_operator_distwgt(const char*, int, Remap_grid_class **);
@@ -34,6 +35,9 @@ class Remap_operator_distwgt: public Remap_operator_basis
         int check_parameter(const char*, const char*, char*);
         void calculate_remap_weights();
         void do_remap_values_caculation(double*, double*, int);
+        void do_remap_values_caculation_of_levels(double*, double*, int, int, long, long);
+        bool is_float_remap_values_supported() { return true; }
+        void do_remap_float_values_caculation_of_levels(float*, float*, int, int, long, long);
         Remap_operator_basis *duplicate_remap_operator(bool);
 		void initialize();
 };
@@ -64,6 +64,12 @@ void Remap_operator_smooth::do_remap_values_caculation(double *data_values_src,
 }
 
 
+void Remap_operator_smooth::do_remap_values_caculation_of_levels(double *data_values_src, double *data_values_dst, int dst_array_size, int num_levels, long src_level_stride, long dst_level_stride)
+{
+    remap_weights_groups[0]->remap_values_of_levels(data_values_src, data_values_dst, dst_array_size, num_levels, src_level_stride, dst_level_stride);
+}
+
+
 Remap_operator_basis *Remap_operator_smooth::duplicate_remap_operator(bool fully_copy)
 {
     Remap_operator_basis *duplicated_remap_operator = new Remap_operator_smooth();
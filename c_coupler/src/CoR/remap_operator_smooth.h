@@ -27,6 +27,7 @@ class Remap_operator_smooth: public Remap_operator_basis
         int check_parameter(const char *, const char *, char*);
         void calculate_remap_weights();
         void do_remap_values_caculation(double*, double*, int);
+        void do_remap_values_caculation_of_levels(double*, double*, int, int, long, long);
         Remap_operator_basis *duplicate_remap_operator(bool);
 };
 
@@ -16,69 +16,6 @@
 #include <assert.h>
 
 
-void Remap_operator_spline_1D::solve_aperiodic_tridiagonal_system(double *a, double *b, double *c, double *f, int n)
-{
-    double y;
-
-
-    for (int i = 1; i < n; i++) {
-        y = a[i]/b[i-1];
-        b[i] -= c[i-1]*y;
-        f[i] -= f[i-1]*y;
-    }
-
-    f[n-1] /= b[n-1];
-    for (int i = n-2; i >=0; i--)
-        f[i] = (f[i]-f[i+1]*c[i])/b[i];
-}
-
-
-void Remap_operator_spline_1D::solve_periodic_tridiagonal_system(double *a, double *b, double *c, double *f, int n)
-{
-    double y;
-    int i;
-
-
-    temp_array_column[0] = a[0];
-    temp_array_row[0] = c[n-1];
-    for (i = 1; i < n-2; i++) {
-        y = a[i]/b[i-1];
-        b[i] -= c[i-1]*y;
-        temp_array_column[i] = -temp_array_column[i-1]*y;
-        f[i] -= f[i-1]*y;
-        y = temp_array_row[i-1]/b[i-1];
-        temp_array_row[i] = -c[i-1]*y;
-        b[n-1] -= temp_array_column[i-1]*y;
-        f[n-1] -= f[i-1]*y;
-    }    
-
-    y = a[n-2]/b[n-3];
-    b[n-2] -= c[n-3]*y;
-    c[n-2] -= temp_array_column[n-3]*y;
-    f[n-2] -= f[n-3]*y;
-    y = temp_array_row[n-3]/b[n-3];
-    a[n-1] -= c[n-3]*y;
-    b[n-1] -= temp_array_column[n-3]*y;
-    f[n-1] -= f[n-3]*y;
-
-    y = a[n-1]/b[n-2];
-    b[n-1] -= c[n-2]*y;
-    f[n-1] -= f[n-2]*y;
-    
-    // back substitution
-    f[n-1] /= b[n-1];
-    b[n-1] = 1.0;
-    f[n-2] -= f[n-1]*c[n-2]/b[n-1];
-    f[n-2] /= b[n-2];
-    b[n-2] = 1.0;
-    for (i = n-3; i >= 0; i--) {
-        f[i] = f[i]-c[i]*f[i+1]-temp_array_column[i]*f[n-1];
-        f[i] /= b[i];
-        b[i] = 1.0;
-    }
-}
-
-
 void Remap_operator_spline_1D::set_parameter(const char *parameter_name, const char *parameter_value)
 {
     EXECUTION_REPORT(REPORT_ERROR, -1, enable_to_set_parameters, 
@@ -146,6 +83,7 @@ Remap_operator_spline_1D::Remap_operator_spline_1D(const char *object_name, int
     keep_monotonicity = false;
     set_keep_monotonicity = false;
     allocate_local_arrays();
+    remap_tables.is_built = false;
     remap_weights_groups.push_back(new Remap_weight_sparse_matrix(this));
     remap_weights_groups.push_back(new Remap_weight_sparse_matrix(this));
     remap_weights_groups.push_back(new Remap_weight_sparse_matrix(this));
@@ -173,6 +111,7 @@ void Remap_operator_spline_1D::calculate_remap_weights()
 
     allocate_1D_remap_operator_common_arrays_space();
     allocate_local_arrays();
+    remap_tables.is_built = false;
 
     clear_remap_weight_info_in_sparse_matrix();
     calculate_dst_src_mapping_info();
@@ -229,122 +168,265 @@ void Remap_operator_spline_1D::calculate_remap_weights()
 }
 
 
-void Remap_operator_spline_1D::do_remap_values_caculation(double *data_values_src, double *data_values_dst, int dst_array_size)
+void Remap_operator_spline_1D::build_remap_tables()
 {
-    int i, j, k, m, start_index_monotonicity_range, end_index_monotonicity_range;
-    int original_index1, original_index2, original_index3;
-    int num_dst_cells_in_monotonicity_ranges;
     long temp_long_value1, temp_long_value2;
     double temp_double_value;
-    double ratio;
-    bool check_monotonicity, next_in_same_monotonicity_range;
-
+    int i, n, num_dst_cells = dst_grid->get_grid_size();
 
-    allocate_1D_remap_operator_common_arrays_space();
-    allocate_local_arrays();
 
-    array_size_src = remap_weights_groups[0]->get_num_weights();
-    if (array_size_src == 0)
+    n = remap_weights_groups[0]->get_num_weights();
+    remap_tables.array_size_src = n;
+    remap_tables.is_built = true;
+    if (n == 0)
         return;
-    
-    for (i = 0; i < array_size_src; i ++) {
-        remap_weights_groups[0]->get_weight((long*)(&array_mu[i]), &temp_long_value1, array_lambda+i, i);
-        useful_src_cells_global_index[i] = temp_long_value1;
-        remap_weights_groups[1]->get_weight((long*)(&coord_values_src[i]), &temp_long_value2, array_h+i, i);
+
+    std::vector<double> a(n), b(n, 2.0), c(n);
+    remap_tables.useful_src_cells_global_index.resize(n);
+    remap_tables.coord_values_src.resize(n);
+    remap_tables.array_h.resize(n);
+    for (i = 0; i < n; i ++) {
+        remap_weights_groups[0]->get_weight((long*)(&a[i]), &temp_long_value1, &c[i], i);
+        remap_tables.useful_src_cells_global_index[i] = temp_long_value1;
+        remap_weights_groups[1]->get_weight((long*)(&remap_tables.coord_values_src[i]), &temp_long_value2, &remap_tables.array_h[i], i);
     }
-    for (i = 0; i < dst_grid->get_grid_size(); i ++) {
-        remap_weights_groups[2]->get_weight((long*)(&final_factor1[i]), ((long*)(&final_factor2[i])), final_factor3+i, i);
-        remap_weights_groups[3]->get_weight((long*)(&final_factor4[i]), ((long*)(&final_factor5[i])), coord_values_dst+i, i);
+    remap_tables.coord_values_dst.resize(num_dst_cells);
+    remap_tables.src_cell_index_left.resize(num_dst_cells);
+    remap_tables.src_cell_index_right.resize(num_dst_cells);
+    for (i = 0; i < 5; i ++)
+        remap_tables.final_factors[i].resize(num_dst_cells);
+    for (i = 0; i < num_dst_cells; i ++) {
+        remap_weights_groups[2]->get_weight((long*)(&remap_tables.final_factors[0][i]), (long*)(&remap_tables.final_factors[1][i]), &remap_tables.final_factors[2][i], i);
+        remap_weights_groups[3]->get_weight((long*)(&remap_tables.final_factors[3][i]), (long*)(&remap_tables.final_factors[4][i]), &remap_tables.coord_values_dst[i], i);
         remap_weights_groups[4]->get_weight(&temp_long_value1, &temp_long_value2, &temp_double_value, i);
-        src_cell_index_left[i] = temp_long_value1;
-        src_cell_index_right[i] = temp_long_value2;
+        remap_tables.src_cell_index_left[i] = temp_long_value1;
+        remap_tables.src_cell_index_right[i] = temp_long_value2;
     }
 
-    for (i = 0; i < array_size_src; i++)
-        array_alpha[i] = 2.0;
-    
-    preprocess_field_value(data_values_src);
+    // the elimination steps of the aperiodic and periodic tridiagonal systems that do not depend on the right-hand side
+    remap_tables.factor_multiplier.assign(n, 0.0);
+    remap_tables.factor_row_multiplier.assign(n, 0.0);
+    remap_tables.factor_column.assign(n, 0.0);
+    if (!periodic) {
+        for (i = 1; i < n; i ++) {
+            remap_tables.factor_multiplier[i] = a[i]/b[i-1];
+            b[i] -= c[i-1]*remap_tables.factor_multiplier[i];
+        }
+        remap_tables.factor_diagonal = b;
+        remap_tables.factor_upper = c;
+        return;
+    }
+
+    std::vector<double> temp_row(n);
+    double *h = &(remap_tables.array_h[0]), *column = &(remap_tables.factor_column[0]), *multiplier = &(remap_tables.factor_multiplier[0]), *row_multiplier = &(remap_tables.factor_row_multiplier[0]);
+    double *pa = &a[1], *pb = &b[1], *pc = &c[1];
+    c[n-1] = h[0]/(h[n-2]+h[0]);
+    a[n-1] = 1.0-c[n-1];
+    n --;
+    column[0] = pa[0];
+    temp_row[0] = pc[n-1];
+    for (i = 1; i < n-2; i++) {
+        multiplier[i] = pa[i]/pb[i-1];
+        pb[i] -= pc[i-1]*multiplier[i];
+        column[i] = -column[i-1]*multiplier[i];
+        row_multiplier[i] = temp_row[i-1]/pb[i-1];
+        temp_row[i] = -pc[i-1]*row_multiplier[i];
+        pb[n-1] -= column[i-1]*row_multiplier[i];
+    }
+    multiplier[n-2] = pa[n-2]/pb[n-3];
+    pb[n-2] -= pc[n-3]*multiplier[n-2];
+    pc[n-2] -= column[n-3]*multiplier[n-2];
+    row_multiplier[n-2] = temp_row[n-3]/pb[n-3];
+    pa[n-1] -= pc[n-3]*row_multiplier[n-2];
+    pb[n-1] -= column[n-3]*row_multiplier[n-2];
+    remap_tables.factor_last_multiplier = pa[n-1]/pb[n-2];
+    pb[n-1] -= pc[n-2]*remap_tables.factor_last_multiplier;
+    remap_tables.factor_diagonal.assign(pb, pb+n);
+    remap_tables.factor_upper.assign(pc, pc+n);
+}
+
+
+/* Solves the tridiagonal systems of num_columns columns with the factorization in the remap tables. The right-hand 
+   side of row i and column j is d[i*stride+j], and it is replaced by the solution */
+void Remap_operator_spline_1D::solve_batched_tridiagonal_systems(double *d, int stride, int num_columns)
+{
+    const double *multiplier = &(remap_tables.factor_multiplier[0]), *row_multiplier = &(remap_tables.factor_row_multiplier[0]);
+    const double *diagonal = &(remap_tables.factor_diagonal[0]), *upper = &(remap_tables.factor_upper[0]), *column = &(remap_tables.factor_column[0]);
+    int i, j, n = remap_tables.array_size_src;
 
-    for (i = 1; i < array_size_src-1; i++)
-        array_d[i] = 6.0*((packed_data_values_src[i+1]-packed_data_values_src[i])/array_h[i]-(packed_data_values_src[i]-packed_data_values_src[i-1])/array_h[i-1])/(array_h[i-1]+array_h[i]);
 
     if (!periodic) {
-        array_d[0] = 0.0;
-        array_d[array_size_src-1] = 0.0;
-        solve_aperiodic_tridiagonal_system(array_mu, array_alpha, array_lambda, array_d, array_size_src);
+        for (i = 1; i < n; i ++)
+            for (j = 0; j < num_columns; j ++)
+                d[i*stride+j] -= d[(i-1)*stride+j]*multiplier[i];
+        for (j = 0; j < num_columns; j ++)
+            d[(n-1)*stride+j] /= diagonal[n-1];
+        for (i = n-2; i >= 0; i --)
+            for (j = 0; j < num_columns; j ++)
+                d[i*stride+j] = (d[i*stride+j]-d[(i+1)*stride+j]*upper[i])/diagonal[i];
+        return;
     }
-    else {
-        array_lambda[array_size_src-1] = array_h[0]/(array_h[array_size_src-2]+array_h[0]);
-        array_mu[array_size_src-1] = 1.0-array_lambda[array_size_src-1];
-        array_d[array_size_src-1] = 6.0*((packed_data_values_src[1]-packed_data_values_src[0])/array_h[0]-(packed_data_values_src[array_size_src-1]-packed_data_values_src[array_size_src-2])/array_h[array_size_src-2])/(array_h[0]+array_h[array_size_src-2]);
-        solve_periodic_tridiagonal_system(array_mu+1, array_alpha+1, array_lambda+1, array_d+1, array_size_src-1);
-        array_d[0]=array_d[array_size_src-1];
+
+    double *f = d + stride;
+    n --;
+    for (i = 1; i < n-2; i ++)
+        for (j = 0; j < num_columns; j ++) {
+            f[i*stride+j] -= f[(i-1)*stride+j]*multiplier[i];
+            f[(n-1)*stride+j] -= f[(i-1)*stride+j]*row_multiplier[i];
+        }
+    for (j = 0; j < num_columns; j ++) {
+        f[(n-2)*stride+j] -= f[(n-3)*stride+j]*multiplier[n-2];
+        f[(n-1)*stride+j] -= f[(n-3)*stride+j]*row_multiplier[n-2];
+        f[(n-1)*stride+j] -= f[(n-2)*stride+j]*remap_tables.factor_last_multiplier;
+        f[(n-1)*stride+j] /= diagonal[n-1];
+        f[(n-2)*stride+j] -= f[(n-1)*stride+j]*upper[n-2];
+        f[(n-2)*stride+j] /= diagonal[n-2];
     }
+    for (i = n-3; i >= 0; i --)
+        for (j = 0; j < num_columns; j ++) {
+            f[i*stride+j] = f[i*stride+j]-upper[i]*f[(i+1)*stride+j]-column[i]*f[(n-1)*stride+j];
+            f[i*stride+j] /= diagonal[i];
+        }
+}
 
-    for (i = 0; i < dst_grid->get_grid_size(); i ++) {
+
+void Remap_operator_spline_1D::keep_monotonicity_of_column(const double *packed_values_src, int stride, double *data_values_dst)
+{
+    int i, j, k, start_index_monotonicity_range, end_index_monotonicity_range;
+    int original_index1, original_index2, original_index3;
+    int num_dst_cells_in_monotonicity_ranges;
+    double ratio;
+    bool check_monotonicity, next_in_same_monotonicity_range;
+    const int *src_cell_index_left = &(remap_tables.src_cell_index_left[0]), *src_cell_index_right = &(remap_tables.src_cell_index_right[0]);
+    const double *coord_values_src = &(remap_tables.coord_values_src[0]), *coord_values_dst = &(remap_tables.coord_values_dst[0]);
+
+
+    for (i = 0, num_dst_cells_in_monotonicity_ranges = 0; i < dst_grid->get_grid_size(); i ++) {
         if (src_cell_index_left[i] == -1 || src_cell_index_right[i] == -1)
             continue;
-        if (src_cell_index_left[i] == src_cell_index_right[i])
-            data_values_dst[i] = packed_data_values_src[src_cell_index_left[i]];
+        if (!(coord_values_dst[i] > coord_values_src[src_cell_index_left[i]] && coord_values_dst[i] < coord_values_src[src_cell_index_right[i]]))
+            continue;
+        dst_cell_indexes_in_monotonicity_ranges[num_dst_cells_in_monotonicity_ranges ++] = i;
+    }
+    start_index_monotonicity_range = -1;
+    for (i = 0; i < num_dst_cells_in_monotonicity_ranges; i ++) {
+        if (start_index_monotonicity_range == -1) {
+            j = 0;
+            start_index_monotonicity_range = i;
+            data_in_monotonicity_range[j++] = packed_values_src[src_cell_index_left[dst_cell_indexes_in_monotonicity_ranges[i]]*stride];
+        }
+        end_index_monotonicity_range = i;
+        data_in_monotonicity_range[j++] = data_values_dst[dst_cell_indexes_in_monotonicity_ranges[i]];
+        if (i == num_dst_cells_in_monotonicity_ranges - 1)
+            next_in_same_monotonicity_range = false;
         else {
-            data_values_dst[i] = array_d[src_cell_index_left[i]]*final_factor1[i];
-            data_values_dst[i] += array_d[src_cell_index_right[i]]*final_factor2[i];
-            data_values_dst[i] += (packed_data_values_src[src_cell_index_left[i]]-array_d[src_cell_index_left[i]]*final_factor3[i])*final_factor4[i];
-            data_values_dst[i] += (packed_data_values_src[src_cell_index_right[i]]-array_d[src_cell_index_right[i]]*final_factor3[i])*final_factor5[i];
+            original_index1 = dst_cell_indexes_in_monotonicity_ranges[start_index_monotonicity_range];
+            original_index2 = dst_cell_indexes_in_monotonicity_ranges[i+1];
+            next_in_same_monotonicity_range = (src_cell_index_left[original_index1] == src_cell_index_left[original_index2] && src_cell_index_right[original_index1] == src_cell_index_right[original_index2]);
+        }
+        if (!next_in_same_monotonicity_range) {
+            original_index1 = dst_cell_indexes_in_monotonicity_ranges[start_index_monotonicity_range];
+            original_index2 = dst_cell_indexes_in_monotonicity_ranges[end_index_monotonicity_range];
+            EXECUTION_REPORT(REPORT_ERROR, -1, src_cell_index_left[original_index1] == src_cell_index_left[original_index2] && src_cell_index_right[original_index1] == src_cell_index_right[original_index2], 
+                             "software error: in keep monotonicity");             
+            data_in_monotonicity_range[j++] = packed_values_src[src_cell_index_right[original_index1]*stride];
+            check_monotonicity = true;
+            for (k = 0; k < j - 1; k ++)
+                if ((data_in_monotonicity_range[k] >= data_in_monotonicity_range[k+1]) != (data_in_monotonicity_range[0] >= data_in_monotonicity_range[j-1])) {
+                    check_monotonicity = false;
+                    break;
+                }
+            if (!check_monotonicity) {
+                original_index1 = src_cell_index_left[dst_cell_indexes_in_monotonicity_ranges[start_index_monotonicity_range]];
+                original_index2 = src_cell_index_right[dst_cell_indexes_in_monotonicity_ranges[start_index_monotonicity_range]];
+                for (k = start_index_monotonicity_range; k <= end_index_monotonicity_range; k ++) {
+                    original_index3 = dst_cell_indexes_in_monotonicity_ranges[k];
+                    ratio = (coord_values_dst[original_index3]-coord_values_src[original_index1]) / (coord_values_src[original_index2]-coord_values_src[original_index1]);
+                    data_values_dst[original_index3] = packed_values_src[original_index1*stride]*(1-ratio) + packed_values_src[original_index2*stride]*ratio;
+                }
+            }
+            start_index_monotonicity_range = -1;
         }
     }
+}
 
+
+void Remap_operator_spline_1D::do_remap_values_caculation(double *data_values_src, double *data_values_dst, int dst_array_size)
+{
+    do_remap_values_caculation_of_levels(data_values_src, data_values_dst, dst_array_size, 1, 0, 0);
+}
+
+
+void Remap_operator_spline_1D::do_remap_values_caculation_of_levels(double *data_values_src, double *data_values_dst, int dst_array_size, int num_levels, long src_level_stride, long dst_level_stride)
+{
+    int i, j, k, n, num_columns, left, right;
+    const int stride = SPLINE_1D_NUM_BATCHED_COLUMNS;
+    double *packed_values, *d;
+
+
+    if (!remap_tables.is_built)
+        build_remap_tables();
+    n = remap_tables.array_size_src;
+    if (n == 0)
+        return;
     if (keep_monotonicity) {
-        for (i = 0, num_dst_cells_in_monotonicity_ranges = 0; i < dst_grid->get_grid_size(); i ++) {
-            if (src_cell_index_left[i] == -1 || src_cell_index_right[i] == -1)
-                continue;
-            if (!(coord_values_dst[i] > coord_values_src[src_cell_index_left[i]] && coord_values_dst[i] < coord_values_src[src_cell_index_right[i]]))
-                continue;
-            dst_cell_indexes_in_monotonicity_ranges[num_dst_cells_in_monotonicity_ranges ++] = i;
-        }
-        start_index_monotonicity_range = -1;
-        for (i = 0; i < num_dst_cells_in_monotonicity_ranges; i ++) {
-            if (start_index_monotonicity_range == -1) {
-                j = 0;
-                start_index_monotonicity_range = i;
-                data_in_monotonicity_range[j++] = packed_data_values_src[src_cell_index_left[dst_cell_indexes_in_monotonicity_ranges[i]]];
-            }
-            end_index_monotonicity_range = i;
-            data_in_monotonicity_range[j++] = data_values_dst[dst_cell_indexes_in_monotonicity_ranges[i]];
-            if (i == num_dst_cells_in_monotonicity_ranges - 1)
-                next_in_same_monotonicity_range = false;
-            else {
-                original_index1 = dst_cell_indexes_in_monotonicity_ranges[start_index_monotonicity_range];
-                original_index2 = dst_cell_indexes_in_monotonicity_ranges[i+1];
-                next_in_same_monotonicity_range = (src_cell_index_left[original_index1] == src_cell_index_left[original_index2] && src_cell_index_right[original_index1] == src_cell_index_right[original_index2]);
+        allocate_1D_remap_operator_common_arrays_space();
+        allocate_local_arrays();
+    }
+
+    const int *useful_src_cells_global_index = &(remap_tables.useful_src_cells_global_index[0]);
+    const int *src_cell_index_left = &(remap_tables.src_cell_index_left[0]), *src_cell_index_right = &(remap_tables.src_cell_index_right[0]);
+    const double *h = &(remap_tables.array_h[0]);
+    const double *factor1 = &(remap_tables.final_factors[0][0]), *factor2 = &(remap_tables.final_factors[1][0]), *factor3 = &(remap_tables.final_factors[2][0]);
+    const double *factor4 = &(remap_tables.final_factors[3][0]), *factor5 = &(remap_tables.final_factors[4][0]);
+
+    if (batched_data_values.size() < 2*n*stride)
+        batched_data_values.resize(2*n*stride);
+    packed_values = &(batched_data_values[0]);
+    d = packed_values + n*stride;
+
+    for (k = 0; k < num_levels; k += stride) {
+        num_columns = num_levels-k < stride? num_levels-k : stride;
+        for (i = 0; i < n; i ++)
+            for (j = 0; j < num_columns; j ++)
+                packed_values[i*stride+j] = data_values_src[(k+j)*src_level_stride+useful_src_cells_global_index[i]];
+
+        for (i = 1; i < n-1; i ++)
+            for (j = 0; j < num_columns; j ++)
+                d[i*stride+j] = 6.0*((packed_values[(i+1)*stride+j]-packed_values[i*stride+j])/h[i]-(packed_values[i*stride+j]-packed_values[(i-1)*stride+j])/h[i-1])/(h[i-1]+h[i]);
+        for (j = 0; j < num_columns; j ++) {
+            if (!periodic) {
+                d[j] = 0.0;
+                d[(n-1)*stride+j] = 0.0;
             }
-            if (!next_in_same_monotonicity_range) {
-                original_index1 = dst_cell_indexes_in_monotonicity_ranges[start_index_monotonicity_range];
-                original_index2 = dst_cell_indexes_in_monotonicity_ranges[end_index_monotonicity_range];
-                EXECUTION_REPORT(REPORT_ERROR, -1, src_cell_index_left[original_index1] == src_cell_index_left[original_index2] && src_cell_index_right[original_index1] == src_cell_index_right[original_index2], 
-                                 "software error: in keep monotonicity");             
-                data_in_monotonicity_range[j++] = packed_data_values_src[src_cell_index_right[original_index1]];
-                check_monotonicity = true;
-                for (k = 0; k < j - 1; k ++)
-                    if ((data_in_monotonicity_range[k] >= data_in_monotonicity_range[k+1]) != (data_in_monotonicity_range[0] >= data_in_monotonicity_range[j-1])) {
-                        check_monotonicity = false;
-                        break;
-                    }
-                if (!check_monotonicity) {
-                    original_index1 = src_cell_index_left[dst_cell_indexes_in_monotonicity_ranges[start_index_monotonicity_range]];
-                    original_index2 = src_cell_index_right[dst_cell_indexes_in_monotonicity_ranges[start_index_monotonicity_range]];
-                    for (k = start_index_monotonicity_range; k <= end_index_monotonicity_range; k ++) {
-                        original_index3 = dst_cell_indexes_in_monotonicity_ranges[k];
-                        ratio = (coord_values_dst[original_index3]-coord_values_src[original_index1]) / (coord_values_src[original_index2]-coord_values_src[original_index1]);
-                        data_values_dst[original_index3] = packed_data_values_src[original_index1]*(1-ratio) + packed_data_values_src[original_index2]*ratio;
-                    }
-                }
-                start_index_monotonicity_range = -1;
+            else d[(n-1)*stride+j] = 6.0*((packed_values[stride+j]-packed_values[j])/h[0]-(packed_values[(n-1)*stride+j]-packed_values[(n-2)*stride+j])/h[n-2])/(h[0]+h[n-2]);
+        }
+        solve_batched_tridiagonal_systems(d, stride, num_columns);
+        if (periodic)
+            for (j = 0; j < num_columns; j ++)
+                d[j] = d[(n-1)*stride+j];
+
+        for (i = 0; i < dst_grid->get_grid_size(); i ++) {
+            left = src_cell_index_left[i];
+            right = src_cell_index_right[i];
+            if (left == -1 || right == -1)
+                continue;
+            if (left == right)
+                for (j = 0; j < num_columns; j ++)
+                    data_values_dst[(k+j)*dst_level_stride+i] = packed_values[left*stride+j];
+            else for (j = 0; j < num_columns; j ++) {
+                double value = d[left*stride+j]*factor1[i];
+                value += d[right*stride+j]*factor2[i];
+                value += (packed_values[left*stride+j]-d[left*stride+j]*factor3[i])*factor4[i];
+                value += (packed_values[right*stride+j]-d[right*stride+j]*factor3[i])*factor5[i];
+                data_values_dst[(k+j)*dst_level_stride+i] = value;
             }
         }
-    }
 
-    postprocess_field_value(data_values_dst);
+        if (keep_monotonicity)
+            for (j = 0; j < num_columns; j ++)
+                keep_monotonicity_of_column(packed_values+j, stride, data_values_dst+(k+j)*dst_level_stride);
+    }
 }
 
 
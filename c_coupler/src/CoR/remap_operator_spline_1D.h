@@ -12,6 +12,34 @@
 
 
 #include "remap_operator_1D_basis.h"
+#include <vector>
+
+
+#define SPLINE_1D_NUM_BATCHED_COLUMNS     16
+
+
+/* The remapping weights of a 1D spline operator do not change between columns that share the operator, 
+   so they are unpacked once into structure-of-arrays tables, together with the factorization of the 
+   tridiagonal system (whose matrix does not depend on the field values). The columns are then remapped 
+   in batches, with the loops over the columns of a batch innermost */
+struct Spline_1D_remap_tables
+{
+    bool is_built;
+    int array_size_src;
+    std::vector<int> useful_src_cells_global_index;
+    std::vector<double> coord_values_src;
+    std::vector<double> array_h;
+    std::vector<double> factor_multiplier;
+    std::vector<double> factor_row_multiplier;
+    std::vector<double> factor_diagonal;
+    std::vector<double> factor_upper;
+    std::vector<double> factor_column;
+    double factor_last_multiplier;
+    std::vector<double> coord_values_dst;
+    std::vector<int> src_cell_index_left;
+    std::vector<int> src_cell_index_right;
+    std::vector<double> final_factors[5];
+};
 
 
 class Remap_operator_spline_1D: public Remap_operator_1D_basis
@@ -33,20 +61,24 @@ class Remap_operator_spline_1D: public Remap_operator_1D_basis
         double *final_factor3;
         double *final_factor4;
         double *final_factor5;
+        Spline_1D_remap_tables remap_tables;
+        std::vector<double> batched_data_values;
 
-        void solve_aperiodic_tridiagonal_system(double*, double*, double*, double*, int);
-        void solve_periodic_tridiagonal_system(double*, double*, double*, double*, int);
         void compute_remap_weights_of_one_dst_cell(long);
         void allocate_local_arrays();
+        void build_remap_tables();
+        void solve_batched_tridiagonal_systems(double*, int, int);
+        void keep_monotonicity_of_column(const double*, int, double*);
 
     public:
-        Remap_operator_spline_1D() {}
+        Remap_operator_spline_1D() { remap_tables.is_built = false; }
         Remap_operator_spline_1D(const char*, int, Remap_grid_class **);
         ~Remap_operator_spline_1D();
         void set_parameter(const char *, const char *);
         int check_parameter(const char *, const char *, char *);
         void calculate_remap_weights();
         void do_remap_values_caculation(double*, double*, int);
+        void do_remap_values_caculation_of_levels(double*, double*, int, int, long, long);
         Remap_operator_basis *duplicate_remap_operator(bool);
 };
 
@@ -8,6 +8,7 @@
 
 
 #include "cor_global_data.h"
+#include "global_data.h"
 #include "remap_statement_operand.h"
 #include <string.h>
 #include <math.h>
@@ -62,6 +63,52 @@ long get_interchange_index(long index_iter_src,
 }
 
 
+/* When the interchange rotates the sized sub grids (the first num_rotated_sub_grids of src become the last ones, 
+    such as swapping the horizontal grid with the vertical grid), it is a transpose of a matrix whose rows are the 
+    higher sub grids of src. Returns num_rotated_sub_grids, or -1 for other interchanges */
+int get_num_rotated_sub_grids_of_interchange(int num_sized_sub_grids_src, int *index_interchange_table_src_to_dst)
+{
+    int num_rotated_sub_grids = num_sized_sub_grids_src - index_interchange_table_src_to_dst[0];
+
+
+    if (index_interchange_table_src_to_dst[0] == 0)
+        return -1;
+    for (int i = 0; i < num_sized_sub_grids_src; i ++)
+        if (index_interchange_table_src_to_dst[i] != (i+num_sized_sub_grids_src-num_rotated_sub_grids) % num_sized_sub_grids_src)
+            return -1;
+
+    return num_rotated_sub_grids;
+}
+
+
+/* Transposes data_src of num_rows_src rows of num_cols_src cells into data_interchange of num_cols_src rows of 
+    num_rows_src cells, tile by tile so that both the rows read and the rows written stay in cache */
+template <class T> void transpose_array_data_blocked(T *data_src, T *data_interchange, long num_rows_src, long num_cols_src, int num_point_per_cell)
+{
+    long i, j, row_tile_end, col_tile_end;
+    int k;
+
+
+    for (long row_tile_start = 0; row_tile_start < num_rows_src; row_tile_start += INTERCHANGE_TRANSPOSE_TILE_SIZE) {
+        row_tile_end = row_tile_start+INTERCHANGE_TRANSPOSE_TILE_SIZE < num_rows_src? row_tile_start+INTERCHANGE_TRANSPOSE_TILE_SIZE : num_rows_src;
+        for (long col_tile_start = 0; col_tile_start < num_cols_src; col_tile_start += INTERCHANGE_TRANSPOSE_TILE_SIZE) {
+            col_tile_end = col_tile_start+INTERCHANGE_TRANSPOSE_TILE_SIZE < num_cols_src? col_tile_start+INTERCHANGE_TRANSPOSE_TILE_SIZE : num_cols_src;
+            if (num_point_per_cell == 1) {
+                for (j = col_tile_start; j < col_tile_end; j ++)
+                    for (i = row_tile_start; i < row_tile_end; i ++)
+                        data_interchange[j*num_rows_src+i] = data_src[i*num_cols_src+j];
+            }
+            else {
+                for (j = col_tile_start; j < col_tile_end; j ++)
+                    for (i = row_tile_start; i < row_tile_end; i ++)
+                        for (k = 0; k < num_point_per_cell; k ++)
+                            data_interchange[(j*num_rows_src+i)*num_point_per_cell+k] = data_src[(i*num_cols_src+j)*num_point_per_cell+k];
+            }
+        }
+    }
+}
+
+
 template <class T> void interchange_array_data(int num_sized_sub_grids_src,
                                                     long *sub_grid_indexes_src,
                                                     long *sub_grid_indexes_interchange,
@@ -79,8 +126,17 @@ template <class T> void interchange_array_data(int num_sized_sub_grids_src,
     long *tmp_interchange_index_map = NULL;
     int sub_grid_tile_sizes_src[256], sub_grid_num_tiles_src[256], sub_grid_tile_iter_src[256], total_tile_size_iter, sub_grid_tile_current_start_index[256], sub_grid_tile_current_end_index[256], index_interchange_table_dst_to_src[256];
     int interchange_block_num_elements, total_tile_size_in_each_direction, num_total_tiles, total_tile_iter;
+    int num_rotated_sub_grids;
 
 
+    num_rotated_sub_grids = get_num_rotated_sub_grids_of_interchange(num_sized_sub_grids_src, index_interchange_table_src_to_dst);
+    if (num_rotated_sub_grids > 0) {
+        for (i = 0, iter = 1; i < num_rotated_sub_grids; i ++)
+            iter *= sub_grid_sizes_src[i];
+        transpose_array_data_blocked(data_src, data_interchange, array_size/iter, iter, num_point_per_cell);
+        return;
+    }
+
     for (i = 0; i < num_sized_sub_grids_src; i ++)
         index_interchange_table_dst_to_src[index_interchange_table_src_to_dst[i]] = i;
     interchange_block_num_elements = INTERCHANGE_BLOCK_SIZE / sizeof(T);
@@ -185,6 +241,7 @@ template <class T> void interchange_array_data(int num_sized_sub_grids_src,
 Remap_data_field::Remap_data_field()
 {
     data_buf = NULL;
+    buffer_pool_mark = 0;
     field_name_in_application[0] = '\0';
     field_name_in_IO_file[0] = '\0';
     data_type_in_application[0] = '\0';
@@ -196,7 +253,7 @@ Remap_data_field::Remap_data_field()
 }
 
 
-Remap_data_field *Remap_data_field::duplicate_remap_data_field(long data_size, bool copy_data)
+Remap_data_field *Remap_data_field::duplicate_remap_data_field(long data_size, bool copy_data, int buffer_pool_mark)
 {
     Remap_data_field *duplicated_data_field;
     
@@ -212,7 +269,11 @@ Remap_data_field *Remap_data_field::duplicate_remap_data_field(long data_size, b
         duplicated_data_field->read_data_size = data_size;
         duplicated_data_field->required_data_size = data_size;
     }
-	if (duplicated_data_field->required_data_size > 0)
+	if (duplicated_data_field->required_data_size > 0 && buffer_pool_mark != 0 && memory_manager != NULL) {
+		duplicated_data_field->data_buf = memory_manager->get_buffer_pool()->allocate_buf(duplicated_data_field->required_data_size*get_data_type_size(duplicated_data_field->data_type_in_application), buffer_pool_mark);
+		duplicated_data_field->buffer_pool_mark = buffer_pool_mark;
+	}
+	else if (duplicated_data_field->required_data_size > 0)
 	    duplicated_data_field->data_buf = new char [duplicated_data_field->required_data_size*get_data_type_size(duplicated_data_field->data_type_in_application)];
 	else duplicated_data_field->data_buf = NULL;
     if (copy_data) {
@@ -233,23 +294,33 @@ void Remap_data_field::interchange_remap_data_field(Remap_data_field *field_data
     Remap_grid_class *sized_sub_grids_src[256], *sized_sub_grids_interchange[256]; 
     long sub_grid_sizes_src[256], sub_grid_sizes_interchange[256];
     int index_interchange_table_src_to_dst[256];
-    long sub_grid_indexes_src[256], sub_grid_indexes_interchange[256];
-    int i, j;
-    int num_point_per_cell;
-
+    int i;
 
-    EXECUTION_REPORT(REPORT_ERROR, -1, this->required_data_size % grid_src->get_grid_size() == 0,
-                 "remap software error in interchange_remap_data_field\n");
 
     grid_src->get_sized_sub_grids(&num_sized_sub_grids_src, sized_sub_grids_src);
     grid_interchange->get_sized_sub_grids(&num_sized_sub_grids_interchange, sized_sub_grids_interchange);
     grid_src->get_grid_index_interchange_table(grid_interchange, index_interchange_table_src_to_dst);
-    num_point_per_cell = this->required_data_size / grid_src->get_grid_size();
     for (i = 0; i < num_sized_sub_grids_src; i ++)
         sub_grid_sizes_src[i] = sized_sub_grids_src[i]->get_grid_size();
     for (i = 0; i < num_sized_sub_grids_interchange; i ++)
         sub_grid_sizes_interchange[i] = sized_sub_grids_interchange[i]->get_grid_size();
 
+    interchange_data_buf(this->data_buf, field_data_interchanged->data_buf, num_sized_sub_grids_src, sub_grid_sizes_src, sub_grid_sizes_interchange, index_interchange_table_src_to_dst, grid_src->get_grid_size());
+}
+
+
+/* interchange_data_buf rearranges the data of this field (stored in data_buf_src) into data_buf_interchange
+    according to the sizes of the sized sub grids and the index interchange table from src to interchange */
+void Remap_data_field::interchange_data_buf(void *data_buf_src, void *data_buf_interchange, int num_sized_sub_grids_src, long *sub_grid_sizes_src, long *sub_grid_sizes_interchange, int *index_interchange_table_src_to_dst, long grid_size)
+{
+    long sub_grid_indexes_src[256], sub_grid_indexes_interchange[256];
+    int num_point_per_cell;
+
+
+    EXECUTION_REPORT(REPORT_ERROR, -1, this->required_data_size % grid_size == 0,
+                 "remap software error in interchange_remap_data_field\n");
+    num_point_per_cell = this->required_data_size / grid_size;
+
     if (words_are_the_same(this->data_type_in_application, DATA_TYPE_DOUBLE) ||
         words_are_the_same(this->data_type_in_application, DATA_TYPE_LONG))
         interchange_array_data(num_sized_sub_grids_src, 
@@ -258,9 +329,9 @@ void Remap_data_field::interchange_remap_data_field(Remap_data_field *field_data
                            sub_grid_sizes_src, 
                            sub_grid_sizes_interchange, 
                            index_interchange_table_src_to_dst,
-                           (double*) this->data_buf,
-                           (double*) field_data_interchanged->data_buf,
-                           grid_src->get_grid_size(),
+                           (double*) data_buf_src,
+                           (double*) data_buf_interchange,
+                           grid_size,
                            num_point_per_cell);
     else if (words_are_the_same(this->data_type_in_application, DATA_TYPE_FLOAT) ||
              words_are_the_same(this->data_type_in_application, DATA_TYPE_INT))
@@ -270,9 +341,9 @@ void Remap_data_field::interchange_remap_data_field(Remap_data_field *field_data
                            sub_grid_sizes_src, 
                            sub_grid_sizes_interchange, 
                            index_interchange_table_src_to_dst,
-                           (int*) this->data_buf,
-                           (int*) field_data_interchanged->data_buf,
-                           grid_src->get_grid_size(),
+                           (int*) data_buf_src,
+                           (int*) data_buf_interchange,
+                           grid_size,
                            num_point_per_cell);
     else if (words_are_the_same(this->data_type_in_application, DATA_TYPE_BOOL) ||
              words_are_the_same(this->data_type_in_application, DATA_TYPE_CHAR))
@@ -282,9 +353,9 @@ void Remap_data_field::interchange_remap_data_field(Remap_data_field *field_data
                            sub_grid_sizes_src, 
                            sub_grid_sizes_interchange, 
                            index_interchange_table_src_to_dst,
-                           (char*) this->data_buf,
-                           (char*) field_data_interchanged->data_buf,
-                           grid_src->get_grid_size(),
+                           (char*) data_buf_src,
+                           (char*) data_buf_interchange,
+                           grid_size,
                            num_point_per_cell);
     else if (words_are_the_same(this->data_type_in_application, DATA_TYPE_SHORT))
         interchange_array_data(num_sized_sub_grids_src, 
@@ -293,9 +364,9 @@ void Remap_data_field::interchange_remap_data_field(Remap_data_field *field_data
                            sub_grid_sizes_src, 
                            sub_grid_sizes_interchange, 
                            index_interchange_table_src_to_dst,
-                           (short*) this->data_buf,
-                           (short*) field_data_interchanged->data_buf,
-                           grid_src->get_grid_size(),
+                           (short*) data_buf_src,
+                           (short*) data_buf_interchange,
+                           grid_size,
                            num_point_per_cell);
     else EXECUTION_REPORT(REPORT_ERROR, -1, false, "remap software error in interchange_remap_data_field\n");
 }
@@ -303,8 +374,19 @@ void Remap_data_field::interchange_remap_data_field(Remap_data_field *field_data
 
 Remap_data_field::~Remap_data_field()
 {
-    if (data_buf != NULL)
-        delete [] data_buf;
+    release_data_buf();
+}
+
+
+void Remap_data_field::release_data_buf()
+{
+    if (data_buf != NULL) {
+        if (buffer_pool_mark != 0)
+            memory_manager->get_buffer_pool()->release_buf(data_buf);
+        else delete [] data_buf;
+    }
+    data_buf = NULL;
+    buffer_pool_mark = 0;
 }
 
 
@@ -15,6 +15,7 @@
 #include <vector>
   
 #define INTERCHANGE_BLOCK_SIZE ((int)64*1024)
+#define INTERCHANGE_TRANSPOSE_TILE_SIZE 32
 
 
 class Remap_grid_class;
@@ -49,6 +50,7 @@ class Remap_data_field
 {
     public:
         void *data_buf;
+        int buffer_pool_mark;    // the buffer mark when data_buf is from the memory buffer pool, otherwise 0
         char field_name_in_application[NAME_STR_SIZE];
         char field_name_in_IO_file[NAME_STR_SIZE];
         char data_type_in_application[NAME_STR_SIZE];
@@ -61,8 +63,10 @@ class Remap_data_field
 
         Remap_data_field();
         ~Remap_data_field();
-        Remap_data_field *duplicate_remap_data_field(long, bool);
+        Remap_data_field *duplicate_remap_data_field(long, bool, int buffer_pool_mark = 0);
+        void release_data_buf();
         void interchange_remap_data_field(Remap_data_field*, Remap_grid_class*, Remap_grid_class*);
+        void interchange_data_buf(void*, void*, int, long*, long*, int*, long);
         void push_back_attribute(Remap_field_attribute field_attribute) { field_attributes.push_back(field_attribute); }
         void read_fill_value();
         void set_fill_value(void*);
@@ -122,7 +122,7 @@ bool dynamic_search_nearest_points_var_distance(int dst_cell_index, int &num_fou
 	EXECUTION_REPORT_ERROR_OPTIONALLY(REPORT_ERROR, -1, current_runtime_remap_operator->get_src_grid()->get_is_H2D_grid(), "Software error in search_nearest_points_var_number");
 
 	if (current_distributed_H2D_weights_generator != NULL && num_required_points == -1)
-		current_distributed_H2D_weights_generator->confirm_or_enlarge_current_src_subdomain_grid_for_remapping(dst_cell_index, dist_threshold);
+		confirm_or_enlarge_src_subdomain_grid_for_remapping(dst_cell_index, dist_threshold);
 
 	while (true) {
 		get_cell_center_coord_values_of_dst_grid(dst_cell_index, dst_center_values);
@@ -133,11 +133,11 @@ bool dynamic_search_nearest_points_var_distance(int dst_cell_index, int &num_fou
 			break;
 		EXECUTION_REPORT_ERROR_OPTIONALLY(REPORT_ERROR, -1, num_required_points > 0);
 		if (num_found_points >= num_required_points) {
-			if (!current_distributed_H2D_weights_generator->confirm_or_enlarge_current_src_subdomain_grid_for_remapping(dst_cell_index, found_points_dist[num_required_points-1]))
+			if (!confirm_or_enlarge_src_subdomain_grid_for_remapping(dst_cell_index, found_points_dist[num_required_points-1]))
 				break;
 			else continue;
 		}
-		if (!current_distributed_H2D_weights_generator->confirm_or_enlarge_current_src_subdomain_grid_for_remapping(dst_cell_index, dist_threshold))
+		if (!confirm_or_enlarge_src_subdomain_grid_for_remapping(dst_cell_index, dist_threshold))
 			break;
 	}
 
@@ -0,0 +1,57 @@
+/***************************************************************
+  *  Copyright (c) 2017, Tsinghua University.
+  *  This is a source file of C-Coupler.
+  *  This file is initially finished by Dr. Li Liu.
+  *  If you have any problem,
+  *  please contact Dr. Li Liu via liuli-cess@tsinghua.edu.cn
+  ***************************************************************/
+
+
+/* Kernels of applying remapping weights (COO, or compressed by rows of dst cells as CSR) to the values of one level. The
+   kernels only depend on the arrays they are given, so that they can be benchmarked and tested without the other modules 
+   of C-Coupler. */
+
+
+#ifndef REMAP_WEIGHT_KERNELS_H
+#define REMAP_WEIGHT_KERNELS_H
+
+
+/* Applies the COO weights to the values of one level, accumulating them in the dst array */
+inline void remap_values_with_coo_weights(long num_remaped_dst_cells, const long *remaped_dst_cells_indexes, long num_weights, const long *cells_indexes_src, const long *cells_indexes_dst, const double *weight_values,
+                                          const double *data_values_src, double *data_values_dst)
+{
+    for (long i = 0; i < num_remaped_dst_cells; i ++)
+        data_values_dst[remaped_dst_cells_indexes[i]] = 0.0;
+    for (long i = 0; i < num_weights; i ++)
+        data_values_dst[cells_indexes_dst[i]] += data_values_src[cells_indexes_src[i]] * weight_values[i];
+}
+
+
+/* Applies the COO weights to the float values of one level, accumulating them in double in temp_values_dst (which has 
+   as many values as the dst array) before they are written back */
+inline void remap_values_with_coo_weights(long num_remaped_dst_cells, const long *remaped_dst_cells_indexes, long num_weights, const long *cells_indexes_src, const long *cells_indexes_dst, const double *weight_values,
+                                          const float *data_values_src, float *data_values_dst, double *temp_values_dst)
+{
+    for (long i = 0; i < num_remaped_dst_cells; i ++)
+        temp_values_dst[remaped_dst_cells_indexes[i]] = 0.0;
+    for (long i = 0; i < num_weights; i ++)
+        temp_values_dst[cells_indexes_dst[i]] += ((double) data_values_src[cells_indexes_src[i]]) * weight_values[i];
+    for (long i = 0; i < num_remaped_dst_cells; i ++)
+        data_values_dst[remaped_dst_cells_indexes[i]] = (float) temp_values_dst[remaped_dst_cells_indexes[i]];
+}
+
+
+/* Applies the CSR weights to the values of one level, with the value of each row accumulated in a register */
+template <typename T, typename W> void remap_values_with_csr_weights(int num_rows, const int *rows_dst_index, const int *rows_offset, const int *cells_indexes_src, const W *weight_values,
+                                                                      const T *data_values_src, T *data_values_dst)
+{
+    for (int i = 0; i < num_rows; i ++) {
+        double dst_value = 0.0;
+        for (int j = rows_offset[i]; j < rows_offset[i+1]; j ++)
+            dst_value += ((double) data_values_src[cells_indexes_src[j]]) * weight_values[j];
+        data_values_dst[rows_dst_index[i]] = (T) dst_value;
+    }
+}
+
+
+#endif
@@ -25,6 +25,7 @@ Remap_weight_of_operator_instance_class::Remap_weight_of_operator_instance_class
     this->remap_beg_iter = remap_beg_iter;
     this->remap_end_iter = remap_beg_iter + 1;
 	this->duplicated_remap_operator = NULL;
+    this->same_remap_weights_as_previous = false;
     if (remap_operator->get_src_grid()->get_is_H2D_grid()) {
 		this->duplicated_remap_operator = remap_operator->duplicate_remap_operator(true);
     }
@@ -38,6 +39,7 @@ Remap_weight_of_operator_instance_class::Remap_weight_of_operator_instance_class
     this->remap_beg_iter = remap_beg_iter;
     this->remap_end_iter = remap_beg_iter + 1;
     this->duplicated_remap_operator = duplicated_remap_operator;
+    this->same_remap_weights_as_previous = false;
 }
 
 
@@ -223,6 +225,8 @@ Remap_weight_of_operator_class::~Remap_weight_of_operator_class()
 {
     for (int i = 0; i < remap_weights_of_operator_instances.size(); i ++)
         delete remap_weights_of_operator_instances[i];
+    for (std::map<std::vector<long>, Grid_data_interchange_plan*>::iterator iter = interchange_plans.begin(); iter != interchange_plans.end(); iter ++)
+        delete iter->second;
 }
 
 
@@ -230,6 +234,7 @@ void Remap_weight_of_operator_class::do_remap(int comp_id, Remap_grid_data_class
 {
 
     double *data_value_src, *data_value_dst;
+    float *float_data_value_src, *float_data_value_dst;
     int i, j, k;
     long remap_beg_iter, remap_end_iter;
     long field_array_offset;
@@ -241,8 +246,8 @@ void Remap_weight_of_operator_class::do_remap(int comp_id, Remap_grid_data_class
 
     if (comp_id != -1)          
         comp_comm_group_mgt_mgr->get_global_node_of_local_comp(comp_id,false,"")->get_performance_timing_mgr()->performance_timing_start(TIMING_TYPE_COMPUTATION, -1, -1, "interchange data");
-    field_data_src->interchange_grid_data(field_data_grid_src);
-    field_data_dst->interchange_grid_data(field_data_grid_dst);
+    field_data_src->interchange_grid_data(field_data_grid_src, interchange_plans);
+    field_data_dst->interchange_grid_data(field_data_grid_dst, interchange_plans);
     if (comp_id != -1)          
         comp_comm_group_mgt_mgr->get_global_node_of_local_comp(comp_id,false,"")->get_performance_timing_mgr()->performance_timing_stop(TIMING_TYPE_COMPUTATION, -1, -1, "interchange data");
 
@@ -251,32 +256,52 @@ void Remap_weight_of_operator_class::do_remap(int comp_id, Remap_grid_data_class
 
     EXECUTION_REPORT_ERROR_OPTIONALLY(REPORT_ERROR, -1, !is_remap_weight_empty(), "Software error in Remap_weight_of_operator_class::do_remap: empty remap weights");
     
-    for (i = 0; i < remap_weights_of_operator_instances.size(); i ++) {
+    for (i = 0; i < remap_weights_of_operator_instances.size(); i = j + 1) {
+        j = i;
         remap_beg_iter = remap_weights_of_operator_instances[i]->remap_beg_iter;
 		if (remap_beg_iter == -1)
 			continue;
-        if (remap_weights_of_operator_instances[i]->remap_end_iter != -1)
-            remap_end_iter = remap_weights_of_operator_instances[i]->remap_end_iter;
-        else if (i+1 < remap_weights_of_operator_instances.size())
-                remap_end_iter = remap_weights_of_operator_instances[i+1]->remap_beg_iter;
-        else remap_end_iter = field_data_grid_src->get_grid_size()/operator_grid_src->get_grid_size();
-        for (j = remap_beg_iter; j < remap_end_iter; j ++) {
-            field_array_offset = j;
-            if (report_error_enabled) {
-                EXECUTION_REPORT_ERROR_OPTIONALLY(REPORT_ERROR, -1, field_array_offset >= 0 && (field_array_offset+1)*remap_weights_of_operator_instances[i]->get_operator_grid_src()->get_grid_size() <= field_data_size_src,
-                                 "remap software error4 in do_remap of Remap_weight_of_strategy_class");
-                EXECUTION_REPORT_ERROR_OPTIONALLY(REPORT_ERROR, -1, field_array_offset >= 0 && (field_array_offset+1)*remap_weights_of_operator_instances[i]->get_operator_grid_dst()->get_grid_size() <= field_data_size_dst,
-                                  "remap software error5 in do_remap of Remap_weight_of_strategy_class");
-            }    
-            data_value_src = ((double*) field_data_src->get_grid_data_field()->data_buf) + field_array_offset*remap_weights_of_operator_instances[i]->get_operator_grid_src()->get_grid_size();
-            data_value_dst = ((double*) field_data_dst->get_grid_data_field()->data_buf) + field_array_offset*remap_weights_of_operator_instances[i]->get_operator_grid_dst()->get_grid_size();
-            EXECUTION_REPORT_ERROR_OPTIONALLY(REPORT_ERROR, -1, remap_weights_of_operator_instances[i]->duplicated_remap_operator != NULL, "C-Coupler error3 in do_remap of Remap_weight_of_operator_class %s", remap_weights_of_operator_instances[i]->get_operator_grid_src()->get_grid_name());
-            remap_weights_of_operator_instances[i]->duplicated_remap_operator->do_remap_values_caculation(data_value_src, data_value_dst, remap_weights_of_operator_instances[i]->get_operator_grid_dst()->get_grid_size());
+        remap_end_iter = get_remap_end_iter_of_instance(i);
+        if (remap_end_iter <= remap_beg_iter)
+            continue;
+        // the following instances that share the remapping weights of instance i are remapped in the same call
+        while (j+1 < remap_weights_of_operator_instances.size() && remap_weights_of_operator_instances[j+1]->same_remap_weights_as_previous && 
+               remap_weights_of_operator_instances[j+1]->remap_beg_iter == remap_end_iter && get_remap_end_iter_of_instance(j+1) > remap_end_iter)
+            remap_end_iter = get_remap_end_iter_of_instance(++j);
+        field_array_offset = remap_beg_iter;
+        if (report_error_enabled) {
+            EXECUTION_REPORT_ERROR_OPTIONALLY(REPORT_ERROR, -1, field_array_offset >= 0 && remap_end_iter*remap_weights_of_operator_instances[i]->get_operator_grid_src()->get_grid_size() <= field_data_size_src,
+                             "remap software error4 in do_remap of Remap_weight_of_strategy_class");
+            EXECUTION_REPORT_ERROR_OPTIONALLY(REPORT_ERROR, -1, field_array_offset >= 0 && remap_end_iter*remap_weights_of_operator_instances[i]->get_operator_grid_dst()->get_grid_size() <= field_data_size_dst,
+                              "remap software error5 in do_remap of Remap_weight_of_strategy_class");
+        }    
+        EXECUTION_REPORT_ERROR_OPTIONALLY(REPORT_ERROR, -1, remap_weights_of_operator_instances[i]->duplicated_remap_operator != NULL, "C-Coupler error3 in do_remap of Remap_weight_of_operator_class %s", remap_weights_of_operator_instances[i]->get_operator_grid_src()->get_grid_name());
+        if (words_are_the_same(field_data_src->get_grid_data_field()->data_type_in_application, DATA_TYPE_FLOAT)) {
+            EXECUTION_REPORT_ERROR_OPTIONALLY(REPORT_ERROR, -1, words_are_the_same(field_data_dst->get_grid_data_field()->data_type_in_application, DATA_TYPE_FLOAT), "Software error in Remap_weight_of_operator_class::do_remap: different data types of src and dst fields");
+            float_data_value_src = ((float*) field_data_src->get_grid_data_field()->data_buf) + field_array_offset*remap_weights_of_operator_instances[i]->get_operator_grid_src()->get_grid_size();
+            float_data_value_dst = ((float*) field_data_dst->get_grid_data_field()->data_buf) + field_array_offset*remap_weights_of_operator_instances[i]->get_operator_grid_dst()->get_grid_size();
+            remap_weights_of_operator_instances[i]->duplicated_remap_operator->do_remap_float_values_caculation_of_levels(float_data_value_src, float_data_value_dst, remap_weights_of_operator_instances[i]->get_operator_grid_dst()->get_grid_size(), remap_end_iter-remap_beg_iter,
+                                                                                                                      remap_weights_of_operator_instances[i]->get_operator_grid_src()->get_grid_size(), remap_weights_of_operator_instances[i]->get_operator_grid_dst()->get_grid_size());
+            continue;
         }
+        data_value_src = ((double*) field_data_src->get_grid_data_field()->data_buf) + field_array_offset*remap_weights_of_operator_instances[i]->get_operator_grid_src()->get_grid_size();
+        data_value_dst = ((double*) field_data_dst->get_grid_data_field()->data_buf) + field_array_offset*remap_weights_of_operator_instances[i]->get_operator_grid_dst()->get_grid_size();
+        remap_weights_of_operator_instances[i]->duplicated_remap_operator->do_remap_values_caculation_of_levels(data_value_src, data_value_dst, remap_weights_of_operator_instances[i]->get_operator_grid_dst()->get_grid_size(), remap_end_iter-remap_beg_iter,
+                                                                                                                remap_weights_of_operator_instances[i]->get_operator_grid_src()->get_grid_size(), remap_weights_of_operator_instances[i]->get_operator_grid_dst()->get_grid_size());
     }
 }
 
 
+long Remap_weight_of_operator_class::get_remap_end_iter_of_instance(int i)
+{
+    if (remap_weights_of_operator_instances[i]->remap_end_iter != -1)
+        return remap_weights_of_operator_instances[i]->remap_end_iter;
+    if (i+1 < remap_weights_of_operator_instances.size())
+        return remap_weights_of_operator_instances[i+1]->remap_beg_iter;
+    return field_data_grid_src->get_grid_size()/operator_grid_src->get_grid_size();
+}
+
+
 void Remap_weight_of_operator_class::add_remap_weight_of_operator_instance(Remap_weight_of_operator_instance_class *operator_instance)
 {
     remap_weights_of_operator_instances.push_back(operator_instance);
@@ -289,9 +314,9 @@ void Remap_weight_of_operator_class::renew_vertical_remap_weights(Remap_grid_cla
     long i;
     Remap_grid_data_class *lev_center_field_in_3D_src_grid = NULL, *lev_center_field_in_3D_dst_grid = NULL;
     Remap_operator_grid *runtime_remap_operator_grid_src = NULL, *runtime_remap_operator_grid_dst = NULL;
-    Remap_operator_basis *new_remap_operator;
+    Remap_operator_basis *new_remap_operator, *previous_remap_operator = NULL;
     double *lev_center_values_in_3D_src_grid = NULL, *lev_center_values_in_3D_dst_grid = NULL;
-    long lev_grid_size_src, lev_grid_size_dst, offset;
+    long lev_grid_size_src, lev_grid_size_dst, offset, previous_offset;
 
     
     EXECUTION_REPORT_ERROR_OPTIONALLY(REPORT_ERROR, -1, runtime_remap_grid_src->get_num_dimensions() == 1 && runtime_remap_grid_src->has_grid_coord_label(COORD_LABEL_LEV) && runtime_remap_grid_dst->get_num_dimensions() == 1 && runtime_remap_grid_dst->has_grid_coord_label(COORD_LABEL_LEV),
@@ -327,6 +352,18 @@ void Remap_weight_of_operator_class::renew_vertical_remap_weights(Remap_grid_cla
         offset = remap_weights_of_operator_instances[i]->remap_beg_iter;
 		if (offset == -1)
 			continue;
+        remap_weights_of_operator_instances[i]->same_remap_weights_as_previous = previous_remap_operator != NULL &&
+            (lev_center_values_in_3D_src_grid == NULL || memcmp(lev_center_values_in_3D_src_grid+offset*lev_grid_size_src, lev_center_values_in_3D_src_grid+previous_offset*lev_grid_size_src, lev_grid_size_src*sizeof(double)) == 0) &&
+            (lev_center_values_in_3D_dst_grid == NULL || memcmp(lev_center_values_in_3D_dst_grid+offset*lev_grid_size_dst, lev_center_values_in_3D_dst_grid+previous_offset*lev_grid_size_dst, lev_grid_size_dst*sizeof(double)) == 0);
+        previous_offset = offset;
+        if (remap_weights_of_operator_instances[i]->same_remap_weights_as_previous) {
+            // the column has the same vertical coordinate values as the previous one, so that its remapping weights are copied instead of recalculated
+            delete new_remap_operator;
+            new_remap_operator = previous_remap_operator->duplicate_remap_operator(true);
+            delete remap_weights_of_operator_instances[i]->duplicated_remap_operator;
+            remap_weights_of_operator_instances[i]->duplicated_remap_operator = new_remap_operator;
+            continue;
+        }
         if (lev_center_field_in_3D_src_grid != NULL) {
             EXECUTION_REPORT_ERROR_OPTIONALLY(REPORT_ERROR, -1, offset >= 0 && offset*lev_grid_size_src+lev_grid_size_src<= lev_center_field_in_3D_src_grid->get_grid_data_field()->required_data_size, "C-Coupler error7 in renew_vertical_remap_weights of Remap_weight_of_operator_class"); 
         }    
@@ -354,6 +391,7 @@ void Remap_weight_of_operator_class::renew_vertical_remap_weights(Remap_grid_cla
 		if (remap_weights_of_operator_instances[i]->duplicated_remap_operator != NULL)
 	        delete remap_weights_of_operator_instances[i]->duplicated_remap_operator;
         remap_weights_of_operator_instances[i]->duplicated_remap_operator = new_remap_operator;
+        previous_remap_operator = new_remap_operator;
     }
 
     if (runtime_remap_operator_grid_src != NULL) {
@@ -520,6 +558,9 @@ Remap_weight_of_strategy_class::~Remap_weight_of_strategy_class()
 		if (remap_grid_manager->search_exact_grid(field_data_grids_in_remapping_process[i]) == NULL)
 			delete field_data_grids_in_remapping_process[i];
 	}
+
+    for (std::map<std::vector<long>, Grid_data_interchange_plan*>::iterator iter = interchange_plans.begin(); iter != interchange_plans.end(); iter ++)
+        delete iter->second;
 }
 
 
@@ -587,7 +628,7 @@ void Remap_weight_of_strategy_class::do_remap(int comp_id, Remap_grid_data_class
 			if (i != remap_weights_of_operators.size()-1 && remap_weights_of_operators[i]->field_data_grid_dst->is_similar_grid_with(field_data_dst->get_coord_value_grid()))
 				EXECUTION_REPORT_ERROR_OPTIONALLY(REPORT_ERROR, -1, words_are_the_same(field_data_dst->get_grid_data_field()->field_name_in_application, V3D_GRID_3D_LEVEL_FIELD_NAME), "Software error in Remap_weight_of_strategy_class::do_remap");
         }    
-        else tmp_field_data_dst = field_data_src->duplicate_grid_data_field(remap_weights_of_operators[i]->field_data_grid_dst, 1, false, false);
+        else tmp_field_data_dst = field_data_src->duplicate_grid_data_field(remap_weights_of_operators[i]->field_data_grid_dst, 1, false, false, BUF_MARK_REMAP_INTERMEDIATE);
         remap_weights_of_operators[i]->do_remap(comp_id, tmp_field_data_src, tmp_field_data_dst);
         if (comp_id != -1)        
             comp_comm_group_mgt_mgr->get_global_node_of_local_comp(comp_id,false,"")->get_performance_timing_mgr()->performance_timing_stop(TIMING_TYPE_COMPUTATION, -1, -1, remap_weights_of_operators[i]->get_original_remap_operator()->get_operator_name());
@@ -601,14 +642,22 @@ void Remap_weight_of_strategy_class::do_remap(int comp_id, Remap_grid_data_class
         delete tmp_field_data_src;
     if (comp_id != -1)          
         comp_comm_group_mgt_mgr->get_global_node_of_local_comp(comp_id,false,"")->get_performance_timing_mgr()->performance_timing_start(TIMING_TYPE_COMPUTATION, -1, -1, "interchange data");
-    field_data_src->interchange_grid_data(field_data_src->get_coord_value_grid());
-    field_data_dst->interchange_grid_data(field_data_dst->get_coord_value_grid());
+    field_data_src->interchange_grid_data(field_data_src->get_coord_value_grid(), interchange_plans);
+    field_data_dst->interchange_grid_data(field_data_dst->get_coord_value_grid(), interchange_plans);
     field_data_dst->get_grid_data_field()->read_data_size = field_data_dst->get_grid_data_field()->required_data_size;
     if (comp_id != -1)          
         comp_comm_group_mgt_mgr->get_global_node_of_local_comp(comp_id,false,"")->get_performance_timing_mgr()->performance_timing_stop(TIMING_TYPE_COMPUTATION, -1, -1, "interchange data");
 }
 
 
+/* Float field data can be remapped without being transformed into double only when a single remap operator, whose weights
+   are applied directly, is involved. Otherwise the intermediate field data between operators would lose precision */
+bool Remap_weight_of_strategy_class::is_float_remap_supported()
+{
+    return remap_weights_of_operators.size() == 1 && remap_weights_of_operators[0]->get_original_remap_operator()->is_float_remap_values_supported();
+}
+
+
 void Remap_weight_of_strategy_class::add_remap_related_grid(std::vector<std::pair<Remap_grid_class *, bool> > &all_remap_related_grids_info, Remap_grid_class *remap_grid, bool on_dst_decomp)
 {
 	std::pair<Remap_grid_class *, bool> remap_related_grid_info;
@@ -15,6 +15,7 @@
 #include "remap_grid_data_class.h"
 #include "remap_operator_basis.h"
 #include <vector>
+#include <map>
 
 
 class Remap_operator_basis;
@@ -36,9 +37,10 @@ class Remap_weight_of_operator_instance_class
         Remap_operator_basis *duplicated_remap_operator;
         int remap_beg_iter;
         int remap_end_iter;
+        bool same_remap_weights_as_previous;
         
     public: 
-        Remap_weight_of_operator_instance_class() { duplicated_remap_operator = NULL; }
+        Remap_weight_of_operator_instance_class() { duplicated_remap_operator = NULL; same_remap_weights_as_previous = false; }
         Remap_weight_of_operator_instance_class(Remap_grid_class*, Remap_grid_class*, long, Remap_operator_basis*);
         Remap_weight_of_operator_instance_class(Remap_grid_class*, Remap_grid_class*, long, Remap_operator_basis*, Remap_operator_basis*);
         ~Remap_weight_of_operator_instance_class();
@@ -66,7 +68,10 @@ class Remap_weight_of_operator_class
         Remap_grid_class *operator_grid_dst;
         Remap_operator_basis *original_remap_operator;
         std::vector<Remap_weight_of_operator_instance_class*> remap_weights_of_operator_instances;
+        std::map<std::vector<long>, Grid_data_interchange_plan*> interchange_plans;
         bool empty_remap_weight;
+
+        long get_remap_end_iter_of_instance(int);
         
     public: 
         Remap_weight_of_operator_class(Remap_grid_class*, Remap_grid_class*, Remap_operator_basis*, Remap_grid_class*, Remap_grid_class*);
@@ -99,6 +104,7 @@ class Remap_weight_of_strategy_class
         int num_field_data_grids_in_remapping_process;
         Remap_grid_class *field_data_grids_in_remapping_process[512];
         Remap_grid_data_class *runtime_mask_fields_in_remapping_process[512];
+        std::map<std::vector<long>, Grid_data_interchange_plan*> interchange_plans;
 
         void read_grid_info_from_array(Remap_grid_class*, bool, const char *, FILE*, long&, long);
         void read_data_from_array(void*, int, const char*, FILE*, long&, long, bool);
@@ -139,6 +145,7 @@ class Remap_weight_of_strategy_class
         Remap_grid_class *get_field_data_grid_in_remapping_process(int);
         Remap_grid_data_class *get_runtime_mask_field_in_remapping_process(int);
         Remap_weight_of_operator_class *get_dynamic_V1D_remap_weight_of_operator();
+        bool is_float_remap_supported();
         void mark_empty_remap_weight() { remap_weights_of_operators[remap_weights_of_operators.size()-1]->mark_empty_remap_weight(); }
 };
 
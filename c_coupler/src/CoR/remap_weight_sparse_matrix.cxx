@@ -14,6 +14,7 @@
 #include <stdio.h>
 #include <string.h>
 #include <math.h>
+#include <limits.h>
 
 
 Remap_weight_sparse_matrix::Remap_weight_sparse_matrix(Remap_operator_basis *remap_operator, 
@@ -48,6 +49,9 @@ Remap_weight_sparse_matrix::Remap_weight_sparse_matrix(Remap_operator_basis *rem
     }
 
     this->remaped_dst_cells_indexes_array_size = this->num_remaped_dst_cells_indexes;
+    compressed_weights_status = COMPRESSED_WEIGHTS_NOT_BUILT;
+    temp_values_dst = NULL;
+    temp_values_dst_size = 0;
 }
 
 
@@ -62,18 +66,32 @@ Remap_weight_sparse_matrix::Remap_weight_sparse_matrix(Remap_operator_basis *rem
     cells_indexes_dst = new long [weight_arrays_size];
     weight_values = new double [weight_arrays_size];
     remaped_dst_cells_indexes = new long [remaped_dst_cells_indexes_array_size];
+    compressed_weights_status = COMPRESSED_WEIGHTS_NOT_BUILT;
+    temp_values_dst = NULL;
+    temp_values_dst_size = 0;
 }
 
 
 Remap_weight_sparse_matrix::~Remap_weight_sparse_matrix()
 {
-	EXECUTION_REPORT_ERROR_OPTIONALLY(REPORT_ERROR, -1, cells_indexes_src != NULL && cells_indexes_dst != NULL && weight_values != NULL, "Software error in ~Remap_weight_sparse_matrix");
+	EXECUTION_REPORT_ERROR_OPTIONALLY(REPORT_ERROR, -1, compressed_weights_status == COMPRESSED_WEIGHTS_BUILT || (cells_indexes_src != NULL && cells_indexes_dst != NULL && weight_values != NULL), "Software error in ~Remap_weight_sparse_matrix");
 
-    delete [] cells_indexes_src;
-    delete [] cells_indexes_dst;
+    if (cells_indexes_src != NULL)
+        delete [] cells_indexes_src;
+    if (cells_indexes_dst != NULL)
+        delete [] cells_indexes_dst;
     if (remaped_dst_cells_indexes != NULL)
         delete [] remaped_dst_cells_indexes;
-    delete [] weight_values;
+    if (weight_values != NULL)
+        delete [] weight_values;
+    if (compressed_weights_status == COMPRESSED_WEIGHTS_BUILT) {
+        delete [] compressed_rows_dst_index;
+        delete [] compressed_rows_offset;
+        delete [] compressed_cells_indexes_src;
+        delete [] compressed_weight_values;
+    }
+    if (temp_values_dst != NULL)
+        delete [] temp_values_dst;
 }
 
 
@@ -81,6 +99,141 @@ void Remap_weight_sparse_matrix::clear_weights_info()
 {
     num_weights = 0; 
     num_remaped_dst_cells_indexes = 0;
+    release_compressed_weights();
+}
+
+
+/* Rebuilds the COO arrays released by build_compressed_weights from the compressed weights, with the capacity they had before */
+void Remap_weight_sparse_matrix::rebuild_uncompressed_weights()
+{
+    if (compressed_weights_status != COMPRESSED_WEIGHTS_BUILT)
+        return;
+
+    if (cells_indexes_src == NULL) {
+        cells_indexes_src = new long [weight_arrays_size];
+        cells_indexes_dst = new long [weight_arrays_size];
+        for (int i = 0; i < num_compressed_rows; i ++)
+            for (int j = compressed_rows_offset[i]; j < compressed_rows_offset[i+1]; j ++) {
+                cells_indexes_src[j] = compressed_cells_indexes_src[j];
+                cells_indexes_dst[j] = compressed_rows_dst_index[i];
+            }
+    }
+    if (weight_values == NULL) {
+        weight_values = new double [weight_arrays_size];
+        for (long i = 0; i < num_weights; i ++)
+            weight_values[i] = compressed_weight_values[i];
+    }
+}
+
+
+/* The COO arrays are rebuilt before the compressed weights are released, because the callers that get the COO arrays may change them */
+void Remap_weight_sparse_matrix::release_compressed_weights()
+{
+    if (compressed_weights_status == COMPRESSED_WEIGHTS_BUILT) {
+        rebuild_uncompressed_weights();
+        delete [] compressed_rows_dst_index;
+        delete [] compressed_rows_offset;
+        delete [] compressed_cells_indexes_src;
+        delete [] compressed_weight_values;
+    }
+    compressed_weights_status = COMPRESSED_WEIGHTS_NOT_BUILT;
+}
+
+
+/* Builds a read-only copy of the weights compressed by rows of dst cells (CSR) with 32-bit indexes, which is used by the
+   remapping kernels instead of the COO arrays. The weights of each row keep their original order, so that the remapping
+   results are the same as those with the COO arrays (unless the weights are stored in single precision). When the COO
+   weights are already sorted by dst cells, the COO index arrays (and the weight values, if the compressed copy keeps them
+   in double) are released and are rebuilt by rebuild_uncompressed_weights only when they are accessed again. The copy is 
+   rebuilt after the weights are changed */
+void Remap_weight_sparse_matrix::build_compressed_weights()
+{
+    long max_index_src = -1, max_index_dst = -1, i, memory_size_before, memory_size_after;
+    int *rows_index, *rows_fill;
+    bool sorted_by_dst = true;
+
+
+    if (compressed_weights_status != COMPRESSED_WEIGHTS_NOT_BUILT)
+        return;
+
+    compressed_weights_status = COMPRESSED_WEIGHTS_UNAVAILABLE;
+    for (i = 0; i < num_weights; i ++) {
+        if (cells_indexes_src[i] < 0 || cells_indexes_dst[i] < 0)
+            return;
+        if (cells_indexes_src[i] > max_index_src)
+            max_index_src = cells_indexes_src[i];
+        if (cells_indexes_dst[i] > max_index_dst)
+            max_index_dst = cells_indexes_dst[i];
+        if (i > 0 && cells_indexes_dst[i] < cells_indexes_dst[i-1])
+            sorted_by_dst = false;
+    }
+    for (i = 0; i < num_remaped_dst_cells_indexes; i ++) {
+        if (remaped_dst_cells_indexes[i] < 0)
+            return;
+        if (remaped_dst_cells_indexes[i] > max_index_dst)
+            max_index_dst = remaped_dst_cells_indexes[i];
+    }
+    if (num_weights >= INT_MAX || max_index_src >= INT_MAX || max_index_dst >= INT_MAX)
+        return;
+
+    rows_index = new int [max_index_dst+1];
+    for (i = 0; i <= max_index_dst; i ++)
+        rows_index[i] = 0;
+    for (i = 0; i < num_remaped_dst_cells_indexes; i ++)
+        rows_index[remaped_dst_cells_indexes[i]] = 1;
+    for (i = 0; i < num_weights; i ++)
+        rows_index[cells_indexes_dst[i]] = 1;
+    num_compressed_rows = 0;
+    for (i = 0; i <= max_index_dst; i ++)
+        if (rows_index[i] == 1)
+            rows_index[i] = num_compressed_rows ++;
+        else rows_index[i] = -1;
+
+    compressed_rows_dst_index = new int [num_compressed_rows];
+    compressed_rows_offset = new int [num_compressed_rows+1];
+    compressed_cells_indexes_src = new int [num_weights];
+    compressed_weight_values = new compressed_remap_weight_type [num_weights];
+    rows_fill = new int [num_compressed_rows];
+    for (i = 0; i <= max_index_dst; i ++)
+        if (rows_index[i] != -1)
+            compressed_rows_dst_index[rows_index[i]] = i;
+    for (i = 0; i <= num_compressed_rows; i ++)
+        compressed_rows_offset[i] = 0;
+    for (i = 0; i < num_weights; i ++)
+        compressed_rows_offset[rows_index[cells_indexes_dst[i]]+1] ++;
+    for (i = 0; i < num_compressed_rows; i ++) {
+        compressed_rows_offset[i+1] += compressed_rows_offset[i];
+        rows_fill[i] = compressed_rows_offset[i];
+    }
+    for (i = 0; i < num_weights; i ++) {
+        int position = rows_fill[rows_index[cells_indexes_dst[i]]] ++;
+        compressed_cells_indexes_src[position] = cells_indexes_src[i];
+        compressed_weight_values[position] = weight_values[i];
+    }
+    delete [] rows_index;
+    delete [] rows_fill;
+    compressed_weights_status = COMPRESSED_WEIGHTS_BUILT;
+
+    memory_size_before = weight_arrays_size*(2*sizeof(long)+sizeof(double));
+    if (sorted_by_dst) {
+        delete [] cells_indexes_src;
+        delete [] cells_indexes_dst;
+        cells_indexes_src = NULL;
+        cells_indexes_dst = NULL;
+        if (sizeof(compressed_remap_weight_type) == sizeof(double)) {
+            delete [] weight_values;
+            weight_values = NULL;
+        }
+    }
+    memory_size_after = num_weights*(sizeof(int)+sizeof(compressed_remap_weight_type)) + (2*num_compressed_rows+1)*sizeof(int);
+    if (cells_indexes_src != NULL)
+        memory_size_after += weight_arrays_size*2*sizeof(long);
+    if (weight_values != NULL)
+        memory_size_after += weight_arrays_size*sizeof(double);
+
+    EXECUTION_REPORT_LOG(REPORT_LOG, -1, true, "The remapping sparse matrix with %ld weights is compressed into %d rows: %ld bytes instead of %ld bytes are read by each remapping; the weights occupy %ld bytes instead of %ld bytes%s", num_weights, num_compressed_rows, 
+                         num_weights*(sizeof(int)+sizeof(compressed_remap_weight_type)) + num_compressed_rows*2*sizeof(int), num_weights*(2*sizeof(long)+sizeof(double)) + num_remaped_dst_cells_indexes*sizeof(long),
+                         memory_size_after, memory_size_before, sorted_by_dst? "" : " (the COO arrays are kept because they are not sorted by dst cells)");
 }
 
 
@@ -92,6 +245,7 @@ void Remap_weight_sparse_matrix::add_weights(long *indexes_src, long index_dst,
 	const int *local_cells_global_indexes_src, *local_cells_global_indexes_dst;
 
 
+    release_compressed_weights();
     if (is_real_weight) {
         for (i = 0; i < num_added_weights; i ++)
             EXECUTION_REPORT(REPORT_ERROR, -1, indexes_src[i] >= 0 && indexes_src[i] < remap_operator->get_src_grid()->get_grid_size(), "C-Coupler error1 in add_weights of Remap_weight_sparse_matrix");
@@ -150,6 +304,7 @@ void Remap_weight_sparse_matrix::add_weights(long *indexes_src, long index_dst,
 
 void Remap_weight_sparse_matrix::get_weight(long *index_src, long *index_dst, double *weight_value, int index_weight)
 {
+    rebuild_uncompressed_weights();
     EXECUTION_REPORT_ERROR_OPTIONALLY(REPORT_ERROR, -1, index_weight >= 0 && index_weight < num_weights, "software error when get remapping weight of sparse matrix\n");
     *index_src = cells_indexes_src[index_weight];
     *index_dst = cells_indexes_dst[index_weight];
@@ -157,18 +312,82 @@ void Remap_weight_sparse_matrix::get_weight(long *index_src, long *index_dst, do
 }
 
 
+/* Applies the compressed weights to the levels (or ensemble slices) one by one. Blocking the levels, so that each weight is 
+   loaded once per block of levels, was measured to be slower than this (see tests/bench_remap_weight_sparse_matrix.cxx): 
+   the strided loads of a block in the layout of the fields and the transposes into a level-contiguous layout cost more than 
+   streaming the weights once per level. The values of each level are accumulated in double in the order of the weights, 
+   whatever the data type of the arrays is */
+template <typename T> void Remap_weight_sparse_matrix::remap_values_of_levels_with_compressed_weights(T *data_values_src, T *data_values_dst, int num_levels, long src_level_stride, long dst_level_stride)
+{
+    for (int k = 0; k < num_levels; k ++)
+        remap_values_with_csr_weights(num_compressed_rows, compressed_rows_dst_index, compressed_rows_offset, compressed_cells_indexes_src, compressed_weight_values, 
+                                      data_values_src + k*src_level_stride, data_values_dst + k*dst_level_stride);
+}
+
+
 void Remap_weight_sparse_matrix::remap_values(double *data_values_src, double *data_values_dst, int dst_array_size)
 {
-    for (long i = 0; i < num_remaped_dst_cells_indexes; i ++)
-        data_values_dst[remaped_dst_cells_indexes[i]] = 0.0;
+    build_compressed_weights();
+    if (compressed_weights_status == COMPRESSED_WEIGHTS_BUILT) {
+        remap_values_of_levels_with_compressed_weights(data_values_src, data_values_dst, 1, 0, 0);
+        return;
+    }
 
-    for (long i = 0; i < num_weights; i ++)
-        data_values_dst[cells_indexes_dst[i]] += data_values_src[cells_indexes_src[i]] * weight_values[i];
+    remap_values_with_coo_weights(num_remaped_dst_cells_indexes, remaped_dst_cells_indexes, num_weights, cells_indexes_src, cells_indexes_dst, weight_values, data_values_src, data_values_dst);
+}
+
+
+void Remap_weight_sparse_matrix::remap_values_of_levels(double *data_values_src, double *data_values_dst, int dst_array_size, int num_levels, long src_level_stride, long dst_level_stride)
+{
+    if (num_levels == 1) {
+        remap_values(data_values_src, data_values_dst, dst_array_size);
+        return;
+    }
+
+    build_compressed_weights();
+    if (compressed_weights_status == COMPRESSED_WEIGHTS_BUILT) {
+        remap_values_of_levels_with_compressed_weights(data_values_src, data_values_dst, num_levels, src_level_stride, dst_level_stride);
+        return;
+    }
+
+    for (int k = 0; k < num_levels; k ++)
+        remap_values_with_coo_weights(num_remaped_dst_cells_indexes, remaped_dst_cells_indexes, num_weights, cells_indexes_src, cells_indexes_dst, weight_values, 
+                                      data_values_src + k*src_level_stride, data_values_dst + k*dst_level_stride);
+}
+
+
+/* Float arrays are read and written directly, while the values are accumulated in double. Without compressed weights, the
+   values of each level are accumulated in a temporary double array before being written back. The temporary array is kept 
+   by the sparse matrix and is only reallocated when a larger one is required */
+void Remap_weight_sparse_matrix::remap_values_of_levels(float *data_values_src, float *data_values_dst, int dst_array_size, int num_levels, long src_level_stride, long dst_level_stride)
+{
+    build_compressed_weights();
+    if (compressed_weights_status == COMPRESSED_WEIGHTS_BUILT) {
+        remap_values_of_levels_with_compressed_weights(data_values_src, data_values_dst, num_levels, src_level_stride, dst_level_stride);
+        return;
+    }
+
+    if (temp_values_dst_size < dst_array_size) {
+        if (temp_values_dst != NULL)
+            delete [] temp_values_dst;
+        temp_values_dst_size = dst_array_size;
+        temp_values_dst = new double [temp_values_dst_size];
+    }
+    for (int k = 0; k < num_levels; k ++)
+        remap_values_with_coo_weights(num_remaped_dst_cells_indexes, remaped_dst_cells_indexes, num_weights, cells_indexes_src, cells_indexes_dst, weight_values, 
+                                      data_values_src + k*src_level_stride, data_values_dst + k*dst_level_stride, temp_values_dst);
+}
+
+
+void Remap_weight_sparse_matrix::remap_values(float *data_values_src, float *data_values_dst, int dst_array_size)
+{
+    remap_values_of_levels(data_values_src, data_values_dst, dst_array_size, 1, 0, 0);
 }
 
 
 void Remap_weight_sparse_matrix::calc_src_decomp(long *decomp_map_src, const long *decomp_map_dst)
 {
+    rebuild_uncompressed_weights();
     for (long i = 0; i < num_weights; i ++)
         decomp_map_src[cells_indexes_src[i]] = (decomp_map_src[cells_indexes_src[i]] | decomp_map_dst[cells_indexes_dst[i]]);
 }
@@ -179,6 +398,7 @@ Remap_weight_sparse_matrix *Remap_weight_sparse_matrix::duplicate_remap_weight_o
     Remap_weight_sparse_matrix *duplicated_remap_weight_of_sparse_matrix;
 
 
+    rebuild_uncompressed_weights();
     duplicated_remap_weight_of_sparse_matrix = new Remap_weight_sparse_matrix(remap_operator);
     duplicated_remap_weight_of_sparse_matrix->weight_arrays_size = this->weight_arrays_size;
     duplicated_remap_weight_of_sparse_matrix->num_weights = this->num_weights;
@@ -203,6 +423,8 @@ Remap_weight_sparse_matrix *Remap_weight_sparse_matrix::duplicate_remap_weight_o
 
 void Remap_weight_sparse_matrix::compare_to_another_sparse_matrix(Remap_weight_sparse_matrix *another_sparse_matrix)
 {
+    this->rebuild_uncompressed_weights();
+    another_sparse_matrix->rebuild_uncompressed_weights();
     EXECUTION_REPORT(REPORT_ERROR, -1, this->num_weights == another_sparse_matrix->num_weights, "C-Coupler error1 in compare_to_another_sparse_matrix");
     EXECUTION_REPORT(REPORT_ERROR, -1, this->num_remaped_dst_cells_indexes == another_sparse_matrix->num_remaped_dst_cells_indexes, "C-Coupler error2 in compare_to_another_sparse_matrix");
 
@@ -219,6 +441,7 @@ void Remap_weight_sparse_matrix::compare_to_another_sparse_matrix(Remap_weight_s
 
 void Remap_weight_sparse_matrix::print()
 {
+    rebuild_uncompressed_weights();
     for (int i = 0; i < num_weights; i ++)
         printf("remapping weight (%d): src_index=%d, dst_index=%d, weight_value=%lf\n", i, cells_indexes_src[i], cells_indexes_dst[i], weight_values[i]);
 }
@@ -234,6 +457,7 @@ Remap_weight_sparse_matrix *Remap_weight_sparse_matrix::gather(int comp_id)
 	int *all_array_size = new int [comp_node->get_num_procs()];
 	Remap_weight_sparse_matrix *overall_sparse_matrix = NULL;
 	
+	rebuild_uncompressed_weights();
 	gather_array_in_one_comp(comp_node->get_num_procs(), comp_node->get_current_proc_local_id(), (void*)cells_indexes_src, num_weights, sizeof(long), all_array_size, (void**)(&overall_cells_indexes_src), num_overall_wgts, comp_node->get_comm_group());
 	gather_array_in_one_comp(comp_node->get_num_procs(), comp_node->get_current_proc_local_id(), (void*)cells_indexes_dst, num_weights, sizeof(long), all_array_size, (void**)(&overall_cells_indexes_dst), num_overall_wgts, comp_node->get_comm_group());
 	gather_array_in_one_comp(comp_node->get_num_procs(), comp_node->get_current_proc_local_id(), (void*)weight_values, num_weights, sizeof(long), all_array_size, (void**)(&overall_wgt_values), num_overall_wgts, comp_node->get_comm_group());
@@ -12,6 +12,19 @@
 
 
 #include "remap_grid_class.h"
+#include "remap_weight_kernels.h"
+
+
+#ifdef USE_FLOAT_REMAP_WEIGHTS
+typedef float compressed_remap_weight_type;
+#else
+typedef double compressed_remap_weight_type;
+#endif
+
+
+#define COMPRESSED_WEIGHTS_NOT_BUILT       0
+#define COMPRESSED_WEIGHTS_BUILT           1
+#define COMPRESSED_WEIGHTS_UNAVAILABLE     2
 
 
 class Remap_operator_basis;
@@ -29,24 +42,43 @@ class Remap_weight_sparse_matrix
         long num_weights;
         long remaped_dst_cells_indexes_array_size;
         long num_remaped_dst_cells_indexes;
+        int compressed_weights_status;
+        int num_compressed_rows;
+        int *compressed_rows_dst_index;
+        int *compressed_rows_offset;
+        int *compressed_cells_indexes_src;
+        compressed_remap_weight_type *compressed_weight_values;
+        double *temp_values_dst;
+        long temp_values_dst_size;
+
+        void build_compressed_weights();
+        void rebuild_uncompressed_weights();
+        template <typename T> void remap_values_of_levels_with_compressed_weights(T*, T*, int, long, long);
         
     public:
         Remap_weight_sparse_matrix(Remap_operator_basis*);
         Remap_weight_sparse_matrix(Remap_operator_basis*, long, long*, long*, double*, long, long*);
         ~Remap_weight_sparse_matrix();
         void clear_weights_info();
+        void release_compressed_weights();
         void add_weights(long*, long, double*, int, bool);
         void get_weight(long*, long*, double*, int);
         void remap_values(double*, double*, int);
+        void remap_values_of_levels(double*, double*, int, int, long, long);
+        void remap_values(float*, float*, int);
+        void remap_values_of_levels(float*, float*, int, int, long, long);
         void calc_src_decomp(long*, const long*);
         Remap_weight_sparse_matrix *duplicate_remap_weight_of_sparse_matrix();
         Remap_operator_basis *get_remap_operator() { return remap_operator; }
         long get_num_weights() { return num_weights; }
-        long *get_indexes_src_grid() { return cells_indexes_src; }
-        long *get_indexes_dst_grid() { return cells_indexes_dst; }
+        /* The COO arrays are rebuilt from the compressed weights once and then kept together with them, so that the pointers
+           returned stay valid until release_compressed_weights, clear_weights_info or add_weights is called. A caller that 
+           changes the COO arrays must call release_compressed_weights afterwards, so that the compressed weights are rebuilt */
+        long *get_indexes_src_grid() { rebuild_uncompressed_weights(); return cells_indexes_src; }
+        long *get_indexes_dst_grid() { rebuild_uncompressed_weights(); return cells_indexes_dst; }
         long get_num_remaped_dst_cells_indexes() { return num_remaped_dst_cells_indexes; }
         long *get_remaped_dst_cells_indexes() { return remaped_dst_cells_indexes; }
-        double *get_weight_values() { return weight_values; }
+        double *get_weight_values() { rebuild_uncompressed_weights(); return weight_values; }
         void compare_to_another_sparse_matrix(Remap_weight_sparse_matrix*);
         void print();
 		Remap_weight_sparse_matrix *gather(int);
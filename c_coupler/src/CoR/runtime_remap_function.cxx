@@ -191,21 +191,33 @@ void Runtime_remap_function::calculate_static_remapping_weights(long current_rem
 			EXECUTION_REPORT_ERROR_OPTIONALLY(REPORT_ERROR, -1, runtime_remap_operator->get_dst_grid()->get_boundary_min_lon() != NULL_COORD_VALUE, "Software error in Runtime_remap_function::calculate_static_remapping_weights: \"%s\"", runtime_remap_operator->get_dst_grid()->get_grid_name());
 		}
         if (runtime_remap_operator->get_src_grid()->get_is_H2D_grid()) {
+			Remap_weight_sparse_matrix *wgt_matrix = NULL;
+			Local_H2D_remap_weights_cache *local_remap_weights_cache = NULL;
 			current_remap_local_cell_global_indexes = NULL;
-			if (H2D_remapping_wgt_file != NULL) {
+			if (comp_comm_group_mgt_mgr->get_remapping_weights_cache_enabled() && current_remapping_time_iter == 0 && wgt_cal_comp_id != -1 && original_dst_decomp_id != -1 && src_original_grid_id != -1 && dst_original_grid_id != -1) {
+				local_remap_weights_cache = new Local_H2D_remap_weights_cache(wgt_cal_comp_id, src_original_grid_id, dst_original_grid_id, original_dst_decomp_id, runtime_remap_operator, remap_weight_of_strategy->get_object_name(), H2D_remapping_wgt_file);
+				wgt_matrix = local_remap_weights_cache->load_local_remap_weights(runtime_remap_operator);
+			}
+			if (wgt_matrix == NULL && H2D_remapping_wgt_file != NULL) {
 				comp_comm_group_mgt_mgr->get_root_component_model()->get_performance_timing_mgr()->performance_timing_start(TIMING_TYPE_COMPUTATION, -1, -1, "Distributed_H2D_weights_generator::read_normal_remap_weights");
-	            Remap_weight_sparse_matrix *wgt_matrix = ((Distributed_H2D_weights_generator*)(NULL))->read_normal_remap_weights(decomps_info_mgr->get_decomp_info(original_dst_decomp_id), H2D_remapping_wgt_file, runtime_remap_operator);
+	            wgt_matrix = ((Distributed_H2D_weights_generator*)(NULL))->read_normal_remap_weights(decomps_info_mgr->get_decomp_info(original_dst_decomp_id), H2D_remapping_wgt_file, runtime_remap_operator);
 				comp_comm_group_mgt_mgr->get_root_component_model()->get_performance_timing_mgr()->performance_timing_stop(TIMING_TYPE_COMPUTATION, -1, -1, "Distributed_H2D_weights_generator::read_normal_remap_weights");
-	            runtime_remap_operator->update_unique_weight_sparse_matrix(wgt_matrix);
+				if (local_remap_weights_cache != NULL)
+					local_remap_weights_cache->save_local_remap_weights(wgt_matrix);
 			}
-			else {
+			else if (wgt_matrix == NULL) {
 				EXECUTION_REPORT(REPORT_ERROR, -1, current_remapping_time_iter == 0, "Software error in Runtime_remap_function::calculate_static_remapping_weights: 3-D masks are not supported currently. Please contact Dr. Li Liu for help.");
 				current_distributed_H2D_weights_generator = new Distributed_H2D_weights_generator(wgt_cal_comp_id, src_original_grid_id, dst_original_grid_id, original_dst_decomp_id, runtime_remap_operator);
 //				current_distributed_H2D_weights_generator->check_consistency_of_normal_remap_weights(runtime_remap_operator->get_remap_weights_group(0));
-				runtime_remap_operator->update_unique_weight_sparse_matrix(current_distributed_H2D_weights_generator->extract_normal_remap_weights());
+				wgt_matrix = current_distributed_H2D_weights_generator->extract_normal_remap_weights();
 				delete current_distributed_H2D_weights_generator;
 				current_distributed_H2D_weights_generator = NULL;
+				if (local_remap_weights_cache != NULL)
+					local_remap_weights_cache->save_local_remap_weights(wgt_matrix);
 			}
+			runtime_remap_operator->update_unique_weight_sparse_matrix(wgt_matrix);
+			if (local_remap_weights_cache != NULL)
+				delete local_remap_weights_cache;
         }
         else {
             if (src_grid_changed)
@@ -11,6 +11,7 @@
 #include "memory_mgt.h"
 #include "global_data.h"
 #include "cor_global_data.h"
+#include "dictionary.h"
 #include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
@@ -288,7 +289,15 @@ bool Field_mem_info::match_field_mem(void *data_buffer)
 
 void Field_mem_info::reset_field_name(const char *new_name)
 {
+    char old_name[NAME_STR_SIZE];
+
+
+    if (words_are_the_same(field_name, new_name))
+        return;
+    strcpy(old_name, field_name);
     strcpy(field_name, new_name);
+    if (memory_manager != NULL)
+        memory_manager->update_index_of_renamed_field_instance(this, old_name);
 }
 
 
@@ -624,19 +633,27 @@ Field_mem_info *Memory_mgt::alloc_mem(Field_mem_info *original_field_instance, i
     }
     else if (special_buf_mark == BUF_MARK_UNIT_TRANS) {
         // check unit
-        fields_mem.push_back(new Field_mem_info(original_field_instance->get_field_name(), original_field_instance->get_decomp_id(), original_field_instance->get_comp_or_grid_id(), new_buf_mark, unit_or_datatype, original_field_instance->get_data_type(), "new field instance for unit transformation", check_field_name, disable_decomp_grid));
+
+
+        fields_mem.push_back(new Field_mem_info(original_field_instance->get_field_name(), original_field_instance->get_decomp_id(), original_field_instance->get_comp_or_grid_id(), new_buf_mark, unit_or_datatype, original_field_instance->get_data_type(), "new field instance for unit transformation", check_field_name, disable_decomp_grid));
     }
     else if (special_buf_mark == BUF_MARK_REMAP_NORMAL) {
         // check unit
-        fields_mem.push_back(new Field_mem_info(original_field_instance->get_field_name(), original_field_instance->get_decomp_id(), original_field_instance->get_comp_or_grid_id(), new_buf_mark, original_field_instance->get_unit(), unit_or_datatype, "new field instance for remapping", check_field_name, disable_decomp_grid));
+
+
+        fields_mem.push_back(new Field_mem_info(original_field_instance->get_field_name(), original_field_instance->get_decomp_id(), original_field_instance->get_comp_or_grid_id(), new_buf_mark, original_field_instance->get_unit(), unit_or_datatype, "new field instance for remapping", check_field_name, disable_decomp_grid));
     }
     else if (special_buf_mark == BUF_MARK_REMAP_DATATYPE_TRANS_SRC) {
         // check unit
-        fields_mem.push_back(new Field_mem_info(original_field_instance->get_field_name(), original_field_instance->get_decomp_id(), original_field_instance->get_comp_or_grid_id(), new_buf_mark, original_field_instance->get_unit(), unit_or_datatype, "new field instance for data type transformation in remapping", check_field_name, disable_decomp_grid));
+    
+
+    fields_mem.push_back(new Field_mem_info(original_field_instance->get_field_name(), original_field_instance->get_decomp_id(), original_field_instance->get_comp_or_grid_id(), new_buf_mark, original_field_instance->get_unit(), unit_or_datatype, "new field instance for data type transformation in remapping", check_field_name, disable_decomp_grid));
     }
     else if (special_buf_mark == BUF_MARK_REMAP_DATATYPE_TRANS_DST) {
         // check unit
-        fields_mem.push_back(new Field_mem_info(original_field_instance->get_field_name(), original_field_instance->get_decomp_id(), original_field_instance->get_comp_or_grid_id(), new_buf_mark, original_field_instance->get_unit(), unit_or_datatype, "new field instance for data type transformation in remapping", check_field_name, disable_decomp_grid));
+
+
+        fields_mem.push_back(new Field_mem_info(original_field_instance->get_field_name(), original_field_instance->get_decomp_id(), original_field_instance->get_comp_or_grid_id(), new_buf_mark, original_field_instance->get_unit(), unit_or_datatype, "new field instance for data type transformation in remapping", check_field_name, disable_decomp_grid));
     }
     else if (special_buf_mark == BUF_MARK_ENS_DATA_TRANSFER) {
         fields_mem.push_back(new Field_mem_info(original_field_instance->get_field_name(), original_field_instance->get_decomp_id(), original_field_instance->get_comp_or_grid_id(), new_buf_mark, original_field_instance->get_unit(), unit_or_datatype, "new field instance for statistical processing in ensemble procedures", check_field_name, disable_decomp_grid));
@@ -644,6 +661,7 @@ Field_mem_info *Memory_mgt::alloc_mem(Field_mem_info *original_field_instance, i
     else EXECUTION_REPORT(REPORT_ERROR, -1, false, "Software error in Field_mem_info *alloc_mem");
 
     fields_mem[fields_mem.size()-1]->set_field_instance_id(TYPE_FIELD_INST_ID_PREFIX|(fields_mem.size()-1), "in Memory_mgt::alloc_mem");
+    add_field_instance_into_index(fields_mem.size()-1);
 	
 
     return fields_mem[fields_mem.size()-1];
@@ -674,27 +692,38 @@ Field_mem_info *Memory_mgt::alloc_mem(const char *field_name, int decomp_id, int
 
     
     /* If memory buffer has been allocated, return it */
-    for (i = 0; i < fields_mem.size(); i ++)
-        if (fields_mem[i] != NULL && fields_mem[i]->match_field_instance(field_name, decomp_id, comp_or_grid_id, buf_mark)) {
-            EXECUTION_REPORT(REPORT_ERROR, -1, words_are_the_same(data_type, fields_mem[i]->get_field_data()->get_grid_data_field()->data_type_in_application),
-                             "Software error in Memory_mgt::alloc_mem: data types conflict");
-            return fields_mem[i];
-        }
+    field_mem = search_field_instance(field_name, decomp_id, comp_or_grid_id, buf_mark);
+    if (field_mem != NULL) {
+        EXECUTION_REPORT(REPORT_ERROR, -1, words_are_the_same(data_type, field_mem->get_field_data()->get_grid_data_field()->data_type_in_application),
+                         "Software error in Memory_mgt::alloc_mem: data types conflict");
+        return field_mem;
+    }
 
     /* Compute the size of the memory buffer and then allocate and return it */
     field_mem = new Field_mem_info(field_name, decomp_id, comp_or_grid_id, buf_mark, field_unit, data_type, annotation, check_field_name, disable_decomp_grid);
     field_mem->set_field_instance_id(TYPE_FIELD_INST_ID_PREFIX|fields_mem.size(), annotation);
     fields_mem.push_back(field_mem);
+    add_field_instance_into_index(fields_mem.size()-1);
 
     return field_mem;
 }
 
 
+Memory_mgt::Memory_mgt()
+{
+    buffer_pool = new Memory_buffer_pool();
+    fields_mem_index = new Dictionary<int>(1024);
+}
+
+
 Memory_mgt::~Memory_mgt()
 {
     for (int i = 0; i < fields_mem.size(); i ++)
 		if (fields_mem[i] != NULL)
 	        delete fields_mem[i];
+	buffer_pool->report_high_water_marks();
+	delete buffer_pool;
+	delete fields_mem_index;
 }
 
 
@@ -729,11 +758,77 @@ long Memory_mgt::get_field_size(void *data_buf, const char *annotation)
 }
 
 
-Field_mem_info *Memory_mgt::search_field_instance(const char *field_name, int decomp_id, int comp_or_grid_id, int buf_mark)
+void Memory_mgt::calculate_field_instance_key(const char *field_name, int decomp_id, int comp_or_grid_id, int buf_mark, char *field_instance_key)
+{
+    sprintf(field_instance_key, "%x %x %x %s", decomp_id, comp_or_grid_id, buf_mark, field_name);
+}
+
+
+/* The field instances with the same key are kept in a bucket, because a field instance can be registered more than once */
+std::vector<int> *Memory_mgt::search_fields_mem_index_bucket(const char *field_name, int decomp_id, int comp_or_grid_id, int buf_mark, bool add_bucket)
 {
+    char field_instance_key[NAME_STR_SIZE*2];
+    int bucket_id;
+
+
+    calculate_field_instance_key(field_name, decomp_id, comp_or_grid_id, buf_mark, field_instance_key);
+    bucket_id = fields_mem_index->search(field_instance_key, false);
+    if (bucket_id == 0) {
+        if (!add_bucket)
+            return NULL;
+        fields_mem_index_buckets.push_back(std::vector<int>());
+        bucket_id = fields_mem_index_buckets.size();
+        fields_mem_index->insert(field_instance_key, bucket_id);
+    }
+
+    return &(fields_mem_index_buckets[bucket_id-1]);
+}
+
+
+void Memory_mgt::add_field_instance_into_index(int i)
+{
+    search_fields_mem_index_bucket(fields_mem[i]->get_field_name(), fields_mem[i]->get_decomp_id(), fields_mem[i]->get_comp_or_grid_id(), fields_mem[i]->get_buf_mark(), true)->push_back(i);
+}
+
+
+void Memory_mgt::rebuild_fields_mem_index()
+{
+    delete fields_mem_index;
+    fields_mem_index = new Dictionary<int>(1024);
+    fields_mem_index_buckets.clear();
     for (int i = 0; i < fields_mem.size(); i ++)
-        if (fields_mem[i] != NULL && fields_mem[i]->match_field_instance(field_name, decomp_id, comp_or_grid_id, buf_mark))
-            return fields_mem[i];
+        if (fields_mem[i] != NULL)
+            add_field_instance_into_index(i);
+}
+
+
+void Memory_mgt::update_index_of_renamed_field_instance(Field_mem_info *field_mem, const char *old_field_name)
+{
+    std::vector<int> *candidate_fields = search_fields_mem_index_bucket(old_field_name, field_mem->get_decomp_id(), field_mem->get_comp_or_grid_id(), field_mem->get_buf_mark(), false);
+
+
+    if (candidate_fields == NULL)
+        return;
+    for (int i = 0; i < candidate_fields->size(); i ++)
+        if (fields_mem[(*candidate_fields)[i]] == field_mem) {
+            int field_index = (*candidate_fields)[i];
+            candidate_fields->erase(candidate_fields->begin()+i);
+            add_field_instance_into_index(field_index);
+            return;
+        }
+}
+
+
+Field_mem_info *Memory_mgt::search_field_instance(const char *field_name, int decomp_id, int comp_or_grid_id, int buf_mark)
+{
+    std::vector<int> *candidate_fields = search_fields_mem_index_bucket(field_name, decomp_id, comp_or_grid_id, buf_mark, false);
+
+
+    if (candidate_fields == NULL)
+        return NULL;
+    for (int i = 0; i < candidate_fields->size(); i ++)
+        if (fields_mem[(*candidate_fields)[i]] != NULL && fields_mem[(*candidate_fields)[i]]->match_field_instance(field_name, decomp_id, comp_or_grid_id, buf_mark))
+            return fields_mem[(*candidate_fields)[i]];
 
     return NULL;
 }
@@ -800,6 +895,7 @@ int Memory_mgt::register_external_field_instance(const char *field_name, void *d
 	    new_field_instance->reset_mem_buf(data_buffer, true, usage_tag);
     EXECUTION_REPORT(REPORT_ERROR, comp_id, usage_tag >= 0 && usage_tag <= 3, "Error happens when calling the API \"CCPL_register_field_instance/CCPL_start_chunk_field_instance_registration\" to register a field instance of \"%s\": the value of the parameter \"usage_tag\" (%d) is wrong. The right value should be between 1 and 3. Please check the model code with the annotation \"%s\"", field_name, usage_tag, annotation);
     fields_mem.push_back(new_field_instance);
+    add_field_instance_into_index(fields_mem.size()-1);
 
     return new_field_instance->get_field_instance_id();
 }
@@ -860,5 +956,112 @@ void Memory_mgt::delete_field_inst(Field_mem_info *field_mem)
 
 	EXECUTION_REPORT_ERROR_OPTIONALLY(REPORT_ERROR, -1, i < fields_mem.size(), "Software error in Memory_mgt::delete_field_inst");
 	fields_mem.erase(fields_mem.begin()+i);
+	rebuild_fields_mem_index();
+}
+
+
+Memory_buffer_pool::Memory_buffer_pool()
+{
+    bytes_in_use = 0;
+    bytes_cached = 0;
+    high_water_bytes_in_use = 0;
+    high_water_bytes_allocated = 0;
+    num_requests = 0;
+    num_reused_requests = 0;
+}
+
+
+Memory_buffer_pool::~Memory_buffer_pool()
+{
+    release_cached_bufs();
+}
+
+
+/* Size classes grow geometrically with four classes per power of two 
+   (256, 320, 384, 448, 512, 640, ... bytes), so that a buffer wastes at 
+   most 25% of its size */
+long Memory_buffer_pool::get_size_of_size_class(int size_class)
+{
+    return ((long)(4+size_class%4)) * (((long)64) << (size_class/4));
+}
+
+
+int Memory_buffer_pool::get_size_class(long buf_size)
+{
+    int size_class = 0;
+
+
+    while (get_size_of_size_class(size_class+4) < buf_size)
+        size_class += 4;
+    while (get_size_of_size_class(size_class) < buf_size)
+        size_class ++;
+
+    return size_class;
 }
 
+
+void *Memory_buffer_pool::allocate_buf(long buf_size, int buf_mark)
+{
+    int size_class = get_size_class(buf_size);
+    long class_size = get_size_of_size_class(size_class);
+    long *buf;
+
+
+    num_requests ++;
+    std::vector<long*> &free_bufs_of_class = free_bufs[std::make_pair(size_class, buf_mark)];
+    if (free_bufs_of_class.size() > 0) {
+        buf = free_bufs_of_class.back();
+        free_bufs_of_class.pop_back();
+        bytes_cached -= class_size;
+        num_reused_requests ++;
+    }
+    else {
+        buf = new long [2+(class_size+sizeof(long)-1)/sizeof(long)];
+        buf[0] = size_class;
+        buf[1] = buf_mark;
+    }
+
+    bytes_in_use += class_size;
+    bytes_in_use_of_marks[buf_mark] += class_size;
+    if (high_water_bytes_in_use < bytes_in_use)
+        high_water_bytes_in_use = bytes_in_use;
+    if (high_water_bytes_allocated < bytes_in_use + bytes_cached)
+        high_water_bytes_allocated = bytes_in_use + bytes_cached;
+    if (high_water_bytes_of_marks[buf_mark] < bytes_in_use_of_marks[buf_mark])
+        high_water_bytes_of_marks[buf_mark] = bytes_in_use_of_marks[buf_mark];
+
+    return buf + 2;
+}
+
+
+void Memory_buffer_pool::release_buf(void *data_buf)
+{
+    long *buf = ((long*) data_buf) - 2;
+    long class_size = get_size_of_size_class((int)buf[0]);
+
+
+    EXECUTION_REPORT_ERROR_OPTIONALLY(REPORT_ERROR, -1, bytes_in_use >= class_size && bytes_in_use_of_marks[(int)buf[1]] >= class_size, "Software error in Memory_buffer_pool::release_buf");
+    bytes_in_use -= class_size;
+    bytes_in_use_of_marks[(int)buf[1]] -= class_size;
+    bytes_cached += class_size;
+    free_bufs[std::make_pair((int)buf[0], (int)buf[1])].push_back(buf);
+}
+
+
+void Memory_buffer_pool::release_cached_bufs()
+{
+    for (std::map<std::pair<int, int>, std::vector<long*> >::iterator iter = free_bufs.begin(); iter != free_bufs.end(); iter ++) {
+        for (int i = 0; i < iter->second.size(); i ++)
+            delete [] iter->second[i];
+        iter->second.clear();
+    }
+    bytes_cached = 0;
+}
+
+
+void Memory_buffer_pool::report_high_water_marks()
+{
+    EXECUTION_REPORT_LOG(REPORT_LOG, -1, true, "The memory buffer pool served %ld requests (%ld reused): the high-water mark is %ld bytes in use and %ld bytes allocated", num_requests, num_reused_requests, high_water_bytes_in_use, high_water_bytes_allocated);
+    for (std::map<int, long>::iterator iter = high_water_bytes_of_marks.begin(); iter != high_water_bytes_of_marks.end(); iter ++)
+        EXECUTION_REPORT_LOG(REPORT_LOG, -1, true, "The high-water mark of the memory buffer pool for the buffer mark %x is %ld bytes", iter->first, iter->second);
+}
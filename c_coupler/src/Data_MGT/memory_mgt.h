@@ -11,6 +11,7 @@
 #define MEM_MGT
 
 #include <vector>
+#include <map>
 #include "common_utils.h"
 #include "remap_grid_data_class.h"
 #include "timer_mgt.h"
@@ -32,6 +33,8 @@
 #define BUF_MARK_REMAP_DATATYPE_TRANS_DST        ((int)(0xF0750000))
 #define BUF_MARK_HALO_EXCHANGE                   ((int)(0xF0760000))
 #define BUF_MARK_ENS_DATA_TRANSFER               ((int)(0xF0770000))
+#define BUF_MARK_REMAP_INTERMEDIATE              ((int)(0xF0780000))
+#define BUF_MARK_REMAP_INTERCHANGE               ((int)(0xF0790000))
 
 
 #define REG_FIELD_TAG_NONE                       ((int)0)
@@ -126,13 +129,60 @@ class Field_mem_info
 };
 
 
+/* Memory_buffer_pool recycles the temporary data buffers that are allocated 
+   and released again in each coupling step (e.g., the intermediate fields of 
+   remapping). Buffers are rounded up to size classes and the released buffers 
+   are kept in free lists keyed by the size class and the buffer mark, so that 
+   the next request of the same kind does not reach the system allocator. The 
+   high-water marks of the memory in use are recorded for each buffer mark. */
+class Memory_buffer_pool
+{
+    private:
+        std::map<std::pair<int, int>, std::vector<long*> > free_bufs;
+        std::map<int, long> bytes_in_use_of_marks;
+        std::map<int, long> high_water_bytes_of_marks;
+        long bytes_in_use;
+        long bytes_cached;
+        long high_water_bytes_in_use;
+        long high_water_bytes_allocated;
+        long num_requests;
+        long num_reused_requests;
+
+        int get_size_class(long);
+        long get_size_of_size_class(int);
+
+    public:
+        Memory_buffer_pool();
+        ~Memory_buffer_pool();
+        void *allocate_buf(long, int);
+        void release_buf(void *);
+        void release_cached_bufs();
+        void report_high_water_marks();
+        long get_high_water_bytes_in_use() { return high_water_bytes_in_use; }
+};
+
+
+/* The field instances are indexed in a hashing table by their names, decompositions, grids and buffer marks, 
+   so that searching a field instance does not scan all field instances. The field instance ID can be used as 
+   the handle of a field instance for the direct access through get_field_instance */
+template <class T> class Dictionary;
+
+
 class Memory_mgt
 {
     private:
         std::vector<Field_mem_info *> fields_mem;
+        Dictionary<int> *fields_mem_index;
+        std::vector<std::vector<int> > fields_mem_index_buckets;
+        Memory_buffer_pool *buffer_pool;
+
+        void calculate_field_instance_key(const char *, int, int, int, char*);
+        std::vector<int> *search_fields_mem_index_bucket(const char*, int, int, int, bool);
+        void add_field_instance_into_index(int);
+        void rebuild_fields_mem_index();
         
     public: 
-        Memory_mgt() {}
+        Memory_mgt();
         Field_mem_info *alloc_mem(Field_mem_info*, int, int, const char*, bool, bool);
         Field_mem_info *alloc_mem(const char*, int, int, int, const char*, const char*, const char*, bool, bool);
          int register_external_field_instance(const char *, void *, int, int, int, int, int, const char *, const char *, const char *);
@@ -147,6 +197,8 @@ class Memory_mgt
         void copy_field_data_values(Field_mem_info *, Field_mem_info*);
 		void get_comp_existing_registered_field_insts(std::vector<Field_mem_info *>&, int);
 		void delete_field_inst(Field_mem_info*);
+		Memory_buffer_pool *get_buffer_pool() { return buffer_pool; }
+		void update_index_of_renamed_field_instance(Field_mem_info*, const char*);
 };
 
 #endif
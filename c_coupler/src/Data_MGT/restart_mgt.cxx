@@ -10,6 +10,7 @@
 #include "global_data.h"
 #include "restart_mgt.h"
 #include "io_pnetcdf.h"
+#include <algorithm>
 
 
 
@@ -107,6 +108,7 @@ Restart_mgt::Restart_mgt(Comp_comm_group_mgt_node *comp_node)
     restart_read_data_file_name = NULL;
     are_all_restarted_fields_read = false;
     restart_normal_fields_enabled = false;
+    next_in_flight_staged_field = 0;
 }
 
 
@@ -122,6 +124,8 @@ Restart_mgt::~Restart_mgt()
         delete restart_read_data_file_name;
     if (backup_restart_write_data_file != NULL)
         delete backup_restart_write_data_file;
+    for (int i = 0; i < staged_restart_fields.size(); i ++)
+        delete [] staged_restart_fields[i].staged_data;
 }
 
 
@@ -266,6 +270,11 @@ void Restart_mgt::do_restart_write(const char *annotation, bool bypass_timer, bo
     check_API_parameter_bool(comp_node->get_comp_id(), API_ID_RESTART_MGT_WRITE_IO, comp_node->get_comm_group(), "generating restart data files", bypass_imported_fields, "bypass_timer", annotation);
 
     if (bypass_timer || time_mgr->is_restart_timer_on()) {
+        if (is_restart_write_in_flight()) {
+            EXECUTION_REPORT_LOG(REPORT_LOG, comp_node->get_comp_id(), true, "Wait for the previous restart writing at the model code with the annotation \"%s\"", annotation);
+            write_staged_restart_fields(-1);
+            write_restart_mgt_into_file();
+        }
         EXECUTION_REPORT(REPORT_ERROR, comp_node->get_comp_id(), current_full_time != last_restart_write_full_time, "Error happens when the component model tries to write restart data files: the corresponding API \"CCPL_do_restart_write_IO\" has been called more than once at the same time step. Please verify the model code with the annotation \"%s\"", annotation);
         if (time_mgr->get_runtype_mark() == RUNTYPE_MARK_CONTINUE || time_mgr->get_runtype_mark() == RUNTYPE_MARK_BRANCH) {
             EXECUTION_REPORT(REPORT_ERROR, comp_node->get_comp_id(), time_mgr->get_restart_full_time() != ((long)time_mgr->get_current_num_elapsed_day()*((long)100000))+time_mgr->get_current_second(), "Error happens when the component model calls the API \"CCPL_do_restart_write_IO\" to write restart data at the model time %ld: the current model run is a %s run restarted at the same model time, while the model time to write restart data cannot be the same as the restarted model time. Please verify the model code with the annotation \"%s\".", current_full_time, time_mgr->get_run_type(), annotation);
@@ -294,6 +303,9 @@ void Restart_mgt::do_restart_write(const char *annotation, bool bypass_timer, bo
                 backup_restart_write_data_file = NULL;
             }
 #ifdef USE_PARALLEL_IO
+            // only the root process hands the restart data file over to backup_restart_write_data_file, while the other I/O processes keep the closed file until here
+            if (restart_write_data_file != NULL)
+                delete restart_write_data_file;
             restart_write_data_file = new IO_pnetcdf(comp_node->get_comp_id(), num_io_procs, io_proc_mark, io_comm, restart_data_file_name, restart_data_file_name, "w", false);
 #else
             restart_write_data_file = new IO_netcdf(restart_data_file_name, restart_data_file_name, "w", false);
@@ -310,15 +322,92 @@ void Restart_mgt::do_restart_write(const char *annotation, bool bypass_timer, bo
         for (int i = 0; i < restarted_field_instances.size(); i ++) {
             Field_mem_info *output_field;
             output_field = restarted_field_instances[i].first;
-            if (!bypass_imported_fields)
-                write_restart_field_data(output_field, NULL, NULL, false);
-            else if (!restarted_field_instances[i].second)
-                write_restart_field_data(output_field, NULL, NULL, false);
+            if (bypass_imported_fields && restarted_field_instances[i].second)
+                continue;
+            if (comp_comm_group_mgt_mgr->get_restart_write_async_enabled() && output_field->get_num_chunks() == 0)
+                stage_restart_field_data(output_field);
+            else write_restart_field_data(output_field, NULL, NULL, false);
         }
+        if (!is_restart_write_in_flight())
+            close_restart_write_data_file();
     }
 }
 
 
+void Restart_mgt::stage_restart_field_data(Field_mem_info *field_instance)
+{
+    long data_size = field_instance->get_size_of_field() * get_data_type_size(field_instance->get_data_type());
+    int i;
+
+
+    for (i = 0; i < staged_restart_fields.size(); i ++)
+        if (staged_restart_fields[i].field_instance == field_instance)
+            break;
+    if (i == staged_restart_fields.size()) {
+        Restart_staged_field staged_field;
+        staged_field.field_instance = field_instance;
+        staged_field.staged_data = NULL;
+        staged_field.staged_data_size = 0;
+        staged_restart_fields.push_back(staged_field);
+    }
+    if (staged_restart_fields[i].staged_data_size != data_size) {
+        if (staged_restart_fields[i].staged_data != NULL)
+            delete [] staged_restart_fields[i].staged_data;
+        staged_restart_fields[i].staged_data = new char [data_size];
+        staged_restart_fields[i].staged_data_size = data_size;
+    }
+    memcpy(staged_restart_fields[i].staged_data, field_instance->get_data_buf(), data_size);
+    in_flight_staged_fields.push_back(i);
+}
+
+
+/* Writes at most max_num_fields (all when it is -1) of the staged restart fields. The staged values are swapped 
+   into the field instance for the collective gathering and writing, and then swapped back, which keeps the 
+   current model values unchanged. All processes of the component model call it with the same parameter */
+void Restart_mgt::write_staged_restart_fields(int max_num_fields)
+{
+    for (int num_written_fields = 0; is_restart_write_in_flight() && (max_num_fields == -1 || num_written_fields < max_num_fields); num_written_fields ++) {
+        Restart_staged_field *staged_field = &(staged_restart_fields[in_flight_staged_fields[next_in_flight_staged_field++]]);
+        char *field_data = (char*) staged_field->field_instance->get_data_buf();
+        std::swap_ranges(field_data, field_data+staged_field->staged_data_size, staged_field->staged_data);
+        write_restart_field_data(staged_field->field_instance, NULL, NULL, false);
+        std::swap_ranges(field_data, field_data+staged_field->staged_data_size, staged_field->staged_data);
+    }
+
+    if (!is_restart_write_in_flight()) {
+        in_flight_staged_fields.clear();
+        next_in_flight_staged_field = 0;
+        close_restart_write_data_file();
+    }
+}
+
+
+/* The restart data file is kept open on the I/O processes while its fields are written, and the writes of all fields are 
+   completed at once when it is closed after the last field. All processes of the component model call it at the same points */
+void Restart_mgt::close_restart_write_data_file()
+{
+#ifdef USE_PARALLEL_IO
+    int io_proc_mark, io_proc_stride;
+    MPI_Comm io_comm;
+
+
+    datamodel_mgr->get_comp_PIO_proc_setting(comp_node->get_comp_id(), io_proc_stride, io_proc_mark, io_comm);
+    if (io_proc_mark == 1 && restart_write_data_file != NULL)
+        restart_write_data_file->close_file();
+#endif
+}
+
+
+void Restart_mgt::finish_restart_write()
+{
+    if (!is_restart_write_in_flight())
+        return;
+
+    write_staged_restart_fields(-1);
+    write_restart_mgt_into_file();
+}
+
+
 void Restart_mgt::get_field_IO_name(char *field_IO_name, Field_mem_info *field_instance, const char *interface_name, const char*label, bool use_time_info)
 {
     //Field_mem_info *global_field = fields_gather_scatter_mgr->gather_field(field_instance);
@@ -451,6 +540,12 @@ void Restart_mgt::write_restart_mgt_into_file()
     FILE *restart_file, *rpointer_file;
     
 
+    if (is_restart_write_in_flight()) {
+        write_staged_restart_fields(RESTART_ASYNC_NUM_FIELDS_PER_STEP);
+        if (is_restart_write_in_flight())
+            return;
+    }
+
     if (comp_node->get_current_proc_local_id() != 0) {
         clean(true);
         return;
@@ -13,6 +13,7 @@
 
 #define RESTART_BUF_TYPE_TIME            "time_restart"
 #define RESTART_BUF_TYPE_INTERFACE       "interface"
+#define RESTART_ASYNC_NUM_FIELDS_PER_STEP     4
 
 
 #include "common_utils.h"
@@ -59,6 +60,17 @@ class Restart_buffer_container
 };
 
 
+/* A staging buffer keeps a snapshot of a restarted field at the restart time step, so that the field can be 
+   written into the restart data file at the following time steps while the model keeps changing its values. 
+   The staging buffers are kept and reused by the next restart writing */
+struct Restart_staged_field
+{
+    Field_mem_info *field_instance;
+    char *staged_data;
+    long staged_data_size;
+};
+
+
 class Restart_mgt
 {
     private:
@@ -84,12 +96,21 @@ class Restart_mgt
         bool are_all_restarted_fields_read;
         bool bypass_import_fields_at_read;
         bool bypass_import_fields_at_write;
+        std::vector<Restart_staged_field> staged_restart_fields;
+        std::vector<int> in_flight_staged_fields;
+        int next_in_flight_staged_field;
+
+        void stage_restart_field_data(Field_mem_info *);
+        void write_staged_restart_fields(int);
+        void close_restart_write_data_file();
 
     public:
         Restart_mgt(Comp_comm_group_mgt_node*);
         ~Restart_mgt();
         void clean(bool);
         void do_restart_write(const char *, bool, bool);
+        void finish_restart_write();
+        bool is_restart_write_in_flight() { return next_in_flight_staged_field < in_flight_staged_fields.size(); }
         void write_restart_mgt_into_file();
         void read_restart_mgt_info(bool, const char *, const char *);
         void read_restart_mgt_info(const char *, const char *);
@@ -64,7 +64,10 @@ extern "C" void finalize_ccpl_
     if (comp_comm_group_mgt_mgr->get_current_proc_global_id() == 0)
         EXECUTION_REPORT(REPORT_PROGRESS, -1, true, "Start to finalize C-Coupler at the model code with the annotation \"%s\"", annotation);
 
+    comp_comm_group_mgt_mgr->finish_restart_writes();
     comp_comm_group_mgt_mgr->output_performance_timing();
+    if (datamodel_mgr != NULL)
+        datamodel_mgr->close_output_files();
     inout_interface_mgr->free_all_MPI_wins();
 
     delete annotation_mgr;
@@ -390,8 +393,11 @@ extern "C" void register_root_component_
         EXECUTION_REPORT(REPORT_ERROR, -1, false, "Error happens when registering the root component (\"%s\") at the model code with the annotation \"%s\": the root compnent (\"%s\") has been registered before, at the model code with the annotation \"%s\". Please note that there must be only one root component model at each MPI process", comp_name, annotation, comp_comm_group_mgt_mgr->get_root_component_model()->get_comp_name(), comp_comm_group_mgt_mgr->get_annotation_start());
     MPI_Initialized(&flag);
     if (flag == 0) {
+        int MPI_thread_level;
         EXECUTION_REPORT_LOG(REPORT_LOG, -1, true, "Initialize MPI when registering the root component \"%s\"", comp_name);
-        MPI_Init(NULL, NULL);
+        /* MPI_THREAD_MULTIPLE is requested because the asynchronous output flushes the writes of the parallel I/O processes in a background thread */
+        MPI_Init_thread(NULL, NULL, MPI_THREAD_MULTIPLE, &MPI_thread_level);
+        EXECUTION_REPORT_LOG(REPORT_LOG, -1, true, "MPI is initialized with the thread support level %s", MPI_thread_level == MPI_THREAD_MULTIPLE? "MPI_THREAD_MULTIPLE" : (MPI_thread_level == MPI_THREAD_SERIALIZED? "MPI_THREAD_SERIALIZED" : (MPI_thread_level == MPI_THREAD_FUNNELED? "MPI_THREAD_FUNNELED" : "MPI_THREAD_SINGLE")));
     }
 
     synchronize_comp_processes_for_API(-1, API_ID_COMP_MGT_REG_COMP, MPI_COMM_WORLD, "registering root component", annotation);
@@ -0,0 +1,289 @@
+/***************************************************************
+  *  Copyright (c) 2017, Tsinghua University.
+  *  This is a source file of C-Coupler.
+  *  This file was initially finished by Dr. Li Liu.
+  *  If you have any problem,
+  *  please contact Dr. Li Liu via liuli-cess@tsinghua.edu.cn
+  ***************************************************************/
+
+
+#include "timer_calendar_kernels.h"
+
+
+int elapsed_days_on_start_of_month_of_nonleap_year[] = {0, 31, 59, 90, 120, 151, 181, 212, 243, 273, 304, 334};
+int elapsed_days_on_start_of_month_of_leap_year[] = {0, 31, 60, 91, 121, 152, 182, 213, 244, 274, 305, 335};
+int num_days_of_month_of_nonleap_year[] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+int num_days_of_month_of_leap_year[] = {31, 29, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+
+
+bool calendar_is_leap_year(int year)
+{
+	return ((year % 4) == 0 && (year % 100) != 0) || (year % 400) == 0;
+}
+
+
+long calendar_calculate_elapsed_day(bool leap_year_on, int year, int month, int day)
+{
+	int num_leap_year;
+
+
+	if (!leap_year_on)
+		return year * NUM_DAYS_PER_NONLEAP_YEAR + elapsed_days_on_start_of_month_of_nonleap_year[month - 1] + day - 1;
+
+	num_leap_year = (year - 1) / 4 - (year - 1) / 100 + (year - 1) / 400;
+
+	if (year > 0)
+		num_leap_year ++;   // year 0 is a leap year
+
+	if (calendar_is_leap_year(year))
+		return year * NUM_DAYS_PER_NONLEAP_YEAR + num_leap_year + elapsed_days_on_start_of_month_of_leap_year[month - 1] + day - 1;
+
+	return year * NUM_DAYS_PER_NONLEAP_YEAR + num_leap_year + elapsed_days_on_start_of_month_of_nonleap_year[month - 1] + day - 1;
+}
+
+
+void calendar_advance_time(bool leap_year_on, int &current_year, int &current_month, int &current_day, int &current_second, int &current_num_elapsed_day, int time_step_in_second)
+{
+	int i, num_days_in_current_month;
+
+
+	current_second += time_step_in_second;
+	for (i = 0; i < current_second / SECONDS_PER_DAY; i ++) {
+		current_num_elapsed_day ++;
+		if (leap_year_on && calendar_is_leap_year(current_year))
+			num_days_in_current_month = num_days_of_month_of_leap_year[current_month - 1];
+		else num_days_in_current_month = num_days_of_month_of_nonleap_year[current_month - 1];
+		current_day ++;
+		if (current_day > num_days_in_current_month) {
+			current_month ++;
+			current_day = 1;
+		}
+		if (current_month > 12) {
+			current_month = 1;
+			current_year ++;
+		}
+	}
+	current_second = current_second % SECONDS_PER_DAY;
+}
+
+
+/* Equivalent to advancing the time step by step, but skips whole years and months at once */
+void calendar_advance_time_by_seconds(bool leap_year_on, int &current_year, int &current_month, int &current_day, int &current_second, int &current_num_elapsed_day, long num_seconds)
+{
+	long num_days, num_days_in_current_year, num_days_in_current_month;
+
+
+	num_days = (current_second + num_seconds) / SECONDS_PER_DAY;
+	current_second = (current_second + num_seconds) % SECONDS_PER_DAY;
+	current_num_elapsed_day += num_days;
+	while (num_days > 0) {
+		num_days_in_current_year = leap_year_on && calendar_is_leap_year(current_year) ? NUM_DAYS_PER_LEAP_YEAR : NUM_DAYS_PER_NONLEAP_YEAR;
+		if (current_month == 1 && current_day == 1 && num_days >= num_days_in_current_year) {
+			num_days -= num_days_in_current_year;
+			current_year ++;
+			continue;
+		}
+		if (leap_year_on && calendar_is_leap_year(current_year))
+			num_days_in_current_month = num_days_of_month_of_leap_year[current_month - 1];
+		else num_days_in_current_month = num_days_of_month_of_nonleap_year[current_month - 1];
+		if (current_day + num_days <= num_days_in_current_month) {
+			current_day += num_days;
+			break;
+		}
+		num_days -= num_days_in_current_month - current_day + 1;
+		current_day = 1;
+		current_month ++;
+		if (current_month > 12) {
+			current_month = 1;
+			current_year ++;
+		}
+	}
+}
+
+
+bool calendar_is_timer_on(const Calendar_timer *timer, int current_year, int current_month, int current_day, int current_second, int current_num_elapsed_day)
+{
+	long num_elapsed_time;
+
+
+	if (timer->frequency_count == 0)
+		return true;
+
+	if (timer->unit == CALENDAR_TIMER_UNIT_SECOND)
+		num_elapsed_time = ((long)(current_num_elapsed_day - timer->start_num_elapsed_day)) * SECONDS_PER_DAY + current_second - timer->start_second;
+	else if (timer->unit == CALENDAR_TIMER_UNIT_DAY) {
+		if (current_second != 0)
+			return false;
+		num_elapsed_time = current_num_elapsed_day - timer->start_num_elapsed_day;
+	}
+	else if (timer->unit == CALENDAR_TIMER_UNIT_MONTH) {
+		if (current_second != 0 || current_day != 1)
+			return false;
+		num_elapsed_time = (current_year - timer->start_year) * NUM_MONTH_PER_YEAR + current_month - timer->start_month;
+	}
+	else {
+		if (current_second != 0 || current_day != 1 || current_month != 1)
+			return false;
+		num_elapsed_time = current_year - timer->start_year;
+	}
+
+	return num_elapsed_time >= timer->local_lag_count && ((num_elapsed_time - timer->local_lag_count) % timer->frequency_count) == 0;
+}
+
+
+/* For the units of seconds and days, the times when the timer is on form an arithmetic sequence. As the remainders of
+   this sequence modulo the time step repeat after time_step_in_second/gcd(time_step_in_second, period) members, it is
+   enough to check this number of candidates for a time that can be reached by stepping from the current time */
+static bool search_time_of_timer_on_linearly(const Calendar_timer *timer, int current_year, int current_month, int current_day, int current_second, int current_num_elapsed_days, int time_step_in_second, long num_steps, bool search_last, int &timer_num_elapsed_days, int &timer_date, int &timer_second)
+{
+	long first_time = ((long)current_num_elapsed_days) * SECONDS_PER_DAY + current_second, last_time = first_time + (num_steps - 1) * time_step_in_second;
+	long first_timer_on_time, period, candidate_id, candidate_time, max_num_candidates, gcd, remainder, divisor;
+	bool found = false;
+
+
+	if (timer->unit == CALENDAR_TIMER_UNIT_SECOND) {
+		period = timer->frequency_count;
+		first_timer_on_time = ((long)timer->start_num_elapsed_day) * SECONDS_PER_DAY + timer->start_second + timer->local_lag_count;
+	}
+	else {
+		period = ((long)timer->frequency_count) * SECONDS_PER_DAY;
+		first_timer_on_time = ((long)timer->start_num_elapsed_day + timer->local_lag_count) * SECONDS_PER_DAY;
+	}
+	gcd = time_step_in_second;
+	divisor = period;
+	while (divisor != 0) {
+		remainder = gcd % divisor;
+		gcd = divisor;
+		divisor = remainder;
+	}
+	max_num_candidates = time_step_in_second / gcd;
+
+	if (search_last) {
+		if (last_time < first_timer_on_time)
+			return false;
+		candidate_id = (last_time - first_timer_on_time) / period;
+	}
+	else candidate_id = first_time <= first_timer_on_time ? 0 : (first_time - first_timer_on_time + period - 1) / period;
+	for (long i = 0; i < max_num_candidates && candidate_id >= 0; i ++) {
+		candidate_time = first_timer_on_time + candidate_id * period;
+		if (candidate_time < first_time)
+			break;
+		if ((candidate_time - first_time) % time_step_in_second == 0) {
+			found = true;
+			break;
+		}
+		candidate_id += search_last ? -1 : 1;
+	}
+	if (!found)
+		return false;
+
+	calendar_advance_time_by_seconds(timer->leap_year_on, current_year, current_month, current_day, current_second, current_num_elapsed_days, candidate_time - first_time);
+	timer_num_elapsed_days = current_num_elapsed_days;
+	timer_date = current_year * 10000 + current_month * 100 + current_day;
+	timer_second = current_second;
+
+	return true;
+}
+
+
+/* For the units of months and years, the timer can only be on at the beginning of a month. Only these months are checked,
+   and the search of the next time is given up after a whole calendar cycle so that the caller can fall back to stepping */
+static bool search_time_of_timer_on_in_calendar(const Calendar_timer *timer, int current_year, int current_month, int current_day, int current_second, int current_num_elapsed_days, int time_step_in_second, long num_steps, bool search_last, int &timer_num_elapsed_days, int &timer_date, int &timer_second)
+{
+	long first_time = ((long)current_num_elapsed_days) * SECONDS_PER_DAY + current_second, last_time = first_time + (num_steps - 1) * time_step_in_second;
+	long current_day_id = calendar_calculate_elapsed_day(timer->leap_year_on, current_year, current_month, current_day), first_month_id, month_period;
+	long candidate_id, candidate_month_id, candidate_num_elapsed_days, candidate_time;
+	int last_year = current_year, last_month = current_month, last_day = current_day, last_second = current_second, last_num_elapsed_days = current_num_elapsed_days;
+	bool found = false;
+
+
+	if (timer->unit == CALENDAR_TIMER_UNIT_MONTH) {
+		first_month_id = ((long)timer->start_year) * NUM_MONTH_PER_YEAR + timer->start_month - 1 + timer->local_lag_count;
+		month_period = timer->frequency_count;
+	}
+	else {
+		first_month_id = ((long)timer->start_year + timer->local_lag_count) * NUM_MONTH_PER_YEAR;
+		month_period = ((long)timer->frequency_count) * NUM_MONTH_PER_YEAR;
+	}
+
+	if (search_last) {
+		calendar_advance_time_by_seconds(timer->leap_year_on, last_year, last_month, last_day, last_second, last_num_elapsed_days, last_time - first_time);
+		candidate_month_id = ((long)last_year) * NUM_MONTH_PER_YEAR + last_month - 1;
+		if (candidate_month_id < first_month_id)
+			return false;
+		candidate_id = (candidate_month_id - first_month_id) / month_period;
+	}
+	else {
+		candidate_month_id = ((long)current_year) * NUM_MONTH_PER_YEAR + current_month - 1;
+		candidate_id = candidate_month_id <= first_month_id ? 0 : (candidate_month_id - first_month_id + month_period - 1) / month_period;
+	}
+	for (long i = 0; candidate_id >= 0 && (search_last || i < NUM_MONTHS_PER_CALENDAR_CYCLE); i ++) {
+		candidate_month_id = first_month_id + candidate_id * month_period;
+		if (candidate_month_id < 0)
+			break;
+		candidate_num_elapsed_days = current_num_elapsed_days + calendar_calculate_elapsed_day(timer->leap_year_on, candidate_month_id / NUM_MONTH_PER_YEAR, candidate_month_id % NUM_MONTH_PER_YEAR + 1, 1) - current_day_id;
+		candidate_time = candidate_num_elapsed_days * SECONDS_PER_DAY;
+		if (candidate_time < first_time) {
+			if (search_last)
+				break;
+		}
+		else if ((candidate_time - first_time) % time_step_in_second == 0) {
+			found = true;
+			break;
+		}
+		candidate_id += search_last ? -1 : 1;
+	}
+	if (!found)
+		return false;
+
+	timer_num_elapsed_days = candidate_num_elapsed_days;
+	timer_date = (candidate_month_id / NUM_MONTH_PER_YEAR) * 10000 + (candidate_month_id % NUM_MONTH_PER_YEAR + 1) * 100 + 1;
+	timer_second = 0;
+
+	return true;
+}
+
+
+/* Searches, among the times reached by advancing from the current time with the time step, the next time (search_last is
+   false) or the last time within num_steps steps (search_last is true) when the timer is on, without stepping one by one.
+   Returns false when no such time is found, which for the next time means that the search has been given up */
+bool calendar_search_time_of_timer_on(const Calendar_timer *timer, int current_year, int current_month, int current_day, int current_second, int current_num_elapsed_days, int time_step_in_second, long num_steps, bool search_last, int &timer_num_elapsed_days, int &timer_date, int &timer_second)
+{
+	if (time_step_in_second <= 0 || (search_last && num_steps <= 0))
+		return false;
+
+	if (timer->frequency_count == 0) {
+		if (search_last)
+			calendar_advance_time_by_seconds(timer->leap_year_on, current_year, current_month, current_day, current_second, current_num_elapsed_days, (num_steps - 1) * time_step_in_second);
+		timer_num_elapsed_days = current_num_elapsed_days;
+		timer_date = current_year * 10000 + current_month * 100 + current_day;
+		timer_second = current_second;
+		return true;
+	}
+
+	if (timer->unit == CALENDAR_TIMER_UNIT_SECOND || timer->unit == CALENDAR_TIMER_UNIT_DAY)
+		return search_time_of_timer_on_linearly(timer, current_year, current_month, current_day, current_second, current_num_elapsed_days, time_step_in_second, num_steps, search_last, timer_num_elapsed_days, timer_date, timer_second);
+	return search_time_of_timer_on_in_calendar(timer, current_year, current_month, current_day, current_second, current_num_elapsed_days, time_step_in_second, num_steps, search_last, timer_num_elapsed_days, timer_date, timer_second);
+}
+
+
+/* Same as above, but by checking the timer at each time step. The search of the next time is not bounded when num_steps is negative */
+bool calendar_search_time_of_timer_on_by_stepping(const Calendar_timer *timer, int current_year, int current_month, int current_day, int current_second, int current_num_elapsed_days, int time_step_in_second, long num_steps, bool search_last, int &timer_num_elapsed_days, int &timer_date, int &timer_second)
+{
+	bool found = false;
+
+
+	for (long i = 0; num_steps < 0 || i < num_steps; i ++) {
+		if (calendar_is_timer_on(timer, current_year, current_month, current_day, current_second, current_num_elapsed_days)) {
+			found = true;
+			timer_num_elapsed_days = current_num_elapsed_days;
+			timer_date = current_year * 10000 + current_month * 100 + current_day;
+			timer_second = current_second;
+			if (!search_last)
+				break;
+		}
+		calendar_advance_time(timer->leap_year_on, current_year, current_month, current_day, current_second, current_num_elapsed_days, time_step_in_second);
+	}
+
+	return found;
+}
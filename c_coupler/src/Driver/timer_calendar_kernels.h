@@ -0,0 +1,62 @@
+/***************************************************************
+  *  Copyright (c) 2017, Tsinghua University.
+  *  This is a source file of C-Coupler.
+  *  This file was initially finished by Dr. Li Liu.
+  *  If you have any problem,
+  *  please contact Dr. Li Liu via liuli-cess@tsinghua.edu.cn
+  ***************************************************************/
+
+
+#ifndef TIMER_CALENDAR_KERNELS
+#define TIMER_CALENDAR_KERNELS
+
+
+#define SECONDS_PER_DAY                 ((long)86400)
+#define NUM_MONTH_PER_YEAR              ((long)12)
+#define NUM_DAYS_PER_NONLEAP_YEAR       ((long)365)
+#define NUM_DAYS_PER_LEAP_YEAR          ((long)366)
+#define NUM_MONTHS_PER_CALENDAR_CYCLE   ((long)4800)
+
+
+enum {
+	CALENDAR_TIMER_UNIT_SECOND,
+	CALENDAR_TIMER_UNIT_DAY,
+	CALENDAR_TIMER_UNIT_MONTH,
+	CALENDAR_TIMER_UNIT_YEAR
+};
+
+
+/* A periodical timer (with the frequency unit converted from its name) together with the calendar and the start time
+   of the component model it belongs to. A timer whose frequency count is 0 is always on */
+struct Calendar_timer
+{
+	bool leap_year_on;
+	int unit;
+	int frequency_count;
+	int local_lag_count;
+	int start_year;
+	int start_month;
+	int start_day;
+	int start_second;
+	int start_num_elapsed_day;
+};
+
+
+/* The calendar arithmetic and the search of the times when a periodical timer is on do not depend on the other modules
+   of C-Coupler, so that they can also be built into standalone tests. A time is given as its year, month, day, second
+   of the day and number of elapsed days, which are all advanced together */
+extern int elapsed_days_on_start_of_month_of_nonleap_year[];
+extern int elapsed_days_on_start_of_month_of_leap_year[];
+extern int num_days_of_month_of_nonleap_year[];
+extern int num_days_of_month_of_leap_year[];
+
+extern bool calendar_is_leap_year(int);
+extern long calendar_calculate_elapsed_day(bool, int, int, int);
+extern void calendar_advance_time(bool, int &, int &, int &, int &, int &, int);
+extern void calendar_advance_time_by_seconds(bool, int &, int &, int &, int &, int &, long);
+extern bool calendar_is_timer_on(const Calendar_timer *, int, int, int, int, int);
+extern bool calendar_search_time_of_timer_on(const Calendar_timer *, int, int, int, int, int, int, long, bool, int &, int &, int &);
+extern bool calendar_search_time_of_timer_on_by_stepping(const Calendar_timer *, int, int, int, int, int, int, long, bool, int &, int &, int &);
+
+
+#endif
@@ -16,17 +16,27 @@
 #include <dirent.h>
 
 
-int elapsed_days_on_start_of_month_of_nonleap_year[] = {0, 31, 59, 90, 120, 151, 181, 212, 243, 273, 304, 334};
-int elapsed_days_on_start_of_month_of_leap_year[] = {0, 31, 60, 91, 121, 152, 182, 213, 244, 274, 305, 335};
-int num_days_of_month_of_nonleap_year[] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
-int num_days_of_month_of_leap_year[] = {31, 29, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+static int get_calendar_timer_unit(const char *frequency_unit)
+{
+	if (IS_TIME_UNIT_SECOND(frequency_unit))
+		return CALENDAR_TIMER_UNIT_SECOND;
+	if (IS_TIME_UNIT_DAY(frequency_unit))
+		return CALENDAR_TIMER_UNIT_DAY;
+	if (IS_TIME_UNIT_MONTH(frequency_unit))
+		return CALENDAR_TIMER_UNIT_MONTH;
+	if (IS_TIME_UNIT_YEAR(frequency_unit))
+		return CALENDAR_TIMER_UNIT_YEAR;
+
+	EXECUTION_REPORT(REPORT_ERROR, -1, false, "C-Coupler software error: frequency unit %s is unsupported\n", frequency_unit);
+	return -1;
+}
 
 
 bool common_is_timer_on(const char *frequency_unit, int frequency_count, int local_lag_count, int current_year,
                         int current_month, int current_day, int current_second, int current_num_elapsed_day,
                         int start_year, int start_month, int start_day, int start_second, int start_num_elapsed_day)
 {
-	long num_elapsed_time;
+	Calendar_timer timer;
 
 
 	if (frequency_count == 0) {
@@ -35,27 +45,17 @@ bool common_is_timer_on(const char *frequency_unit, int frequency_count, int loc
 	}
 	EXECUTION_REPORT_ERROR_OPTIONALLY(REPORT_ERROR, -1, frequency_count > 0, "C-Coupler software error: the frequency count must be larger than 0\n");
 
-	if (IS_TIME_UNIT_SECOND(frequency_unit)) {
-		num_elapsed_time = ((long)(current_num_elapsed_day - start_num_elapsed_day)) * SECONDS_PER_DAY + current_second - start_second;
-	}
-	else if (IS_TIME_UNIT_DAY(frequency_unit)) {
-		if (current_second != 0)
-			return false;
-		num_elapsed_time = current_num_elapsed_day - start_num_elapsed_day;
-	}
-	else if (IS_TIME_UNIT_MONTH(frequency_unit)) {
-		if (current_second != 0 || current_day != 1)
-			return false;
-		num_elapsed_time = (current_year - start_year) * NUM_MONTH_PER_YEAR + current_month - start_month;
-	}
-	else if (IS_TIME_UNIT_YEAR(frequency_unit)) {
-		if (current_second != 0 || current_day != 1 || current_month != 1)
-			return false;
-		num_elapsed_time = current_year - start_year;
-	}
-	else EXECUTION_REPORT(REPORT_ERROR, -1, false, "C-Coupler software error: frequency unit %s is unsupported\n", frequency_unit);
+	timer.leap_year_on = false;
+	timer.unit = get_calendar_timer_unit(frequency_unit);
+	timer.frequency_count = frequency_count;
+	timer.local_lag_count = local_lag_count;
+	timer.start_year = start_year;
+	timer.start_month = start_month;
+	timer.start_day = start_day;
+	timer.start_second = start_second;
+	timer.start_num_elapsed_day = start_num_elapsed_day;
 
-	return num_elapsed_time >= local_lag_count && ((num_elapsed_time - local_lag_count) % frequency_count) == 0;
+	return calendar_is_timer_on(&timer, current_year, current_month, current_day, current_second, current_num_elapsed_day);
 }
 
 
@@ -140,17 +140,43 @@ bool Periodical_timer::is_timer_on(int current_year, int current_month, int curr
 }
 
 
+void Periodical_timer::get_calendar_timer(Time_mgt *time_mgr, Calendar_timer *timer)
+{
+	timer->leap_year_on = time_mgr->get_is_leap_year_on();
+	timer->unit = frequency_count == 0? CALENDAR_TIMER_UNIT_SECOND : get_calendar_timer_unit(frequency_unit);
+	timer->frequency_count = frequency_count;
+	timer->local_lag_count = local_lag_count;
+	timer->start_year = time_mgr->get_start_year();
+	timer->start_month = time_mgr->get_start_month();
+	timer->start_day = time_mgr->get_start_day();
+	timer->start_second = time_mgr->get_start_second();
+	timer->start_num_elapsed_day = time_mgr->get_start_num_elapsed_day();
+}
+
+
+/* The next time when the timer is on is searched in closed form, while stepping is only the fallback when the search is given up */
 void Periodical_timer::get_time_of_next_timer_on(Time_mgt *time_mgr, int current_year, int current_month, int current_day, int current_second, int current_num_elapsed_days, int time_step_in_second, int &next_timer_num_elapsed_days, int &next_timer_date, int &next_timer_second, bool advance)
 {
+	Calendar_timer timer;
+
+
+	EXECUTION_REPORT(REPORT_ERROR, -1, time_step_in_second > 0, "Software error in Periodical_timer::get_time_of_next_timer_on: the time step is not positive");
 	if (advance)
 		time_mgr->advance_time(current_year, current_month, current_day, current_second, current_num_elapsed_days, time_step_in_second);
-	while (!is_timer_on(current_year, current_month, current_day, current_second, current_num_elapsed_days, time_mgr->get_start_year(),
-	                    time_mgr->get_start_month(), time_mgr->get_start_day(), time_mgr->get_start_second(), time_mgr->get_start_num_elapsed_day()))
-		time_mgr->advance_time(current_year, current_month, current_day, current_second, current_num_elapsed_days, time_step_in_second);
+	get_calendar_timer(time_mgr, &timer);
+	if (!calendar_search_time_of_timer_on(&timer, current_year, current_month, current_day, current_second, current_num_elapsed_days, time_step_in_second, -1, false, next_timer_num_elapsed_days, next_timer_date, next_timer_second))
+		calendar_search_time_of_timer_on_by_stepping(&timer, current_year, current_month, current_day, current_second, current_num_elapsed_days, time_step_in_second, -1, false, next_timer_num_elapsed_days, next_timer_date, next_timer_second);
+}
+
 
-	next_timer_num_elapsed_days = current_num_elapsed_days;
-	next_timer_date = current_year * 10000 + current_month * 100 + current_day;
-	next_timer_second = current_second;
+bool Periodical_timer::get_time_of_last_timer_on(Time_mgt *time_mgr, int current_year, int current_month, int current_day, int current_second, int current_num_elapsed_days, int time_step_in_second, long num_steps, int &last_timer_num_elapsed_days, int &last_timer_date, int &last_timer_second)
+{
+	Calendar_timer timer;
+
+
+	EXECUTION_REPORT(REPORT_ERROR, -1, time_step_in_second > 0, "Software error in Periodical_timer::get_time_of_last_timer_on: the time step is not positive");
+	get_calendar_timer(time_mgr, &timer);
+	return calendar_search_time_of_timer_on(&timer, current_year, current_month, current_day, current_second, current_num_elapsed_days, time_step_in_second, num_steps, true, last_timer_num_elapsed_days, last_timer_date, last_timer_second);
 }
 
 
@@ -627,15 +653,15 @@ bool Coupling_timer::is_timer_on(int current_year, int current_month, int curren
 
 void Coupling_timer::get_time_of_next_timer_on(Time_mgt *time_mgr, int current_year, int current_month, int current_day, int current_second, int current_num_elapsed_days, int time_step_in_second, int &next_timer_num_elapsed_days, int &next_timer_date, int &next_timer_second, bool advance)
 {
-	if (advance)
-		time_mgr->advance_time(current_year, current_month, current_day, current_second, current_num_elapsed_days, time_step_in_second);
-	while (!is_timer_on(current_year, current_month, current_day, current_second, current_num_elapsed_days, time_mgr->get_start_year(),
-	                    time_mgr->get_start_month(), time_mgr->get_start_day(), time_mgr->get_start_second(), time_mgr->get_start_num_elapsed_day()))
-		time_mgr->advance_time(current_year, current_month, current_day, current_second, current_num_elapsed_days, time_step_in_second);
+	EXECUTION_REPORT_ERROR_OPTIONALLY(REPORT_ERROR, -1, periodical_timer != NULL && time_slots_points == NULL && children_coupling_timers.size() == 0, "Software error in Coupling_timer::get_time_of_next_timer_on");
+	periodical_timer->get_time_of_next_timer_on(time_mgr, current_year, current_month, current_day, current_second, current_num_elapsed_days, time_step_in_second, next_timer_num_elapsed_days, next_timer_date, next_timer_second, advance);
+}
 
-	next_timer_num_elapsed_days = current_num_elapsed_days;
-	next_timer_date = current_year * 10000 + current_month * 100 + current_day;
-	next_timer_second = current_second;
+
+bool Coupling_timer::get_time_of_last_timer_on(Time_mgt *time_mgr, int current_year, int current_month, int current_day, int current_second, int current_num_elapsed_days, int time_step_in_second, long num_steps, int &last_timer_num_elapsed_days, int &last_timer_date, int &last_timer_second)
+{
+	EXECUTION_REPORT_ERROR_OPTIONALLY(REPORT_ERROR, -1, periodical_timer != NULL && time_slots_points == NULL && children_coupling_timers.size() == 0, "Software error in Coupling_timer::get_time_of_last_timer_on");
+	return periodical_timer->get_time_of_last_timer_on(time_mgr, current_year, current_month, current_day, current_second, current_num_elapsed_days, time_step_in_second, num_steps, last_timer_num_elapsed_days, last_timer_date, last_timer_second);
 }
 
 
@@ -1005,12 +1031,67 @@ Time_mgt::Time_mgt(int comp_id, const char *XML_file_name, bool is_for_root_comp
 			}
 			EXECUTION_REPORT_LOG(REPORT_LOG, -1, true, "The stop time generated by C-Coupler according to the users' specification is %04d%02d%02d-%05d", stop_year, stop_month, stop_day, stop_second);
 		}
+		const char *max_trans_message_size_str = get_XML_attribute(-1, CCPL_NAME_STR_LEN, XML_element, "max_trans_message_size", XML_file_name, line_number, "maximum size (in MB) of each MPI message for transferring coupling fields", "the overall parameters to run the model", false);
+		if (max_trans_message_size_str != NULL) {
+			int max_trans_message_size;
+			EXECUTION_REPORT(REPORT_ERROR, -1, is_string_decimal_number(max_trans_message_size_str) && sscanf(max_trans_message_size_str, "%d", &max_trans_message_size) == 1 && max_trans_message_size > 0 && max_trans_message_size < 2048, "Error happens when using the XML configuration file \"%s\": the value (\"%s\") of the attribute \"max_trans_message_size\" is not an integer between 1 and 2047 (in MB). Please verify the XML file around the line %d", XML_file_name, max_trans_message_size_str, line_number);
+			comp_comm_group_mgt_mgr->set_max_trans_message_size(((long)max_trans_message_size)*1024*1024);
+		}
+		EXECUTION_REPORT_LOG(REPORT_LOG, -1, true, "max_trans_message_size is %ld bytes", comp_comm_group_mgt_mgr->get_max_trans_message_size());
+		const char *num_remap_weights_threads_str = get_XML_attribute(-1, CCPL_NAME_STR_LEN, XML_element, "num_remap_weights_threads", XML_file_name, line_number, "number of threads of each process for calculating remapping weights", "the overall parameters to run the model", false);
+		if (num_remap_weights_threads_str != NULL) {
+			int num_remap_weights_threads;
+			EXECUTION_REPORT(REPORT_ERROR, -1, is_string_decimal_number(num_remap_weights_threads_str) && sscanf(num_remap_weights_threads_str, "%d", &num_remap_weights_threads) == 1 && num_remap_weights_threads > 0 && num_remap_weights_threads <= 256, "Error happens when using the XML configuration file \"%s\": the value (\"%s\") of the attribute \"num_remap_weights_threads\" is not an integer between 1 and 256. Please verify the XML file around the line %d", XML_file_name, num_remap_weights_threads_str, line_number);
+			comp_comm_group_mgt_mgr->set_num_remap_weights_threads(num_remap_weights_threads);
+		}
+		EXECUTION_REPORT_LOG(REPORT_LOG, -1, true, "num_remap_weights_threads is %d", comp_comm_group_mgt_mgr->get_num_remap_weights_threads());
+		const char *remapping_weights_cache_str = get_XML_attribute(-1, CCPL_NAME_STR_LEN, XML_element, "remapping_weights_cache", XML_file_name, line_number, "whether the local parallel remapping weights of each process are cached on disk for later runs", "the overall parameters to run the model", false);
+		if (remapping_weights_cache_str != NULL) {
+			EXECUTION_REPORT(REPORT_ERROR, -1, words_are_the_same(remapping_weights_cache_str, "on") || words_are_the_same(remapping_weights_cache_str, "off"), "Error happens when using the XML configuration file \"%s\": the value (\"%s\") of the attribute \"remapping_weights_cache\" must be \"on\" or \"off\". Please verify the XML file around the line %d", XML_file_name, remapping_weights_cache_str, line_number);
+			comp_comm_group_mgt_mgr->set_remapping_weights_cache_enabled(words_are_the_same(remapping_weights_cache_str, "on"));
+		}
+		EXECUTION_REPORT_LOG(REPORT_LOG, -1, true, "remapping_weights_cache is %s", comp_comm_group_mgt_mgr->get_remapping_weights_cache_enabled()? "on" : "off");
+		const char *routing_info_cache_str = get_XML_attribute(-1, CCPL_NAME_STR_LEN, XML_element, "routing_info_cache", XML_file_name, line_number, "whether the routing information of data transfer between components is cached on disk for later runs", "the overall parameters to run the model", false);
+		if (routing_info_cache_str != NULL) {
+			EXECUTION_REPORT(REPORT_ERROR, -1, words_are_the_same(routing_info_cache_str, "on") || words_are_the_same(routing_info_cache_str, "off"), "Error happens when using the XML configuration file \"%s\": the value (\"%s\") of the attribute \"routing_info_cache\" must be \"on\" or \"off\". Please verify the XML file around the line %d", XML_file_name, routing_info_cache_str, line_number);
+			comp_comm_group_mgt_mgr->set_routing_info_cache_enabled(words_are_the_same(routing_info_cache_str, "on"));
+		}
+		EXECUTION_REPORT_LOG(REPORT_LOG, -1, true, "routing_info_cache is %s", comp_comm_group_mgt_mgr->get_routing_info_cache_enabled()? "on" : "off");
+		const char *performance_trace_str = get_XML_attribute(-1, CCPL_NAME_STR_LEN, XML_element, "performance_trace", XML_file_name, line_number, "whether the start and stop events of performance timing are traced and dumped at the end of the run", "the overall parameters to run the model", false);
+		if (performance_trace_str != NULL) {
+			EXECUTION_REPORT(REPORT_ERROR, -1, words_are_the_same(performance_trace_str, "on") || words_are_the_same(performance_trace_str, "off"), "Error happens when using the XML configuration file \"%s\": the value (\"%s\") of the attribute \"performance_trace\" must be \"on\" or \"off\". Please verify the XML file around the line %d", XML_file_name, performance_trace_str, line_number);
+			comp_comm_group_mgt_mgr->set_performance_trace_enabled(words_are_the_same(performance_trace_str, "on"));
+		}
+		EXECUTION_REPORT_LOG(REPORT_LOG, -1, true, "performance_trace is %s", comp_comm_group_mgt_mgr->get_performance_trace_enabled()? "on" : "off");
+		const char *restart_write_async_str = get_XML_attribute(-1, CCPL_NAME_STR_LEN, XML_element, "restart_write_async", XML_file_name, line_number, "whether the restarted fields are staged at the restart time step and written into the restart data files at the following time steps", "the overall parameters to run the model", false);
+		if (restart_write_async_str != NULL) {
+			EXECUTION_REPORT(REPORT_ERROR, -1, words_are_the_same(restart_write_async_str, "on") || words_are_the_same(restart_write_async_str, "off"), "Error happens when using the XML configuration file \"%s\": the value (\"%s\") of the attribute \"restart_write_async\" must be \"on\" or \"off\". Please verify the XML file around the line %d", XML_file_name, restart_write_async_str, line_number);
+			comp_comm_group_mgt_mgr->set_restart_write_async_enabled(words_are_the_same(restart_write_async_str, "on"));
+		}
+		EXECUTION_REPORT_LOG(REPORT_LOG, -1, true, "restart_write_async is %s", comp_comm_group_mgt_mgr->get_restart_write_async_enabled()? "on" : "off");
+		const char *H2D_subdomain_load_balance_str = get_XML_attribute(-1, CCPL_NAME_STR_LEN, XML_element, "H2D_subdomain_load_balance", XML_file_name, line_number, "whether the subdomains for distributed generation of H2D remapping weights are assigned to processes according to their estimated workloads", "the overall parameters to run the model", false);
+		if (H2D_subdomain_load_balance_str != NULL) {
+			EXECUTION_REPORT(REPORT_ERROR, -1, words_are_the_same(H2D_subdomain_load_balance_str, "on") || words_are_the_same(H2D_subdomain_load_balance_str, "off"), "Error happens when using the XML configuration file \"%s\": the value (\"%s\") of the attribute \"H2D_subdomain_load_balance\" must be \"on\" or \"off\". Please verify the XML file around the line %d", XML_file_name, H2D_subdomain_load_balance_str, line_number);
+			comp_comm_group_mgt_mgr->set_H2D_subdomain_load_balance_enabled(words_are_the_same(H2D_subdomain_load_balance_str, "on"));
+		}
+		EXECUTION_REPORT_LOG(REPORT_LOG, -1, true, "H2D_subdomain_load_balance is %s", comp_comm_group_mgt_mgr->get_H2D_subdomain_load_balance_enabled()? "on" : "off");
 #ifdef USE_PARALLEL_IO
 		int max_num_pio_proc;
 		const char *pio_max_num_proc_str = get_XML_attribute(-1, CCPL_NAME_STR_LEN, XML_element, "max_num_pio_proc", XML_file_name, line_number, "maximum number of processes for handling parallel I/O", "the overall parameters to run the model", true);
 		EXECUTION_REPORT(REPORT_ERROR, -1, sscanf(pio_max_num_proc_str, "%d", &max_num_pio_proc) == 1 && max_num_pio_proc > 0, "Error happens when configuring parallel I/O : the value (currently is \"%s\") of the XML attribute \"max_num_pio_proc\" is not a positive integer. Please verify the XML configuration file \"%s\".", pio_max_num_proc_str, XML_file_name);
 		comp_comm_group_mgt_mgr->set_max_num_of_PIO_procs(max_num_pio_proc);
 		EXECUTION_REPORT_LOG(REPORT_LOG, -1, true, "max_num_pio_proc is %d", max_num_pio_proc);
+		const char *asynchronous_output_str = get_XML_attribute(-1, CCPL_NAME_STR_LEN, XML_element, "asynchronous_output", XML_file_name, line_number, "whether the parallel I/O processes write the output files in the background", "the overall parameters to run the model", false);
+		if (asynchronous_output_str != NULL) {
+			EXECUTION_REPORT(REPORT_ERROR, -1, words_are_the_same(asynchronous_output_str, "on") || words_are_the_same(asynchronous_output_str, "off"), "Error happens when using the XML configuration file \"%s\": the value (\"%s\") of the attribute \"asynchronous_output\" must be \"on\" or \"off\". Please verify the XML file around the line %d", XML_file_name, asynchronous_output_str, line_number);
+			if (words_are_the_same(asynchronous_output_str, "on")) {
+				int MPI_thread_level;
+				MPI_Query_thread(&MPI_thread_level);
+				EXECUTION_REPORT(REPORT_WARNING, -1, MPI_thread_level == MPI_THREAD_MULTIPLE, "The asynchronous output specified in the XML configuration file \"%s\" is disabled, because MPI is not initialized with the thread support level MPI_THREAD_MULTIPLE (C-Coupler requests it when initializing MPI, while a model that initializes MPI itself should call MPI_Init_thread with MPI_THREAD_MULTIPLE) or the MPI library does not provide it", XML_file_name);
+				comp_comm_group_mgt_mgr->set_asynchronous_output(MPI_thread_level == MPI_THREAD_MULTIPLE);
+			}
+		}
+		EXECUTION_REPORT_LOG(REPORT_LOG, -1, true, "asynchronous_output is %s", comp_comm_group_mgt_mgr->get_asynchronous_output()? "on" : "off");
 #endif
 	}
 
@@ -1074,23 +1155,9 @@ int Time_mgt::get_current_num_days_in_year()
 
 long Time_mgt::calculate_elapsed_day(int year, int month, int day)
 {
-	int num_leap_year;
-
-
 	check_is_time_legal(year, month, day, 0, "(at calculate_elapsed_day)");
 
-	if (!leap_year_on)
-		return year * NUM_DAYS_PER_NONLEAP_YEAR + elapsed_days_on_start_of_month_of_nonleap_year[month - 1] + day - 1;
-
-	num_leap_year = (year - 1) / 4 - (year - 1) / 100 + (year - 1) / 400;
-
-	if (year > 0)
-		num_leap_year ++;   // year 0 is a leap year
-
-	if (is_a_leap_year(year))
-		return year * NUM_DAYS_PER_NONLEAP_YEAR + num_leap_year + elapsed_days_on_start_of_month_of_leap_year[month - 1] + day - 1;
-
-	return year * NUM_DAYS_PER_NONLEAP_YEAR + num_leap_year + elapsed_days_on_start_of_month_of_nonleap_year[month - 1] + day - 1;
+	return calendar_calculate_elapsed_day(leap_year_on, year, month, day);
 }
 
 
@@ -1106,29 +1173,19 @@ long Time_mgt::get_elapsed_day_from_full_time(long full_time)
 
 void Time_mgt::advance_time(int &current_year, int &current_month, int &current_day, int &current_second, int &current_num_elapsed_day, int time_step_in_second)
 {
-	int i, num_days_in_current_month;
+	if (&current_year == &(this->current_year))
+		time_has_been_advanced = true;
+	calendar_advance_time(leap_year_on, current_year, current_month, current_day, current_second, current_num_elapsed_day, time_step_in_second);
+	//datamodel_mgr->handle_implicit_output("handle all implicit handlers for datamodel");
+}
 
 
+/* Equivalent to advancing the time step by step, but skips whole years and months at once */
+void Time_mgt::advance_time_by_seconds(int &current_year, int &current_month, int &current_day, int &current_second, int &current_num_elapsed_day, long num_seconds)
+{
 	if (&current_year == &(this->current_year))
 		time_has_been_advanced = true;
-	current_second += time_step_in_second;
-	for (i = 0; i < current_second / SECONDS_PER_DAY; i ++) {
-		current_num_elapsed_day ++;
-		if (leap_year_on && is_a_leap_year(current_year))
-			num_days_in_current_month = num_days_of_month_of_leap_year[current_month - 1];
-		else num_days_in_current_month = num_days_of_month_of_nonleap_year[current_month - 1];
-		current_day ++;
-		if (current_day > num_days_in_current_month) {
-			current_month ++;
-			current_day = 1;
-		}
-		if (current_month > 12) {
-			current_month = 1;
-			current_year ++;
-		}
-	}
-	current_second = current_second % SECONDS_PER_DAY;
-	//datamodel_mgr->handle_implicit_output("handle all implicit handlers for datamodel");
+	calendar_advance_time_by_seconds(leap_year_on, current_year, current_month, current_day, current_second, current_num_elapsed_day, num_seconds);
 }
 
 
@@ -1461,7 +1518,7 @@ bool Time_mgt::set_time_step_in_second(int time_step_in_second, const char *anno
 
 bool Time_mgt::is_a_leap_year(int year)
 {
-	return ((year % 4) == 0 && (year % 100) != 0) || (year % 400) == 0;
+	return calendar_is_leap_year(year);
 }
 
 
@@ -45,11 +45,6 @@
 #define RUNTYPE_BRANCH                  "branch"
 #define RUNTYPE_HYBRID                  "hybrid"
 
-#define SECONDS_PER_DAY                 ((long)86400)
-#define NUM_MONTH_PER_YEAR              ((long)12)
-#define NUM_DAYS_PER_NONLEAP_YEAR       ((long)365)
-#define NUM_DAYS_PER_LEAP_YEAR          ((long)366)
-
 
 #define IS_TIME_UNIT_STEP(unit)         (words_are_the_same(unit,FREQUENCY_UNIT_STEP) || words_are_the_same(unit,FREQUENCY_UNIT_STEPS) || words_are_the_same(unit,FREQUENCY_UNIT_NSTEP) || words_are_the_same(unit,FREQUENCY_UNIT_NSTEPS))
 #define IS_TIME_UNIT_SECOND(unit)       (words_are_the_same(unit,FREQUENCY_UNIT_SECOND) || words_are_the_same(unit,FREQUENCY_UNIT_SECONDS) || words_are_the_same(unit,FREQUENCY_UNIT_NSECOND) || words_are_the_same(unit,FREQUENCY_UNIT_NSECONDS))
@@ -75,6 +70,7 @@
 
 
 #include "common_utils.h"
+#include "timer_calendar_kernels.h"
 #include <vector>
 
 
@@ -124,6 +120,8 @@ private:
     int comp_id;
     Time_mgt *comp_time_mgr;
 
+    void get_calendar_timer(Time_mgt *, Calendar_timer *);
+
 public:
     Periodical_timer(int, int, const char*, int, int, int, const char*);
     Periodical_timer(int, int, Periodical_timer*);
@@ -139,6 +137,7 @@ public:
     const char *get_frequency_unit() { return frequency_unit; }
     void write_timer_into_array(char **, long &, long &);
     void get_time_of_next_timer_on(Time_mgt *, int, int, int, int, int, int, int &, int &, int &, bool);
+    bool get_time_of_last_timer_on(Time_mgt *, int, int, int, int, int, int, long, int &, int &, int &);
     void reset_remote_lag_count() { remote_lag_count = 0; }
     bool is_the_same_with(Periodical_timer *);
 };
@@ -198,6 +197,7 @@ public:
     const char *get_frequency_unit();
     void write_timer_into_array(char **, long &, long &);
     void get_time_of_next_timer_on(Time_mgt *, int, int, int, int, int, int, int &, int &, int &, bool);
+    bool get_time_of_last_timer_on(Time_mgt *, int, int, int, int, int, int, long, int &, int &, int &);
     void reset_remote_lag_count();
     bool is_the_same_with(Coupling_timer *);
     void add_child_coupling_timer(Coupling_timer *, const char *);
@@ -283,6 +283,7 @@ public:
     void initialize_to_start_time();
     void advance_model_time(const char*, bool);
     void advance_time(int &, int &, int &, int &, int &, int);
+    void advance_time_by_seconds(int &, int &, int &, int &, int &, long);
     int get_current_year() { return current_year; }
     int get_current_month() { return current_month; }
     int get_current_day() { return current_day; }
@@ -369,8 +370,4 @@ public:
 };
 
 
-extern int num_days_of_month_of_nonleap_year[];
-extern int num_days_of_month_of_leap_year[];
-
-
 #endif
@@ -717,6 +717,14 @@ Comp_comm_group_mgt_mgr::Comp_comm_group_mgt_mgr(const char *executable_name)
     CCPL_platform_log_dir[0] = '\0';
     log_buffer = NULL; 
 	max_num_of_PIO_procs = -1;
+	max_trans_message_size = DEFAULT_MAX_TRANS_MESSAGE_SIZE;
+	asynchronous_output = false;
+	num_remap_weights_threads = 1;
+	remapping_weights_cache_enabled = false;
+	routing_info_cache_enabled = false;
+	performance_trace_enabled = false;
+	restart_write_async_enabled = false;
+	H2D_subdomain_load_balance_enabled = false;
     EXECUTION_REPORT(REPORT_ERROR, -1, getcwd(root_working_dir,NAME_STR_SIZE) != NULL, 
                      "Cannot get the current working directory for running the model");
 
@@ -742,6 +750,8 @@ Comp_comm_group_mgt_mgr::Comp_comm_group_mgt_mgr(const char *executable_name)
     create_directory(temp_string, MPI_COMM_WORLD, current_proc_global_id == 0, true, false);
     sprintf(temp_string, "%s/CCPL_dir/run/CCPL_logs/by_components", root_working_dir);
     create_directory(temp_string, MPI_COMM_WORLD, current_proc_global_id == 0, false, false);
+    sprintf(performance_trace_dir, "%s/CCPL_dir/run/CCPL_logs/performance_traces", root_working_dir);
+    create_directory(performance_trace_dir, MPI_COMM_WORLD, current_proc_global_id == 0, false, false);
     sprintf(temp_string, "%s/CCPL_dir/run/data", root_working_dir);
     create_directory(temp_string, MPI_COMM_WORLD, current_proc_global_id == 0, false, false);
 	sprintf(external_procedure_lib_dir, "%s/CCPL_dir/libs/external_procedures/", root_working_dir);
@@ -753,6 +763,10 @@ Comp_comm_group_mgt_mgr::Comp_comm_group_mgt_mgr(const char *executable_name)
     create_directory(internal_H2D_grids_dir, MPI_COMM_WORLD, current_proc_global_id == 0, true, false);
     sprintf(internal_remapping_weights_dir, "%s/CCPL_dir/run/data/all/internal_remapping_weights", root_working_dir);
     create_directory(internal_remapping_weights_dir, MPI_COMM_WORLD, current_proc_global_id == 0, false, false);
+    sprintf(remapping_weights_cache_dir, "%s/CCPL_dir/run/data/all/remapping_weights_cache", root_working_dir);
+    create_directory(remapping_weights_cache_dir, MPI_COMM_WORLD, current_proc_global_id == 0, false, false);
+    sprintf(routing_info_cache_dir, "%s/CCPL_dir/run/data/all/routing_info_cache", root_working_dir);
+    create_directory(routing_info_cache_dir, MPI_COMM_WORLD, current_proc_global_id == 0, false, false);
     sprintf(components_processes_dir, "%s/CCPL_dir/run/data/all/components_processes", root_working_dir);
     create_directory(components_processes_dir, MPI_COMM_WORLD, current_proc_global_id == 0, true, false);
     sprintf(components_exports_dir, "%s/CCPL_dir/run/data/all/components_exports", root_working_dir);
@@ -1329,8 +1343,19 @@ void Comp_comm_group_mgt_mgr::output_log(const char *log_string, bool flush_log_
 void Comp_comm_group_mgt_mgr::output_performance_timing()
 {
     for (int i = 0; i < global_node_array.size(); i ++)
-        if (global_node_array[i]->is_real_component_model() && global_node_array[i]->get_performance_timing_mgr() != NULL)
+        if (global_node_array[i]->is_real_component_model() && global_node_array[i]->get_performance_timing_mgr() != NULL) {
             global_node_array[i]->get_performance_timing_mgr()->performance_timing_output();
+            if (performance_trace_enabled)
+                global_node_array[i]->get_performance_timing_mgr()->performance_trace_output();
+        }
+}
+
+
+void Comp_comm_group_mgt_mgr::finish_restart_writes()
+{
+    for (int i = 0; i < global_node_array.size(); i ++)
+        if (global_node_array[i]->is_real_component_model() && global_node_array[i]->get_restart_mgr() != NULL)
+            global_node_array[i]->get_restart_mgr()->finish_restart_write();
 }
 
 
@@ -35,6 +35,7 @@
 #define DATAMODEL_NAME_PREFIX      "DATA_MODEL"
 #define DATAINST_NAME_PREFIX       "DATA_INST"
 #define ALGMODEL_NAME_PREFIX       "ALGORITHM_MODEL"
+#define DEFAULT_MAX_TRANS_MESSAGE_SIZE  ((long)256*1024*1024)
 
 
 class Comp_comm_group_mgt_node
@@ -149,6 +150,9 @@ class Comp_comm_group_mgt_mgr
         char root_working_dir[NAME_STR_SIZE];
         char internal_H2D_grids_dir[NAME_STR_SIZE];
 		char internal_remapping_weights_dir[NAME_STR_SIZE];
+		char remapping_weights_cache_dir[NAME_STR_SIZE];
+		char routing_info_cache_dir[NAME_STR_SIZE];
+		char performance_trace_dir[NAME_STR_SIZE];
         char components_processes_dir[NAME_STR_SIZE];
         char components_exports_dir[NAME_STR_SIZE];
         char active_coupling_connections_dir[NAME_STR_SIZE];
@@ -165,6 +169,14 @@ class Comp_comm_group_mgt_mgr
         char *log_buffer;
         int log_buffer_content_size;
 		int max_num_of_PIO_procs;
+		long max_trans_message_size;
+		bool asynchronous_output;
+		int num_remap_weights_threads;
+		bool remapping_weights_cache_enabled;
+		bool routing_info_cache_enabled;
+		bool performance_trace_enabled;
+		bool restart_write_async_enabled;
+		bool H2D_subdomain_load_balance_enabled;
 
     public:
         Comp_comm_group_mgt_mgr(const char*);
@@ -176,6 +188,22 @@ class Comp_comm_group_mgt_mgr
         bool is_legal_local_comp_id(int, bool);
 		void set_max_num_of_PIO_procs(int proc_num) { this->max_num_of_PIO_procs = proc_num; }
 		int get_max_num_of_PIO_procs() { return max_num_of_PIO_procs; }
+		void set_max_trans_message_size(long size) { this->max_trans_message_size = size; }
+		long get_max_trans_message_size() { return max_trans_message_size; }
+		void set_asynchronous_output(bool asynchronous_output) { this->asynchronous_output = asynchronous_output; }
+		bool get_asynchronous_output() { return asynchronous_output; }
+		void set_num_remap_weights_threads(int num_threads) { this->num_remap_weights_threads = num_threads; }
+		int get_num_remap_weights_threads() { return num_remap_weights_threads; }
+		void set_remapping_weights_cache_enabled(bool enabled) { this->remapping_weights_cache_enabled = enabled; }
+		bool get_remapping_weights_cache_enabled() { return remapping_weights_cache_enabled; }
+		void set_routing_info_cache_enabled(bool enabled) { this->routing_info_cache_enabled = enabled; }
+		bool get_routing_info_cache_enabled() { return routing_info_cache_enabled; }
+		void set_performance_trace_enabled(bool enabled) { this->performance_trace_enabled = enabled; }
+		bool get_performance_trace_enabled() { return performance_trace_enabled; }
+		void set_restart_write_async_enabled(bool enabled) { this->restart_write_async_enabled = enabled; }
+		bool get_restart_write_async_enabled() { return restart_write_async_enabled; }
+		void set_H2D_subdomain_load_balance_enabled(bool enabled) { this->H2D_subdomain_load_balance_enabled = enabled; }
+		bool get_H2D_subdomain_load_balance_enabled() { return H2D_subdomain_load_balance_enabled; }
         void transform_global_node_tree_into_array(Comp_comm_group_mgt_node*, Comp_comm_group_mgt_node**, int&);
         Comp_comm_group_mgt_node *get_global_node_of_local_comp(int, bool, const char*);
         MPI_Comm get_comm_group_of_local_comp(int, const char*);
@@ -195,6 +223,9 @@ class Comp_comm_group_mgt_mgr
         const char *get_root_working_dir() { return root_working_dir; }
         const char *get_internal_H2D_grids_dir() { return internal_H2D_grids_dir; }
 		const char *get_internal_remapping_weights_dir() { return internal_remapping_weights_dir; }
+		const char *get_remapping_weights_cache_dir() { return remapping_weights_cache_dir; }
+		const char *get_routing_info_cache_dir() { return routing_info_cache_dir; }
+		const char *get_performance_trace_dir() { return performance_trace_dir; }
         const char *get_components_processes_dir() { return components_processes_dir; }
         const char *get_components_exports_dir() { return components_exports_dir; }
         const char *get_active_coupling_connections_dir() { return active_coupling_connections_dir; }
@@ -219,6 +250,7 @@ class Comp_comm_group_mgt_mgr
         void output_log(const char *, bool);
         const char *get_exe_log_file_name() { return exe_log_file_name; }        
         void output_performance_timing();
+        void finish_restart_writes();
         bool does_comp_name_include_reserved_prefix(const char *);
 		int get_num_members_in_ensemble_set(Comp_comm_group_mgt_node *, Comp_comm_group_mgt_node *);	
 		void load_comp_info_of_ensemble(std::vector<Comp_comm_group_mgt_node *> &, int, const char *, int, MPI_Comm, int);
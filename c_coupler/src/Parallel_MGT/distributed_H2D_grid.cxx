@@ -12,6 +12,9 @@
 #include "triangulation.h"
 #include "remap_utils_nearest_points.h"
 #include <math.h>
+#include <queue>
+#include <algorithm>
+#include <functional>
 
 
 void Distributed_H2D_grid_engine::initialize_data(const char *comp_full_name, const char *grid_name, long global_grid_size, int num_lons, int num_lats, Remap_grid_class *CoR_grid_initialization, Original_grid_info *original_grid)
@@ -346,6 +349,7 @@ Remapping_grid_domain_decomp_engine::Remapping_grid_domain_decomp_engine(int src
 	this->num_southPole_subdomain = 0;
 	this->src_grid_one_sided_comm_data_buf = NULL;
 	this->dst_grid_one_sided_comm_data_buf = NULL;
+	this->subdomains_expansion_time = 0;
 
 	whole_domain_lat_diff = whole_domain_max_lat - whole_domain_min_lat;
 	if (whole_domain_min_lon < whole_domain_max_lon)
@@ -396,6 +400,7 @@ Remapping_grid_domain_decomp_engine::Remapping_grid_domain_decomp_engine(int src
 	num_total_subdomains = num_northPole_subdomain + num_southPole_subdomain + num_nonPole_region_x_subdomains*num_nonPole_region_y_subdomains;
 
 	EXECUTION_REPORT_LOG(REPORT_LOG, comp_id, true, "Decompose the common grid domain into %d (%d %d %dx%d) subdomains", num_total_subdomains, num_northPole_subdomain,num_southPole_subdomain,num_nonPole_region_x_subdomains, num_nonPole_region_y_subdomains);
+	assign_subdomains_to_procs(comp_node);
 	EXECUTION_REPORT(REPORT_LOG, -1, true, "start to generate_subdomains_decomp_grid src");
 	src_subdomain_decomp_grid = generate_subdomains_decomp_grid(src_original_cor_grid, src_subdomains_CoR_grids);
 	dst_subdomain_decomp_grid = NULL;
@@ -427,17 +432,18 @@ Remapping_grid_domain_decomp_engine::Remapping_grid_domain_decomp_engine(int src
 	wtime(&time1);
 	src_grid_original_num_vertex = 4;
 	for (int i = 0; i < num_total_subdomains; i ++) {
-		if (i % num_total_procs == comp_node->get_current_proc_local_id()) {
+		if (get_subdomain_owner_proc_id(i) == comp_node->get_current_proc_local_id()) {
 			expand_subdomain_halo_grid(i, src_original_cor_grid, src_subdomains_CoR_grids, true);
-			if (src_subdomains_expanded_CoR_grids[i/num_total_procs] != NULL) {
-				EXECUTION_REPORT_ERROR_OPTIONALLY(REPORT_ERROR, -1, src_subdomains_expanded_CoR_grids[i/num_total_procs]->get_num_vertexes() > 0, "Software error in Remapping_grid_domain_decomp_engine::Remapping_grid_domain_decomp_engine");
+			if (src_subdomains_expanded_CoR_grids[get_subdomain_index_intra_owner_proc(i)] != NULL) {
+				EXECUTION_REPORT_ERROR_OPTIONALLY(REPORT_ERROR, -1, src_subdomains_expanded_CoR_grids[get_subdomain_index_intra_owner_proc(i)]->get_num_vertexes() > 0, "Software error in Remapping_grid_domain_decomp_engine::Remapping_grid_domain_decomp_engine");
 				if (report_error_enabled)
-					src_subdomains_expanded_CoR_grids[i/num_total_procs]->check_center_vertex_values_consistency_2D(true);
+					src_subdomains_expanded_CoR_grids[get_subdomain_index_intra_owner_proc(i)]->check_center_vertex_values_consistency_2D(true);
 			}
 		}
 	}	
 
 	wtime(&time2);
+	subdomains_expansion_time = time2 - time1;
 	EXECUTION_REPORT(REPORT_LOG, -1, true, "The time for expanding subdomains is %lf vs %lf", time2 - time3, time1-time3);
 
 	//destroy_grid_one_sided_comm_data_buf(true);
@@ -472,7 +478,7 @@ void Remapping_grid_domain_decomp_engine::initialize_subdomains_halo_info(Remap_
 	clear_subdomains_halo_info();
 
 	for (int i = 0; i < subdomains_CoR_grids.size(); i ++) {
-		EXECUTION_REPORT_ERROR_OPTIONALLY(REPORT_ERROR, -1, subdomains_CoR_grids[i].first%num_total_procs == comp_node->get_current_proc_local_id() && i == subdomains_CoR_grids[i].first/num_total_procs, "Software error in Remapping_grid_domain_decomp_engine::Remapping_grid_domain_decomp_engine");
+		EXECUTION_REPORT_ERROR_OPTIONALLY(REPORT_ERROR, -1, get_subdomain_owner_proc_id(subdomains_CoR_grids[i].first) == comp_node->get_current_proc_local_id() && i == get_subdomain_index_intra_owner_proc(subdomains_CoR_grids[i].first), "Software error in Remapping_grid_domain_decomp_engine::Remapping_grid_domain_decomp_engine");
 		subdomains_halo_num_levels.push_back(0);
 		std::vector<Remap_grid_class*> CoR_grids;
 		std::vector<int> subdomains_IDs;
@@ -482,7 +488,7 @@ void Remapping_grid_domain_decomp_engine::initialize_subdomains_halo_info(Remap_
 		subdomains_halo_lon_bounds.push_back(lon_lat_bounds);
 		subdomains_halo_lat_bounds.push_back(lon_lat_bounds);
 		src_subdomains_expanded_CoR_grids.push_back(NULL);
-		calculate_subdomain_halo_bounds(original_cor_grid, subdomains_CoR_grids[i].first, 0, subdomains_halo_lon_bounds[subdomains_CoR_grids[i].first/num_total_procs], subdomains_halo_lat_bounds[subdomains_CoR_grids[i].first/num_total_procs]); 
+		calculate_subdomain_halo_bounds(original_cor_grid, subdomains_CoR_grids[i].first, 0, subdomains_halo_lon_bounds[i], subdomains_halo_lat_bounds[i]); 
 	}
 }
 
@@ -519,8 +525,8 @@ void Remapping_grid_domain_decomp_engine::confirm_or_generate_grid_vertexes(Rema
 	write_data_into_array_buffer(subdomain_triangulation_info, subdomains_CoR_grids.size()*3*sizeof(int), &triangulation_comm_data_buf, triangulation_comm_data_buf_max_size, triangulation_comm_data_buf_content_size);
 	
 	for (int i = 0; i < num_total_subdomains; i ++) {
-		if (i % num_total_procs == comp_node->get_current_proc_local_id()) {
-			int subdomain_index_intra_proc = i / comp_node->get_num_procs();
+		if (get_subdomain_owner_proc_id(i) == comp_node->get_current_proc_local_id()) {
+			int subdomain_index_intra_proc = get_subdomain_index_intra_owner_proc(i);
 			subdomain_triangulation_info[subdomain_index_intra_proc*3+0] = i;
 			subdomain_triangulation_info[subdomain_index_intra_proc*3+1] = 0;
 			subdomain_triangulation_info[subdomain_index_intra_proc*3+2] = 0;
@@ -575,8 +581,8 @@ void Remapping_grid_domain_decomp_engine::check_halo_subdomain_triangulation_che
 
 	get_subdomain_halo_subdomains_IDs(original_cor_grid, local_subdomains_index[current_subdomain_index], 1, subdomain_halo_subdomain_IDs);
 	for(int halo_index = 0; halo_index < subdomain_halo_subdomain_IDs.size(); halo_index ++ ) {
-		remote_subdomain_owner_id = subdomain_halo_subdomain_IDs[halo_index] % comp_node->get_num_procs();
-		subdomain_index_intra_remote_process = subdomain_halo_subdomain_IDs[halo_index] / comp_node->get_num_procs();
+		remote_subdomain_owner_id = get_subdomain_owner_proc_id(subdomain_halo_subdomain_IDs[halo_index]);
+		subdomain_index_intra_remote_process = get_subdomain_index_intra_owner_proc(subdomain_halo_subdomain_IDs[halo_index]);
 		MPI_Win_lock(MPI_LOCK_SHARED, remote_subdomain_owner_id, 0, triangulation_comm_win);
 		MPI_Get(halo_subdomain_triangulation_info, sizeof(int)*3, MPI_CHAR, remote_subdomain_owner_id, subdomain_index_intra_remote_process*sizeof(int)*3, sizeof(int)*3, MPI_CHAR, triangulation_comm_win);
 		MPI_Win_unlock(remote_subdomain_owner_id, triangulation_comm_win);
@@ -766,12 +772,125 @@ int Remapping_grid_domain_decomp_engine::calculate_grid_point_subdomain_ID(doubl
 }
 
 
-Decomp_grid_info *Remapping_grid_domain_decomp_engine::generate_subdomains_decomp_grid(Remap_grid_class *original_cor_grid, std::vector<std::pair<int, Remap_grid_class*> > &subdomains_CoR_grids)
+Distributed_H2D_grid_engine *Remapping_grid_domain_decomp_engine::get_distributed_H2D_grid_of_original_grid(Remap_grid_class *original_cor_grid)
 {
 	Comp_comm_group_mgt_node *host_comp_node = comp_comm_group_mgt_mgr->search_global_node(comp_id);
 	Distributed_H2D_grid_engine *distributed_H2D_grid = distributed_H2D_grid_mgr->search_distributed_H2D_grid(host_comp_node->get_comp_full_name(), original_cor_grid);
+
+
 	if (distributed_H2D_grid == NULL)
 		distributed_H2D_grid = distributed_H2D_grid_mgr->search_distributed_H2D_grid(NULL, original_cor_grid);
+	EXECUTION_REPORT_ERROR_OPTIONALLY(REPORT_ERROR, -1, distributed_H2D_grid != NULL && distributed_H2D_grid->get_basic_decomp_grid() != NULL, "Software error in Remapping_grid_domain_decomp_engine::get_distributed_H2D_grid_of_original_grid");
+	return distributed_H2D_grid;
+}
+
+
+void Remapping_grid_domain_decomp_engine::count_active_grid_cells_in_subdomains(Remap_grid_class *original_cor_grid, std::vector<long> &num_active_cells)
+{
+	Remap_grid_class *decomp_cor_grid = get_distributed_H2D_grid_of_original_grid(original_cor_grid)->get_basic_decomp_grid()->get_decomp_grid();
+	double *decomp_lon_values = (double*) decomp_cor_grid->get_grid_center_field(COORD_LABEL_LON)->get_grid_data_field()->data_buf;
+	double *decomp_lat_values = (double*) decomp_cor_grid->get_grid_center_field(COORD_LABEL_LAT)->get_grid_data_field()->data_buf;
+	bool *decomp_mask_values = decomp_cor_grid->get_grid_mask_field() == NULL? NULL : (bool*) decomp_cor_grid->get_grid_mask_field()->get_grid_data_field()->data_buf;
+	std::vector<long> local_num_active_cells(num_total_subdomains, 0);
+
+
+	for (int i = 0; i < decomp_cor_grid->get_grid_size(); i ++)
+		if (decomp_mask_values == NULL || decomp_mask_values[i])
+			local_num_active_cells[calculate_grid_point_subdomain_ID(decomp_lon_values[i], decomp_lat_values[i])] ++;
+	num_active_cells.resize(num_total_subdomains);
+	MPI_Allreduce(&local_num_active_cells[0], &num_active_cells[0], num_total_subdomains, MPI_LONG, MPI_SUM, comp_comm_group_mgt_mgr->search_global_node(comp_id)->get_comm_group());
+}
+
+
+/* The workload of a subdomain is dominated by the triangulation and the remapping weight calculation
+   on its source grid points expanded with the first level of halo subdomains, which is about n*log(n)
+   for n active source grid points, plus the search of its active destination grid points among them */
+void Remapping_grid_domain_decomp_engine::estimate_subdomains_workloads(std::vector<double> &workloads)
+{
+	std::vector<long> src_num_active_cells, dst_num_active_cells;
+	std::vector<int> halo_subdomains_IDs;
+	double num_expanded_src_cells;
+
+
+	count_active_grid_cells_in_subdomains(src_original_cor_grid, src_num_active_cells);
+	if (dst_original_cor_grid != NULL)
+		count_active_grid_cells_in_subdomains(dst_original_cor_grid, dst_num_active_cells);
+	else dst_num_active_cells.resize(num_total_subdomains, 0);
+
+	workloads.resize(num_total_subdomains);
+	for (int i = 0; i < num_total_subdomains; i ++) {
+		num_expanded_src_cells = src_num_active_cells[i];
+		if (num_total_subdomains > 1) {
+			get_subdomain_halo_subdomains_IDs(src_original_cor_grid, i, 1, halo_subdomains_IDs);
+			for (int j = 0; j < halo_subdomains_IDs.size(); j ++)
+				num_expanded_src_cells += src_num_active_cells[halo_subdomains_IDs[j]];
+		}
+		workloads[i] = (num_expanded_src_cells + dst_num_active_cells[i]) * log(num_expanded_src_cells + 2.0);
+	}
+}
+
+
+/* By default, the subdomain k is owned by the process k%num_total_procs. When the load balance of
+   subdomains is enabled, the subdomains are assigned, from the heaviest one, to the process with
+   the lightest estimated workload so far. All processes get the same assignment as the workloads
+   are calculated from global cell counts. The local subdomains of each process are ordered by
+   their IDs in both cases */
+void Remapping_grid_domain_decomp_engine::assign_subdomains_to_procs(Comp_comm_group_mgt_node *comp_node)
+{
+	std::vector<double> workloads, procs_workloads(num_total_procs, 0.0), round_robin_procs_workloads(num_total_procs, 0.0);
+	std::vector<std::pair<double, int> > sorted_subdomains;
+	std::priority_queue<std::pair<double, int>, std::vector<std::pair<double, int> >, std::greater<std::pair<double, int> > > procs_queue;
+	std::vector<int> num_subdomains_in_procs(num_total_procs, 0);
+	double max_workload = 0.0, round_robin_max_workload = 0.0, total_workload = 0.0;
+
+
+	subdomains_owner_proc_id.resize(num_total_subdomains);
+	subdomains_index_intra_owner_proc.resize(num_total_subdomains);
+	for (int i = 0; i < num_total_subdomains; i ++)
+		subdomains_owner_proc_id[i] = i % num_total_procs;
+
+	if (comp_comm_group_mgt_mgr->get_H2D_subdomain_load_balance_enabled()) {
+		estimate_subdomains_workloads(workloads);
+		for (int i = 0; i < num_total_subdomains; i ++)
+			sorted_subdomains.push_back(std::make_pair(-workloads[i], i));
+		std::sort(sorted_subdomains.begin(), sorted_subdomains.end());
+		for (int p = 0; p < num_total_procs; p ++)
+			procs_queue.push(std::make_pair(0.0, p));
+		for (int i = 0; i < num_total_subdomains; i ++) {
+			std::pair<double, int> lightest_proc = procs_queue.top();
+			procs_queue.pop();
+			subdomains_owner_proc_id[sorted_subdomains[i].second] = lightest_proc.second;
+			lightest_proc.first -= sorted_subdomains[i].first;
+			procs_queue.push(lightest_proc);
+		}
+	}
+
+	current_proc_subdomains_IDs.clear();
+	for (int i = 0; i < num_total_subdomains; i ++) {
+		subdomains_index_intra_owner_proc[i] = num_subdomains_in_procs[subdomains_owner_proc_id[i]] ++;
+		if (subdomains_owner_proc_id[i] == comp_node->get_current_proc_local_id())
+			current_proc_subdomains_IDs.push_back(i);
+	}
+
+	if (workloads.size() == 0)
+		return;
+	for (int i = 0; i < num_total_subdomains; i ++) {
+		procs_workloads[subdomains_owner_proc_id[i]] += workloads[i];
+		round_robin_procs_workloads[i%num_total_procs] += workloads[i];
+		total_workload += workloads[i];
+	}
+	for (int p = 0; p < num_total_procs; p ++) {
+		max_workload = MAX(max_workload, procs_workloads[p]);
+		round_robin_max_workload = MAX(round_robin_max_workload, round_robin_procs_workloads[p]);
+	}
+	EXECUTION_REPORT_LOG(REPORT_LOG, comp_id, true, "The %d subdomains for remapping are assigned to %d processes according to their estimated workloads: the current process owns %d subdomains with the estimated workload %lf. The maximum estimated workload of processes is %lf (%lf with the round-robin assignment) while the average is %lf, so the estimated imbalance (maximum/average) is %lf (%lf with the round-robin assignment)", num_total_subdomains, num_total_procs, current_proc_subdomains_IDs.size(), procs_workloads[comp_node->get_current_proc_local_id()], max_workload, round_robin_max_workload, total_workload/num_total_procs, total_workload > 0? max_workload*num_total_procs/total_workload : 1.0, total_workload > 0? round_robin_max_workload*num_total_procs/total_workload : 1.0);
+}
+
+
+Decomp_grid_info *Remapping_grid_domain_decomp_engine::generate_subdomains_decomp_grid(Remap_grid_class *original_cor_grid, std::vector<std::pair<int, Remap_grid_class*> > &subdomains_CoR_grids)
+{
+	Comp_comm_group_mgt_node *host_comp_node = comp_comm_group_mgt_mgr->search_global_node(comp_id);
+	Distributed_H2D_grid_engine *distributed_H2D_grid = get_distributed_H2D_grid_of_original_grid(original_cor_grid);
 	Decomp_grid_info *basic_decomp_grid = distributed_H2D_grid->get_basic_decomp_grid();
 	Decomp_grid_info *subdomains_decomp_grid;
 	EXECUTION_REPORT_ERROR_OPTIONALLY(REPORT_ERROR, -1, basic_decomp_grid != NULL && decomps_info_mgr->get_decomp_info(basic_decomp_grid->get_decomp_id())->get_host_comp_id() == comp_id, "Software error in Remapping_grid_domain_decomp_engine::generate_subdomains_decomp_grid");
@@ -802,7 +921,7 @@ Decomp_grid_info *Remapping_grid_domain_decomp_engine::generate_subdomains_decom
 	for (int i = 0; i < decomp_cor_grid->get_grid_size(); i ++) {
 		Grid_point_subdomain_mapping_info_data[i].content.global_grid_cell_index = basic_local_cell_global_indx[i];
 		Grid_point_subdomain_mapping_info_data[i].content.subdomain_id = calculate_grid_point_subdomain_ID(decomp_lon_values[i], decomp_lat_values[i]);
-		Grid_point_subdomain_mapping_info_data[i].content.owner_proc_id = Grid_point_subdomain_mapping_info_data[i].content.subdomain_id % num_total_procs;
+		Grid_point_subdomain_mapping_info_data[i].content.owner_proc_id = get_subdomain_owner_proc_id(Grid_point_subdomain_mapping_info_data[i].content.subdomain_id);
 		Grid_point_subdomain_mapping_info_data[i].target_proc_id = Grid_point_subdomain_mapping_info_data[i].content.owner_proc_id;
 	}
 	Grid_point_subdomain_mapping_info_sort->do_data_sorting_with_target_process_id(&Grid_point_subdomain_mapping_info_data, decomps_info_mgr->get_decomp_info(basic_decomp_grid->get_decomp_id()), host_comp_node, &num_local_sorted_data);
@@ -820,7 +939,7 @@ Decomp_grid_info *Remapping_grid_domain_decomp_engine::generate_subdomains_decom
 		for (int i = 0; i < decomp_cor_grid->get_grid_size(); i ++) {
 			grid_points_subdomain_map[i].global_grid_cell_index = basic_local_cell_global_indx[i];
 			grid_points_subdomain_map[i].subdomain_id = calculate_grid_point_subdomain_ID(decomp_lon_values[i], decomp_lat_values[i]);
-			grid_points_subdomain_map[i].owner_proc_id = grid_points_subdomain_map[i].subdomain_id % num_total_procs;
+			grid_points_subdomain_map[i].owner_proc_id = get_subdomain_owner_proc_id(grid_points_subdomain_map[i].subdomain_id);
 		}
 		gather_array_in_one_comp(host_comp_node->get_num_procs(), host_comp_node->get_current_proc_local_id(), grid_points_subdomain_map, decomp_cor_grid->get_grid_size(), sizeof(Grid_point_subdomain_mapping_info), NULL, (void**)(&grid_points_whole_map), global_size, host_comp_node->get_comm_group());
 		if (host_comp_node->get_current_proc_local_id() == 0)
@@ -883,16 +1002,14 @@ Decomp_grid_info *Remapping_grid_domain_decomp_engine::generate_subdomains_decom
 	wtime(&time2);
 	EXECUTION_REPORT(REPORT_LOG, -1, true, "the time for generate_decomp_grid_via_data_transfer is %lf", time2 - time1);
 
-	num_local_subdomains = num_total_subdomains/num_total_procs;
-	if (num_total_subdomains%num_total_procs > host_comp_node->get_current_proc_local_id())
-		num_local_subdomains ++;
+	num_local_subdomains = current_proc_subdomains_IDs.size();
 	num_cells_in_local_subdomains = new int [num_local_subdomains];
 	displ_cells_in_local_subdomains = new int [num_local_subdomains];
 	for (int i = 0; i < num_local_subdomains; i ++)
 		num_cells_in_local_subdomains[i] = 0;
 	for (int i = 0; i < num_local_sorted_data; i ++) {
-		EXECUTION_REPORT_ERROR_OPTIONALLY(REPORT_ERROR, -1, Grid_point_subdomain_mapping_info_data[i].content.subdomain_id%num_total_procs == host_comp_node->get_current_proc_local_id() && Grid_point_subdomain_mapping_info_data[i].content.subdomain_id/num_total_procs < num_local_subdomains, "Software error in Remapping_grid_domain_decomp_engine::generate_subdomains_decomp_grid");
-		num_cells_in_local_subdomains[Grid_point_subdomain_mapping_info_data[i].content.subdomain_id/num_total_procs] ++;
+		EXECUTION_REPORT_ERROR_OPTIONALLY(REPORT_ERROR, -1, get_subdomain_owner_proc_id(Grid_point_subdomain_mapping_info_data[i].content.subdomain_id) == host_comp_node->get_current_proc_local_id() && get_subdomain_index_intra_owner_proc(Grid_point_subdomain_mapping_info_data[i].content.subdomain_id) < num_local_subdomains, "Software error in Remapping_grid_domain_decomp_engine::generate_subdomains_decomp_grid");
+		num_cells_in_local_subdomains[get_subdomain_index_intra_owner_proc(Grid_point_subdomain_mapping_info_data[i].content.subdomain_id)] ++;
 	}
 	for (int i=0, j=0; i < num_local_subdomains; i ++) {
 		displ_cells_in_local_subdomains[i] = j;
@@ -900,7 +1017,7 @@ Decomp_grid_info *Remapping_grid_domain_decomp_engine::generate_subdomains_decom
 		num_cells_in_local_subdomains[i] = 0;
 	}
 	for (int i = 0; i < num_local_sorted_data; i ++) {
-		int local_subdomain_id = Grid_point_subdomain_mapping_info_data[i].content.subdomain_id/num_total_procs;
+		int local_subdomain_id = get_subdomain_index_intra_owner_proc(Grid_point_subdomain_mapping_info_data[i].content.subdomain_id);
 		cell_indexes_in_local_subdomains[displ_cells_in_local_subdomains[local_subdomain_id]+num_cells_in_local_subdomains[local_subdomain_id]] = i;
 		EXECUTION_REPORT_ERROR_OPTIONALLY(REPORT_ERROR, -1, cell_indexes_in_local_subdomains_tmp[displ_cells_in_local_subdomains[local_subdomain_id]+num_cells_in_local_subdomains[local_subdomain_id]] == Grid_point_subdomain_mapping_info_data[i].content.global_grid_cell_index+1, "Software error in Remapping_grid_domain_decomp_engine::generate_subdomains_decomp_grid");
 		num_cells_in_local_subdomains[local_subdomain_id] ++;
@@ -911,11 +1028,11 @@ Decomp_grid_info *Remapping_grid_domain_decomp_engine::generate_subdomains_decom
 	for (int i = 0; i < num_local_subdomains; i ++) {
 		std::pair<int, Remap_grid_class*> subdomain_CoR_grid;
 		if (num_cells_in_local_subdomains[i] == 0) {
-			subdomain_CoR_grid.first = host_comp_node->get_current_proc_local_id() + i*num_total_procs;
+			subdomain_CoR_grid.first = current_proc_subdomains_IDs[i];
 			subdomain_CoR_grid.second = NULL;
 		} else {
 			subdomain_CoR_grid.first = Grid_point_subdomain_mapping_info_data[displ_cells_in_local_subdomains[i]].content.subdomain_id;
-			EXECUTION_REPORT_ERROR_OPTIONALLY(REPORT_ERROR, -1, subdomain_CoR_grid.first%num_total_procs == host_comp_node->get_current_proc_local_id(), "Software error in Remapping_grid_domain_decomp_engine::generate_subdomains_decomp_grid");
+			EXECUTION_REPORT_ERROR_OPTIONALLY(REPORT_ERROR, -1, subdomain_CoR_grid.first == current_proc_subdomains_IDs[i], "Software error in Remapping_grid_domain_decomp_engine::generate_subdomains_decomp_grid");
 			sprintf(subdomain_decomp_name, "%s_at_subdomain_%d", decomp_name, Grid_point_subdomain_mapping_info_data[displ_cells_in_local_subdomains[i]].content.subdomain_id);
 			subdomain_CoR_grid.second = subdomains_decomp_grid->get_decomp_grid()->generate_decomp_grid(cell_indexes_in_local_subdomains+displ_cells_in_local_subdomains[i], num_cells_in_local_subdomains[i], subdomain_decomp_name);
 			subdomain_CoR_grid.second->set_local_cell_global_indexes(cell_indexes_in_local_subdomains_tmp+displ_cells_in_local_subdomains[i], true);
@@ -988,8 +1105,8 @@ Remap_grid_class *Remapping_grid_domain_decomp_engine::get_subdomain_grid(int su
 	double time1, time2, time3, time4, time5, time6, time7;
 
 	wtime(&time1);
-	owner_process_id = subdomain_id % comp_node->get_num_procs();
-	subdomain_index_intra_owner_process = subdomain_id / comp_node->get_num_procs();
+	owner_process_id = get_subdomain_owner_proc_id(subdomain_id);
+	subdomain_index_intra_owner_process = get_subdomain_index_intra_owner_proc(subdomain_id);
 	if (owner_process_id == comp_node->get_current_proc_local_id()) {
 		subdomain_grid = subdomains_CoR_grids[subdomain_index_intra_owner_process].second;
 		if (subdomain_grid != NULL)
@@ -1178,7 +1295,7 @@ Remap_grid_class *Remapping_grid_domain_decomp_engine::expand_src_subdomain_halo
 
 void Remapping_grid_domain_decomp_engine::expand_subdomain_halo_grid(int subdomain_ID, Remap_grid_class *original_cor_grid, std::vector<std::pair<int, Remap_grid_class*> >& subdomains_CoR_grids, bool is_src)
 {
-	int subdomain_index = subdomain_ID / num_total_procs;
+	int subdomain_index = get_subdomain_index_intra_owner_proc(subdomain_ID);
 	int halo_level = (++subdomains_halo_num_levels[subdomain_index]);
 	int k, j;
 	std::vector<int> halo_subdomains_IDs;
@@ -1214,7 +1331,7 @@ void Remapping_grid_domain_decomp_engine::expand_subdomain_halo_grid(int subdoma
 			subdomains_halo_subdomains_CoR_grids[subdomain_index].push_back(halo_subdomain_CoR_grid);
 	}
 	wtime(&time2);
-	calculate_subdomain_halo_bounds(original_cor_grid, subdomain_ID, halo_level, subdomains_halo_lon_bounds[subdomain_ID/num_total_procs], subdomains_halo_lat_bounds[subdomain_ID/num_total_procs]);
+	calculate_subdomain_halo_bounds(original_cor_grid, subdomain_ID, halo_level, subdomains_halo_lon_bounds[subdomain_index], subdomains_halo_lat_bounds[subdomain_index]);
 	generate_subdomain_expanded_CoR_grid_with_triangulation(subdomain_ID, subdomains_CoR_grids, original_cor_grid, is_src);
 	wtime(&time3);
 	EXECUTION_REPORT(REPORT_LOG, -1, true, "time to expand is %lf vs %lf", time2-time1, time3-time2);
@@ -1407,9 +1524,9 @@ unsigned long Remapping_grid_domain_decomp_engine::cal_triangles_checksum_on_bou
 void Remapping_grid_domain_decomp_engine::generate_subdomain_expanded_CoR_grid_with_triangulation(int subdomain_ID, std::vector<std::pair<int, Remap_grid_class*> >& origin_subdomains_CoR_grids, Remap_grid_class *original_cor_grid, bool is_src)
 {
 	int total_size = 0, active_size, k;
-	std::vector<Remap_grid_class *> *subdomain_halo_subdomains_CoR_grids = &(subdomains_halo_subdomains_CoR_grids[subdomain_ID/num_total_procs]);
+	std::vector<Remap_grid_class *> *subdomain_halo_subdomains_CoR_grids = &(subdomains_halo_subdomains_CoR_grids[get_subdomain_index_intra_owner_proc(subdomain_ID)]);
 	std::vector<Remap_grid_class *> expanded_subdomains_CoR_grids;
-	Remap_grid_class *subdomain_CoR_grid = origin_subdomains_CoR_grids[subdomain_ID/num_total_procs].second, *sub_grids[2], *expanded_CoR_grid;
+	Remap_grid_class *subdomain_CoR_grid = origin_subdomains_CoR_grids[get_subdomain_index_intra_owner_proc(subdomain_ID)].second, *sub_grids[2], *expanded_CoR_grid;
 	std::vector<const void *> subdomains_center_lon_fields, subdomains_center_lat_fields, subdomains_vertex_lon_fields, subdomains_vertex_lat_fields, subdomains_mask_fields, subdomains_global_cell_indexes;
 	bool *expanded_domain_mask;
 	int subdomain_type; // 0 for common subdomain, 1 for north pole, -1 for south pole.
@@ -1426,15 +1543,15 @@ void Remapping_grid_domain_decomp_engine::generate_subdomain_expanded_CoR_grid_w
 	int new_max_num_voronoi_diagram_vertex;
 
 	wtime(&time1);
-	if (src_subdomains_expanded_CoR_grids[subdomain_ID/num_total_procs] != NULL) {
-		delete src_subdomains_expanded_CoR_grids[subdomain_ID/num_total_procs];
-		src_subdomains_expanded_CoR_grids[subdomain_ID/num_total_procs] = NULL;
+	if (src_subdomains_expanded_CoR_grids[get_subdomain_index_intra_owner_proc(subdomain_ID)] != NULL) {
+		delete src_subdomains_expanded_CoR_grids[get_subdomain_index_intra_owner_proc(subdomain_ID)];
+		src_subdomains_expanded_CoR_grids[get_subdomain_index_intra_owner_proc(subdomain_ID)] = NULL;
 	}
 
-	expanded_bound_min_lon = subdomains_halo_lon_bounds[subdomain_ID/num_total_procs].first;
-	expanded_bound_max_lon = subdomains_halo_lon_bounds[subdomain_ID/num_total_procs].second;
-	expanded_bound_min_lat = subdomains_halo_lat_bounds[subdomain_ID/num_total_procs].first;
-	expanded_bound_max_lat = subdomains_halo_lat_bounds[subdomain_ID/num_total_procs].second;
+	expanded_bound_min_lon = subdomains_halo_lon_bounds[get_subdomain_index_intra_owner_proc(subdomain_ID)].first;
+	expanded_bound_max_lon = subdomains_halo_lon_bounds[get_subdomain_index_intra_owner_proc(subdomain_ID)].second;
+	expanded_bound_min_lat = subdomains_halo_lat_bounds[get_subdomain_index_intra_owner_proc(subdomain_ID)].first;
+	expanded_bound_max_lat = subdomains_halo_lat_bounds[get_subdomain_index_intra_owner_proc(subdomain_ID)].second;
 	if (subdomain_CoR_grid != NULL && subdomain_CoR_grid->get_grid_size() > 0) {
 		expanded_subdomains_CoR_grids.push_back(subdomain_CoR_grid);
 		num_vertexes_in_grid.push_back(subdomain_CoR_grid->get_num_vertexes());
@@ -1604,7 +1721,7 @@ void Remapping_grid_domain_decomp_engine::generate_subdomain_expanded_CoR_grid_w
 		triangulation->generate_all_result_triangles();
 
 		result_triangles = new Triangle_inline [triangulation->num_result_triangles];
-		subdomain_triangulation_info_index = subdomain_ID / comp_comm_group_mgt_mgr->search_global_node(comp_id)->get_num_procs();
+		subdomain_triangulation_info_index = get_subdomain_index_intra_owner_proc(subdomain_ID);
 		subdomain_triangulation_info[subdomain_triangulation_info_index*3+0] = subdomain_ID;
 		subdomain_triangulation_info[subdomain_triangulation_info_index*3+1] = triangulation->num_result_triangles;
 		subdomain_triangulation_info[subdomain_triangulation_info_index*3+2] = triangulation_comm_data_buf_content_size;
@@ -1641,7 +1758,7 @@ void Remapping_grid_domain_decomp_engine::generate_subdomain_expanded_CoR_grid_w
 	wtime(&time7);
 
 	EXECUTION_REPORT(REPORT_LOG, -1, true, "generate_subdomain_expanded_CoR_grid_with_triangulation times: %lf  %lf  %lf  %lf  %lf  %lf  %lf", time2-time1, time3-time2, time4-time3, time5-time4, time6-time5, time7-time6);
-	src_subdomains_expanded_CoR_grids[subdomain_ID/num_total_procs] = expanded_CoR_grid;
+	src_subdomains_expanded_CoR_grids[get_subdomain_index_intra_owner_proc(subdomain_ID)] = expanded_CoR_grid;
 	if (expanded_CoR_grid_global_cell_indexes != NULL)
 		delete [] expanded_CoR_grid_global_cell_indexes;
 }
@@ -107,6 +107,9 @@ class Remapping_grid_domain_decomp_engine
 		std::vector<std::vector<int> > subdomains_halo_subdomains_IDs;
 		std::vector<int> subdomains_halo_num_levels;
 		std::vector<int> local_subdomains_index;
+		std::vector<int> subdomains_owner_proc_id;
+		std::vector<int> subdomains_index_intra_owner_proc;
+		std::vector<int> current_proc_subdomains_IDs;
 		std::vector<Triangle_inline*> subdomains_final_triangles;
 		std::vector<int> num_subdomains_final_triangles;
 
@@ -117,13 +120,19 @@ class Remapping_grid_domain_decomp_engine
 		MPI_Win src_grid_MPI_Win, dst_grid_MPI_Win;
 		MPI_Win triangulation_comm_win;
 		int *subdomain_triangulation_info;
+		double subdomains_expansion_time;
 
 	public:
 		Remapping_grid_domain_decomp_engine(int, int, Remap_grid_class*, Remap_grid_class*, double, double, double, double);
 		~Remapping_grid_domain_decomp_engine();
 		bool is_north_pole_subdomain(int subdomain_ID) { return subdomain_ID < num_northPole_subdomain; } 
 		bool is_south_pole_subdomain(int subdomain_ID) { return subdomain_ID == num_northPole_subdomain && num_southPole_subdomain > 0; }
-		int get_subdomain_owner_proc_id(int subdomain_ID) { return subdomain_ID % num_total_procs; }
+		int get_subdomain_owner_proc_id(int subdomain_ID) { return subdomains_owner_proc_id[subdomain_ID]; }
+		int get_subdomain_index_intra_owner_proc(int subdomain_ID) { return subdomains_index_intra_owner_proc[subdomain_ID]; }
+		Distributed_H2D_grid_engine *get_distributed_H2D_grid_of_original_grid(Remap_grid_class *);
+		void count_active_grid_cells_in_subdomains(Remap_grid_class *, std::vector<long> &);
+		void estimate_subdomains_workloads(std::vector<double> &);
+		void assign_subdomains_to_procs(Comp_comm_group_mgt_node *);
 		int calculate_grid_point_subdomain_ID(double, double);
 		Decomp_grid_info *generate_subdomains_decomp_grid(Remap_grid_class *, std::vector<std::pair<int, Remap_grid_class*> > &);
 		void generate_grid_one_sided_comm_info(std::vector<std::pair<int, Remap_grid_class*> >&, char**, MPI_Win*);
@@ -147,6 +156,7 @@ class Remapping_grid_domain_decomp_engine
 		void initialize_subdomains_halo_info(Remap_grid_class *, std::vector<std::pair<int, Remap_grid_class*> >&, Comp_comm_group_mgt_node *);
 		void clear_subdomains_halo_info();
 		int get_num_subdomains() { return src_subdomains_CoR_grids.size(); }
+		double get_subdomains_expansion_time() { return subdomains_expansion_time; }
 		Remap_grid_class *get_src_expanded_subdomain(int);
 		Remap_grid_class *get_dst_subdomain(int);	
 		void get_src_current_expanded_subdomain_boundaries(int, double &, double &, double &, double &);
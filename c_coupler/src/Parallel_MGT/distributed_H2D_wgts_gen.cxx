@@ -10,6 +10,7 @@
 #include "global_data.h"
 #include "distributed_H2D_wgts_gen.h"
 #include "remap_utils_nearest_points.h"
+#include <sys/stat.h>
 
 
 void sort_normal_distributed_remapping_weight_elements_locally(common_sort_struct<Normal_distributed_wgt_element> *normal_distributed_wgt_map, int num_weights)
@@ -49,6 +50,7 @@ void sort_normal_remapping_weights_in_sparse_matrix_locally(Remap_weight_sparse_
 		weight_matrix->get_indexes_dst_grid()[i] = normal_distributed_wgt_map[i].content.dst_cell_index;
 		weight_matrix->get_weight_values()[i] = normal_distributed_wgt_map[i].content.wgt_value;
 	}
+	weight_matrix->release_compressed_weights();
 
 	delete [] normal_distributed_wgt_map;
 }
@@ -226,6 +228,20 @@ void Distributed_H2D_weights_generator::append_wgt_sparse_matrix(std::vector<Nor
 }
 
 
+/* Reports the time that each process spends on a phase of processing its subdomains, together
+   with the imbalance among the processes, which indicates how well the subdomains are assigned */
+void Distributed_H2D_weights_generator::report_subdomains_workload_time(Comp_comm_group_mgt_node *comp_node, const char *phase_name, double local_time)
+{
+	double min_time, max_time, total_time;
+
+
+	MPI_Allreduce(&local_time, &min_time, 1, MPI_DOUBLE, MPI_MIN, comp_node->get_comm_group());
+	MPI_Allreduce(&local_time, &max_time, 1, MPI_DOUBLE, MPI_MAX, comp_node->get_comm_group());
+	MPI_Allreduce(&local_time, &total_time, 1, MPI_DOUBLE, MPI_SUM, comp_node->get_comm_group());
+	EXECUTION_REPORT_LOG(REPORT_LOG, comp_id, true, "The process spends %lf seconds on the %s of its %d subdomains (%s assignment of subdomains). Among the %d processes, the time is %lf at least, %lf at most and %lf on average, so the imbalance (maximum/average) is %lf", local_time, phase_name, remapping_grid_domain_decomp_engine->get_num_subdomains(), comp_comm_group_mgt_mgr->get_H2D_subdomain_load_balance_enabled()? "load-balanced" : "round-robin", comp_node->get_num_procs(), min_time, max_time, total_time/comp_node->get_num_procs(), total_time > 0? max_time*comp_node->get_num_procs()/total_time : 1.0);
+}
+
+
 Distributed_H2D_weights_generator::Distributed_H2D_weights_generator(int comp_id, int src_original_grid_id, int dst_original_grid_id, int dst_decomp_id, Remap_operator_basis *entire_remap_operator)
 {
 	double common_min_lon, common_max_lon, common_min_lat, common_max_lat;
@@ -238,7 +254,7 @@ Distributed_H2D_weights_generator::Distributed_H2D_weights_generator(int comp_id
 	int num_active_dst_decomp_grid_local_cells = 0, send_recv_mark, proc_id_send_to, proc_id_recv_from, j, prev_j, next_j;
 	int num_original_normal_distributed_wgt_elements, num_dst_decomp_grid_local_wgts, weight_group_begin_pos;
 	Comp_comm_group_mgt_node *comp_node = comp_comm_group_mgt_mgr->search_global_node(comp_id);
-	double time1, time2, time3, time4;
+	double time1, time2, time3, time4, time5;
 	char src_H2D_sub_grid_name[NAME_STR_SIZE], dst_H2D_sub_grid_name[NAME_STR_SIZE], full_default_wgt_file_name[NAME_STR_SIZE];
 	Original_grid_info *src_original_grid, *dst_original_grid;
 	Distributed_H2D_grid_engine *distributed_grid_src, *distributed_grid_dst;
@@ -261,6 +277,7 @@ Distributed_H2D_weights_generator::Distributed_H2D_weights_generator(int comp_id
 	wtime(&time2);
 	MPI_Barrier(comp_node->get_comm_group());
 	EXECUTION_REPORT(REPORT_LOG, -1, true, "Time for generating Remapping_grid_domain_decomp_engine is %lf", time2-time1);
+	wtime(&time5);
 	for (int i = 0; i < remapping_grid_domain_decomp_engine->get_num_subdomains(); i ++) {
 		Remap_grid_class *current_dst_subdomain_grid = remapping_grid_domain_decomp_engine->get_dst_subdomain(i);
 		if (current_dst_subdomain_grid == NULL || current_dst_subdomain_grid->get_num_active_cells() == 0)
@@ -300,6 +317,11 @@ Distributed_H2D_weights_generator::Distributed_H2D_weights_generator(int comp_id
 		delete subdomain_remap_operator;
 	}
 
+	wtime(&time3);
+	report_subdomains_workload_time(comp_node, "halo expansion and triangulation", remapping_grid_domain_decomp_engine->get_subdomains_expansion_time());
+	report_subdomains_workload_time(comp_node, "weight calculation", time3-time5);
+	report_subdomains_workload_time(comp_node, "halo expansion, triangulation and weight calculation", remapping_grid_domain_decomp_engine->get_subdomains_expansion_time()+time3-time5);
+
 	current_runtime_remap_operator_grid_src = backup_operator_grid_src;
 	current_runtime_remap_operator_grid_dst = backup_operator_grid_dst;
 	current_runtime_remap_operator = backup_remap_operator;
@@ -546,3 +568,221 @@ Remap_weight_sparse_matrix *Distributed_H2D_weights_generator::read_normal_remap
 	return rearrange_for_local_H2D_parallel_weights(dst_decomp_info, entire_remap_operator, normal_distributed_wgt_map, num_wgts_after_redistribution, NULL, NULL, NULL);
 }
 
+
+
+/* The local H2D remapping weights of each process (together with the global indexes of the source cells they refer to) are cached
+   in a binary file in the directory of remapping weights cache. The cache file is only used when the grids (through the checksums 
+   of their horizontal coordinates, vertexes, areas and masks), the remapping configuration, the remapping weights file (if any, 
+   through its name, size and modification time) and the parallel decomposition of the target grid are all the same as those 
+   when generating the file */
+Local_H2D_remap_weights_cache::Local_H2D_remap_weights_cache(int comp_id, int src_original_grid_id, int dst_original_grid_id, int dst_decomp_id, Remap_operator_basis *entire_remap_operator, const char *remap_weights_name, const char *H2D_remapping_wgt_file)
+{
+	Comp_comm_group_mgt_node *comp_node = comp_comm_group_mgt_mgr->search_global_node(comp_id);
+	Original_grid_info *src_original_grid = original_grid_mgr->get_original_grid(src_original_grid_id);
+	Original_grid_info *dst_original_grid = original_grid_mgr->get_original_grid(dst_original_grid_id);
+	Decomp_info *dst_decomp_info = decomps_info_mgr->get_decomp_info(dst_decomp_id);
+	char src_H2D_sub_grid_name[NAME_STR_SIZE], dst_H2D_sub_grid_name[NAME_STR_SIZE];
+	long local_layout_checksum, layout_checksum;
+	struct stat wgt_file_stat;
+
+
+	EXECUTION_REPORT_ERROR_OPTIONALLY(REPORT_ERROR, -1, comp_node != NULL && src_original_grid != NULL && dst_original_grid != NULL && dst_decomp_info != NULL, "Software error in Local_H2D_remap_weights_cache::Local_H2D_remap_weights_cache");
+	this->comp_id = comp_id;
+	this->dst_decomp_id = dst_decomp_id;
+	this->comm = comp_node->get_comm_group();
+	strcpy(this->remap_weights_name, remap_weights_name);
+	if (H2D_remapping_wgt_file != NULL)
+		strcpy(this->H2D_remapping_wgt_file_name, H2D_remapping_wgt_file);
+	else this->H2D_remapping_wgt_file_name[0] = '\0';
+
+	cache_keys[0] = LOCAL_H2D_REMAP_WEIGHTS_CACHE_VERSION;
+	cache_keys[1] = src_original_grid->get_checksum_H2D_mask();
+	cache_keys[2] = src_original_grid->get_checksum_H2D_center_lon();
+	cache_keys[3] = src_original_grid->get_checksum_H2D_center_lat();
+	cache_keys[4] = dst_original_grid->get_checksum_H2D_mask();
+	cache_keys[5] = dst_original_grid->get_checksum_H2D_center_lon();
+	cache_keys[6] = dst_original_grid->get_checksum_H2D_center_lat();
+	cache_keys[7] = src_original_grid->get_H2D_sub_CoR_grid()->get_grid_size();
+	cache_keys[8] = dst_original_grid->get_H2D_sub_CoR_grid()->get_grid_size();
+	cache_keys[9] = calculate_checksum_of_array(this->remap_weights_name, strlen(this->remap_weights_name), sizeof(char), NULL, MPI_COMM_NULL);
+	cache_keys[10] = calculate_checksum_of_array(this->H2D_remapping_wgt_file_name, strlen(this->H2D_remapping_wgt_file_name), sizeof(char), NULL, MPI_COMM_NULL);
+	cache_keys[11] = comp_node->get_num_procs();
+	cache_keys[12] = comp_node->get_current_proc_local_id();
+	cache_keys[13] = dst_decomp_info->get_num_local_cells();
+	cache_keys[14] = dst_decomp_info->get_num_global_cells();
+	cache_keys[15] = calculate_checksum_of_array(dst_decomp_info->get_local_cell_global_indx(), dst_decomp_info->get_num_local_cells(), sizeof(int), NULL, MPI_COMM_NULL);
+	calculate_vertexes_and_area_checksums(comp_node, src_original_grid, cache_keys+16);
+	calculate_vertexes_and_area_checksums(comp_node, dst_original_grid, cache_keys+19);
+	cache_keys[22] = -1;
+	cache_keys[23] = -1;
+	if (strlen(this->H2D_remapping_wgt_file_name) > 0 && stat(this->H2D_remapping_wgt_file_name, &wgt_file_stat) == 0) {
+		cache_keys[22] = wgt_file_stat.st_size;
+		cache_keys[23] = wgt_file_stat.st_mtime;
+	}
+
+	local_layout_checksum = (cache_keys[15] + cache_keys[13]) * (cache_keys[12] + 1);
+	EXECUTION_REPORT(REPORT_ERROR, -1, MPI_Allreduce(&local_layout_checksum, &layout_checksum, 1, MPI_LONG, MPI_SUM, comm) == MPI_SUCCESS);
+	EXECUTION_REPORT(REPORT_ERROR, -1, src_original_grid->get_H2D_sub_grid_full_name(src_H2D_sub_grid_name), "Software error in Local_H2D_remap_weights_cache::Local_H2D_remap_weights_cache");
+	EXECUTION_REPORT(REPORT_ERROR, -1, dst_original_grid->get_H2D_sub_grid_full_name(dst_H2D_sub_grid_name), "Software error in Local_H2D_remap_weights_cache::Local_H2D_remap_weights_cache");
+	sprintf(cache_file_name, "%s/LOCAL_WGT__%s__FROM__%s__TO__%s__%lx__%d_%d.bin", comp_comm_group_mgt_mgr->get_remapping_weights_cache_dir(), entire_remap_operator->get_operator_name(), src_H2D_sub_grid_name, dst_H2D_sub_grid_name, cache_keys[9]^cache_keys[10]^layout_checksum, comp_node->get_num_procs(), comp_node->get_current_proc_local_id());
+}
+
+
+/* The checksums of the vertex coordinates (longitude and latitude) and of the areas of an H2D grid are calculated on the 
+   basic decomposition of its distributed grid, which is collective in the component. A checksum is 0 if the grid does not 
+   have the corresponding data */
+void Local_H2D_remap_weights_cache::calculate_vertexes_and_area_checksums(Comp_comm_group_mgt_node *comp_node, Original_grid_info *original_grid, long *checksums)
+{
+	Distributed_H2D_grid_engine *distributed_grid = distributed_H2D_grid_mgr->search_distributed_H2D_grid(comp_node->get_full_name(), original_grid->get_H2D_sub_CoR_grid());
+	if (distributed_grid == NULL)
+		distributed_grid = distributed_H2D_grid_mgr->search_distributed_H2D_grid(NULL, original_grid->get_H2D_sub_CoR_grid());
+	EXECUTION_REPORT_ERROR_OPTIONALLY(REPORT_ERROR, -1, distributed_grid != NULL && distributed_grid->get_basic_decomp_grid() != NULL, "Software error in Local_H2D_remap_weights_cache::calculate_vertexes_and_area_checksums");
+	Remap_grid_class *decomp_grid = distributed_grid->get_basic_decomp_grid()->get_decomp_grid();
+	const int *local_cells_global_indexes = decomp_grid->get_local_cell_global_indexes();
+	int num_vertexes = original_grid->get_H2D_sub_CoR_grid()->get_num_vertexes();
+
+
+	checksums[0] = 0;
+	checksums[1] = 0;
+	checksums[2] = 0;
+	if (decomp_grid->get_grid_vertex_field(COORD_LABEL_LON) != NULL && num_vertexes > 0) {
+		int *local_vertexes_global_indexes = new int [decomp_grid->get_grid_size()*num_vertexes];
+		for (int i = 0; i < decomp_grid->get_grid_size(); i ++)
+			for (int j = 0; j < num_vertexes; j ++)
+				local_vertexes_global_indexes[i*num_vertexes+j] = local_cells_global_indexes[i]*num_vertexes + j;
+		checksums[0] = calculate_checksum_of_array(decomp_grid->get_grid_vertex_field(COORD_LABEL_LON)->get_grid_data_field()->data_buf, decomp_grid->get_grid_size()*num_vertexes, sizeof(double), local_vertexes_global_indexes, comm);
+		checksums[1] = calculate_checksum_of_array(decomp_grid->get_grid_vertex_field(COORD_LABEL_LAT)->get_grid_data_field()->data_buf, decomp_grid->get_grid_size()*num_vertexes, sizeof(double), local_vertexes_global_indexes, comm);
+		delete [] local_vertexes_global_indexes;
+	}
+	if (decomp_grid->get_grid_imported_area() != NULL)
+		checksums[2] = calculate_checksum_of_array(decomp_grid->get_grid_imported_area()->get_grid_data_field()->data_buf, decomp_grid->get_grid_size(), sizeof(double), local_cells_global_indexes, comm);
+}
+
+
+bool Local_H2D_remap_weights_cache::read_data_from_cache_file(void *data, long data_size, FILE *cache_file)
+{
+	if (data_size == 0)
+		return true;
+
+	return fread(data, 1, data_size, cache_file) == data_size;
+}
+
+
+Remap_weight_sparse_matrix *Local_H2D_remap_weights_cache::load_local_remap_weights(Remap_operator_basis *entire_remap_operator)
+{
+	Decomp_info *dst_decomp_info = decomps_info_mgr->get_decomp_info(dst_decomp_id);
+	long file_cache_keys[NUM_LOCAL_H2D_REMAP_WEIGHTS_CACHE_KEYS], file_size = 0, num_weights = 0, num_remaped_dst_cells_indexes = 0;
+	long *indexes_src = NULL, *indexes_dst = NULL, *remaped_dst_cells_indexes = NULL;
+	double *weight_values = NULL;
+	int *file_local_cell_global_indx = NULL, *remap_local_cell_global_indexes = NULL;
+	int num_remap_local_cell_global_indexes = 0, local_hit = 0, overall_hit = 0;
+	char file_remap_weights_name[NAME_STR_SIZE], file_H2D_remapping_wgt_file_name[NAME_STR_SIZE];
+	bool valid;
+	FILE *cache_file;
+	double time1, time2;
+
+
+	wtime(&time1);
+	cache_file = fopen(cache_file_name, "r");
+	if (cache_file != NULL) {
+		fseek(cache_file, 0, SEEK_END);
+		file_size = ftell(cache_file);
+		fseek(cache_file, 0, SEEK_SET);
+		valid = read_data_from_cache_file(file_cache_keys, sizeof(long)*NUM_LOCAL_H2D_REMAP_WEIGHTS_CACHE_KEYS, cache_file);
+		for (int i = 0; valid && i < NUM_LOCAL_H2D_REMAP_WEIGHTS_CACHE_KEYS; i ++)
+			valid = file_cache_keys[i] == cache_keys[i];
+		valid = valid && read_data_from_cache_file(file_remap_weights_name, NAME_STR_SIZE, cache_file) && read_data_from_cache_file(file_H2D_remapping_wgt_file_name, NAME_STR_SIZE, cache_file);
+		valid = valid && words_are_the_same(file_remap_weights_name, remap_weights_name) && words_are_the_same(file_H2D_remapping_wgt_file_name, H2D_remapping_wgt_file_name);
+		if (valid) {
+			file_local_cell_global_indx = new int [dst_decomp_info->get_num_local_cells()+1];
+			valid = read_data_from_cache_file(file_local_cell_global_indx, sizeof(int)*dst_decomp_info->get_num_local_cells(), cache_file);
+			for (int i = 0; valid && i < dst_decomp_info->get_num_local_cells(); i ++)
+				valid = file_local_cell_global_indx[i] == dst_decomp_info->get_local_cell_global_indx()[i];
+			delete [] file_local_cell_global_indx;
+		}
+		valid = valid && read_data_from_cache_file(&num_remap_local_cell_global_indexes, sizeof(int), cache_file) && num_remap_local_cell_global_indexes >= 0 && sizeof(int)*((long)num_remap_local_cell_global_indexes) <= file_size;
+		if (valid) {
+			remap_local_cell_global_indexes = new int [num_remap_local_cell_global_indexes+1];
+			valid = read_data_from_cache_file(remap_local_cell_global_indexes, sizeof(int)*num_remap_local_cell_global_indexes, cache_file);
+		}
+		valid = valid && read_data_from_cache_file(&num_weights, sizeof(long), cache_file) && num_weights >= 0 && (sizeof(long)*2+sizeof(double))*num_weights <= file_size;
+		if (valid) {
+			indexes_src = new long [num_weights+1];
+			indexes_dst = new long [num_weights+1];
+			weight_values = new double [num_weights+1];
+			valid = read_data_from_cache_file(indexes_src, sizeof(long)*num_weights, cache_file) && read_data_from_cache_file(indexes_dst, sizeof(long)*num_weights, cache_file) && read_data_from_cache_file(weight_values, sizeof(double)*num_weights, cache_file);
+		}
+		valid = valid && read_data_from_cache_file(&num_remaped_dst_cells_indexes, sizeof(long), cache_file) && num_remaped_dst_cells_indexes >= 0 && sizeof(long)*num_remaped_dst_cells_indexes <= file_size;
+		if (valid) {
+			remaped_dst_cells_indexes = new long [num_remaped_dst_cells_indexes+1];
+			valid = read_data_from_cache_file(remaped_dst_cells_indexes, sizeof(long)*num_remaped_dst_cells_indexes, cache_file) && ftell(cache_file) == file_size;
+		}
+		fclose(cache_file);
+		local_hit = valid? 1 : 0;
+	}
+
+	EXECUTION_REPORT(REPORT_ERROR, -1, MPI_Allreduce(&local_hit, &overall_hit, 1, MPI_INT, MPI_MIN, comm) == MPI_SUCCESS);
+	if (overall_hit == 0) {
+		if (remap_local_cell_global_indexes != NULL)
+			delete [] remap_local_cell_global_indexes;
+		if (indexes_src != NULL) {
+			delete [] indexes_src;
+			delete [] indexes_dst;
+			delete [] weight_values;
+		}
+		if (remaped_dst_cells_indexes != NULL)
+			delete [] remaped_dst_cells_indexes;
+		EXECUTION_REPORT_LOG(REPORT_LOG, comp_id, true, "The cached remapping weights \"%s\" cannot be used (%d at the current process) and the remapping weights will be generated", cache_file_name, local_hit);
+		return NULL;
+	}
+
+	current_remap_local_cell_global_indexes = remap_local_cell_global_indexes;
+	num_current_remap_local_cell_global_indexes = num_remap_local_cell_global_indexes;
+	wtime(&time2);
+	EXECUTION_REPORT_LOG(REPORT_LOG, comp_id, true, "Load %ld local remapping weights from the cache file \"%s\" in %lf seconds", num_weights, cache_file_name, time2-time1);
+
+	return new Remap_weight_sparse_matrix(entire_remap_operator, num_weights, indexes_src, indexes_dst, weight_values, num_remaped_dst_cells_indexes, remaped_dst_cells_indexes);
+}
+
+
+void Local_H2D_remap_weights_cache::save_local_remap_weights(Remap_weight_sparse_matrix *local_remap_weights)
+{
+	Decomp_info *dst_decomp_info = decomps_info_mgr->get_decomp_info(dst_decomp_id);
+	char temp_cache_file_name[NAME_STR_SIZE*2+16];
+	long num_weights = local_remap_weights->get_num_weights(), num_remaped_dst_cells_indexes = local_remap_weights->get_num_remaped_dst_cells_indexes();
+	bool write_succeeded;
+	FILE *cache_file;
+
+
+	EXECUTION_REPORT_ERROR_OPTIONALLY(REPORT_ERROR, -1, current_remap_local_cell_global_indexes != NULL, "Software error in Local_H2D_remap_weights_cache::save_local_remap_weights");
+
+	sprintf(temp_cache_file_name, "%s.tmp", cache_file_name);
+	cache_file = fopen(temp_cache_file_name, "w+");
+	if (cache_file == NULL) {
+		EXECUTION_REPORT(REPORT_WARNING, comp_id, false, "Failed to open the file \"%s\" for caching the remapping weights. The remapping weights will not be cached", temp_cache_file_name);
+		return;
+	}
+	fwrite(cache_keys, sizeof(long), NUM_LOCAL_H2D_REMAP_WEIGHTS_CACHE_KEYS, cache_file);
+	fwrite(remap_weights_name, sizeof(char), NAME_STR_SIZE, cache_file);
+	fwrite(H2D_remapping_wgt_file_name, sizeof(char), NAME_STR_SIZE, cache_file);
+	fwrite(dst_decomp_info->get_local_cell_global_indx(), sizeof(int), dst_decomp_info->get_num_local_cells(), cache_file);
+	fwrite(&num_current_remap_local_cell_global_indexes, sizeof(int), 1, cache_file);
+	fwrite(current_remap_local_cell_global_indexes, sizeof(int), num_current_remap_local_cell_global_indexes, cache_file);
+	fwrite(&num_weights, sizeof(long), 1, cache_file);
+	fwrite(local_remap_weights->get_indexes_src_grid(), sizeof(long), num_weights, cache_file);
+	fwrite(local_remap_weights->get_indexes_dst_grid(), sizeof(long), num_weights, cache_file);
+	fwrite(local_remap_weights->get_weight_values(), sizeof(double), num_weights, cache_file);
+	fwrite(&num_remaped_dst_cells_indexes, sizeof(long), 1, cache_file);
+	fwrite(local_remap_weights->get_remaped_dst_cells_indexes(), sizeof(long), num_remaped_dst_cells_indexes, cache_file);
+	write_succeeded = ferror(cache_file) == 0;
+	write_succeeded = fclose(cache_file) == 0 && write_succeeded;
+	if (write_succeeded)
+		write_succeeded = rename(temp_cache_file_name, cache_file_name) == 0;
+	if (!write_succeeded) {
+		remove(temp_cache_file_name);
+		EXECUTION_REPORT(REPORT_WARNING, comp_id, false, "Failed to write the file \"%s\" for caching the remapping weights. The remapping weights will not be cached", cache_file_name);
+		return;
+	}
+
+	EXECUTION_REPORT_LOG(REPORT_LOG, comp_id, true, "Save %ld local remapping weights into the cache file \"%s\"", num_weights, cache_file_name);
+}
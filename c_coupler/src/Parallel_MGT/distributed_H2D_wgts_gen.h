@@ -57,6 +57,7 @@ class Distributed_H2D_weights_generator
 		Remapping_grid_domain_decomp_engine *remapping_grid_domain_decomp_engine;
 
 		void append_wgt_sparse_matrix(std::vector<Normal_distributed_wgt_element> &, Remap_weight_sparse_matrix *);
+		void report_subdomains_workload_time(Comp_comm_group_mgt_node *, const char *, double);
 
 	public:
 		Distributed_H2D_weights_generator(int, int, int, int, Remap_operator_basis *);
@@ -69,6 +70,32 @@ class Distributed_H2D_weights_generator
 };
 
 
+#define LOCAL_H2D_REMAP_WEIGHTS_CACHE_VERSION      2
+#define NUM_LOCAL_H2D_REMAP_WEIGHTS_CACHE_KEYS     24
+
+
+class Local_H2D_remap_weights_cache
+{
+	private:
+		int comp_id;
+		int dst_decomp_id;
+		MPI_Comm comm;
+		long cache_keys[NUM_LOCAL_H2D_REMAP_WEIGHTS_CACHE_KEYS];
+		char remap_weights_name[NAME_STR_SIZE];
+		char H2D_remapping_wgt_file_name[NAME_STR_SIZE];
+		char cache_file_name[NAME_STR_SIZE*2];
+
+		bool read_data_from_cache_file(void *, long, FILE *);
+		void calculate_vertexes_and_area_checksums(Comp_comm_group_mgt_node *, Original_grid_info *, long *);
+
+	public:
+		Local_H2D_remap_weights_cache(int, int, int, int, Remap_operator_basis *, const char *, const char *);
+		~Local_H2D_remap_weights_cache() {}
+		Remap_weight_sparse_matrix *load_local_remap_weights(Remap_operator_basis *);
+		void save_local_remap_weights(Remap_weight_sparse_matrix *);
+};
+
+
 extern void sort_normal_remapping_weights_in_sparse_matrix_locally(Remap_weight_sparse_matrix *);
 
 
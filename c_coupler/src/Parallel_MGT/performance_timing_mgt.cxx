@@ -9,11 +9,116 @@
 
 #include <mpi.h>
 #include <string.h>
+#include <sys/time.h>
 #include "performance_timing_mgt.h"
 #include "global_data.h"
+#include "dictionary.h"
 
 
-Performance_timing_unit::Performance_timing_unit(int comp_id, int unit_type, int unit_behavior, int unit_int_keyword, const char *unit_char_keyword)
+Performance_trace_recorder::Performance_trace_recorder(int comp_id)
+{
+    this->comp_id = comp_id;
+    events = new Performance_trace_event [PERFORMANCE_TRACE_BUFFER_SIZE];
+    num_recorded_events = 0;
+    time_mgr = NULL;
+    stopped = false;
+}
+
+
+Performance_trace_recorder::~Performance_trace_recorder()
+{
+    delete [] events;
+}
+
+
+void Performance_trace_recorder::record_event(int unit_id, double time, bool is_start)
+{
+    Performance_trace_event *event = events + (num_recorded_events % PERFORMANCE_TRACE_BUFFER_SIZE);
+
+
+    if (time_mgr == NULL && components_time_mgrs != NULL)
+        time_mgr = components_time_mgrs->get_time_mgr(comp_id);
+    event->time = time;
+    event->unit_id = unit_id;
+    event->is_start = is_start;
+    if (time_mgr != NULL) {
+        event->model_date = time_mgr->get_current_date();
+        event->model_second = time_mgr->get_current_second();
+    }
+    else {
+        event->model_date = -1;
+        event->model_second = -1;
+    }
+    num_recorded_events ++;
+}
+
+
+static void write_json_string(FILE *fp, const char *string)
+{
+    fputc('"', fp);
+    for (int i = 0; string[i] != '\0'; i ++) {
+        if (string[i] == '"' || string[i] == '\\')
+            fputc('\\', fp);
+        if ((unsigned char) string[i] >= 0x20)
+            fputc(string[i], fp);
+    }
+    fputc('"', fp);
+}
+
+
+/* Each pair of start and stop events of a timing unit becomes a complete event ("ph":"X") in the Chrome trace 
+   format, whose time stamp and duration are in microseconds. The time stamps are shifted from the process-local 
+   clock of wtime to the wall clock, so that the trace files of different processes can be loaded together */
+void Performance_trace_recorder::write_chrome_trace_file(const char *file_name, std::vector<Performance_timing_unit*> &timing_units, int global_proc_id)
+{
+    std::vector<long> start_event_index(timing_units.size(), -1);
+    long first_event_index = num_recorded_events > PERFORMANCE_TRACE_BUFFER_SIZE? num_recorded_events - PERFORMANCE_TRACE_BUFFER_SIZE : 0;
+    const char *category_names[5] = {"", "communication", "IO", "computation", "model_run"};
+    char unit_label[256];
+    struct timeval wall_time;
+    double local_time, time_offset;
+    bool first_record = true;
+    FILE *fp;
+
+
+    gettimeofday(&wall_time, NULL);
+    wtime(&local_time);
+    time_offset = wall_time.tv_sec + 1.0e-6*wall_time.tv_usec - local_time;
+
+    fp = fopen(file_name, "w");
+    EXECUTION_REPORT(REPORT_ERROR, comp_id, fp != NULL, "Fail to open the performance trace file \"%s\". Please check the directory of performance traces", file_name);
+    fprintf(fp, "{\"traceEvents\":[\n");
+    if (num_recorded_events > PERFORMANCE_TRACE_BUFFER_SIZE) {
+        fprintf(fp, "{\"name\":\"trace buffer overflow: %ld earliest events are dropped\",\"ph\":\"i\",\"s\":\"p\",\"ts\":%.3lf,\"pid\":%d,\"tid\":%d}", first_event_index, 
+                (events[first_event_index%PERFORMANCE_TRACE_BUFFER_SIZE].time+time_offset)*1.0e6, global_proc_id, comp_id);
+        first_record = false;
+    }
+    for (long i = first_event_index; i < num_recorded_events; i ++) {
+        Performance_trace_event *event = events + (i % PERFORMANCE_TRACE_BUFFER_SIZE);
+        if (event->is_start) {
+            start_event_index[event->unit_id] = i;
+            continue;
+        }
+        if (start_event_index[event->unit_id] == -1)
+            continue;
+        Performance_trace_event *start_event = events + (start_event_index[event->unit_id] % PERFORMANCE_TRACE_BUFFER_SIZE);
+        start_event_index[event->unit_id] = -1;
+        timing_units[event->unit_id]->get_unit_label(unit_label);
+        if (!first_record)
+            fprintf(fp, ",\n");
+        first_record = false;
+        fprintf(fp, "{\"name\":");
+        write_json_string(fp, unit_label);
+        fprintf(fp, ",\"cat\":\"%s\",\"ph\":\"X\",\"ts\":%.3lf,\"dur\":%.3lf,\"pid\":%d,\"tid\":%d,\"args\":{\"model_date\":%d,\"model_second\":%d}}", 
+                category_names[timing_units[event->unit_id]->get_unit_type()], (start_event->time+time_offset)*1.0e6, (event->time-start_event->time)*1.0e6, 
+                global_proc_id, comp_id, start_event->model_date, start_event->model_second);
+    }
+    fprintf(fp, "\n],\"displayTimeUnit\":\"ms\"}\n");
+    fclose(fp);
+}
+
+
+Performance_timing_unit::Performance_timing_unit(Performance_timing_mgt *timing_mgr, int comp_id, int unit_id, int unit_type, int unit_behavior, int unit_int_keyword, const char *unit_char_keyword)
 {
     check_timing_unit(unit_type, unit_behavior, unit_int_keyword, unit_char_keyword);
     this->previous_time = -1.0;
@@ -22,10 +127,63 @@ Performance_timing_unit::Performance_timing_unit(int comp_id, int unit_type, int
     this->unit_behavior = unit_behavior;
     this->unit_int_keyword = unit_int_keyword;
     this->comp_id = comp_id;
+    this->unit_id = unit_id;
+    this->timing_mgr = timing_mgr;
     EXECUTION_REPORT_ERROR_OPTIONALLY(REPORT_ERROR, -1, unit_char_keyword != NULL, "the keyword (last paremeter of the interface) of a performance timing unit for computation task can not be NULL");
     if (unit_type == TIMING_TYPE_COMPUTATION || unit_type == TIMING_TYPE_COMMUNICATION || unit_type == TIMING_TYPE_MODEL_RUN)
         strcpy(this->unit_char_keyword, unit_char_keyword);
     else this->unit_char_keyword[0] = '\0';
+    memset(&trace_histogram, 0, sizeof(Performance_trace_histogram));
+    get_unit_label(trace_histogram.unit_label);
+}
+
+
+void Performance_timing_unit::get_unit_label(char *unit_label)
+{
+    const char *behavior_name = "";
+
+
+    if (unit_type == TIMING_TYPE_IO) {
+        if (unit_behavior == TIMING_IO_INPUT)
+            strcpy(unit_label, "IO input");
+        else if (unit_behavior == TIMING_IO_OUTPUT)
+            strcpy(unit_label, "IO output");
+        else if (unit_behavior == TIMING_OUTPUT_ALL)
+            strcpy(unit_label, "IO output all");
+        else strcpy(unit_label, "IO restart");
+        return;
+    }
+
+    if (unit_type == TIMING_TYPE_COMMUNICATION) {
+        switch (unit_behavior) {
+            case TIMING_COMMUNICATION_SEND_WAIT:
+                behavior_name = "send wait";
+                break;
+            case TIMING_COMMUNICATION_RECV_WAIT:
+                behavior_name = "receive wait";
+                break;
+            case TIMING_COMMUNICATION_SENDRECV:
+                behavior_name = "send and receive";
+                break;
+            case TIMING_COMMUNICATION_SEND_QUERRY:
+                behavior_name = "send querry";
+                break;
+            case TIMING_COMMUNICATION_RECV_QUERRY:
+                behavior_name = "receive querry";
+                break;
+            case TIMING_COMMUNICATION_SEND:
+                behavior_name = "send";
+                break;
+            case TIMING_COMMUNICATION_RECV:
+                behavior_name = "receive";
+                break;
+        }
+    }
+    else if (unit_type == TIMING_TYPE_COMPUTATION)
+        behavior_name = "computation";
+    else if (unit_type == TIMING_TYPE_MODEL_RUN)
+        behavior_name = "model run";
+    snprintf(unit_label, 256, "%s: %s", behavior_name, unit_char_keyword);
 }
 
 
@@ -73,6 +231,7 @@ void Performance_timing_unit::timing_start()
 {
     EXECUTION_REPORT_ERROR_OPTIONALLY(REPORT_ERROR, -1, previous_time == -1.0, "C-Coupler or model error in starting performance timing: timing unit (%s) has not been stoped", unit_char_keyword);
     wtime(&previous_time);
+    timing_mgr->record_trace_event(unit_id, previous_time, true);
 }
 
 
@@ -83,8 +242,19 @@ void Performance_timing_unit::timing_stop()
 
     EXECUTION_REPORT_ERROR_OPTIONALLY(REPORT_ERROR, -1, previous_time != -1.0, "C-Coupler or model error in stopping performance timing: timing unit has not been started");
     wtime(&current_time);
-    if (current_time >= previous_time)
+    if (current_time >= previous_time) {
         total_time += current_time - previous_time;
+        if (timing_mgr->record_trace_event(unit_id, current_time, false)) {
+            int bin = 0;
+            for (double duration = (current_time-previous_time)*1.0e6; duration >= 2.0 && bin < PERFORMANCE_TRACE_NUM_HISTOGRAM_BINS-1; duration /= 2.0)
+                bin ++;
+            trace_histogram.bins[bin] ++;
+            trace_histogram.num_durations ++;
+            trace_histogram.total_duration += current_time - previous_time;
+            if (trace_histogram.max_duration < current_time - previous_time)
+                trace_histogram.max_duration = current_time - previous_time;
+        }
+    }
     previous_time = -1.0;
 }
 
@@ -124,15 +294,35 @@ void Performance_timing_unit::timing_output()
 }
 
 
+Performance_timing_mgt::Performance_timing_mgt(int comp_id)
+{
+    this->comp_id = comp_id;
+    trace_recorder = NULL;
+    timing_units_index = new Dictionary<int>(1024);
+}
+
+
+/* The key only has the keywords that match_timing_unit compares, so that a key identifies one timing unit */
+void Performance_timing_mgt::calculate_timing_unit_key(int unit_type, int unit_behavior, const char *unit_char_keyword, char *unit_key)
+{
+    sprintf(unit_key, "%d %d %s", unit_type, unit_type == TIMING_TYPE_COMMUNICATION || unit_type == TIMING_TYPE_IO? unit_behavior : 0, unit_type != TIMING_TYPE_IO && unit_char_keyword != NULL? unit_char_keyword : "");
+}
+
+
 int Performance_timing_mgt::search_timing_unit(int unit_type, int unit_behavior, int unit_int_keyword, const char *unit_char_keyword)
 {
-    int i;
-    
-    for (i = 0; i < performance_timing_units.size(); i ++)
-        if (performance_timing_units[i]->match_timing_unit(unit_type, unit_behavior, unit_int_keyword, unit_char_keyword))
-            return i;
+    char unit_key[512];
+    int unit_index;
 
-    performance_timing_units.push_back(new Performance_timing_unit(comp_id, unit_type, unit_behavior, unit_int_keyword, unit_char_keyword));
+
+    calculate_timing_unit_key(unit_type, unit_behavior, unit_char_keyword, unit_key);
+    unit_index = timing_units_index->search(unit_key, false);
+    if (unit_index != 0 && performance_timing_units[unit_index-1]->match_timing_unit(unit_type, unit_behavior, unit_int_keyword, unit_char_keyword))
+        return unit_index - 1;
+    EXECUTION_REPORT_ERROR_OPTIONALLY(REPORT_ERROR, -1, unit_index == 0, "Software error in Performance_timing_mgt::search_timing_unit: the timing unit of the key \"%s\" does not match", unit_key);
+
+    performance_timing_units.push_back(new Performance_timing_unit(this, comp_id, performance_timing_units.size(), unit_type, unit_behavior, unit_int_keyword, unit_char_keyword));
+    timing_units_index->insert(unit_key, performance_timing_units.size());
     return performance_timing_units.size() - 1;
 }
 
@@ -155,6 +345,27 @@ void Performance_timing_mgt::performance_timing_add(int unit_type, int unit_beha
 }
 
 
+void Performance_timing_mgt::performance_timing_start(int handle)
+{
+    EXECUTION_REPORT_ERROR_OPTIONALLY(REPORT_ERROR, -1, handle >= 0 && handle < performance_timing_units.size(), "Software error in Performance_timing_mgt::performance_timing_start: wrong handle of timing unit");
+    performance_timing_units[handle]->timing_start();
+}
+
+
+void Performance_timing_mgt::performance_timing_stop(int handle)
+{
+    EXECUTION_REPORT_ERROR_OPTIONALLY(REPORT_ERROR, -1, handle >= 0 && handle < performance_timing_units.size(), "Software error in Performance_timing_mgt::performance_timing_stop: wrong handle of timing unit");
+    performance_timing_units[handle]->timing_stop();
+}
+
+
+void Performance_timing_mgt::performance_timing_add(int handle, double time_inc)
+{
+    EXECUTION_REPORT_ERROR_OPTIONALLY(REPORT_ERROR, -1, handle >= 0 && handle < performance_timing_units.size(), "Software error in Performance_timing_mgt::performance_timing_add: wrong handle of timing unit");
+    performance_timing_units[handle]->timing_add(time_inc);
+}
+
+
 void Performance_timing_mgt::performance_timing_output()
 {
     for (int i = 0; i < performance_timing_units.size(); i ++)
@@ -169,9 +380,90 @@ void Performance_timing_mgt::performance_timing_reset()
 }
 
 
+bool Performance_timing_mgt::record_trace_event(int unit_id, double time, bool is_start)
+{
+    if (trace_recorder == NULL) {
+        if (comp_comm_group_mgt_mgr == NULL || !comp_comm_group_mgt_mgr->get_performance_trace_enabled())
+            return false;
+        trace_recorder = new Performance_trace_recorder(comp_id);
+    }
+    if (trace_recorder->is_stopped())
+        return false;
+
+    trace_recorder->record_event(unit_id, time, is_start);
+    return true;
+}
+
+
+/* Collective among the processes of the component model: each process dumps its trace file, and the histograms 
+   of the durations of the timing units are merged by unit label into one summary file of the component model. 
+   The bin i (i > 0) of a histogram counts the durations in [2^i, 2^(i+1)) microseconds */
+void Performance_timing_mgt::performance_trace_output()
+{
+    Comp_comm_group_mgt_node *comp_node = comp_comm_group_mgt_mgr->get_global_node_of_local_comp(comp_id, false, "in Performance_timing_mgt::performance_trace_output");
+    std::vector<Performance_trace_histogram> local_histograms, merged_histograms;
+    Performance_trace_histogram *all_histograms = NULL;
+    long num_all_histograms;
+    char file_name[NAME_STR_SIZE];
+    FILE *fp;
+
+
+    if (trace_recorder != NULL && !trace_recorder->is_stopped()) {
+        sprintf(file_name, "%s/%s.proc%d.json", comp_comm_group_mgt_mgr->get_performance_trace_dir(), comp_node->get_full_name(), comp_node->get_current_proc_local_id());
+        trace_recorder->write_chrome_trace_file(file_name, performance_timing_units, comp_comm_group_mgt_mgr->get_current_proc_global_id());
+        trace_recorder->stop();
+    }
+
+    for (int i = 0; i < performance_timing_units.size(); i ++)
+        if (performance_timing_units[i]->get_trace_histogram()->num_durations > 0)
+            local_histograms.push_back(*(performance_timing_units[i]->get_trace_histogram()));
+    gather_array_in_one_comp(comp_node->get_num_procs(), comp_node->get_current_proc_local_id(), local_histograms.size() > 0? &(local_histograms[0]) : NULL, local_histograms.size(), 
+                             sizeof(Performance_trace_histogram), NULL, (void**)(&all_histograms), num_all_histograms, comp_node->get_comm_group());
+    if (comp_node->get_current_proc_local_id() != 0)
+        return;
+
+    for (long i = 0; i < num_all_histograms; i ++) {
+        int j;
+        for (j = 0; j < merged_histograms.size(); j ++)
+            if (words_are_the_same(merged_histograms[j].unit_label, all_histograms[i].unit_label))
+                break;
+        if (j == merged_histograms.size()) {
+            merged_histograms.push_back(all_histograms[i]);
+            continue;
+        }
+        merged_histograms[j].num_durations += all_histograms[i].num_durations;
+        merged_histograms[j].total_duration += all_histograms[i].total_duration;
+        if (merged_histograms[j].max_duration < all_histograms[i].max_duration)
+            merged_histograms[j].max_duration = all_histograms[i].max_duration;
+        for (int k = 0; k < PERFORMANCE_TRACE_NUM_HISTOGRAM_BINS; k ++)
+            merged_histograms[j].bins[k] += all_histograms[i].bins[k];
+    }
+    if (all_histograms != NULL)
+        delete [] ((char*) all_histograms);
+
+    sprintf(file_name, "%s/%s.histogram.txt", comp_comm_group_mgt_mgr->get_performance_trace_dir(), comp_node->get_full_name());
+    fp = fopen(file_name, "w");
+    EXECUTION_REPORT(REPORT_ERROR, comp_id, fp != NULL, "Fail to open the performance histogram file \"%s\". Please check the directory of performance traces", file_name);
+    fprintf(fp, "# histograms of the durations of the performance timing units of the component model \"%s\", merged among its %d processes\n", comp_node->get_full_name(), comp_node->get_num_procs());
+    fprintf(fp, "# bin 0 counts the durations shorter than 2 microseconds; bin i (i > 0) counts the durations in [2^i, 2^(i+1)) microseconds\n");
+    for (int j = 0; j < merged_histograms.size(); j ++) {
+        fprintf(fp, "\n%s\n", merged_histograms[j].unit_label);
+        fprintf(fp, "    count %ld, total %lf seconds, mean %lf seconds, max %lf seconds\n", merged_histograms[j].num_durations, merged_histograms[j].total_duration, 
+                merged_histograms[j].total_duration/merged_histograms[j].num_durations, merged_histograms[j].max_duration);
+        for (int k = 0; k < PERFORMANCE_TRACE_NUM_HISTOGRAM_BINS; k ++)
+            if (merged_histograms[j].bins[k] > 0)
+                fprintf(fp, "    bin %2d: %ld\n", k, merged_histograms[j].bins[k]);
+    }
+    fclose(fp);
+}
+
+
 Performance_timing_mgt::~Performance_timing_mgt()
 {
     for (int i = 0; i < performance_timing_units.size(); i ++)
         delete performance_timing_units[i];
+    if (trace_recorder != NULL)
+        delete trace_recorder;
+    delete timing_units_index;
 }
 
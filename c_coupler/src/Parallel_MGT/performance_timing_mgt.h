@@ -42,6 +42,58 @@
 #define TIMING_MODEL_RUN                 41
 
 
+#define PERFORMANCE_TRACE_BUFFER_SIZE           65536
+#define PERFORMANCE_TRACE_NUM_HISTOGRAM_BINS    32
+
+
+class Time_mgt;
+class Performance_timing_mgt;
+template <class T> class Dictionary;
+class Performance_timing_unit;
+
+
+struct Performance_trace_event
+{
+    double time;
+    int unit_id;
+    int model_date;
+    int model_second;
+    bool is_start;
+};
+
+
+struct Performance_trace_histogram
+{
+    char unit_label[256];
+    long num_durations;
+    long bins[PERFORMANCE_TRACE_NUM_HISTOGRAM_BINS];
+    double total_duration;
+    double max_duration;
+};
+
+
+/* The trace recorder keeps the start and stop events of the timing units of a component model in a ring 
+   buffer that is allocated once, so that recording an event does not allocate memory. When the buffer 
+   is full, the oldest events are overwritten */
+class Performance_trace_recorder
+{
+    private:
+        int comp_id;
+        Performance_trace_event *events;
+        long num_recorded_events;
+        Time_mgt *time_mgr;
+        bool stopped;
+
+    public:
+        Performance_trace_recorder(int);
+        ~Performance_trace_recorder();
+        void record_event(int, double, bool);
+        void write_chrome_trace_file(const char*, std::vector<Performance_timing_unit*>&, int);
+        void stop() { stopped = true; }
+        bool is_stopped() { return stopped; }
+};
+
+
 class Performance_timing_unit
 {
     private:
@@ -52,11 +104,14 @@ class Performance_timing_unit
         double previous_time;
         double total_time;
         int comp_id;
+        int unit_id;
+        Performance_timing_mgt *timing_mgr;
+        Performance_trace_histogram trace_histogram;
 
         void check_timing_unit(int, int, int, const char*);
 
     public:
-        Performance_timing_unit(int, int, int, int, const char*);
+        Performance_timing_unit(Performance_timing_mgt*, int, int, int, int, int, const char*);
         ~Performance_timing_unit(){}
         void timing_start();
         void timing_stop();
@@ -64,24 +119,39 @@ class Performance_timing_unit
         bool match_timing_unit(int, int, int, const char*);
         void timing_add(double time_inc) { total_time += time_inc; }
         void timing_reset() { total_time = 0.0; }
+        int get_unit_type() { return unit_type; }
+        void get_unit_label(char*);
+        Performance_trace_histogram *get_trace_histogram() { return &trace_histogram; }
 };
 
 
+/* The timing units are indexed in a hashing table by their keywords, so that searching a timing unit does not 
+   scan all timing units. A caller on a hot path can further get the handle of a timing unit once and then 
+   start, stop or add the timing through the handle directly */
 class Performance_timing_mgt
 {
     private:
         std::vector<Performance_timing_unit*> performance_timing_units;
+        Dictionary<int> *timing_units_index;
         int search_timing_unit(int, int, int, const char*);
+        void calculate_timing_unit_key(int, int, const char*, char*);
         int comp_id;
+        Performance_trace_recorder *trace_recorder;
 
     public: 
-        Performance_timing_mgt(int comp_id) { this->comp_id = comp_id; }
+        Performance_timing_mgt(int);
         ~Performance_timing_mgt();
+        int get_timing_unit_handle(int unit_type, int unit_behavior, int unit_int_keyword, const char *unit_char_keyword) { return search_timing_unit(unit_type, unit_behavior, unit_int_keyword, unit_char_keyword); }
         void performance_timing_start(int, int, int, const char*);
         void performance_timing_stop(int, int, int, const char*);
         void performance_timing_add(int, int, int, const char*, double);
+        void performance_timing_start(int);
+        void performance_timing_stop(int);
+        void performance_timing_add(int, double);
         void performance_timing_output();
         void performance_timing_reset();
+        bool record_trace_event(int, double, bool);
+        void performance_trace_output();
 };
 
 #endif
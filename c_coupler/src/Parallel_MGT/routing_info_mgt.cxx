@@ -14,6 +14,7 @@
 #include "global_data.h"
 #include "cor_global_data.h"
 #include "CCPL_api_mgt.h"
+#include "dictionary.h"
 #include <stdio.h>
 #include <math.h>
 #include <algorithm>
@@ -24,6 +25,7 @@
 Routing_info *Routing_info_mgt::search_or_add_router(const int src_comp_id, const int dst_comp_id, const char *src_decomp_name, const char *dst_decomp_name)
 {
     Routing_info *router;
+    char router_key[NAME_STR_SIZE*3];
 
     router = search_router(src_comp_id, dst_comp_id, src_decomp_name, dst_decomp_name);
 
@@ -34,23 +36,55 @@ Routing_info *Routing_info_mgt::search_or_add_router(const int src_comp_id, cons
 
     router = new Routing_info(src_comp_id, dst_comp_id, src_decomp_name, dst_decomp_name);
     routers.push_back(router);
+    calculate_router_key(dst_comp_id, src_decomp_name, dst_decomp_name, router_key);
+    if (routers_index->search(router_key, false) == 0) {
+        routers_index_buckets.push_back(std::vector<int>());
+        routers_index->insert(router_key, routers_index_buckets.size());
+    }
+    routers_index_buckets[routers_index->search(router_key, false)-1].push_back(routers.size()-1);
 
     return router;
 }
 
 
+Routing_info_mgt::Routing_info_mgt()
+{
+    routers_index = new Dictionary<int>(1024);
+}
+
+
 Routing_info_mgt::~Routing_info_mgt()
 {
     for (int i = 0; i < routers.size(); i ++)
         delete routers[i];
+    delete routers_index;
+}
+
+
+/* The ID of the target component model identifies its full name, so that the key does not need to search the global node of the component model */
+void Routing_info_mgt::calculate_router_key(const int dst_comp_id, const char *src_decomp_name, const char *dst_decomp_name, char *router_key)
+{
+    sprintf(router_key, "%x %s %s", dst_comp_id, src_decomp_name, dst_decomp_name);
 }
 
 
+/* The routers are indexed in a hashing table by the ID of the target component model and the names of the decompositions, so that 
+   searching a router does not scan all routers. The source component model is left out of the key because it may be resolved to the 
+   host component model of the source decomposition when matching a router, so the routers of a key are kept in a bucket */
 Routing_info *Routing_info_mgt::search_router(const int src_comp_id, const int dst_comp_id, const char *src_decomp_name, const char *dst_decomp_name)
 {
-    for (int i = 0; i < routers.size(); i ++)
-        if (routers[i]->match_router(src_comp_id, dst_comp_id, src_decomp_name, dst_decomp_name))
-            return routers[i];
+    char router_key[NAME_STR_SIZE*3];
+    int bucket_id;
+
+
+    calculate_router_key(dst_comp_id, src_decomp_name, dst_decomp_name, router_key);
+    bucket_id = routers_index->search(router_key, false);
+    if (bucket_id == 0)
+        return NULL;
+    std::vector<int> &candidate_routers = routers_index_buckets[bucket_id-1];
+    for (int i = 0; i < candidate_routers.size(); i ++)
+        if (routers[candidate_routers[i]]->match_router(src_comp_id, dst_comp_id, src_decomp_name, dst_decomp_name))
+            return routers[candidate_routers[i]];
 
     return NULL;
 }
@@ -111,9 +145,19 @@ Routing_info::Routing_info(const int src_comp_id, const int dst_comp_id, const c
         if (current_proc_id_src_comp != -1)
             src_comp_node->get_performance_timing_mgr()->performance_timing_start(TIMING_TYPE_COMPUTATION, -1, -1, "generating routing information new");
         else dst_comp_node->get_performance_timing_mgr()->performance_timing_start(TIMING_TYPE_COMPUTATION, -1, -1, "generating routing information new");
-        calculate_routing_mapping_tables();
-		if (!report_error_enabled)
-			build_router_based_on_routing_mapping_tables();
+        if (!report_error_enabled && comp_comm_group_mgt_mgr->get_routing_info_cache_enabled()) {
+            initialize_routing_info_cache();
+            if (!load_routing_info_from_cache()) {
+                calculate_routing_mapping_tables();
+                build_router_based_on_routing_mapping_tables();
+                save_routing_info_into_cache();
+            }
+        }
+        else {
+            calculate_routing_mapping_tables();
+            if (!report_error_enabled)
+                build_router_based_on_routing_mapping_tables();
+        }
         if (current_proc_id_src_comp != -1)
             src_comp_node->get_performance_timing_mgr()->performance_timing_stop(TIMING_TYPE_COMPUTATION, -1, -1, "generating routing information new");
         else dst_comp_node->get_performance_timing_mgr()->performance_timing_stop(TIMING_TYPE_COMPUTATION, -1, -1, "generating routing information new");        
@@ -853,3 +897,280 @@ Comp_comm_group_mgt_node *Routing_info::get_dst_comp_node()
 { 
     return comp_comm_group_mgt_mgr->search_global_node(true_dst_comp_full_name); 
 }
+
+
+
+/* The routing information of each process (the segments of local cells to be sent to or received from each remote process) is 
+   cached in a binary file in the directory of routing information cache. The cache file is only used when the names of the 
+   components and decompositions, the processes of the two components and the parallel decompositions on both sides are all the 
+   same as those when generating the file, so that the distributed sorting and the exchange of the routing mapping tables can be
+   skipped */
+long Routing_info::calculate_decomp_layout_checksum(Decomp_info *decomp_info, Comp_comm_group_mgt_node *comp_node, int current_proc_id)
+{
+    long local_layout_checksum, layout_checksum;
+
+
+    local_layout_checksum = calculate_checksum_of_array(decomp_info->get_local_cell_global_indx(), decomp_info->get_num_local_cells(), sizeof(int), NULL, MPI_COMM_NULL) + decomp_info->get_num_local_cells();
+    if (decomp_info->get_local_cell_chunk_id() != NULL)
+        local_layout_checksum += calculate_checksum_of_array(decomp_info->get_local_cell_chunk_id(), decomp_info->get_num_local_cells(), sizeof(int), NULL, MPI_COMM_NULL);
+    local_layout_checksum *= (current_proc_id + 1);
+    EXECUTION_REPORT(REPORT_ERROR, -1, MPI_Allreduce(&local_layout_checksum, &layout_checksum, 1, MPI_LONG, MPI_SUM, comp_node->get_comm_group()) == MPI_SUCCESS);
+
+    return layout_checksum;
+}
+
+
+void Routing_info::exchange_values_between_components(long *src_values, long *dst_values, int num_values)
+{
+    char *temp_array = NULL;
+    long array_size = sizeof(long)*num_values;
+
+
+    if (current_proc_id_src_comp != -1) {
+        temp_array = new char [array_size];
+        memcpy(temp_array, src_values, array_size);
+    }
+    transfer_array_from_one_comp_to_another(current_proc_id_src_comp, src_comp_node->get_local_proc_global_id(0), current_proc_id_dst_comp, dst_comp_node->get_local_proc_global_id(0), dst_comp_node->get_comm_group(), &temp_array, array_size);
+    if (current_proc_id_dst_comp != -1)
+        memcpy(src_values, temp_array, array_size);
+    if (temp_array != NULL)
+        delete [] temp_array;
+
+    temp_array = NULL;
+    array_size = sizeof(long)*num_values;
+    if (current_proc_id_dst_comp != -1) {
+        temp_array = new char [array_size];
+        memcpy(temp_array, dst_values, array_size);
+    }
+    transfer_array_from_one_comp_to_another(current_proc_id_dst_comp, dst_comp_node->get_local_proc_global_id(0), current_proc_id_src_comp, src_comp_node->get_local_proc_global_id(0), src_comp_node->get_comm_group(), &temp_array, array_size);
+    if (current_proc_id_src_comp != -1)
+        memcpy(dst_values, temp_array, array_size);
+    if (temp_array != NULL)
+        delete [] temp_array;
+}
+
+
+void Routing_info::initialize_routing_info_cache()
+{
+    int num_src_procs = src_comp_node->get_num_procs(), num_dst_procs = dst_comp_node->get_num_procs();
+    int *procs_global_ids = new int [num_src_procs+num_dst_procs];
+    long src_layout_checksum = 0, dst_layout_checksum = 0;
+
+
+    routing_info_cache_keys[0] = ROUTING_INFO_CACHE_VERSION;
+    routing_info_cache_keys[1] = calculate_checksum_of_array(src_comp_full_name, strlen(src_comp_full_name), sizeof(char), NULL, MPI_COMM_NULL) + 3*calculate_checksum_of_array(index_dst_comp_full_name, strlen(index_dst_comp_full_name), sizeof(char), NULL, MPI_COMM_NULL) +
+                                 7*calculate_checksum_of_array(true_dst_comp_full_name, strlen(true_dst_comp_full_name), sizeof(char), NULL, MPI_COMM_NULL) + 11*calculate_checksum_of_array(src_decomp_name, strlen(src_decomp_name), sizeof(char), NULL, MPI_COMM_NULL) +
+                                 13*calculate_checksum_of_array(dst_decomp_name, strlen(dst_decomp_name), sizeof(char), NULL, MPI_COMM_NULL);
+    routing_info_cache_keys[2] = num_src_procs;
+    routing_info_cache_keys[3] = num_dst_procs;
+    for (int i = 0; i < num_src_procs; i ++)
+        procs_global_ids[i] = src_comp_node->get_local_proc_global_id(i);
+    for (int i = 0; i < num_dst_procs; i ++)
+        procs_global_ids[num_src_procs+i] = dst_comp_node->get_local_proc_global_id(i);
+    routing_info_cache_keys[4] = calculate_checksum_of_array(procs_global_ids, num_src_procs+num_dst_procs, sizeof(int), NULL, MPI_COMM_NULL);
+    delete [] procs_global_ids;
+    routing_info_cache_keys[5] = current_proc_id_src_comp;
+    routing_info_cache_keys[6] = current_proc_id_dst_comp;
+    routing_info_cache_keys[7] = -1;
+    routing_info_cache_keys[8] = -1;
+    if (current_proc_id_src_comp != -1) {
+        EXECUTION_REPORT_ERROR_OPTIONALLY(REPORT_ERROR, -1, src_decomp_info != NULL, "Software error in Routing_info::initialize_routing_info_cache: NULL src decomp info");
+        routing_info_cache_keys[7] = src_decomp_info->get_num_local_cells();
+        src_layout_checksum = calculate_decomp_layout_checksum(src_decomp_info, src_comp_node, current_proc_id_src_comp);
+    }
+    if (current_proc_id_dst_comp != -1) {
+        EXECUTION_REPORT_ERROR_OPTIONALLY(REPORT_ERROR, -1, dst_decomp_info != NULL, "Software error in Routing_info::initialize_routing_info_cache: NULL dst decomp info");
+        routing_info_cache_keys[8] = dst_decomp_info->get_num_local_cells();
+        dst_layout_checksum = calculate_decomp_layout_checksum(dst_decomp_info, dst_comp_node, current_proc_id_dst_comp);
+    }
+    exchange_values_between_components(&src_layout_checksum, &dst_layout_checksum, 1);
+    routing_info_cache_keys[9] = src_layout_checksum;
+    routing_info_cache_keys[10] = dst_layout_checksum;
+    routing_info_cache_keys[11] = current_proc_id_src_comp != -1? src_decomp_info->get_num_global_cells() : -1;
+    routing_info_cache_keys[12] = current_proc_id_dst_comp != -1? dst_decomp_info->get_num_global_cells() : -1;
+    routing_info_cache_keys[13] = sizeof(Routing_info_with_one_process);
+
+    sprintf(routing_info_cache_file_name, "%s/ROUTER__%lx__%d_%d__%d_%d.bin", comp_comm_group_mgt_mgr->get_routing_info_cache_dir(), routing_info_cache_keys[1], num_src_procs, num_dst_procs, current_proc_id_src_comp, current_proc_id_dst_comp);
+}
+
+
+bool Routing_info::read_routing_info_with_one_process_from_cache(std::vector<Routing_info_with_one_process *> &routing_info_with_procs, bool is_send, FILE *cache_file, long file_size)
+{
+    Routing_info_with_one_process *routing_info;
+    int num_remote_procs, num_segments_elements;
+
+
+    if (fread(&num_remote_procs, sizeof(int), 1, cache_file) != 1 || num_remote_procs != (is_send? dst_comp_node->get_num_procs() : src_comp_node->get_num_procs()))
+        return false;
+
+    for (int i = 0; i < num_remote_procs; i ++) {
+        routing_info = new Routing_info_with_one_process;
+        routing_info->send_or_recv = is_send;
+        routing_info->num_elements_transferred = 0;
+        routing_info->local_indx_segment_starts = NULL;
+        routing_info->local_indx_segment_lengths = NULL;
+        routing_info_with_procs.push_back(routing_info);
+        if (fread(&routing_info->remote_proc_global_id, sizeof(int), 1, cache_file) != 1 || fread(&routing_info->num_elements_transferred, sizeof(int), 1, cache_file) != 1 || 
+            fread(&routing_info->num_local_indx_segments, sizeof(int), 1, cache_file) != 1) {
+            routing_info->num_elements_transferred = 0;
+            return false;
+        }
+        if (routing_info->num_elements_transferred == 0)
+            continue;
+        if (routing_info->num_elements_transferred < 0 || routing_info->num_local_indx_segments <= 0 || sizeof(int)*2*((long)routing_info->num_local_indx_segments) > file_size) {
+            routing_info->num_elements_transferred = 0;
+            return false;
+        }
+        routing_info->local_indx_segment_starts = new int [routing_info->num_local_indx_segments];
+        routing_info->local_indx_segment_lengths = new int [routing_info->num_local_indx_segments];
+        if (fread(routing_info->local_indx_segment_starts, sizeof(int), routing_info->num_local_indx_segments, cache_file) != routing_info->num_local_indx_segments ||
+            fread(routing_info->local_indx_segment_lengths, sizeof(int), routing_info->num_local_indx_segments, cache_file) != routing_info->num_local_indx_segments)
+            return false;
+        num_segments_elements = 0;
+        for (int j = 0; j < routing_info->num_local_indx_segments; j ++)
+            num_segments_elements += routing_info->local_indx_segment_lengths[j];
+        if (num_segments_elements != routing_info->num_elements_transferred)
+            return false;
+    }
+
+    return true;
+}
+
+
+bool Routing_info::load_routing_info_from_cache()
+{
+    long file_cache_keys[NUM_ROUTING_INFO_CACHE_KEYS], file_size = 0, local_hit = 0, src_hit = 1, dst_hit = 1;
+    char file_names[5][NAME_STR_SIZE];
+    const char *names[5] = {src_comp_full_name, index_dst_comp_full_name, true_dst_comp_full_name, src_decomp_name, dst_decomp_name};
+    int *file_local_cell_global_indx;
+    bool valid;
+    FILE *cache_file;
+    double time1, time2;
+
+
+    wtime(&time1);
+    cache_file = fopen(routing_info_cache_file_name, "r");
+    if (cache_file != NULL) {
+        fseek(cache_file, 0, SEEK_END);
+        file_size = ftell(cache_file);
+        fseek(cache_file, 0, SEEK_SET);
+        valid = fread(file_cache_keys, sizeof(long), NUM_ROUTING_INFO_CACHE_KEYS, cache_file) == NUM_ROUTING_INFO_CACHE_KEYS;
+        for (int i = 0; valid && i < NUM_ROUTING_INFO_CACHE_KEYS; i ++)
+            valid = file_cache_keys[i] == routing_info_cache_keys[i];
+        for (int i = 0; valid && i < 5; i ++)
+            valid = fread(file_names[i], sizeof(char), NAME_STR_SIZE, cache_file) == NAME_STR_SIZE && words_are_the_same(file_names[i], names[i]);
+        if (valid && current_proc_id_src_comp != -1) {
+            file_local_cell_global_indx = new int [src_decomp_info->get_num_local_cells()+1];
+            valid = fread(file_local_cell_global_indx, sizeof(int), src_decomp_info->get_num_local_cells(), cache_file) == src_decomp_info->get_num_local_cells();
+            for (int i = 0; valid && i < src_decomp_info->get_num_local_cells(); i ++)
+                valid = file_local_cell_global_indx[i] == src_decomp_info->get_local_cell_global_indx()[i];
+            delete [] file_local_cell_global_indx;
+        }
+        if (valid && current_proc_id_dst_comp != -1) {
+            file_local_cell_global_indx = new int [dst_decomp_info->get_num_local_cells()+1];
+            valid = fread(file_local_cell_global_indx, sizeof(int), dst_decomp_info->get_num_local_cells(), cache_file) == dst_decomp_info->get_num_local_cells();
+            for (int i = 0; valid && i < dst_decomp_info->get_num_local_cells(); i ++)
+                valid = file_local_cell_global_indx[i] == dst_decomp_info->get_local_cell_global_indx()[i];
+            delete [] file_local_cell_global_indx;
+        }
+        if (valid && current_proc_id_src_comp != -1)
+            valid = read_routing_info_with_one_process_from_cache(send_to_remote_procs_routing_info, true, cache_file, file_size);
+        if (valid && current_proc_id_dst_comp != -1)
+            valid = read_routing_info_with_one_process_from_cache(recv_from_remote_procs_routing_info, false, cache_file, file_size);
+        valid = valid && ftell(cache_file) == file_size;
+        fclose(cache_file);
+        local_hit = valid? 1 : 0;
+    }
+
+    if (current_proc_id_src_comp != -1)
+        EXECUTION_REPORT(REPORT_ERROR, -1, MPI_Allreduce(&local_hit, &src_hit, 1, MPI_LONG, MPI_MIN, src_comp_node->get_comm_group()) == MPI_SUCCESS);
+    if (current_proc_id_dst_comp != -1)
+        EXECUTION_REPORT(REPORT_ERROR, -1, MPI_Allreduce(&local_hit, &dst_hit, 1, MPI_LONG, MPI_MIN, dst_comp_node->get_comm_group()) == MPI_SUCCESS);
+    exchange_values_between_components(&src_hit, &dst_hit, 1);
+
+    if (src_hit == 0 || dst_hit == 0) {
+        for (int i = 0; i < send_to_remote_procs_routing_info.size(); i ++) {
+            if (send_to_remote_procs_routing_info[i]->local_indx_segment_starts != NULL)
+                delete [] send_to_remote_procs_routing_info[i]->local_indx_segment_starts;
+            if (send_to_remote_procs_routing_info[i]->local_indx_segment_lengths != NULL)
+                delete [] send_to_remote_procs_routing_info[i]->local_indx_segment_lengths;
+            delete send_to_remote_procs_routing_info[i];
+        }
+        for (int i = 0; i < recv_from_remote_procs_routing_info.size(); i ++) {
+            if (recv_from_remote_procs_routing_info[i]->local_indx_segment_starts != NULL)
+                delete [] recv_from_remote_procs_routing_info[i]->local_indx_segment_starts;
+            if (recv_from_remote_procs_routing_info[i]->local_indx_segment_lengths != NULL)
+                delete [] recv_from_remote_procs_routing_info[i]->local_indx_segment_lengths;
+            delete recv_from_remote_procs_routing_info[i];
+        }
+        send_to_remote_procs_routing_info.clear();
+        recv_from_remote_procs_routing_info.clear();
+        EXECUTION_REPORT_LOG(REPORT_LOG, -1, true, "The cached routing information \"%s\" cannot be used (%ld at the current process) and the router from (%s %s) to (%s %s) will be generated", routing_info_cache_file_name, local_hit, src_comp_full_name, src_decomp_name, index_dst_comp_full_name, dst_decomp_name);
+        return false;
+    }
+
+    wtime(&time2);
+    EXECUTION_REPORT_LOG(REPORT_LOG, -1, true, "Load the router from (%s %s) to (%s %s) from the cache file \"%s\" in %lf seconds", src_comp_full_name, src_decomp_name, index_dst_comp_full_name, dst_decomp_name, routing_info_cache_file_name, time2-time1);
+
+    return true;
+}
+
+
+void Routing_info::write_routing_info_with_one_process_into_cache(std::vector<Routing_info_with_one_process *> &routing_info_with_procs, FILE *cache_file)
+{
+    int num_remote_procs = routing_info_with_procs.size();
+
+
+    fwrite(&num_remote_procs, sizeof(int), 1, cache_file);
+    for (int i = 0; i < num_remote_procs; i ++) {
+        fwrite(&routing_info_with_procs[i]->remote_proc_global_id, sizeof(int), 1, cache_file);
+        fwrite(&routing_info_with_procs[i]->num_elements_transferred, sizeof(int), 1, cache_file);
+        fwrite(&routing_info_with_procs[i]->num_local_indx_segments, sizeof(int), 1, cache_file);
+        if (routing_info_with_procs[i]->num_elements_transferred == 0)
+            continue;
+        fwrite(routing_info_with_procs[i]->local_indx_segment_starts, sizeof(int), routing_info_with_procs[i]->num_local_indx_segments, cache_file);
+        fwrite(routing_info_with_procs[i]->local_indx_segment_lengths, sizeof(int), routing_info_with_procs[i]->num_local_indx_segments, cache_file);
+    }
+}
+
+
+void Routing_info::save_routing_info_into_cache()
+{
+    char temp_cache_file_name[NAME_STR_SIZE*2+16], name_buffer[NAME_STR_SIZE];
+    const char *names[5] = {src_comp_full_name, index_dst_comp_full_name, true_dst_comp_full_name, src_decomp_name, dst_decomp_name};
+    bool write_succeeded;
+    FILE *cache_file;
+
+
+    sprintf(temp_cache_file_name, "%s.tmp", routing_info_cache_file_name);
+    cache_file = fopen(temp_cache_file_name, "w+");
+    if (cache_file == NULL) {
+        EXECUTION_REPORT(REPORT_WARNING, -1, false, "Failed to open the file \"%s\" for caching the routing information. The routing information will not be cached", temp_cache_file_name);
+        return;
+    }
+    fwrite(routing_info_cache_keys, sizeof(long), NUM_ROUTING_INFO_CACHE_KEYS, cache_file);
+    for (int i = 0; i < 5; i ++) {
+        memset(name_buffer, 0, NAME_STR_SIZE);
+        strcpy(name_buffer, names[i]);
+        fwrite(name_buffer, sizeof(char), NAME_STR_SIZE, cache_file);
+    }
+    if (current_proc_id_src_comp != -1)
+        fwrite(src_decomp_info->get_local_cell_global_indx(), sizeof(int), src_decomp_info->get_num_local_cells(), cache_file);
+    if (current_proc_id_dst_comp != -1)
+        fwrite(dst_decomp_info->get_local_cell_global_indx(), sizeof(int), dst_decomp_info->get_num_local_cells(), cache_file);
+    if (current_proc_id_src_comp != -1)
+        write_routing_info_with_one_process_into_cache(send_to_remote_procs_routing_info, cache_file);
+    if (current_proc_id_dst_comp != -1)
+        write_routing_info_with_one_process_into_cache(recv_from_remote_procs_routing_info, cache_file);
+    write_succeeded = ferror(cache_file) == 0;
+    write_succeeded = fclose(cache_file) == 0 && write_succeeded;
+    if (write_succeeded)
+        write_succeeded = rename(temp_cache_file_name, routing_info_cache_file_name) == 0;
+    if (!write_succeeded) {
+        remove(temp_cache_file_name);
+        EXECUTION_REPORT(REPORT_WARNING, -1, false, "Failed to write the file \"%s\" for caching the routing information. The routing information will not be cached", routing_info_cache_file_name);
+        return;
+    }
+
+    EXECUTION_REPORT_LOG(REPORT_LOG, -1, true, "Save the router from (%s %s) to (%s %s) into the cache file \"%s\"", src_comp_full_name, src_decomp_name, index_dst_comp_full_name, dst_decomp_name, routing_info_cache_file_name);
+}
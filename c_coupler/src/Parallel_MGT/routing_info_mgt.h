@@ -20,6 +20,11 @@
 #include "distributed_merge_sort.h"
 #include <vector>
 
+
+#define ROUTING_INFO_CACHE_VERSION      1
+#define NUM_ROUTING_INFO_CACHE_KEYS     14
+
+
 struct routing_mapping_table_entry
 {
     int global_index;         
@@ -41,6 +46,9 @@ struct Routing_info_with_one_process
 };
 
 
+template <class T> class Dictionary;
+
+
 class Routing_info
 {
     private:
@@ -84,6 +92,9 @@ class Routing_info
 
         Distribute_merge_sort<routing_mapping_table_entry> * distribute_sorting;
 
+        long routing_info_cache_keys[NUM_ROUTING_INFO_CACHE_KEYS];
+        char routing_info_cache_file_name[NAME_STR_SIZE*2];
+
 public:
         Routing_info(const int, const int, const char*, const char*);
         ~Routing_info();
@@ -115,6 +126,13 @@ public:
         void build_2D_router();
         Routing_info_with_one_process *compute_routing_info_between_decomps(int, const int*, const int*, int, const int*, int, int, int, bool, common_sort_struct<routing_mapping_table_entry>*, int);
 		Routing_info_with_one_process *generate_routing_info_between_procs(common_sort_struct<routing_mapping_table_entry> *, int, int, const int *, bool);
+        long calculate_decomp_layout_checksum(Decomp_info*, Comp_comm_group_mgt_node*, int);
+        void exchange_values_between_components(long*, long*, int);
+        void initialize_routing_info_cache();
+        bool load_routing_info_from_cache();
+        void save_routing_info_into_cache();
+        bool read_routing_info_with_one_process_from_cache(std::vector<Routing_info_with_one_process *> &, bool, FILE *, long);
+        void write_routing_info_with_one_process_into_cache(std::vector<Routing_info_with_one_process *> &, FILE *);
 };
 
 
@@ -122,9 +140,13 @@ class Routing_info_mgt
 {
     private:
         std::vector<Routing_info *> routers;
+        Dictionary<int> *routers_index;
+        std::vector<std::vector<int> > routers_index_buckets;
+
+        void calculate_router_key(const int, const char*, const char*, char*);
     
     public:
-        Routing_info_mgt() {}
+        Routing_info_mgt();
         ~Routing_info_mgt();
         Routing_info *search_router(const int, const int, const char*, const char*);
         Routing_info *search_or_add_router(const int, const int, const char*, const char*);
@@ -2608,6 +2608,13 @@ Inout_datamodel::~Inout_datamodel()
 }
 
 
+void Datamodel_mgt::close_output_files()
+{
+	for (int i = 0; i < output_handlers.size(); i ++)
+		output_handlers[i]->close_output_files();
+}
+
+
 Datamodel_mgt::~Datamodel_mgt() 
 {
 	for (int i = 0; i < output_handlers.size(); i ++)
@@ -2796,7 +2803,20 @@ void Output_handler::execute_handler(bool bypass_timer, int API_id, const char *
 					}
 					delete output_field_name;
 				}
-
+#ifdef USE_PARALLEL_IO
+				if (io_proc_mark == 1 && output_procedures[i]->netcdf_file_object != NULL) {
+					// the writes into the file of the handler (or of the restart manager) that calls the gather are all flushed by the owner 
+					// of the file at once, so that the writes of all fields of a step complete in one ncmpi_wait_all; their data is kept 
+					// because the gathered field is reused by the next gather
+					if (external_file_object != NULL)
+						output_procedures[i]->netcdf_file_object->keep_data_of_pending_writes();
+					else if (!comp_comm_group_mgt_mgr->get_asynchronous_output())
+						output_procedures[i]->netcdf_file_object->flush_pending_writes();
+					else output_procedures[i]->netcdf_file_object->flush_pending_writes_asynchronously();
+				}
+				if (external_file_object != NULL)
+					output_procedures[i]->netcdf_file_object = NULL;
+#endif
 			}
 		//}
 	}
@@ -2805,6 +2825,16 @@ void Output_handler::execute_handler(bool bypass_timer, int API_id, const char *
 }
 
 
+void Output_handler::close_output_files()
+{
+#ifdef USE_PARALLEL_IO
+	for (int i = 0; i < output_procedures.size(); i ++)
+		if (output_procedures[i]->netcdf_file_object != NULL)
+			output_procedures[i]->netcdf_file_object->close_file();
+#endif
+}
+
+
 bool Output_handler::check_handler_field_instance_match(Field_mem_info *field_instance, Field_mem_info *&restart_field_instance) {
 	std::vector<const char*> interface_fields_name;
 	int field_local_index;
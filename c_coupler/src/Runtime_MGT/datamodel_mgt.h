@@ -548,6 +548,7 @@ public:
 	void get_or_generate_field_real_output_grid(const char*, Field_mem_info*, int&);
 	char *modify_special_v3d_grid_name(char*, const char*);
 	void execute_handler(bool, int, const char*, void*, const char*);
+	void close_output_files();
 
 	MPI_Comm get_io_comm() { return io_comm; }
 	int get_io_proc_mark() { return io_proc_mark; }
@@ -605,6 +606,7 @@ public:
 	void handle_explicit_input(int, const char*);
 	Input_handler_controller *get_input_handler_controller(int);
 	bool is_legal_input_handler_controller_id(int);
+	void close_output_files();
 };
 
 
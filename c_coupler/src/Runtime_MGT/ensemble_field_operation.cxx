@@ -11,60 +11,26 @@
 #include "ensemble_field_operation.h"
 
 
-/* This implementation does not take consideration of mask */
-template <class T> void member_to_set_operation_template(T **member_fields_data_buffer, T *set_field_data_buffer, int num_members, int field_size, int operation, int specified_member_index)
-{
-	if (operation == ENSEMBLE_OP_TYPE_ANY)
-		memcpy(set_field_data_buffer, member_fields_data_buffer[specified_member_index], field_size * sizeof(T));
-	else {
-		if (operation == ENSEMBLE_OP_TYPE_MAX || operation == ENSEMBLE_OP_TYPE_MIN) {
-			for (int i = 0; i < field_size; i ++) {
-				T ensemble_result = (T) 0;
-				ensemble_result = member_fields_data_buffer[0][i];
-			}
-		}
-		if (operation == ENSEMBLE_OP_TYPE_SUM || operation == ENSEMBLE_OP_TYPE_MEAN || operation == ENSEMBLE_OP_TYPE_ANOMALY) {
-			for (int i = 0; i < field_size; i ++) {
-				T ensemble_result = (T) 0;
-				for (int j = 0; j < num_members; j ++)
-					ensemble_result += member_fields_data_buffer[j][i];
-				if (operation == ENSEMBLE_OP_TYPE_MEAN)
-					set_field_data_buffer[i] = ensemble_result / (T)num_members;
-				else if (operation == ENSEMBLE_OP_TYPE_ANOMALY)
-					set_field_data_buffer[i] = set_field_data_buffer[i] - ensemble_result / (T)num_members;
-				else set_field_data_buffer[i] = ensemble_result;
-			}
-		}
-		else if (operation == ENSEMBLE_OP_TYPE_MIN) {
-			for (int i = 0; i < field_size; i ++) {
-				T ensemble_result = (T) 0;
-				for (int j = 0; j < num_members; j ++)
-					if (ensemble_result > member_fields_data_buffer[j][i])
-						ensemble_result = member_fields_data_buffer[j][i];
-			}
-		}
-		else if (operation == ENSEMBLE_OP_TYPE_MAX) {
-			for (int i = 0; i < field_size; i ++) {
-				T ensemble_result = (T) 0;
-				for (int j = 0; j < num_members; j ++)
-					if (ensemble_result < member_fields_data_buffer[j][i])
-						ensemble_result = member_fields_data_buffer[j][i];
-			}
-		}
-		else EXECUTION_REPORT_ERROR_OPTIONALLY(REPORT_ERROR, -1, false, "Software error in member_to_set_operation_template");
-	}
-}
-
-Member_to_set_operation::Member_to_set_operation(std::vector<Field_mem_info*> &member_fields_inst, Field_mem_info *set_field_inst, int operation, int specified_member_index)
+Member_to_set_operation::Member_to_set_operation(std::vector<Field_mem_info*> &member_fields_inst, Field_mem_info *set_field_inst, int operation, int specified_member_index, int num_threads, int grid_chunk_size)
 {
 	EXECUTION_REPORT_ERROR_OPTIONALLY(REPORT_ERROR, -1, member_fields_inst.size() > 0 && operation >= ENSEMBLE_OP_TYPE_SUM && operation <= ENSEMBLE_OP_TYPE_ANY, "Software error in Member_to_set_operation::Member_to_set_operation");
 	if (operation == ENSEMBLE_OP_TYPE_ANY)
 		EXECUTION_REPORT_ERROR_OPTIONALLY(REPORT_ERROR, -1, specified_member_index >= 0 && specified_member_index < member_fields_inst.size(), "Software error in Member_to_set_operation::Member_to_set_operation");
+	EXECUTION_REPORT_ERROR_OPTIONALLY(REPORT_ERROR, -1, num_threads > 0 && grid_chunk_size >= 0, "Software error in Member_to_set_operation::Member_to_set_operation");
 	this->specified_member_index = specified_member_index;
+#ifdef _OPENMP
+	this->num_threads = num_threads;
+#else
+	EXECUTION_REPORT(REPORT_WARNING, -1, num_threads == 1, "C-Coupler is not compiled with OpenMP, so that the ensemble operation will be done with one thread instead of %d threads", num_threads);
+	this->num_threads = 1;
+#endif
+	this->grid_chunk_size = grid_chunk_size;
+	simd_level = get_ensemble_op_simd_level();
 	for (int i = 0; i < member_fields_inst.size(); i ++)
 		this->member_fields_inst.push_back(member_fields_inst[i]);
 	this->set_field_inst = set_field_inst;
 	member_fields_data_buffer = new void *[member_fields_inst.size()];
+	paired_member_fields_data_buffer = NULL;
 	if (set_field_inst != NULL)
 		set_field_data_buffer = set_field_inst->get_data_buf();
 	else set_field_data_buffer = NULL;
@@ -79,26 +45,50 @@ Member_to_set_operation::Member_to_set_operation(std::vector<Field_mem_info*> &m
 //	if (operation != ENSEMBLE_OP_TYPE_ANY)
 //		EXECUTION_REPORT_ERROR_OPTIONALLY(REPORT_ERROR, -1, words_are_the_same(set_field_inst->get_data_type(), DATA_TYPE_DOUBLE) || words_are_the_same(set_field_inst->get_data_type(), DATA_TYPE_FLOAT), "Software error in Member_to_set_operation::Member_to_set_operation");
 	data_type = strdup(member_fields_inst[0]->get_data_type());
+	if (operation >= ENSEMBLE_OP_TYPE_VARIANCE && operation <= ENSEMBLE_OP_TYPE_COVARIANCE)
+		EXECUTION_REPORT(REPORT_ERROR, -1, words_are_the_same(data_type, DATA_TYPE_DOUBLE) || words_are_the_same(data_type, DATA_TYPE_FLOAT), "Error happens in the ensemble operation of the field \"%s\": the ensemble variance, standard deviation, spread or covariance can only be calculated for a field of \"real4\" or \"real8\", while the data type of this field is \"%s\".", member_fields_inst[0]->get_field_name(), data_type);
+}
+
+
+void Member_to_set_operation::set_paired_member_fields(std::vector<Field_mem_info*> &paired_member_fields_inst)
+{
+	EXECUTION_REPORT_ERROR_OPTIONALLY(REPORT_ERROR, -1, operation_type == ENSEMBLE_OP_TYPE_COVARIANCE && paired_member_fields_inst.size() == member_fields_inst.size() && paired_member_fields_data_buffer == NULL, "Software error in Member_to_set_operation::set_paired_member_fields");
+	paired_member_fields_data_buffer = new void *[paired_member_fields_inst.size()];
+	for (int i = 0; i < paired_member_fields_inst.size(); i ++) {
+		EXECUTION_REPORT(REPORT_ERROR, -1, member_fields_inst[i]->get_comp_id() == paired_member_fields_inst[i]->get_comp_id() && member_fields_inst[i]->get_grid_id() == paired_member_fields_inst[i]->get_grid_id() && member_fields_inst[i]->get_decomp_id() == paired_member_fields_inst[i]->get_decomp_id() && words_are_the_same(member_fields_inst[i]->get_data_type(), paired_member_fields_inst[i]->get_data_type()), "Error happens in the ensemble covariance between the fields \"%s\" and \"%s\": these two fields must be on the same grid and parallel decomposition and have the same data type.", member_fields_inst[i]->get_field_name(), paired_member_fields_inst[i]->get_field_name());
+		this->paired_member_fields_inst.push_back(paired_member_fields_inst[i]);
+		paired_member_fields_data_buffer[i] = paired_member_fields_inst[i]->get_data_buf();
+	}
 }
 
 
 void Member_to_set_operation::execute()
 {
+	double time1, time2;
+
+
+	EXECUTION_REPORT_ERROR_OPTIONALLY(REPORT_ERROR, -1, operation_type != ENSEMBLE_OP_TYPE_COVARIANCE || paired_member_fields_data_buffer != NULL, "Software error in Member_to_set_operation::execute");
+	wtime(&time1);
 	if (words_are_the_same(data_type, DATA_TYPE_BOOL))
-		member_to_set_operation_template((bool**)member_fields_data_buffer, (bool*) set_field_data_buffer, member_fields_inst.size(), field_size, operation_type, specified_member_index);
+		member_to_set_operation_kernel((bool**)member_fields_data_buffer, (bool**)paired_member_fields_data_buffer, (bool*) set_field_data_buffer, member_fields_inst.size(), field_size, operation_type, specified_member_index, num_threads, grid_chunk_size, simd_level);
 	else if (words_are_the_same(data_type, DATA_TYPE_CHAR))
-		member_to_set_operation_template((char**)member_fields_data_buffer, (char*) set_field_data_buffer, member_fields_inst.size(), field_size, operation_type, specified_member_index);
+		member_to_set_operation_kernel((char**)member_fields_data_buffer, (char**)paired_member_fields_data_buffer, (char*) set_field_data_buffer, member_fields_inst.size(), field_size, operation_type, specified_member_index, num_threads, grid_chunk_size, simd_level);
 	else if (words_are_the_same(data_type, DATA_TYPE_DOUBLE))
-		member_to_set_operation_template((double**)member_fields_data_buffer, (double*) set_field_data_buffer, member_fields_inst.size(), field_size, operation_type, specified_member_index);
+		member_to_set_operation_kernel((double**)member_fields_data_buffer, (double**)paired_member_fields_data_buffer, (double*) set_field_data_buffer, member_fields_inst.size(), field_size, operation_type, specified_member_index, num_threads, grid_chunk_size, simd_level);
 	else if (words_are_the_same(data_type, DATA_TYPE_FLOAT))
-		member_to_set_operation_template((float**)member_fields_data_buffer, (float*) set_field_data_buffer, member_fields_inst.size(), field_size, operation_type, specified_member_index);
+		member_to_set_operation_kernel((float**)member_fields_data_buffer, (float**)paired_member_fields_data_buffer, (float*) set_field_data_buffer, member_fields_inst.size(), field_size, operation_type, specified_member_index, num_threads, grid_chunk_size, simd_level);
 	else if (words_are_the_same(data_type, DATA_TYPE_INT))
-		member_to_set_operation_template((int**)member_fields_data_buffer, (int*) set_field_data_buffer, member_fields_inst.size(), field_size, operation_type, specified_member_index);
+		member_to_set_operation_kernel((int**)member_fields_data_buffer, (int**)paired_member_fields_data_buffer, (int*) set_field_data_buffer, member_fields_inst.size(), field_size, operation_type, specified_member_index, num_threads, grid_chunk_size, simd_level);
 	else if (words_are_the_same(data_type, DATA_TYPE_LONG))
-		member_to_set_operation_template((long**)member_fields_data_buffer, (long*) set_field_data_buffer, member_fields_inst.size(), field_size, operation_type, specified_member_index);
+		member_to_set_operation_kernel((long**)member_fields_data_buffer, (long**)paired_member_fields_data_buffer, (long*) set_field_data_buffer, member_fields_inst.size(), field_size, operation_type, specified_member_index, num_threads, grid_chunk_size, simd_level);
 	else if (words_are_the_same(data_type, DATA_TYPE_SHORT))
-		member_to_set_operation_template((short**)member_fields_data_buffer, (short*) set_field_data_buffer, member_fields_inst.size(), field_size, operation_type, specified_member_index);
+		member_to_set_operation_kernel((short**)member_fields_data_buffer, (short**)paired_member_fields_data_buffer, (short*) set_field_data_buffer, member_fields_inst.size(), field_size, operation_type, specified_member_index, num_threads, grid_chunk_size, simd_level);
 	else EXECUTION_REPORT_ERROR_OPTIONALLY(REPORT_ERROR, -1, false, "Software error in Member_to_set_operation::execute");
+	wtime(&time2);
+	if (report_internal_log_enabled && time2 > time1) {
+		long num_bytes = (long)field_size * get_data_type_size(data_type) * (operation_type == ENSEMBLE_OP_TYPE_ANY? 2 : (operation_type == ENSEMBLE_OP_TYPE_ANOMALY? member_fields_inst.size() + 2 : member_fields_inst.size() + paired_member_fields_inst.size() + 1));
+		EXECUTION_REPORT_LOG(REPORT_LOG, -1, true, "TIME in Member_to_set_operation::execute: operation %d with %d members on %d grid points of \"%s\" by %d threads with %s kernels (%lf seconds, %lf GB/s)", operation_type, (int)member_fields_inst.size(), field_size, data_type, num_threads, get_ensemble_op_simd_level_name(simd_level), time2 - time1, num_bytes / (time2 - time1) / 1.0e9);
+	}
 	set_field_inst->check_field_sum(report_internal_log_enabled, true, "Set field after member_to_set_operation");
 }
 
@@ -106,6 +96,8 @@ void Member_to_set_operation::execute()
 Member_to_set_operation::~Member_to_set_operation()
 {
 	delete [] member_fields_data_buffer;
+	if (paired_member_fields_data_buffer != NULL)
+		delete [] paired_member_fields_data_buffer;
 	delete [] data_type;
 }
 
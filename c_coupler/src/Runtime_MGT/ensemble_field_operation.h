@@ -12,33 +12,30 @@
 
 #include <vector>
 #include "memory_mgt.h"
-
-
-enum {
-	ENSEMBLE_OP_TYPE_SUM,
-	ENSEMBLE_OP_TYPE_MIN,
-	ENSEMBLE_OP_TYPE_MAX,
-	ENSEMBLE_OP_TYPE_MEAN,
-	ENSEMBLE_OP_TYPE_ANOMALY,
-	ENSEMBLE_OP_TYPE_ANY
-};
+#include "ensemble_field_operation_kernels.h"
 
 
 class Member_to_set_operation
 {
 	private:
 		std::vector<Field_mem_info*> member_fields_inst;
+		std::vector<Field_mem_info*> paired_member_fields_inst;      // the second field of ENSEMBLE_OP_TYPE_COVARIANCE
 		Field_mem_info *set_field_inst;
 		void **member_fields_data_buffer;
+		void **paired_member_fields_data_buffer;
 		void *set_field_data_buffer;
 		int operation_type;
 		int specified_member_index;
 		int field_size;
+		int num_threads;
+		int grid_chunk_size;                   // 0: evenly divided among the threads
+		int simd_level;
 		char *data_type;                       // 0: float; 1: double; 2: others
 		
 	public:
-		Member_to_set_operation(std::vector<Field_mem_info*>&, Field_mem_info*, int, int);
+		Member_to_set_operation(std::vector<Field_mem_info*>&, Field_mem_info*, int, int, int, int);
 		~Member_to_set_operation();
+		void set_paired_member_fields(std::vector<Field_mem_info*>&);
 		void execute();
 };
 
@@ -0,0 +1,250 @@
+/***************************************************************
+  *  Copyright (c) 2017, Tsinghua University.
+  *  This is a source file of C-Coupler.
+  *  This file was initially finished by Dr. Li Liu.
+  *  If you have any problem,
+  *  please contact Dr. Li Liu via liuli-cess@tsinghua.edu.cn
+  ***************************************************************/
+
+
+#include "ensemble_field_operation_kernels.h"
+#include <string.h>
+#include <math.h>
+
+
+/* The vector kernels are compiled for their instruction sets through the target attribute, so that they are built without
+   any architecture flag of the compiler and only used when the processor supports them */
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define ENSEMBLE_OP_SIMD_DISPATCH
+#include <immintrin.h>
+#endif
+
+
+#define ENSEMBLE_OP_TILE_SIZE      512
+
+
+/* Statistics of one tile of grid points are accumulated member by member, so that each member buffer is streamed contiguously
+   and the accumulators stay in cache. The members are visited in order for each grid point, which keeps the results identical
+   to a straightforward loop over the members */
+template <class T> void member_to_set_init_tile(const T *member_data, int tile_size, T *sum, T *min, T *max)
+{
+	for (int i = 0; i < tile_size; i ++) {
+		sum[i] = (T) 0;
+		sum[i] += member_data[i];
+		min[i] = member_data[i];
+		max[i] = member_data[i];
+	}
+}
+
+
+template <class T> void member_to_set_accumulate_tile_scalar(const T *member_data, int tile_size, T *sum, T *min, T *max)
+{
+	for (int i = 0; i < tile_size; i ++) {
+		sum[i] += member_data[i];
+		if (member_data[i] < min[i])
+			min[i] = member_data[i];
+		if (member_data[i] > max[i])
+			max[i] = member_data[i];
+	}
+}
+
+
+template <class T> void member_to_set_accumulate_tile(const T *member_data, int tile_size, T *sum, T *min, T *max, int simd_level)
+{
+	member_to_set_accumulate_tile_scalar(member_data, tile_size, sum, min, max);
+}
+
+
+#ifdef ENSEMBLE_OP_SIMD_DISPATCH
+
+
+/* The vector min/max instructions return their second operand when either operand is NaN or both are equal, which matches the scalar comparisons above */
+#define DEFINE_SIMD_ACCUMULATE_TILE(KERNEL_NAME, TARGET, T, VEC_WIDTH, VEC_TYPE, VEC_LOAD, VEC_STORE, VEC_ADD, VEC_MIN, VEC_MAX) \
+__attribute__((target(TARGET))) static void KERNEL_NAME(const T *member_data, int tile_size, T *sum, T *min, T *max) \
+{ \
+	int i = 0; \
+	for (; i + VEC_WIDTH <= tile_size; i += VEC_WIDTH) { \
+		VEC_TYPE data = VEC_LOAD(member_data + i); \
+		VEC_STORE(sum + i, VEC_ADD(VEC_LOAD(sum + i), data)); \
+		VEC_STORE(min + i, VEC_MIN(data, VEC_LOAD(min + i))); \
+		VEC_STORE(max + i, VEC_MAX(data, VEC_LOAD(max + i))); \
+	} \
+	member_to_set_accumulate_tile_scalar(member_data + i, tile_size - i, sum + i, min + i, max + i); \
+}
+
+
+DEFINE_SIMD_ACCUMULATE_TILE(member_to_set_accumulate_tile_avx512_double, "avx512f", double, 8, __m512d, _mm512_loadu_pd, _mm512_storeu_pd, _mm512_add_pd, _mm512_min_pd, _mm512_max_pd)
+DEFINE_SIMD_ACCUMULATE_TILE(member_to_set_accumulate_tile_avx512_float, "avx512f", float, 16, __m512, _mm512_loadu_ps, _mm512_storeu_ps, _mm512_add_ps, _mm512_min_ps, _mm512_max_ps)
+DEFINE_SIMD_ACCUMULATE_TILE(member_to_set_accumulate_tile_avx2_double, "avx2", double, 4, __m256d, _mm256_loadu_pd, _mm256_storeu_pd, _mm256_add_pd, _mm256_min_pd, _mm256_max_pd)
+DEFINE_SIMD_ACCUMULATE_TILE(member_to_set_accumulate_tile_avx2_float, "avx2", float, 8, __m256, _mm256_loadu_ps, _mm256_storeu_ps, _mm256_add_ps, _mm256_min_ps, _mm256_max_ps)
+
+
+template <> void member_to_set_accumulate_tile<double>(const double *member_data, int tile_size, double *sum, double *min, double *max, int simd_level)
+{
+	if (simd_level == ENSEMBLE_OP_SIMD_AVX512)
+		member_to_set_accumulate_tile_avx512_double(member_data, tile_size, sum, min, max);
+	else if (simd_level == ENSEMBLE_OP_SIMD_AVX2)
+		member_to_set_accumulate_tile_avx2_double(member_data, tile_size, sum, min, max);
+	else member_to_set_accumulate_tile_scalar(member_data, tile_size, sum, min, max);
+}
+
+
+template <> void member_to_set_accumulate_tile<float>(const float *member_data, int tile_size, float *sum, float *min, float *max, int simd_level)
+{
+	if (simd_level == ENSEMBLE_OP_SIMD_AVX512)
+		member_to_set_accumulate_tile_avx512_float(member_data, tile_size, sum, min, max);
+	else if (simd_level == ENSEMBLE_OP_SIMD_AVX2)
+		member_to_set_accumulate_tile_avx2_float(member_data, tile_size, sum, min, max);
+	else member_to_set_accumulate_tile_scalar(member_data, tile_size, sum, min, max);
+}
+
+
+#endif
+
+
+int get_ensemble_op_simd_level()
+{
+#ifdef ENSEMBLE_OP_SIMD_DISPATCH
+	__builtin_cpu_init();
+	if (__builtin_cpu_supports("avx512f"))
+		return ENSEMBLE_OP_SIMD_AVX512;
+	if (__builtin_cpu_supports("avx2"))
+		return ENSEMBLE_OP_SIMD_AVX2;
+#endif
+	return ENSEMBLE_OP_SIMD_SCALAR;
+}
+
+
+const char *get_ensemble_op_simd_level_name(int simd_level)
+{
+	if (simd_level == ENSEMBLE_OP_SIMD_AVX512)
+		return "avx512";
+	if (simd_level == ENSEMBLE_OP_SIMD_AVX2)
+		return "avx2";
+	return "scalar";
+}
+
+
+template <class T> void member_to_set_operation_on_grid_chunk(T **member_fields_data_buffer, T *set_field_data_buffer, int num_members, int chunk_beg, int chunk_end, int operation, int simd_level)
+{
+	T sum[ENSEMBLE_OP_TILE_SIZE], min[ENSEMBLE_OP_TILE_SIZE], max[ENSEMBLE_OP_TILE_SIZE];
+
+
+	for (int tile_beg = chunk_beg; tile_beg < chunk_end; tile_beg += ENSEMBLE_OP_TILE_SIZE) {
+		int tile_size = chunk_end - tile_beg < ENSEMBLE_OP_TILE_SIZE ? chunk_end - tile_beg : ENSEMBLE_OP_TILE_SIZE;
+		T *set_data = set_field_data_buffer + tile_beg;
+		member_to_set_init_tile(member_fields_data_buffer[0] + tile_beg, tile_size, sum, min, max);
+		for (int j = 1; j < num_members; j ++)
+			member_to_set_accumulate_tile(member_fields_data_buffer[j] + tile_beg, tile_size, sum, min, max, simd_level);
+		switch (operation) {
+			case ENSEMBLE_OP_TYPE_SUM:
+				memcpy(set_data, sum, tile_size * sizeof(T));
+				break;
+			case ENSEMBLE_OP_TYPE_MEAN:
+				for (int i = 0; i < tile_size; i ++)
+					set_data[i] = sum[i] / (T)num_members;
+				break;
+			case ENSEMBLE_OP_TYPE_ANOMALY:
+				for (int i = 0; i < tile_size; i ++)
+					set_data[i] = set_data[i] - sum[i] / (T)num_members;
+				break;
+			case ENSEMBLE_OP_TYPE_MIN:
+				memcpy(set_data, min, tile_size * sizeof(T));
+				break;
+			case ENSEMBLE_OP_TYPE_MAX:
+				memcpy(set_data, max, tile_size * sizeof(T));
+				break;
+		}
+	}
+}
+
+
+/* Mean and the sum of squared deviations (and the co-deviations with the paired field) are updated member by member with
+   Welford's method, so that the ensemble spread is obtained in one streaming pass without gathering the ensemble. Variance and
+   "std" use the sample estimator (divided by N-1), while "spread" is the population
+   standard deviation (the square root of the sum of squared deviations divided by N) */
+template <class T> void member_to_set_moments_on_grid_chunk(T **member_fields_data_buffer, T **paired_member_fields_data_buffer, T *set_field_data_buffer, int num_members, int chunk_beg, int chunk_end, int operation)
+{
+	double mean[ENSEMBLE_OP_TILE_SIZE], paired_mean[ENSEMBLE_OP_TILE_SIZE], sum_deviations[ENSEMBLE_OP_TILE_SIZE];
+
+
+	for (int tile_beg = chunk_beg; tile_beg < chunk_end; tile_beg += ENSEMBLE_OP_TILE_SIZE) {
+		int tile_size = chunk_end - tile_beg < ENSEMBLE_OP_TILE_SIZE ? chunk_end - tile_beg : ENSEMBLE_OP_TILE_SIZE;
+		T *set_data = set_field_data_buffer + tile_beg;
+		for (int i = 0; i < tile_size; i ++) {
+			mean[i] = 0.0;
+			paired_mean[i] = 0.0;
+			sum_deviations[i] = 0.0;
+		}
+		for (int j = 0; j < num_members; j ++) {
+			const T *member_data = member_fields_data_buffer[j] + tile_beg;
+			double num_visited_members = (double) (j + 1);
+			if (operation == ENSEMBLE_OP_TYPE_COVARIANCE) {
+				const T *paired_member_data = paired_member_fields_data_buffer[j] + tile_beg;
+				for (int i = 0; i < tile_size; i ++) {
+					double deviation = (double) member_data[i] - mean[i];
+					mean[i] += deviation / num_visited_members;
+					paired_mean[i] += ((double) paired_member_data[i] - paired_mean[i]) / num_visited_members;
+					sum_deviations[i] += deviation * ((double) paired_member_data[i] - paired_mean[i]);
+				}
+			}
+			else {
+				for (int i = 0; i < tile_size; i ++) {
+					double deviation = (double) member_data[i] - mean[i];
+					mean[i] += deviation / num_visited_members;
+					sum_deviations[i] += deviation * ((double) member_data[i] - mean[i]);
+				}
+			}
+		}
+		switch (operation) {
+			case ENSEMBLE_OP_TYPE_VARIANCE:
+			case ENSEMBLE_OP_TYPE_COVARIANCE:
+				for (int i = 0; i < tile_size; i ++)
+					set_data[i] = (T) (num_members > 1 ? sum_deviations[i] / (num_members - 1) : 0.0);
+				break;
+			case ENSEMBLE_OP_TYPE_STD:
+				for (int i = 0; i < tile_size; i ++)
+					set_data[i] = (T) (num_members > 1 ? sqrt(sum_deviations[i] / (num_members - 1)) : 0.0);
+				break;
+			case ENSEMBLE_OP_TYPE_SPREAD:
+				for (int i = 0; i < tile_size; i ++)
+					set_data[i] = (T) sqrt(sum_deviations[i] / num_members);
+				break;
+		}
+	}
+}
+
+
+/* This implementation does not take consideration of mask. Each thread reduces disjoint grid chunks across all members, so the result does not depend on the number of threads */
+template <class T> void member_to_set_operation_kernel(T **member_fields_data_buffer, T **paired_member_fields_data_buffer, T *set_field_data_buffer, int num_members, int field_size, int operation, int specified_member_index, int num_threads, int grid_chunk_size, int simd_level)
+{
+	if (operation == ENSEMBLE_OP_TYPE_ANY) {
+		memcpy(set_field_data_buffer, member_fields_data_buffer[specified_member_index], field_size * sizeof(T));
+		return;
+	}
+
+	if (grid_chunk_size <= 0)
+		grid_chunk_size = ((field_size + num_threads - 1) / num_threads + ENSEMBLE_OP_TILE_SIZE - 1) / ENSEMBLE_OP_TILE_SIZE * ENSEMBLE_OP_TILE_SIZE;
+	if (grid_chunk_size <= 0)
+		grid_chunk_size = ENSEMBLE_OP_TILE_SIZE;
+	int num_chunks = (field_size + grid_chunk_size - 1) / grid_chunk_size;
+#ifdef _OPENMP
+	#pragma omp parallel for num_threads(num_threads) schedule(static) if (num_threads > 1 && num_chunks > 1)
+#endif
+	for (int k = 0; k < num_chunks; k ++) {
+		int chunk_beg = k * grid_chunk_size;
+		int chunk_end = field_size - chunk_beg < grid_chunk_size ? field_size : chunk_beg + grid_chunk_size;
+		if (operation >= ENSEMBLE_OP_TYPE_VARIANCE)
+			member_to_set_moments_on_grid_chunk(member_fields_data_buffer, paired_member_fields_data_buffer, set_field_data_buffer, num_members, chunk_beg, chunk_end, operation);
+		else member_to_set_operation_on_grid_chunk(member_fields_data_buffer, set_field_data_buffer, num_members, chunk_beg, chunk_end, operation, simd_level);
+	}
+}
+
+
+template void member_to_set_operation_kernel<bool>(bool **, bool **, bool *, int, int, int, int, int, int, int);
+template void member_to_set_operation_kernel<char>(char **, char **, char *, int, int, int, int, int, int, int);
+template void member_to_set_operation_kernel<short>(short **, short **, short *, int, int, int, int, int, int, int);
+template void member_to_set_operation_kernel<int>(int **, int **, int *, int, int, int, int, int, int, int);
+template void member_to_set_operation_kernel<long>(long **, long **, long *, int, int, int, int, int, int, int);
+template void member_to_set_operation_kernel<float>(float **, float **, float *, int, int, int, int, int, int, int);
+template void member_to_set_operation_kernel<double>(double **, double **, double *, int, int, int, int, int, int, int);
@@ -0,0 +1,43 @@
+/***************************************************************
+  *  Copyright (c) 2017, Tsinghua University.
+  *  This is a source file of C-Coupler.
+  *  This file was initially finished by Dr. Li Liu. 
+  *  If you have any problem, 
+  *  please contact Dr. Li Liu via liuli-cess@tsinghua.edu.cn
+  ***************************************************************/
+
+
+#ifndef ENSEMBLE_FIELD_OPERATION_KERNELS
+#define ENSEMBLE_FIELD_OPERATION_KERNELS
+
+
+enum {
+	ENSEMBLE_OP_TYPE_SUM,
+	ENSEMBLE_OP_TYPE_MIN,
+	ENSEMBLE_OP_TYPE_MAX,
+	ENSEMBLE_OP_TYPE_MEAN,
+	ENSEMBLE_OP_TYPE_ANOMALY,
+	ENSEMBLE_OP_TYPE_VARIANCE,
+	ENSEMBLE_OP_TYPE_STD,
+	ENSEMBLE_OP_TYPE_SPREAD,
+	ENSEMBLE_OP_TYPE_COVARIANCE,
+	ENSEMBLE_OP_TYPE_ANY
+};
+
+
+enum {
+	ENSEMBLE_OP_SIMD_SCALAR,
+	ENSEMBLE_OP_SIMD_AVX2,
+	ENSEMBLE_OP_SIMD_AVX512
+};
+
+
+/* The kernels of the member-to-set ensemble operations do not depend on the other modules of C-Coupler, so that they can
+   also be built into standalone benchmarks. The vector instruction sets are selected at run time: the highest one supported
+   by the processor is returned by get_ensemble_op_simd_level, while a lower level can be specified to the kernel */
+extern int get_ensemble_op_simd_level();
+extern const char *get_ensemble_op_simd_level_name(int);
+template <class T> void member_to_set_operation_kernel(T **, T **, T *, int, int, int, int, int, int, int);
+
+
+#endif
@@ -59,17 +59,88 @@ void Ensemble_mgt::register_a_field_for_perturbation(void *data_buf)
     EXECUTION_REPORT(REPORT_ERROR,-1, words_are_the_same(registered_field->get_field_data()->get_grid_data_field()->data_type_in_application, DATA_TYPE_FLOAT) || words_are_the_same(registered_field->get_field_data()->get_grid_data_field()->data_type_in_application, DATA_TYPE_DOUBLE),
                      "The data type of field %s is not real4 or real8. It cannot be used for perturbing the roundoff errors. Please check.", registered_field->get_field_name());
     registered_fields_for_perturbation.push_back(registered_field);
+    registered_fields_perturbation_kernels.push_back(NULL);
+}
+
+
+/* The perturbation kernels below are branch-free loops over the bit patterns of the values, so that the compiler can vectorize them */
+template <class T> void set_last_bit_of_values_to_1(T *values, long size)
+{
+    for (long i = 0; i < size; i ++)
+        values[i] |= ((T)1);
+}
+
+
+template <class T> void set_last_bit_of_values_to_0(T *values, long size)
+{
+    for (long i = 0; i < size; i ++)
+        values[i] &= ~((T)1);
+}
+
+
+template <class T> void reverse_last_bit_of_values(T *values, long size)
+{
+    for (long i = 0; i < size; i ++)
+        values[i] ^= ((T)1);
+}
+
+
+template <class T> void xor_last_bit_of_values_with_a_bit(T *values, long size, unsigned int number_perturbing_bit)
+{
+    for (long i = 0; i < size; i ++)
+        values[i] ^= ((values[i] >> number_perturbing_bit) & ((T)1));
+}
+
+
+template <class T> void set_last_bit_to_1_kernel(void *values, long size, int current_random_number)
+{
+    set_last_bit_of_values_to_1((T*) values, size);
+}
+
+
+template <class T> void set_last_bit_to_0_kernel(void *values, long size, int current_random_number)
+{
+    set_last_bit_of_values_to_0((T*) values, size);
+}
+
+
+template <class T> void reverse_last_bit_kernel(void *values, long size, int current_random_number)
+{
+    reverse_last_bit_of_values((T*) values, size);
+}
+
+
+template <class T> void xor_last_bit_with_a_bit_kernel(void *values, long size, int current_random_number)
+{
+    xor_last_bit_of_values_with_a_bit((T*) values, size, (((unsigned int) current_random_number) >> 1)%(sizeof(T)*8));
+}
+
+
+/* Returns the kernel of the perturbation type for the values of a data type, so that the kernel of a registered field is 
+   selected once instead of at each perturbation */
+Perturbation_kernel Ensemble_mgt::get_perturbation_kernel(const char *data_type)
+{
+    bool is_float = words_are_the_same(data_type, DATA_TYPE_FLOAT);
+
+
+    EXECUTION_REPORT(REPORT_ERROR,-1, is_float || words_are_the_same(data_type, DATA_TYPE_DOUBLE), "C-Coupler software error in Ensemble_mgt::get_perturbation_kernel");
+    if (perturbation_type_id == 1)
+        return is_float? set_last_bit_to_1_kernel<unsigned int> : set_last_bit_to_1_kernel<unsigned long>;
+    if (perturbation_type_id == 2)
+        return is_float? set_last_bit_to_0_kernel<unsigned int> : set_last_bit_to_0_kernel<unsigned long>;
+    if (perturbation_type_id == 3)
+        return is_float? reverse_last_bit_kernel<unsigned int> : reverse_last_bit_kernel<unsigned long>;
+    EXECUTION_REPORT(REPORT_ERROR,-1, perturbation_type_id == 4, "C-Coupler software error in Ensemble_mgt::get_perturbation_kernel");
+    return is_float? xor_last_bit_with_a_bit_kernel<unsigned int> : xor_last_bit_with_a_bit_kernel<unsigned long>;
 }
 
 
 void Ensemble_mgt::perturb_a_field_through_set_last_bit_to_1(void *field_data_buf, const char *data_type, long field_size, int current_random_number)
 {
     if (words_are_the_same(data_type, DATA_TYPE_FLOAT))
-        for (long i = 0; i < field_size; i ++) 
-            ((int*) field_data_buf)[i] = (((int*) field_data_buf)[i] | ((int)1));
+        set_last_bit_of_values_to_1((unsigned int*) field_data_buf, field_size);
     else if (words_are_the_same(data_type, DATA_TYPE_DOUBLE))
-        for (long i = 0; i < field_size; i ++) 
-            ((long*) field_data_buf)[i] = (((long*) field_data_buf)[i] | ((long)1));
+        set_last_bit_of_values_to_1((unsigned long*) field_data_buf, field_size);
     else EXECUTION_REPORT(REPORT_ERROR,-1, false, "C-Coupler software error in perturb_a_field_through_set_last_bit_to_1");
 }
 
@@ -77,11 +148,9 @@ void Ensemble_mgt::perturb_a_field_through_set_last_bit_to_1(void *field_data_bu
 void Ensemble_mgt::perturb_a_field_through_set_last_bit_to_0(void *field_data_buf, const char *data_type, long field_size, int current_random_number)
 {
     if (words_are_the_same(data_type, DATA_TYPE_FLOAT))
-        for (long i = 0; i < field_size; i ++) 
-            ((int*) field_data_buf)[i] = (((int*) field_data_buf)[i] & ((int)0xFFFFFFFE));
+        set_last_bit_of_values_to_0((unsigned int*) field_data_buf, field_size);
     else if (words_are_the_same(data_type, DATA_TYPE_DOUBLE))
-        for (long i = 0; i < field_size; i ++) 
-            ((long*) field_data_buf)[i] = (((long*) field_data_buf)[i] & ((long)0xFFFFFFFFFFFFFFFE));
+        set_last_bit_of_values_to_0((unsigned long*) field_data_buf, field_size);
     else EXECUTION_REPORT(REPORT_ERROR,-1, false, "C-Coupler software error in perturb_a_field_through_set_last_bit_to_0");
 }
 
@@ -89,37 +158,19 @@ void Ensemble_mgt::perturb_a_field_through_set_last_bit_to_0(void *field_data_bu
 void Ensemble_mgt::perturb_a_field_through_reverse_last_bit(void *field_data_buf, const char *data_type, long field_size, int current_random_number)
 {
     if (words_are_the_same(data_type, DATA_TYPE_FLOAT))
-        for (long i = 0; i < field_size; i ++)
-            ((int*) field_data_buf)[i] = ((int*) field_data_buf)[i] ^ ((int)1);
+        reverse_last_bit_of_values((unsigned int*) field_data_buf, field_size);
     else if (words_are_the_same(data_type, DATA_TYPE_DOUBLE))
-        for (long i = 0; i < field_size; i ++) 
-            ((long*) field_data_buf)[i] = ((long*) field_data_buf)[i] ^ ((long)1);
+        reverse_last_bit_of_values((unsigned long*) field_data_buf, field_size);
     else EXECUTION_REPORT(REPORT_ERROR,-1, false, "C-Coupler software error in perturb_a_field_through_reverse_last_bit");
 }
 
 
 void Ensemble_mgt::perturb_a_field_through_xor_last_bit_with_a_bit(void *field_data_buf, const char *data_type, long field_size, int current_random_number)
 {    
-    if (words_are_the_same(data_type, DATA_TYPE_FLOAT)) {
-        unsigned int number_perturbing_bit = (((unsigned int) current_random_number) >> 1)%32;
-        unsigned int perturbing_bitmap = (((unsigned int)1) << number_perturbing_bit);
-        for (long i = 0; i < field_size; i ++) {
-            unsigned int perturbing_bit_value = ((((unsigned int*)field_data_buf)[i] & perturbing_bitmap) >> number_perturbing_bit);
-            if (!(perturbing_bit_value == 0 || perturbing_bit_value == 1))
-                EXECUTION_REPORT(REPORT_ERROR,-1, false, "C-Coupler software error1 in perturb_a_field_through_xor_last_bit_with_a_bit");
-            ((unsigned int*) field_data_buf)[i] = ((unsigned int*) field_data_buf)[i] ^ perturbing_bit_value;
-        }
-    }
-    else if (words_are_the_same(data_type, DATA_TYPE_DOUBLE)) {
-        unsigned int number_perturbing_bit = (((unsigned int) current_random_number) >> 1)%64;
-        unsigned long perturbing_bitmap = (((unsigned long)1) << number_perturbing_bit);
-        for (long i = 0; i < field_size; i ++) {
-            unsigned long perturbing_bit_value = ((((unsigned long*)field_data_buf)[i] & perturbing_bitmap) >> number_perturbing_bit);
-            if (!(perturbing_bit_value == 0 || perturbing_bit_value == 1))
-                EXECUTION_REPORT(REPORT_ERROR,-1, false, "C-Coupler software error2 in perturb_a_field_through_xor_last_bit_with_a_bit");
-            ((unsigned long*) field_data_buf)[i] = ((unsigned long*) field_data_buf)[i] ^ perturbing_bit_value;
-        }
-    }
+    if (words_are_the_same(data_type, DATA_TYPE_FLOAT))
+        xor_last_bit_of_values_with_a_bit((unsigned int*) field_data_buf, field_size, (((unsigned int) current_random_number) >> 1)%32);
+    else if (words_are_the_same(data_type, DATA_TYPE_DOUBLE))
+        xor_last_bit_of_values_with_a_bit((unsigned long*) field_data_buf, field_size, (((unsigned int) current_random_number) >> 1)%64);
     else EXECUTION_REPORT(REPORT_ERROR,-1, false, "C-Coupler software error3 in perturb_a_field_through_xor_last_bit_with_a_bit");
 }
 
@@ -156,10 +207,18 @@ void Ensemble_mgt::perturb_a_model_array(void *field_data_buf, const char *data_
 
 
 void Ensemble_mgt::run()
+{
+    perturb_registered_fields_in_one_pass();
+}
+
+
+/* One random number decides whether all registered fields are perturbed, and is used for perturbing each of them, as 
+   before. Only the kernel of each field is selected once instead of at each perturbation */
+void Ensemble_mgt::perturb_registered_fields_in_one_pass()
 {
     int current_random_number;
 
-    
+
     if (ensemble_member_id <= 0 || !have_random_seed_for_perturbation || registered_fields_for_perturbation.size() == 0)
         return;
 
@@ -169,8 +228,9 @@ void Ensemble_mgt::run()
 
     for (int i = 0; i < registered_fields_for_perturbation.size(); i ++) {
         EXECUTION_REPORT_LOG(REPORT_LOG,-1, true, "Perturb the values of field %s (on grid %s) with random roundoff errors", registered_fields_for_perturbation[i]->get_field_name(), registered_fields_for_perturbation[i]->get_grid_name());
-        perturb_an_array(registered_fields_for_perturbation[i]->get_data_buf(), registered_fields_for_perturbation[i]->get_field_data()->get_grid_data_field()->data_type_in_application,
-                         registered_fields_for_perturbation[i]->get_size_of_field(), current_random_number);
+        if (registered_fields_perturbation_kernels[i] == NULL)
+            registered_fields_perturbation_kernels[i] = get_perturbation_kernel(registered_fields_for_perturbation[i]->get_field_data()->get_grid_data_field()->data_type_in_application);
+        registered_fields_perturbation_kernels[i](registered_fields_for_perturbation[i]->get_data_buf(), registered_fields_for_perturbation[i]->get_size_of_field(), current_random_number);
     }
 }
 
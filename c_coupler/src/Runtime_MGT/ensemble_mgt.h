@@ -15,6 +15,9 @@
 #include "memory_mgt.h"
 
 
+typedef void (*Perturbation_kernel)(void*, long, int);
+
+
 class Ensemble_mgt
 {
     private:
@@ -24,12 +27,14 @@ class Ensemble_mgt
         int ensemble_random_seed_for_perturbation;
         int perturbation_type_id;
         std::vector<Field_mem_info *> registered_fields_for_perturbation;
+        std::vector<Perturbation_kernel> registered_fields_perturbation_kernels;
         
         void perturb_a_field_through_set_last_bit_to_1(void*, const char*, long, int);
         void perturb_a_field_through_set_last_bit_to_0(void*, const char*, long, int);
         void perturb_a_field_through_reverse_last_bit(void*, const char*, long, int);
         void perturb_a_field_through_xor_last_bit_with_a_bit(void*, const char*, long, int);
         void perturb_an_array(void*, const char*, long, int);
+        Perturbation_kernel get_perturbation_kernel(const char*);
 
     public:
         Ensemble_mgt();
@@ -37,6 +42,7 @@ class Ensemble_mgt
         ~Ensemble_mgt() {}
         void register_a_field_for_perturbation(void *);
         void perturb_fields_with_roundoff_errors();
+        void perturb_registered_fields_in_one_pass();
         void perturb_a_model_array(void*, const char*, long);
         void run();
 };
@@ -31,6 +31,8 @@ Field_instances_operation::Field_instances_operation(Ensemble_procedures_inst *e
     this->do_field_instances_operation = true;
     this->use_statistical_method = false;
     this->statistical_periodic_timer_id = -1;
+    this->ensemble_op_num_threads = 1;
+    this->ensemble_op_grid_chunk_size = 0;
     this->do_ensemble_OP = false;
     this->field_instances_ensemble_op = strdup(ENSEMBLE_OP_DEFAULT);
     this->field_instances_statistical_method = strdup(STATISTICAL_METHOD_DEFAULT);
@@ -94,6 +96,8 @@ Field_instances_operation::Field_instances_operation(Ensemble_procedures_inst *e
         this->field_instances_member_id = check_ensemble_op_format(ensemble_operation_type, NULL, ensemble_procedures_inst->get_XML_file_name(), line_number, "configuration of the attributes of default ensemble operation of all field instances");
         EXECUTION_REPORT(REPORT_ERROR, -1, this->do_ensemble_OP == ensemble_procedures_inst->if_use_ensemble_components(), "Error happens when using the XML configuration file \"%s\": the ensemble operation specified by the value (\"%s\") of the attribute \"%s\" in \"%s\" conflicts with the attribute of ensemble components. Please verify the XML file around the line %d.", XML_file_name, ensemble_operation_type, "type", "ensemble_operation", line_number);
         this->field_instances_ensemble_op = strdup(ensemble_operation_type);
+        this->ensemble_op_num_threads = get_ensemble_op_positive_integer_attribute(ensemble_operation_XML_element, "num_threads", "the number of threads for the ensemble operation", 1, XML_file_name);
+        this->ensemble_op_grid_chunk_size = get_ensemble_op_positive_integer_attribute(ensemble_operation_XML_element, "grid_chunk_size", "the number of grid points of a chunk for the ensemble operation", 0, XML_file_name);
         for (TiXmlNode *ensemble_operation_field_XML_node = ensemble_operation_XML_element->FirstChildElement(); ensemble_operation_field_XML_node != NULL; ensemble_operation_field_XML_node = ensemble_operation_field_XML_node->NextSibling()) {
             if (ensemble_operation_field_XML_node->Type() != TiXmlNode::TINYXML_ELEMENT)
                 continue;
@@ -128,6 +132,19 @@ Field_instances_operation::Field_instances_operation(Ensemble_procedures_inst *e
 }
 
 
+int Field_instances_operation::get_ensemble_op_positive_integer_attribute(TiXmlElement *ensemble_operation_XML_element, const char *attribute_keyword, const char *attribute_annotation, int default_value, const char *XML_file_name)
+{
+    int line_number, attribute_value;
+    const char *attribute_string = get_XML_attribute(-1, CCPL_NAME_STR_LEN, ensemble_operation_XML_element, attribute_keyword, XML_file_name, line_number, attribute_annotation, "configuration of the attributes of the ensemble operation for ensemble procedures", false);
+    if (attribute_string == NULL)
+        return default_value;
+    EXECUTION_REPORT(REPORT_ERROR, -1, is_string_decimal_number(attribute_string), "Error happens when using the XML configuration file \"%s\": the value (\"%s\") of the attribute \"%s\" is not a decimal integer. Please verify the XML file around the line %d.", XML_file_name, attribute_string, attribute_keyword, line_number);
+    EXECUTION_REPORT(REPORT_ERROR, -1, sscanf(attribute_string, "%d", &attribute_value) == 1, "Software error in Field_instances_operation::get_ensemble_op_positive_integer_attribute");
+    EXECUTION_REPORT(REPORT_ERROR, -1, attribute_value > 0, "Error happens when using the XML configuration file \"%s\": the value (\"%s\") of the attribute \"%s\" in \"%s\" must be a positive integer. Please verify the XML file around the line %d.", XML_file_name, attribute_string, attribute_keyword, "ensemble_operation", line_number);
+    return attribute_value;
+}
+
+
 field_op *Field_instances_operation::search_field_op(const char *field_name)
 {
     for (int i = 0; i < fields_op.size(); i ++)
@@ -188,7 +205,7 @@ int Field_instances_operation::check_ensemble_op_format(const char *ensemble_op,
     int member_id = -1;
     char tmp_annotation[NAME_STR_SIZE], tmp1_annotation[NAME_STR_SIZE], tmp2_annotation[NAME_STR_SIZE];
     if (field_name == NULL) {
-        sprintf(tmp_annotation, "Error happens when using the XML configuration file \"%s\": the ensemble operation specified by the value (currently is \"%s\") of the attribute \"%s\" in \"%s\" must be one of \"none/gather/aver/anom/max/min/mem_[id]\". Please verify the XML file around the line %d.", XML_file_name, ensemble_op, "type", "ensemble_operation", line_number);
+        sprintf(tmp_annotation, "Error happens when using the XML configuration file \"%s\": the ensemble operation specified by the value (currently is \"%s\") of the attribute \"%s\" in \"%s\" must be one of \"none/gather/aver/anom/max/min/var/std/spread/mem_[id]\". Please verify the XML file around the line %d.", XML_file_name, ensemble_op, "type", "ensemble_operation", line_number);
         sprintf(tmp1_annotation, "Error happens when using the XML configuration file \"%s\": the ensemble operation specified by the value (currently is \"%s\") of the attribute \"%s\" in \"%s\" is wrong, the ensemble member ID should >= 1 and <= %d. Please verify the XML file around the line %d.", XML_file_name, ensemble_op, "type", "ensemble_operation", ensemble_procedures_inst->num_ens_members, line_number);
         if (words_are_the_same(ensemble_op, ENSEMBLE_OP_NONE))
             this->do_ensemble_OP = false;
@@ -196,7 +213,7 @@ int Field_instances_operation::check_ensemble_op_format(const char *ensemble_op,
             this->do_ensemble_OP = true;
             this->use_set_grids = true;
         }
-        else if (words_are_the_same(ensemble_op, ENSEMBLE_OP_AVER) || words_are_the_same(ensemble_op, ENSEMBLE_OP_MAX) || words_are_the_same(ensemble_op, ENSEMBLE_OP_MIN)) {
+        else if (words_are_the_same(ensemble_op, ENSEMBLE_OP_AVER) || words_are_the_same(ensemble_op, ENSEMBLE_OP_MAX) || words_are_the_same(ensemble_op, ENSEMBLE_OP_MIN) || words_are_the_same(ensemble_op, ENSEMBLE_OP_VAR) || words_are_the_same(ensemble_op, ENSEMBLE_OP_STD) || words_are_the_same(ensemble_op, ENSEMBLE_OP_SPREAD)) {
             this->do_ensemble_OP = true;
             this->use_set_grids = false;
         }
@@ -210,7 +227,7 @@ int Field_instances_operation::check_ensemble_op_format(const char *ensemble_op,
     }
     else {
         sprintf(tmp_annotation, "Error happens when using the XML configuration file \"%s\": the ensemble operation for field \"%s\" specified by the value (currently is \"%s\") of the attribute \"%s\" in \"%s\" conflicts with the common value (\"%s\") specified by the attribute \"%s\". Please verify the XML file around the line %d.", XML_file_name, field_name, ensemble_op, "type", "field", field_instances_ensemble_op, "ensemble_operation", line_number);
-        sprintf(tmp1_annotation, "Error happens when using the XML configuration file \"%s\": the ensemble operation for field \"%s\" specified by the value (currently is \"%s\") of the attribute \"%s\" in \"%s\" must be one of \"none/gather/aver/anom/max/min/mem_[id]\". Please verify the XML file around the line %d.", XML_file_name, field_name, ensemble_op, "type", "ensemble_operation", line_number);
+        sprintf(tmp1_annotation, "Error happens when using the XML configuration file \"%s\": the ensemble operation for field \"%s\" specified by the value (currently is \"%s\") of the attribute \"%s\" in \"%s\" must be one of \"none/gather/aver/anom/max/min/var/std/spread/mem_[id]/cov_[field name]\". Please verify the XML file around the line %d.", XML_file_name, field_name, ensemble_op, "type", "ensemble_operation", line_number);
         sprintf(tmp2_annotation, "Error happens when using the XML configuration file \"%s\": the ensemble operation for field \"%s\" specified by the value (currently is \"%s\") of the attribute \"%s\" in \"%s\" is wrong, the ensemble member ID should >= 1 and <= %d. Please verify the XML file around the line %d.", XML_file_name, field_name, ensemble_op, "type", "field", ensemble_procedures_inst->num_ens_members, line_number);
         if (words_are_the_same(ensemble_op, ENSEMBLE_OP_NONE))
             EXECUTION_REPORT(REPORT_ERROR, -1, !this->do_ensemble_OP, tmp_annotation);
@@ -220,7 +237,15 @@ int Field_instances_operation::check_ensemble_op_format(const char *ensemble_op,
                 if (member_id == 0 || member_id > ensemble_procedures_inst->num_ens_members)
                     EXECUTION_REPORT(REPORT_ERROR, -1, false, tmp2_annotation);
             }
-            else EXECUTION_REPORT(REPORT_ERROR, -1, (words_are_the_same(ensemble_op, ENSEMBLE_OP_GATHER) || words_are_the_same(ensemble_op, ENSEMBLE_OP_ANOM) || words_are_the_same(ensemble_op, ENSEMBLE_OP_AVER) || words_are_the_same(ensemble_op, ENSEMBLE_OP_MAX) || words_are_the_same(ensemble_op, ENSEMBLE_OP_MIN)), tmp1_annotation);
+            else if (strstr(ensemble_op, ENSEMBLE_OP_COV "_") == ensemble_op) {
+                const char *paired_field_name = ensemble_op + strlen(ENSEMBLE_OP_COV "_");
+                bool paired_field_existed = false;
+                for (int i = 0; i < ensemble_procedures_inst->get_num_specified_field_instances(); i ++)
+                    if (words_are_the_same(ensemble_procedures_inst->API_specified_field_insts[i]->get_field_name(), paired_field_name))
+                        paired_field_existed = true;
+                EXECUTION_REPORT(REPORT_ERROR, -1, paired_field_existed && !words_are_the_same(paired_field_name, field_name), "Error happens when using the XML configuration file \"%s\": the ensemble covariance of the field \"%s\" specified by the value (currently is \"%s\") of the attribute \"%s\" in \"%s\" must be paired with another field that has been registered to the ensemble procedures instance. Please verify the XML file around the line %d.", XML_file_name, field_name, ensemble_op, "type", "field", line_number);
+            }
+            else EXECUTION_REPORT(REPORT_ERROR, -1, (words_are_the_same(ensemble_op, ENSEMBLE_OP_GATHER) || words_are_the_same(ensemble_op, ENSEMBLE_OP_ANOM) || words_are_the_same(ensemble_op, ENSEMBLE_OP_AVER) || words_are_the_same(ensemble_op, ENSEMBLE_OP_MAX) || words_are_the_same(ensemble_op, ENSEMBLE_OP_MIN) || words_are_the_same(ensemble_op, ENSEMBLE_OP_VAR) || words_are_the_same(ensemble_op, ENSEMBLE_OP_STD) || words_are_the_same(ensemble_op, ENSEMBLE_OP_SPREAD)), tmp1_annotation);
             EXECUTION_REPORT(REPORT_ERROR, -1, this->do_ensemble_OP, tmp_annotation);
         }
     }
@@ -256,6 +281,15 @@ int Field_instances_operation::get_field_op_member_id(const char *field_name)
 }
 
 
+const char *Field_instances_operation::get_field_op_paired_field_name(const char *field_name)
+{
+    const char *ensemble_op = get_field_op_ensemble_op(field_name);
+    if (strstr(ensemble_op, ENSEMBLE_OP_COV "_") != ensemble_op)
+        return NULL;
+    return ensemble_op + strlen(ENSEMBLE_OP_COV "_");
+}
+
+
 Ensemble_procedures_inst::Ensemble_procedures_inst(int instance_id, const char *inst_name, int member_comp_id, int ensemble_nums, int ensemble_id, int size_field_inst, int size_controls, const int *field_inst_ids, const int *control_vars, const char *annotation)
 {
     int line_number;
@@ -612,6 +646,14 @@ void Ensemble_procedures_inst::do_ensemble_OP(std::vector<Field_mem_info*> &fiel
                 ensemble_operation = ENSEMBLE_OP_TYPE_MAX;
             else if (words_are_the_same(this->field_instances_op->get_field_op_ensemble_op(field_insts_list[i]->get_field_name()), ENSEMBLE_OP_MIN))
                 ensemble_operation = ENSEMBLE_OP_TYPE_MIN;
+            else if (words_are_the_same(this->field_instances_op->get_field_op_ensemble_op(field_insts_list[i]->get_field_name()), ENSEMBLE_OP_VAR))
+                ensemble_operation = ENSEMBLE_OP_TYPE_VARIANCE;
+            else if (words_are_the_same(this->field_instances_op->get_field_op_ensemble_op(field_insts_list[i]->get_field_name()), ENSEMBLE_OP_STD))
+                ensemble_operation = ENSEMBLE_OP_TYPE_STD;
+            else if (words_are_the_same(this->field_instances_op->get_field_op_ensemble_op(field_insts_list[i]->get_field_name()), ENSEMBLE_OP_SPREAD))
+                ensemble_operation = ENSEMBLE_OP_TYPE_SPREAD;
+            else if (this->field_instances_op->get_field_op_paired_field_name(field_insts_list[i]->get_field_name()) != NULL)
+                ensemble_operation = ENSEMBLE_OP_TYPE_COVARIANCE;
             //else if (words_are_the_same(this->field_instances_op->get_field_op_ensemble_op(field_insts_list[i]->get_field_name()), ENSEMBLE_OP_SUM))
             //ensemble_operation = ENSEMBLE_OP_TYPE_SUM;
             else if (words_are_the_same(this->field_instances_op->get_field_op_ensemble_op(field_insts_list[i]->get_field_name()), op_mem))
@@ -620,8 +662,21 @@ void Ensemble_procedures_inst::do_ensemble_OP(std::vector<Field_mem_info*> &fiel
             tmp_member_field_insts.clear();
             for (int n = 0; n < this->num_ens_members; n ++)
                 tmp_member_field_insts.push_back(memory_manager->get_field_instance(tmp_ensemble_member_field_insts_id[n][i]));
-            if (do_member_to_set_operation)
-                fields_member_to_set_operation.push_back(new Member_to_set_operation(tmp_member_field_insts, tmp_ensemble_set_field_insts_one_member[i], ensemble_operation, mem_id));
+            if (do_member_to_set_operation) {
+                fields_member_to_set_operation.push_back(new Member_to_set_operation(tmp_member_field_insts, tmp_ensemble_set_field_insts_one_member[i], ensemble_operation, mem_id, this->field_instances_op->get_ensemble_op_num_threads(), this->field_instances_op->get_ensemble_op_grid_chunk_size()));
+                if (ensemble_operation == ENSEMBLE_OP_TYPE_COVARIANCE) {
+                    const char *paired_field_name = this->field_instances_op->get_field_op_paired_field_name(field_insts_list[i]->get_field_name());
+                    int paired_field_index = -1;
+                    for (int j = 0; j < field_insts_list.size(); j ++)
+                        if (words_are_the_same(field_insts_list[j]->get_field_name(), paired_field_name))
+                            paired_field_index = j;
+                    EXECUTION_REPORT(REPORT_ERROR, -1, paired_field_index != -1, "ERROR happens in Ensemble_procedures_inst::do_ensemble_OP: the field \"%s\" paired with the field \"%s\" for the ensemble covariance in DA instance \"%s\" is not imported by the ensemble procedures. Please verify the XML file \"%s\".", paired_field_name, field_insts_list[i]->get_field_name(), this->instance_name, this->XML_file_name);
+                    std::vector<Field_mem_info*> tmp_paired_member_field_insts;
+                    for (int n = 0; n < this->num_ens_members; n ++)
+                        tmp_paired_member_field_insts.push_back(memory_manager->get_field_instance(tmp_ensemble_member_field_insts_id[n][paired_field_index]));
+                    fields_member_to_set_operation.back()->set_paired_member_fields(tmp_paired_member_field_insts);
+                }
+            }
             EXECUTION_REPORT_ERROR_OPTIONALLY(REPORT_ERROR, -1, fields_member_to_set_operation[i] != NULL, "Software error in Ensemble_procedures_inst::do_ensemble_OP");
             fields_member_to_set_operation[i]->execute();
             tmp_ensemble_set_import_field_insts_after_ens_op.push_back(tmp_ensemble_set_field_insts_one_member[i]);
@@ -35,6 +35,10 @@
 #define ENSEMBLE_OP_MAX               "max"
 #define ENSEMBLE_OP_MIN               "min"
 #define ENSEMBLE_OP_MEM               "mem"
+#define ENSEMBLE_OP_VAR               "var"
+#define ENSEMBLE_OP_STD               "std"
+#define ENSEMBLE_OP_SPREAD            "spread"
+#define ENSEMBLE_OP_COV               "cov"
 
 #define GET_ENS_PROCEDURES_INST_INDEX(ID)       (((ID & 0x00FF0000) >> 16) & 0x00000FFF)
 #define GET_ENS_INST_PROCEDURE_INDEX(ID)        ((ID & 0x00FFF000) >> 12)
@@ -45,7 +49,7 @@ struct field_op
 {
 	char field_name[NAME_STR_SIZE];
 	char field_statistical_method[NAME_STR_SIZE];          // inst/aver/accum/max/min
-	char field_ensemble_op[NAME_STR_SIZE];                 // none/gather/aver/anom/max/min/mem_%d
+	char field_ensemble_op[NAME_STR_SIZE];                 // none/gather/aver/anom/max/min/var/std/spread/mem_%d/cov_%s
 	int member_id;                                         // if field_ensemble_op="mem_%d", member_id=%d; else member_id=-1;
 	int statistical_line_number;
 	int op_line_number;
@@ -59,6 +63,8 @@ private:
 	const char *field_instances_ensemble_op;         // default ensemble_op of all field instances
 	int field_instances_member_id;                                  // default member_id
 	int statistical_periodic_timer_id;
+	int ensemble_op_num_threads;                    // number of threads for member-to-set operations
+	int ensemble_op_grid_chunk_size;                // number of grid points of a chunk reduced by a thread; 0 means evenly divided
 	bool do_field_instances_operation;
 	bool use_statistical_method;
 	bool do_ensemble_OP;
@@ -72,6 +78,9 @@ public:
 	bool if_use_statistical_method() { return use_statistical_method; }
 	bool if_do_ensemble_OP() { return do_ensemble_OP; }
 	bool if_use_set_grids() { return use_set_grids; }
+	int get_ensemble_op_num_threads() { return ensemble_op_num_threads; }
+	int get_ensemble_op_grid_chunk_size() { return ensemble_op_grid_chunk_size; }
+	int get_ensemble_op_positive_integer_attribute(TiXmlElement*, const char*, const char*, int, const char*);
 	field_op *search_field_op(const char*);
 	void add_field_op(const char*, const char*, int, int, const char*, int);
 	void check_statistical_method_format(const char*, const char*, const char*, int, const char*);
@@ -79,6 +88,7 @@ public:
 	const char *get_field_op_statistical_method(const char *);
 	const char *get_field_op_ensemble_op(const char *);
 	int get_field_op_member_id(const char *);
+	const char *get_field_op_paired_field_name(const char *);
 };
 
 
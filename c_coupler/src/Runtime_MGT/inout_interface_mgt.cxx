@@ -173,6 +173,9 @@ Connection_coupling_procedure::Connection_coupling_procedure(Inout_interface *in
                 fields_mem_datatype_transformed[i] = memory_manager->alloc_mem(fields_mem_registered[i], BUF_MARK_DATATYPE_TRANS, coupling_connection->connection_id, transfer_data_type,
                                                      inout_interface->get_interface_source() == INTERFACE_SOURCE_REGISTER && i < coupling_connection->fields_name.size(), false);
                 runtime_datatype_transform_algorithms[i] = new Runtime_datatype_transformer(fields_mem_inter_step_averaged[i], fields_mem_datatype_transformed[i]);
+                // the data type transformation always follows the inter-step average, so that they can be done in one pass
+                if (runtime_inter_averaging_algorithm[i] != NULL)
+                    runtime_inter_averaging_algorithm[i]->fuse_datatype_transformer(runtime_datatype_transform_algorithms[i]);
             }
         }
         if (inout_interface->get_interface_type() == COUPLING_INTERFACE_MARK_IMPORT && !(inout_interface->get_parent_interface() != NULL && inout_interface->get_parent_interface()->get_interface_type() == COUPLING_INTERFACE_MARK_HALO_EXCHANGE)) {
@@ -280,6 +283,7 @@ Connection_coupling_procedure::~Connection_coupling_procedure()
 void Connection_coupling_procedure::execute(bool bypass_timer, int *field_update_status, const char *annotation)
 {
     Time_mgt *time_mgr = components_time_mgrs->get_time_mgr(inout_interface->get_comp_id());
+    long remote_time, local_time, num_remote_steps;
     int lag_seconds;
 
 
@@ -315,14 +319,13 @@ void Connection_coupling_procedure::execute(bool bypass_timer, int *field_update
                 local_fields_time_info->last_timer_second = local_fields_time_info->next_timer_second;
                 local_fields_time_info->get_time_of_next_timer_on(true);
             }
-            while ((((long)remote_fields_time_info->current_num_elapsed_days) * ((long)SECONDS_PER_DAY)) + remote_fields_time_info->current_second + lag_seconds <= (((long)local_fields_time_info->current_num_elapsed_days) * ((long)SECONDS_PER_DAY)) + local_fields_time_info->current_second) {
-                if (remote_fields_time_info->timer->is_timer_on(remote_fields_time_info->current_year, remote_fields_time_info->current_month, remote_fields_time_info->current_day, remote_fields_time_info->current_second, remote_fields_time_info->current_num_elapsed_days,
-                        time_mgr->get_start_year(), time_mgr->get_start_month(), time_mgr->get_start_day(), time_mgr->get_start_second(), time_mgr->get_start_num_elapsed_day())) {
-                    remote_fields_time_info->last_timer_num_elapsed_days = remote_fields_time_info->current_num_elapsed_days;
-                    remote_fields_time_info->last_timer_date = remote_fields_time_info->current_year * 10000 + remote_fields_time_info->current_month * 100 + remote_fields_time_info->current_day;
-                    remote_fields_time_info->last_timer_second = remote_fields_time_info->current_second;
-                }
-                time_mgr->advance_time(remote_fields_time_info->current_year, remote_fields_time_info->current_month, remote_fields_time_info->current_day, remote_fields_time_info->current_second, remote_fields_time_info->current_num_elapsed_days,  remote_fields_time_info->time_step_in_second);
+            remote_time = ((long)remote_fields_time_info->current_num_elapsed_days) * ((long)SECONDS_PER_DAY) + remote_fields_time_info->current_second;
+            local_time = ((long)local_fields_time_info->current_num_elapsed_days) * ((long)SECONDS_PER_DAY) + local_fields_time_info->current_second;
+            if (remote_time + lag_seconds <= local_time) {
+                num_remote_steps = (local_time - lag_seconds - remote_time) / remote_fields_time_info->time_step_in_second + 1;
+                remote_fields_time_info->timer->get_time_of_last_timer_on(time_mgr, remote_fields_time_info->current_year, remote_fields_time_info->current_month, remote_fields_time_info->current_day, remote_fields_time_info->current_second, remote_fields_time_info->current_num_elapsed_days,
+                        remote_fields_time_info->time_step_in_second, num_remote_steps, remote_fields_time_info->last_timer_num_elapsed_days, remote_fields_time_info->last_timer_date, remote_fields_time_info->last_timer_second);
+                time_mgr->advance_time_by_seconds(remote_fields_time_info->current_year, remote_fields_time_info->current_month, remote_fields_time_info->current_day, remote_fields_time_info->current_second, remote_fields_time_info->current_num_elapsed_days, num_remote_steps * remote_fields_time_info->time_step_in_second);
             }
             remote_fields_time_info->get_time_of_next_timer_on(false);
         }
@@ -619,6 +622,7 @@ Inout_interface::Inout_interface(const char *temp_array_buffer, long &buffer_con
 
     restart_mgr = NULL;
     inversed_dst_fraction = NULL;
+    halo_exchange_algorithm = NULL;
 }
 
 
@@ -735,6 +739,7 @@ void Inout_interface::initialize_data(const char *interface_name, int interface_
     this->inversed_dst_fraction = NULL;
     this->fields_name.clear();
     this->is_last_halo_exchange_waited = true;
+    this->halo_exchange_algorithm = NULL;
     strcpy(this->interface_name, interface_name);
     strcpy(this->comp_full_name, comp_comm_group_mgt_mgr->get_global_node_of_local_comp(comp_id, false, "in Inout_interface::initialize_data")->get_full_name());
     this->inst_or_aver = inst_or_aver;
@@ -766,6 +771,8 @@ Inout_interface::~Inout_interface()
 
     for (int i = 0; i < children_interfaces.size(); i ++)
         delete children_interfaces[i];
+    if (halo_exchange_algorithm != NULL)
+        delete halo_exchange_algorithm;
 }
 
 
@@ -1213,7 +1220,6 @@ void Inout_interface::execute(bool bypass_timer, int API_id, int *field_update_s
 
 void Inout_interface::do_halo_exchange(int API_id, bool is_asynchronous, const char *annotation)
 {
-    int field_update_status[4096];
     char API_label[NAME_STR_SIZE];
 
 
@@ -1228,18 +1234,17 @@ void Inout_interface::do_halo_exchange(int API_id, bool is_asynchronous, const c
         get_API_hint(comp_id, API_id, API_label);
         EXECUTION_REPORT(REPORT_ERROR, comp_id, false, "Error happens when calling API \"%s\" to execute the halo exchange interface \"%s\": the last call for executing this interface is an asynchorous halo exchange while the model does not confirm that the asynchorous halo exchange has been ended safely. Please check the model code with the annotation \"%s\"", API_label, interface_name, annotation);
     }
-    children_interfaces[0]->execute(true, API_id, field_update_status, 4096, annotation);
-    if (!is_asynchronous) {
-        children_interfaces[1]->execute(true, API_id, field_update_status, 4096, annotation);
-        children_interfaces[0]->get_unique_data_send_algorithm()->wait_sending_data();
-    }
-    is_last_halo_exchange_waited = (!is_asynchronous);
+    if (halo_exchange_algorithm == NULL)
+        halo_exchange_algorithm = new Runtime_halo_exchange_algorithm(comp_id, children_interfaces[0]->fields_mem_registered, children_interfaces[1]->fields_mem_registered, halo_regions);
+    halo_exchange_algorithm->start_exchange();
+    is_last_halo_exchange_waited = false;
+    if (!is_asynchronous)
+        finish_halo_exchange(API_id, annotation);
 }
 
 
 void Inout_interface::finish_halo_exchange(int API_id, const char *annotation)
 {
-    int field_update_status[4096];
     char API_label[NAME_STR_SIZE];
 
 
@@ -1251,8 +1256,7 @@ void Inout_interface::finish_halo_exchange(int API_id, const char *annotation)
     if (is_last_halo_exchange_waited)
         return;
 
-    children_interfaces[1]->execute(true, API_id, field_update_status, 4096, annotation);
-    children_interfaces[0]->get_unique_data_send_algorithm()->wait_sending_data();
+    halo_exchange_algorithm->finish_exchange();
     is_last_halo_exchange_waited = true;
     for (int i = 0; i < children_interfaces[1]->fields_mem_registered.size(); i ++)
         children_interfaces[1]->fields_mem_registered[i]->check_field_sum(report_internal_log_enabled, true, "after halo exchanging");
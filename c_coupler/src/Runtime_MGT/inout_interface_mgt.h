@@ -17,6 +17,7 @@
 #include "memory_mgt.h"
 #include "timer_mgt.h"
 #include "runtime_trans_algorithm.h"
+#include "runtime_halo_exchange_algorithm.h"
 #include "runtime_datatype_transformer.h"
 #include "runtime_cumulate_average_algorithm.h"
 #include "runtime_remap_algorithm.h"
@@ -157,6 +158,7 @@ class Inout_interface
         int execution_checking_status;
         long last_execution_time;
         bool is_last_halo_exchange_waited;
+        Runtime_halo_exchange_algorithm *halo_exchange_algorithm;
         char *inversed_dst_fraction;
         long bypass_counter;
         int num_fields_connected;
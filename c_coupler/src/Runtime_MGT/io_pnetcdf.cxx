@@ -27,6 +27,11 @@ IO_pnetcdf::IO_pnetcdf(int ncfile_id)
     strcpy(this->file_name, "NULL");
     strcpy(this->open_format, "NULL");
     this->is_external_file = true;
+    this->keep_file_open = true;
+    this->file_is_open = true;
+    this->in_define_mode = false;
+    this->time_count = -1;
+    this->flush_thread_active = false;
     this->ncfile_id = ncfile_id;
 }
 
@@ -43,24 +48,256 @@ IO_pnetcdf::IO_pnetcdf(int host_comp_id, int pio_proc_num, int io_proc_mark, MPI
     this->is_external_file = false;
     this->current_proc_local_id = comp_comm_group_mgt_mgr->get_current_proc_id_in_comp(host_comp_id, "in parallel IO");
     this->io_proc_mark = io_proc_mark;
+    this->time_count = -1;
+    this->file_is_open = false;
+    this->in_define_mode = false;
+    this->keep_file_open = words_are_the_same(format, "w");
+    this->flush_thread_active = false;
 
-    if (words_are_the_same(format, "r"))
+    if (words_are_the_same(format, "r")) {
         rcode = ncmpi_open(comm, file_name, NC_NOWRITE, MPI_INFO_NULL, &ncfile_id);
+        report_nc_error();
+        rcode = ncmpi_close(ncfile_id);
+    }
     else if (words_are_the_same(format, "w")) {
         rcode = ncmpi_create(comm, file_name, NC_CLOBBER|NC_64BIT_OFFSET, MPI_INFO_NULL, &ncfile_id);
-        report_nc_error();
-        ncmpi_enddef(ncfile_id);
+        file_is_open = true;
+        in_define_mode = true;
     }
     else EXECUTION_REPORT(REPORT_ERROR, -1, false, "the format of openning netcdf file must be read or write (\"r\" or \"w\")\n");
     report_nc_error();
+}
+
+
+IO_pnetcdf::~IO_pnetcdf()
+{
+    if (is_external_file)
+        flush_pending_writes();
+    else close_file();
+}
+
+
+/* A file opened for writing keeps its handle until close_file() or the destructor, so that the
+   header is parsed once and the variable writes of a time slice can be posted together. A file
+   opened for reading is still closed after each call */
+void IO_pnetcdf::open_file()
+{
+    wait_asynchronous_flush();
+    if (file_is_open)
+        return;
+
+    rcode = ncmpi_open(comm, file_name, keep_file_open? NC_WRITE : NC_NOWRITE, MPI_INFO_NULL, &ncfile_id);
+    report_nc_error();
+    file_is_open = true;
+    in_define_mode = false;
+}
+
+
+void IO_pnetcdf::release_file()
+{
+    if (!keep_file_open)
+        close_file();
+}
+
+
+void IO_pnetcdf::close_file()
+{
+    if (!file_is_open || is_external_file)
+        return;
 
+    flush_pending_writes();
     rcode = ncmpi_close(ncfile_id);
     report_nc_error();
+    file_is_open = false;
+    in_define_mode = false;
 }
 
 
-IO_pnetcdf::~IO_pnetcdf()
+void IO_pnetcdf::enter_define_mode()
+{
+    open_file();
+    if (in_define_mode)
+        return;
+
+    rcode = ncmpi_redef(ncfile_id);
+    report_nc_error();
+    in_define_mode = true;
+}
+
+
+void IO_pnetcdf::enter_data_mode()
+{
+    open_file();
+    if (!in_define_mode)
+        return;
+
+    rcode = ncmpi_enddef(ncfile_id);
+    report_nc_error();
+    in_define_mode = false;
+}
+
+
+void IO_pnetcdf::queue_write(int var_ncid, const char *data_type, int num_dims, const MPI_Offset *starts, const MPI_Offset *counts, void *data_buf, bool own_data_buf)
+{
+    Pnetcdf_pending_write *pending_write = new Pnetcdf_pending_write;
+
+
+    EXECUTION_REPORT(REPORT_ERROR, -1, words_are_the_same(data_type, DATA_TYPE_CHAR) || words_are_the_same(data_type, DATA_TYPE_FLOAT) || words_are_the_same(data_type, DATA_TYPE_INT) || 
+                     words_are_the_same(data_type, DATA_TYPE_SHORT) || words_are_the_same(data_type, DATA_TYPE_DOUBLE), "remap software error3 in write_field_data\n");
+    pending_write->var_ncid = var_ncid;
+    strcpy(pending_write->data_type, data_type);
+    pending_write->starts.assign(starts, starts+num_dims);
+    pending_write->counts.assign(counts, counts+num_dims);
+    pending_write->data_buf = data_buf;
+    pending_write->own_data_buf = own_data_buf;
+    pending_writes.push_back(pending_write);
+}
+
+
+void IO_pnetcdf::queue_time_record_value(const char *var_name, int value)
 {
+    int var_ncid;
+    MPI_Offset starts = time_count - 1, counts = 1;
+    int *value_buf = (int*) new char [sizeof(int)];
+
+
+    rcode = ncmpi_inq_varid(ncfile_id, var_name, &var_ncid);
+    report_nc_error();
+    value_buf[0] = value;
+    queue_write(var_ncid, DATA_TYPE_INT, 1, &starts, &counts, value_buf, true);
+}
+
+
+/* Posts all queued variable writes with ncmpi_iput_vara and completes them with a single ncmpi_wait_all.
+   It may run in the background thread, so errors are only recorded here and reported by release_pending_writes */
+void IO_pnetcdf::post_pending_writes()
+{
+    int i, *requests, local_rcode;
+    MPI_Offset *starts, *counts;
+
+
+    pending_writes_rcode = NC_NOERR;
+    requests = new int [pending_writes.size()];
+    pending_write_statuses.resize(pending_writes.size());
+    for (i = 0; i < pending_writes.size(); i ++) {
+        starts = pending_writes[i]->starts.size() > 0? &(pending_writes[i]->starts[0]) : NULL;
+        counts = pending_writes[i]->counts.size() > 0? &(pending_writes[i]->counts[0]) : NULL;
+        if (words_are_the_same(pending_writes[i]->data_type, DATA_TYPE_CHAR))
+            local_rcode = ncmpi_iput_vara_schar(ncfile_id, pending_writes[i]->var_ncid, starts, counts, (signed char *) pending_writes[i]->data_buf, &requests[i]);
+        else if (words_are_the_same(pending_writes[i]->data_type, DATA_TYPE_FLOAT))
+            local_rcode = ncmpi_iput_vara_float(ncfile_id, pending_writes[i]->var_ncid, starts, counts, (float*) pending_writes[i]->data_buf, &requests[i]);
+        else if (words_are_the_same(pending_writes[i]->data_type, DATA_TYPE_INT))
+            local_rcode = ncmpi_iput_vara_int(ncfile_id, pending_writes[i]->var_ncid, starts, counts, (int *) pending_writes[i]->data_buf, &requests[i]);
+        else if (words_are_the_same(pending_writes[i]->data_type, DATA_TYPE_SHORT))
+            local_rcode = ncmpi_iput_vara_short(ncfile_id, pending_writes[i]->var_ncid, starts, counts, (short *) pending_writes[i]->data_buf, &requests[i]);
+        else local_rcode = ncmpi_iput_vara_double(ncfile_id, pending_writes[i]->var_ncid, starts, counts, (double*) pending_writes[i]->data_buf, &requests[i]);
+        if (local_rcode != NC_NOERR) {
+            pending_writes_rcode = local_rcode;
+            requests[i] = NC_REQ_NULL;
+        }
+    }
+    local_rcode = ncmpi_wait_all(ncfile_id, pending_writes.size(), requests, &(pending_write_statuses[0]));
+    if (pending_writes_rcode == NC_NOERR)
+        pending_writes_rcode = local_rcode;
+    delete [] requests;
+}
+
+
+void IO_pnetcdf::release_pending_writes()
+{
+    rcode = pending_writes_rcode;
+    report_nc_error();
+    for (int i = 0; i < pending_writes.size(); i ++) {
+        EXECUTION_REPORT(REPORT_ERROR, -1, pending_write_statuses[i] == NC_NOERR, "Netcdf error: %s for file %s\n", ncmpi_strerror(pending_write_statuses[i]), file_name);
+        if (pending_writes[i]->own_data_buf)
+            delete [] (char*) pending_writes[i]->data_buf;
+        delete pending_writes[i];
+    }
+    pending_writes.clear();
+    pending_write_statuses.clear();
+
+    for (int i = 0; i < pending_io_field_datas.size(); i ++)
+        delete pending_io_field_datas[i];
+    pending_io_field_datas.clear();
+}
+
+
+void IO_pnetcdf::flush_pending_writes()
+{
+    wait_asynchronous_flush();
+    if (pending_writes.size() == 0 && pending_io_field_datas.size() == 0)
+        return;
+
+    enter_data_mode();
+    post_pending_writes();
+    release_pending_writes();
+}
+
+
+void *IO_pnetcdf::asynchronous_flush_entry(void *io_object)
+{
+    ((IO_pnetcdf*) io_object)->post_pending_writes();
+    return NULL;
+}
+
+
+/* Copies the data of the queued writes into buffers owned by this object, so that the writes can be
+   flushed later even if the field buffers are reused or changed in the meantime */
+void IO_pnetcdf::keep_data_of_pending_writes()
+{
+    long data_size;
+    char *data_copy;
+
+
+    for (int i = 0; i < pending_writes.size(); i ++) {
+        if (pending_writes[i]->own_data_buf)
+            continue;
+        data_size = get_data_type_size(pending_writes[i]->data_type);
+        for (int j = 0; j < pending_writes[i]->counts.size(); j ++)
+            data_size *= pending_writes[i]->counts[j];
+        data_copy = new char [data_size];
+        memcpy(data_copy, pending_writes[i]->data_buf, data_size);
+        pending_writes[i]->data_buf = data_copy;
+        pending_writes[i]->own_data_buf = true;
+    }
+    for (int i = 0; i < pending_io_field_datas.size(); i ++)
+        delete pending_io_field_datas[i];
+    pending_io_field_datas.clear();
+}
+
+
+/* Same as flush_pending_writes, but the writes are completed by a background thread so that the I/O
+   processes can return to the model immediately. The data of the queued writes is first copied into
+   buffers owned by this object, which together with the field buffers form a double buffer. The next
+   access to this file waits for the background thread. Requires MPI_THREAD_MULTIPLE */
+void IO_pnetcdf::flush_pending_writes_asynchronously()
+{
+    wait_asynchronous_flush();
+    if (pending_writes.size() == 0 && pending_io_field_datas.size() == 0)
+        return;
+
+    enter_data_mode();
+    keep_data_of_pending_writes();
+    if (pthread_create(&flush_thread, NULL, asynchronous_flush_entry, this) != 0) {
+        EXECUTION_REPORT_LOG(REPORT_LOG, -1, true, "Fail to start the thread for writing file %s in the background: write it synchronously", file_name);
+        post_pending_writes();
+        release_pending_writes();
+        return;
+    }
+    flush_thread_active = true;
+    EXECUTION_REPORT_LOG(REPORT_LOG, -1, true, "Start writing %d variable slices into file %s in the background", pending_writes.size(), file_name);
+}
+
+
+void IO_pnetcdf::wait_asynchronous_flush()
+{
+    if (!flush_thread_active)
+        return;
+
+    pthread_join(flush_thread, NULL);
+    flush_thread_active = false;
+    EXECUTION_REPORT_LOG(REPORT_LOG, -1, true, "Finish writing %d variable slices into file %s in the background", pending_writes.size(), file_name);
+    release_pending_writes();
 }
 
 
@@ -149,14 +386,13 @@ bool IO_pnetcdf::read_field_data(int host_comp_id, Field_mem_info *io_field_inst
     Remap_data_field *read_data_field = grided_data->get_grid_data_field();
     grided_data->get_coord_value_grid()->get_sized_sub_grids(&num_sized_sub_grids, sized_sub_grids);
 
-    rcode = ncmpi_open(comm, file_name, NC_NOWRITE, MPI_INFO_NULL, &ncfile_id);
-    report_nc_error();
+    flush_pending_writes();
+    enter_data_mode();
 
     rcode = ncmpi_inq_varid(ncfile_id, read_data_field->field_name_in_IO_file, &variable_id);
     if (!check_existence && rcode == NC_ENOTVAR) {
         EXECUTION_REPORT_LOG(REPORT_LOG, -1, true, "Does not find the field \"%s\" in the data file \"%s\"", read_data_field->field_name_in_IO_file, file_name);
-        rcode = ncmpi_close(ncfile_id);
-        report_nc_error();
+        release_file();
         return false;
     }
     report_nc_error();
@@ -320,8 +556,7 @@ bool IO_pnetcdf::read_field_data(int host_comp_id, Field_mem_info *io_field_inst
 
     ncmpi_wait_all(ncfile_id, 1, &req, &st);
     report_nc_error();
-    rcode = ncmpi_close(ncfile_id);
-    report_nc_error();
+    release_file();
 
     return true;
 }
@@ -338,11 +573,7 @@ void IO_pnetcdf::write_grid(int host_comp_id, Field_mem_info *output_field_insta
     if (associated_grid == NULL)
         return;
 
-    rcode = ncmpi_open(comm, file_name, NC_WRITE, MPI_INFO_NULL, &ncfile_id);
-    report_nc_error();
-
-    rcode = ncmpi_redef(ncfile_id);
-    report_nc_error();
+    open_file();
     associated_grid->get_sized_sub_grids(&num_sized_sub_grids, sized_sub_grids);
     for (i = 0; i < num_sized_sub_grids; i ++)
         if (sized_grids_map.find(sized_sub_grids[i]) == sized_grids_map.end()) {
@@ -356,6 +587,7 @@ void IO_pnetcdf::write_grid(int host_comp_id, Field_mem_info *output_field_insta
             else if (sized_sub_grids[i]->get_num_dimensions() == 1)
                 sprintf(tmp_string, "%s", sized_sub_grids[i]->get_coord_label());
             else sprintf(tmp_string, "grid_size_%s", sized_sub_grids[i]->get_grid_name());
+            enter_define_mode();
             if (sized_sub_grids[i]->get_is_sphere_grid())
                 rcode = ncmpi_def_dim(ncfile_id, tmp_string, decomps_info_mgr->get_decomp_info(output_field_instance->get_decomp_id())->get_num_global_cells(), &dim_ncid);
             else rcode = ncmpi_def_dim(ncfile_id, tmp_string, sized_sub_grids[i]->get_grid_size(), &dim_ncid);
@@ -365,6 +597,7 @@ void IO_pnetcdf::write_grid(int host_comp_id, Field_mem_info *output_field_insta
             recorded_grids.push_back(sized_sub_grids[i]);
         }
     if (use_script_format) {
+        enter_define_mode();
         if (sized_grids_map.find(associated_grid) == sized_grids_map.end()) {
             rcode = ncmpi_def_dim(ncfile_id, "grid_size", associated_grid->get_grid_size(), &dim_ncid);
             report_nc_error();
@@ -373,20 +606,14 @@ void IO_pnetcdf::write_grid(int host_comp_id, Field_mem_info *output_field_insta
         }
         rcode = ncmpi_def_dim(ncfile_id, "grid_rank", num_sized_sub_grids, &dim_ncid);
         report_nc_error();
-        int grid_dim_size[256], dims_ncid;
+        int *grid_dim_size = (int*) new char [num_sized_sub_grids*sizeof(int)], dims_ncid;
+        MPI_Offset dims_start = 0, dims_count = num_sized_sub_grids;
         for (int i = 0; i < num_sized_sub_grids; i ++)
             grid_dim_size[i] = sized_sub_grids[i]->get_grid_size();
         rcode = ncmpi_def_var(ncfile_id, "grid_dims", NC_INT, 1, &dim_ncid, &dims_ncid);
         report_nc_error();
-        rcode = ncmpi_enddef(ncfile_id);
-        report_nc_error();
-        ncmpi_put_var_int(ncfile_id, dims_ncid, grid_dim_size);
-        report_nc_error();
-        rcode = ncmpi_redef(ncfile_id);
-        report_nc_error();
+        queue_write(dims_ncid, DATA_TYPE_INT, 1, &dims_start, &dims_count, grid_dim_size, true);
     }
-    ncmpi_enddef(ncfile_id);
-    report_nc_error();
 
     associated_grid->get_leaf_grids(&num_leaf_grids, leaf_grids, associated_grid);
     for (i = 0; i < num_leaf_grids; i ++) {
@@ -408,12 +635,9 @@ void IO_pnetcdf::write_grid(int host_comp_id, Field_mem_info *output_field_insta
             if (write_grid_name)
                 sprintf(tmp_string, "grid_%d_P0", get_recorded_grid_num(leaf_grids[i]));
             double P0 = leaf_grids[i]->get_sigma_grid_top_value();
-            rcode = ncmpi_redef(ncfile_id);
-            report_nc_error();
+            enter_define_mode();
             rcode = ncmpi_put_att_double(ncfile_id, NC_GLOBAL, tmp_string, NC_DOUBLE, 1, &P0);
             report_nc_error();
-            ncmpi_enddef(ncfile_id);
-            report_nc_error();
         }
         grid_data_field = leaf_grids[i]->get_grid_vertex_field();
         if (grid_data_field != NULL && !grid_data_field->get_coord_value_grid()->get_are_vertex_values_set_in_default()) {
@@ -424,10 +648,8 @@ void IO_pnetcdf::write_grid(int host_comp_id, Field_mem_info *output_field_insta
             else sprintf(tmp_string, "num_vertexes_H2D");
             rcode = ncmpi_inq_dimid(ncfile_id, tmp_string, &dim_ncid);
             if (rcode == NC_EBADDIM) {
-                rcode = ncmpi_redef(ncfile_id);
-                report_nc_error();
+                enter_define_mode();
                 rcode = ncmpi_def_dim(ncfile_id, tmp_string, grid_data_field->get_coord_value_grid()->get_num_vertexes(), &dim_ncid);
-                ncmpi_enddef(ncfile_id);
                 report_nc_error();
             }
             write_field_data(host_comp_id, output_field_instance, grid_data_field, associated_grid, true, GRID_VERTEX_LABEL, dim_ncid, write_grid_name, use_script_format, false);
@@ -440,8 +662,7 @@ void IO_pnetcdf::write_grid(int host_comp_id, Field_mem_info *output_field_insta
     if (associated_grid->get_grid_imported_area() != NULL)
         write_field_data(host_comp_id, output_field_instance, associated_grid->get_grid_imported_area(), associated_grid, true, "area", -1, write_grid_name, use_script_format, true);
 
-    rcode = ncmpi_close(ncfile_id);
-    report_nc_error();
+    release_file();
 }
 
 
@@ -460,9 +681,10 @@ void IO_pnetcdf::write_field_data(int host_comp_id, Field_mem_info *output_field
     MPI_Offset starts[256], counts[256];
     Remap_grid_class *sized_sub_grids[256];
     char tmp_string[256];
-    int var_ncid, dim_ncids[256], req;
+    int var_ncid, dim_ncids[256];
     nc_type nc_data_type;
-    int *temp_buffer, st;
+    int *temp_buffer;
+    char *data_copy;
     Comp_comm_group_mgt_node *comp_node = comp_comm_group_mgt_mgr->search_global_node(host_comp_id);
     int local_proc_id = comp_node->get_current_proc_local_id();
 
@@ -586,8 +808,7 @@ void IO_pnetcdf::write_field_data(int host_comp_id, Field_mem_info *output_field
 
     rcode = ncmpi_inq_varid(ncfile_id, tmp_string, &var_ncid);
     if (rcode == NC_ENOTVAR) {
-        rcode = ncmpi_redef(ncfile_id);
-        report_nc_error();
+        enter_define_mode();
         datatype_from_netcdf_to_application(field_data->get_grid_data_field()->data_type_in_IO_file, &nc_data_type);
         rcode = ncmpi_def_var(ncfile_id, tmp_string, nc_data_type, num_dims, dim_ncids, &var_ncid);
         report_nc_error();
@@ -620,127 +841,102 @@ void IO_pnetcdf::write_field_data(int host_comp_id, Field_mem_info *output_field
             }
             report_nc_error();
         }
-        rcode = ncmpi_enddef(ncfile_id);
-        report_nc_error();
     }
 
     if (words_are_the_same(field_data->get_grid_data_field()->data_type_in_application, DATA_TYPE_BOOL)) {
-        temp_buffer = new int [field_data->get_grid_data_field()->required_data_size];
+        temp_buffer = (int*) new char [field_data->get_grid_data_field()->required_data_size*sizeof(int)];
         for (long i = 0; i < field_data->get_grid_data_field()->required_data_size; i ++)
             if (((bool*)field_data->get_grid_data_field()->data_buf)[i])
                 temp_buffer[i] = 1;
             else temp_buffer[i] = 0;
-        rcode = ncmpi_iput_vara_int(ncfile_id, var_ncid, starts, counts, temp_buffer, &req);
-    }
-    else if (words_are_the_same(field_data->get_grid_data_field()->data_type_in_application, DATA_TYPE_CHAR))
-        rcode = ncmpi_iput_vara_schar(ncfile_id, var_ncid, starts, counts, (signed char *) field_data->get_grid_data_field()->data_buf, &req);
-    else if (words_are_the_same(field_data->get_grid_data_field()->data_type_in_application, DATA_TYPE_FLOAT))
-        rcode = ncmpi_iput_vara_float(ncfile_id, var_ncid, starts, counts, (float*) field_data->get_grid_data_field()->data_buf, &req);
-    else if (words_are_the_same(field_data->get_grid_data_field()->data_type_in_application, DATA_TYPE_INT))
-        rcode = ncmpi_iput_vara_int(ncfile_id, var_ncid, starts, counts, (int *) field_data->get_grid_data_field()->data_buf, &req);
-    else if (words_are_the_same(field_data->get_grid_data_field()->data_type_in_application, DATA_TYPE_SHORT))
-        rcode = ncmpi_iput_vara_short(ncfile_id, var_ncid, starts, counts, (short *) field_data->get_grid_data_field()->data_buf, &req);
-    else if (words_are_the_same(field_data->get_grid_data_field()->data_type_in_application, DATA_TYPE_DOUBLE)) {
-        rcode = ncmpi_iput_vara_double(ncfile_id, var_ncid, starts, counts, (double*) field_data->get_grid_data_field()->data_buf, &req);
-    }
-    else EXECUTION_REPORT(REPORT_ERROR, -1, false, "remap software error3 in write_field_data\n");
-    report_nc_error();
-    ncmpi_wait_all(ncfile_id, 1, &req, &st);
-    report_nc_error();
-    if (words_are_the_same(field_data->get_grid_data_field()->data_type_in_application, DATA_TYPE_BOOL))
-        delete [] temp_buffer;
+        queue_write(var_ncid, DATA_TYPE_INT, num_dims, starts, counts, temp_buffer, true);
+    }
+    else if (is_grid_data) {
+        // grid data may be shared by several grids and rearranged for another grid before the flush
+        long data_buf_size = field_data->get_grid_data_field()->required_data_size*get_data_type_size(field_data->get_grid_data_field()->data_type_in_application);
+        data_copy = new char [data_buf_size];
+        memcpy(data_copy, field_data->get_grid_data_field()->data_buf, data_buf_size);
+        queue_write(var_ncid, field_data->get_grid_data_field()->data_type_in_application, num_dims, starts, counts, data_copy, true);
+    }
+    else queue_write(var_ncid, field_data->get_grid_data_field()->data_type_in_application, num_dims, starts, counts, field_data->get_grid_data_field()->data_buf, false);
 }
 
 
 void IO_pnetcdf::write_grided_data(int host_comp_id, Field_mem_info *output_field_instance, bool write_grid_name, int date, int datesec, bool is_restart_field)
 {
     MPI_Offset starts, counts, dim_len;
-    int current_date, current_datesec;
-    int time_var_id, date_var_id, datesec_var_id, tmp_var_id;;
+    int time_var_id, date_var_id, datesec_var_id;
     Remap_grid_data_class *tmp_field_data_for_io;
     Remap_grid_data_class *grided_data = output_field_instance->get_field_data();
 
     if (execution_phase_number == 0)
         return;
     
-    rcode = ncmpi_open(comm, file_name, NC_WRITE, MPI_INFO_NULL, &ncfile_id);
-    report_nc_error();
+    open_file();
 
     if (!io_with_time_info)
         EXECUTION_REPORT(REPORT_ERROR, -1, date == -1 && datesec == -1, "remap software error in write_grided_data \n");
     else {
         EXECUTION_REPORT(REPORT_ERROR, -1, date > 0 && datesec >= 0, "remap software error in write_grided_data \n");
-        rcode = ncmpi_inq_dimid(ncfile_id, "time", &time_dim_id); 
-        if (rcode == NC_EBADDIM) {
-            rcode = ncmpi_redef(ncfile_id);
-            report_nc_error();
-            rcode = ncmpi_def_dim(ncfile_id, "time", NC_UNLIMITED, &time_dim_id);
-            report_nc_error();
-            rcode = ncmpi_def_var(ncfile_id, "time", NC_INT, 1, &time_dim_id, &time_var_id);
-            report_nc_error();
-            rcode = ncmpi_def_var(ncfile_id, "date", NC_INT, 1, &time_dim_id, &date_var_id);
-            report_nc_error();
-            rcode = ncmpi_def_var(ncfile_id, "datesec", NC_INT, 1, &time_dim_id, &datesec_var_id);
-            report_nc_error();
-            ncmpi_enddef(ncfile_id);
-            report_nc_error();
-            time_count = 0;
-            current_date = -1;
-            current_datesec = -1;
-        }
-        else {
-            rcode = ncmpi_inq_dimlen(ncfile_id, time_dim_id, &dim_len);
-            time_count = dim_len;
-            report_nc_error();
-            starts = time_count - 1;
-            counts = 1;
-            rcode = ncmpi_inq_varid(ncfile_id, "date", &date_var_id);
-            report_nc_error();
-            rcode = ncmpi_get_vara_int_all(ncfile_id, date_var_id, &starts, &counts, &current_date);
-            report_nc_error();
-            rcode = ncmpi_inq_varid(ncfile_id, "datesec", &datesec_var_id);
-            report_nc_error();
-            rcode = ncmpi_get_vara_int_all(ncfile_id, datesec_var_id, &starts, &counts, &current_datesec);
-            report_nc_error();
+        if (time_count == -1) {
+            rcode = ncmpi_inq_dimid(ncfile_id, "time", &time_dim_id); 
+            if (rcode == NC_EBADDIM) {
+                enter_define_mode();
+                rcode = ncmpi_def_dim(ncfile_id, "time", NC_UNLIMITED, &time_dim_id);
+                report_nc_error();
+                rcode = ncmpi_def_var(ncfile_id, "time", NC_INT, 1, &time_dim_id, &time_var_id);
+                report_nc_error();
+                rcode = ncmpi_def_var(ncfile_id, "date", NC_INT, 1, &time_dim_id, &date_var_id);
+                report_nc_error();
+                rcode = ncmpi_def_var(ncfile_id, "datesec", NC_INT, 1, &time_dim_id, &datesec_var_id);
+                report_nc_error();
+                time_count = 0;
+                last_written_date = -1;
+                last_written_datesec = -1;
+            }
+            else {
+                report_nc_error();
+                enter_data_mode();
+                rcode = ncmpi_inq_dimlen(ncfile_id, time_dim_id, &dim_len);
+                report_nc_error();
+                time_count = dim_len;
+                last_written_date = -1;
+                last_written_datesec = -1;
+                if (time_count > 0) {
+                    starts = time_count - 1;
+                    counts = 1;
+                    rcode = ncmpi_inq_varid(ncfile_id, "date", &date_var_id);
+                    report_nc_error();
+                    rcode = ncmpi_get_vara_int_all(ncfile_id, date_var_id, &starts, &counts, &last_written_date);
+                    report_nc_error();
+                    rcode = ncmpi_inq_varid(ncfile_id, "datesec", &datesec_var_id);
+                    report_nc_error();
+                    rcode = ncmpi_get_vara_int_all(ncfile_id, datesec_var_id, &starts, &counts, &last_written_datesec);
+                    report_nc_error();
+                }
+            }
         }
-        if (current_date != date || current_datesec != datesec) {
+        if (last_written_date != date || last_written_datesec != datesec) {
             time_count ++;
-            starts = time_count - 1;
-            counts = 1;
-            rcode = ncmpi_inq_varid(ncfile_id, "time", &time_var_id);  
-            report_nc_error();
-            EXECUTION_REPORT(REPORT_LOG, host_comp_id, true, "starts:%d, time_count:%d,counts:%d, time_var_id:%x,nc_file_id:%x", starts, time_count, counts, time_var_id,ncfile_id);
-            rcode = ncmpi_put_vara_int_all(ncfile_id, time_var_id, &starts, &counts, &time_count);
-            report_nc_error();
-            EXECUTION_REPORT(REPORT_LOG, host_comp_id, true, "finished writing time2");
-            rcode = ncmpi_inq_varid(ncfile_id, "date", &date_var_id);  
-            report_nc_error();
-            rcode = ncmpi_put_vara_int_all(ncfile_id, date_var_id, &starts, &counts, &date);   
-            report_nc_error();
-            rcode = ncmpi_inq_varid(ncfile_id, "datesec", &datesec_var_id);  
-            report_nc_error();
-            rcode = ncmpi_put_vara_int_all(ncfile_id, datesec_var_id, &starts, &counts, &datesec);
-            report_nc_error();
+            EXECUTION_REPORT(REPORT_LOG, host_comp_id, true, "queue the time record %d (date %d, datesec %d) in ncfile %s", time_count, date, datesec, file_name);
+            queue_time_record_value("time", time_count);
+            queue_time_record_value("date", date);
+            queue_time_record_value("datesec", datesec);
+            last_written_date = date;
+            last_written_datesec = datesec;
         }
     }
 
-    rcode = ncmpi_close(ncfile_id);
-    report_nc_error();
-
     write_grid(host_comp_id, output_field_instance, grided_data->get_coord_value_grid(), write_grid_name, false);
 
-    rcode = ncmpi_open(comm, file_name, NC_WRITE, MPI_INFO_NULL, &ncfile_id);
-    report_nc_error();
-
     if (strlen(grided_data->get_grid_data_field()->data_type_in_IO_file) == 0)
         strcpy(grided_data->get_grid_data_field()->data_type_in_IO_file, grided_data->get_grid_data_field()->data_type_in_application);
     tmp_field_data_for_io = generate_field_data_for_IO(grided_data, is_restart_field);
     write_field_data(host_comp_id, output_field_instance, tmp_field_data_for_io, grided_data->get_coord_value_grid(), false, "", -1, write_grid_name, false, true);
     if (tmp_field_data_for_io != grided_data)
-        delete tmp_field_data_for_io;
+        pending_io_field_datas.push_back(tmp_field_data_for_io);
 
-    rcode = ncmpi_close(ncfile_id);
-    report_nc_error();
+    release_file();
 }
 
 
@@ -750,16 +946,22 @@ long IO_pnetcdf::get_dimension_size(const char *dim_name, MPI_Comm comm, bool is
     long dimension_size = -1;
 
 
+    wait_asynchronous_flush();
     if (is_root_proc) {
-        rcode = ncmpi_open(comm, file_name, NC_NOWRITE, MPI_INFO_NULL, &ncfile_id);
-        report_nc_error();
+        bool file_opened_here = !file_is_open;
+        if (file_opened_here) {
+            rcode = ncmpi_open(comm, file_name, NC_NOWRITE, MPI_INFO_NULL, &ncfile_id);
+            report_nc_error();
+        }
         rcode = ncmpi_inq_dimid(ncfile_id, dim_name, &dimension_id);
         if (rcode == NC_NOERR) {
             rcode = ncmpi_inq_dimlen(ncfile_id, dimension_id, (MPI_Offset *)(&dimension_size));
             report_nc_error();   
         }
-        rcode = ncmpi_close(ncfile_id);
-        report_nc_error();
+        if (file_opened_here) {
+            rcode = ncmpi_close(ncfile_id);
+            report_nc_error();
+        }
     }
 
     if (comm != MPI_COMM_NULL)
@@ -773,12 +975,7 @@ void IO_pnetcdf::put_global_attr(const char *text_title, const void *attr_value,
     int nc_datatype;
 
     
-    if (!is_external_file) {
-        rcode = ncmpi_open(comm, file_name, NC_WRITE, MPI_INFO_NULL, &ncfile_id);
-        report_nc_error();
-    }
-    rcode = ncmpi_redef(ncfile_id);
-    report_nc_error();
+    enter_define_mode();
 
     if (words_are_the_same(nc_data_type, DATA_TYPE_STRING))
         EXECUTION_REPORT(REPORT_ERROR, -1, words_are_the_same(local_data_type, DATA_TYPE_STRING), "software error in IO_pnetcdf::put_global_attr: miss match of data type");
@@ -798,12 +995,9 @@ void IO_pnetcdf::put_global_attr(const char *text_title, const void *attr_value,
         rcode = ncmpi_put_att_double(ncfile_id, NC_GLOBAL, text_title, NC_DOUBLE, size, (const double*)attr_value);
     else EXECUTION_REPORT(REPORT_ERROR, -1, false, "software error in IO_pnetcdf::put_global_attr: wrong local data type %s", local_data_type);
     report_nc_error();
-    ncmpi_enddef(ncfile_id);
-    report_nc_error();
-    if (!is_external_file) {
-        rcode = ncmpi_close(ncfile_id);
-        report_nc_error();
-    }
+    if (is_external_file)
+        enter_data_mode();
+    else release_file();
 }
 
 
@@ -812,26 +1006,24 @@ bool IO_pnetcdf::get_field_datatype(const char *field_name, char *var_data_type)
     int variable_id = NC_GLOBAL;
     nc_type nc_data_type;
 
-    rcode = ncmpi_open(comm, file_name, NC_NOWRITE, MPI_INFO_NULL, &ncfile_id);
-    report_nc_error();
+    open_file();
 
     if (field_name != NULL) {
         rcode = ncmpi_inq_varid(ncfile_id, field_name, &variable_id);
         if (rcode != NC_NOERR) {
-            rcode = nc_close(ncfile_id);
-            report_nc_error();
+            release_file();
             return false;
         }
     }
     rcode = ncmpi_inq_vartype(ncfile_id, variable_id, &nc_data_type);
     if (rcode != NC_NOERR) {
-        rcode = ncmpi_close(ncfile_id);
-        report_nc_error();
+        release_file();
         return false;
     }
     datatype_from_netcdf_to_application(nc_data_type, var_data_type, field_name);
-    rcode = ncmpi_close(ncfile_id);
-    report_nc_error();
+    release_file();
+
+    return true;
 }
 
 
@@ -841,21 +1033,18 @@ bool IO_pnetcdf::get_file_field_attribute(const char *field_name, const char *at
     nc_type nc_data_type;
     MPI_Offset attribute_size;
 
-    rcode = ncmpi_open(comm, file_name, NC_NOWRITE, MPI_INFO_NULL, &ncfile_id);
-    report_nc_error();
+    open_file();
 
     if (field_name != NULL) {
         rcode = ncmpi_inq_varid(ncfile_id, field_name, &variable_id);
         if (rcode != NC_NOERR) {
-            rcode = ncmpi_close(ncfile_id);
-            report_nc_error();
+            release_file();
             return false;
         }
     }
     rcode = ncmpi_inq_att(ncfile_id, variable_id, attribute_name, &nc_data_type, &attribute_size);
     if (rcode != NC_NOERR) {
-        rcode = ncmpi_close(ncfile_id);
-        report_nc_error();
+        release_file();
         return false;
     }
     switch (nc_data_type) {
@@ -882,18 +1071,16 @@ bool IO_pnetcdf::get_file_field_attribute(const char *field_name, const char *at
             rcode = ncmpi_get_att_double(ncfile_id, variable_id, attribute_name, (double*)attribute_value);
             break;
         default:
-            rcode = ncmpi_close(ncfile_id);
-            report_nc_error();
+            release_file();
             return false;
     }
     if (rcode != NC_NOERR) {
-        rcode = ncmpi_close(ncfile_id);
+        release_file();
         if (neccessity) report_nc_error();
         return false;
     }
 
-    rcode = ncmpi_close(ncfile_id);
-    report_nc_error();
+    release_file();
 
     return true;
 }
@@ -15,6 +15,7 @@
 
 #include "io_basis.h"
 #include <pnetcdf.h>
+#include <pthread.h>
 #include "cor_global_data.h"
 #include "remap_weight_of_strategy_class.h"
 #include "remap_common_utils.h"
@@ -26,6 +27,18 @@
 #define SCRIP_VERTEX_LAT_LABEL          "grid_corner_lat"
 #define SCRIP_MASK_LABEL                "grid_imask"
 
+
+struct Pnetcdf_pending_write
+{
+    int var_ncid;
+    char data_type[NAME_STR_SIZE];
+    std::vector<MPI_Offset> starts;
+    std::vector<MPI_Offset> counts;
+    void *data_buf;
+    bool own_data_buf;
+};
+
+
 class IO_pnetcdf: public IO_basis
 {
     private:
@@ -34,12 +47,33 @@ class IO_pnetcdf: public IO_basis
         bool io_with_time_info;
         int time_dim_id;
         int time_count;
+        int last_written_date;
+        int last_written_datesec;
         bool is_external_file;
+        bool keep_file_open;
+        bool file_is_open;
+        bool in_define_mode;
         int pio_proc_num;
         int current_proc_local_id;
         int io_proc_mark;
         MPI_Comm comm;
+        std::vector<Pnetcdf_pending_write*> pending_writes;
+        std::vector<Remap_grid_data_class*> pending_io_field_datas;
+        std::vector<int> pending_write_statuses;
+        int pending_writes_rcode;
+        pthread_t flush_thread;
+        bool flush_thread_active;
         
+        void open_file();
+        void release_file();
+        void enter_define_mode();
+        void enter_data_mode();
+        void queue_write(int, const char*, int, const MPI_Offset*, const MPI_Offset*, void*, bool);
+        void queue_time_record_value(const char*, int);
+        void post_pending_writes();
+        void release_pending_writes();
+        void wait_asynchronous_flush();
+        static void *asynchronous_flush_entry(void*);
         void write_field_data(Remap_grid_data_class*, Remap_grid_class*, bool, const char*, int, bool, bool);
         void write_field_data(int, Field_mem_info*, Remap_grid_data_class*, Remap_grid_class*, bool, const char*, int, bool, bool, bool);
         void datatype_from_netcdf_to_application(nc_type, char*, const char*);
@@ -64,6 +98,10 @@ class IO_pnetcdf: public IO_basis
         MPI_Comm get_io_comm() { return comm; }
         bool get_field_datatype(const char*, char*);
         bool get_file_field_attribute(const char*, const char*, char*, char*, bool);
+        void flush_pending_writes();
+        void flush_pending_writes_asynchronously();
+        void keep_data_of_pending_writes();
+        void close_file();
 
 };
 
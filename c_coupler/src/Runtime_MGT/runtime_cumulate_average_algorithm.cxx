@@ -16,34 +16,6 @@
 
 
 
-template<typename T> void template_cumulate_or_average(T* dst, const T* src, const int length, 
-        const int computing_count, const bool do_average)
-{
-    if (computing_count == 1) {
-        for (int i = 0; i < length; i++)
-            dst[i] = src[i];
-    } 
-    else {
-        for (int i = 0; i < length; i++)
-            dst[i] += src[i];
-    }
-    if (do_average && computing_count != 1) {
-        /// a trick
-        T frac = 1 / ((T)computing_count);
-        if (frac == 0) {
-            /// not a float number
-            for (int i = 0; i < length; i++)
-                dst[i] = dst[i] / computing_count;
-
-        } else {
-            /// float number
-            for (int i = 0; i < length; i++)
-                dst[i] = dst[i] * frac;
-        }
-    }
-}
-
-
 Runtime_cumulate_average_algorithm::Runtime_cumulate_average_algorithm(Connection_coupling_procedure *coupling_procedure, Field_mem_info *field_src, Field_mem_info *field_dst)
 {
     cumulate_average_field_info *cumulate_average_field  = new cumulate_average_field_info;
@@ -55,6 +27,9 @@ Runtime_cumulate_average_algorithm::Runtime_cumulate_average_algorithm(Connectio
     cumulate_average_field->num_elements_in_field = field_src->get_size_of_field();
     cumulate_average_field->field_data_type = field_src->get_data_type();
     cumulate_average_field->current_computing_count = 0;
+    cumulate_average_field->kernel = get_cumulate_average_kernel(cumulate_average_field->field_data_type);
+    cumulate_average_field->mem_info_transformed = NULL;
+    cumulate_average_field->average_and_transformation_kernel = NULL;
 	if (field_src->get_field_data()->get_coord_value_grid() != field_dst->get_field_data()->get_coord_value_grid()) {
 		cumulate_average_field->original_mem_info_src = field_src;
 		if (field_src->get_num_chunks() > 0)
@@ -66,17 +41,24 @@ Runtime_cumulate_average_algorithm::Runtime_cumulate_average_algorithm(Connectio
 }
 
 
-void Runtime_cumulate_average_algorithm::handler_cumulate_or_average(const char *data_type, void *data_dst, const void *data_src, const int length, const int computing_count, const bool do_average)
+/* Fuses the data type transformation that follows each average into the average, so that the
+   averaged values are transformed in the same pass over the field. Returns false when the
+   transformation cannot be fused and therefore has to run separately */
+bool Runtime_cumulate_average_algorithm::fuse_datatype_transformer(Runtime_datatype_transformer *datatype_transformer)
 {
-	if (words_are_the_same(data_type, DATA_TYPE_FLOAT))
-		template_cumulate_or_average<float>((float *) data_dst, (float *) data_src, length, computing_count, do_average);
-	else if (words_are_the_same(data_type, DATA_TYPE_DOUBLE))
-		template_cumulate_or_average<double>((double *) data_dst, (double *) data_src, length, computing_count, do_average);
-	else if (words_are_the_same(data_type, DATA_TYPE_INT))
-		template_cumulate_or_average<int>((int *) data_dst, (int *) data_src, length, computing_count, do_average);
-    else if (words_are_the_same(data_type, DATA_TYPE_SHORT))
-        template_cumulate_or_average<short>((short *) data_dst, (short *) data_src, length, computing_count, do_average);
-	else EXECUTION_REPORT(REPORT_ERROR, -1, false, "error data type in cumulate_average algorithm\n"); 
+    Field_mem_info *transformer_src = datatype_transformer->get_src_field(), *transformer_dst = datatype_transformer->get_dst_field();
+
+
+    if (cumulate_average_fields.size() != 1 || transformer_src != cumulate_average_fields[0]->mem_info_dst || transformer_dst == NULL || transformer_src->get_num_chunks() != transformer_dst->get_num_chunks())
+        return false;
+    cumulate_average_fields[0]->average_and_transformation_kernel = get_average_and_datatype_transformation_kernel(transformer_src->get_field_data()->get_grid_data_field()->data_type_in_application, transformer_dst->get_field_data()->get_grid_data_field()->data_type_in_application);
+    if (cumulate_average_fields[0]->average_and_transformation_kernel == NULL)
+        return false;
+    cumulate_average_fields[0]->mem_info_transformed = transformer_dst;
+    datatype_transformer->mark_fused_into_average();
+    EXECUTION_REPORT_LOG(REPORT_LOG, comp_id, true, "The data type transformation of field \"%s\" is fused into its average", transformer_dst->get_field_name());
+
+    return true;
 }
 
 
@@ -116,11 +98,21 @@ void Runtime_cumulate_average_algorithm::cumulate_or_average(bool do_average)
         EXECUTION_REPORT_ERROR_OPTIONALLY(REPORT_ERROR, -1, words_are_the_same(cumulate_average_fields[i]->mem_info_src->get_data_type(), cumulate_average_fields[i]->mem_info_dst->get_data_type()), "Software error in Runtime_cumulate_average_algorithm::Runtime_cumulate_average_algorithm");
         cumulate_average_fields[i]->current_computing_count ++;
 		int num_chunks = cumulate_average_fields[i]->mem_info_src->get_num_chunks();
-		if (num_chunks == 0)
-			handler_cumulate_or_average(cumulate_average_fields[i]->field_data_type, cumulate_average_fields[i]->mem_info_dst->get_data_buf(), cumulate_average_fields[i]->mem_info_src->get_data_buf(), cumulate_average_fields[i]->num_elements_in_field, cumulate_average_fields[i]->current_computing_count, do_average);
+		Field_mem_info *mem_info_transformed = do_average? cumulate_average_fields[i]->mem_info_transformed : NULL;
+		if (mem_info_transformed != NULL) {
+			mem_info_transformed->define_field_values(false);
+			if (num_chunks == 0)
+				cumulate_average_fields[i]->average_and_transformation_kernel(cumulate_average_fields[i]->mem_info_dst->get_data_buf(), cumulate_average_fields[i]->mem_info_src->get_data_buf(), mem_info_transformed->get_data_buf(), cumulate_average_fields[i]->num_elements_in_field, cumulate_average_fields[i]->current_computing_count);
+			else for (int j = 0; j < num_chunks; j ++) {
+				EXECUTION_REPORT_ERROR_OPTIONALLY(REPORT_ERROR, -1, cumulate_average_fields[i]->mem_info_src->get_chunk_data_buf_size(j) == cumulate_average_fields[i]->mem_info_dst->get_chunk_data_buf_size(j) && mem_info_transformed->get_chunk_data_buf_size(j) == cumulate_average_fields[i]->mem_info_dst->get_chunk_data_buf_size(j), "Software error Runtime_cumulate_average_algorithm::cumulate_or_average");
+				cumulate_average_fields[i]->average_and_transformation_kernel(cumulate_average_fields[i]->mem_info_dst->get_chunk_buf(j), cumulate_average_fields[i]->mem_info_src->get_chunk_buf(j), mem_info_transformed->get_chunk_buf(j), cumulate_average_fields[i]->mem_info_src->get_chunk_data_buf_size(j), cumulate_average_fields[i]->current_computing_count);
+			}
+		}
+		else if (num_chunks == 0)
+			cumulate_average_fields[i]->kernel(cumulate_average_fields[i]->mem_info_dst->get_data_buf(), cumulate_average_fields[i]->mem_info_src->get_data_buf(), cumulate_average_fields[i]->num_elements_in_field, cumulate_average_fields[i]->current_computing_count, do_average);
 		else for (int j = 0; j < num_chunks; j ++) {
 			EXECUTION_REPORT_ERROR_OPTIONALLY(REPORT_ERROR, -1, cumulate_average_fields[i]->mem_info_src->get_chunk_data_buf_size(j) == cumulate_average_fields[i]->mem_info_dst->get_chunk_data_buf_size(j), "Software error Runtime_cumulate_average_algorithm::cumulate_or_average");
-			handler_cumulate_or_average(cumulate_average_fields[i]->field_data_type, cumulate_average_fields[i]->mem_info_dst->get_chunk_buf(j), cumulate_average_fields[i]->mem_info_src->get_chunk_buf(j), cumulate_average_fields[i]->mem_info_src->get_chunk_data_buf_size(j), cumulate_average_fields[i]->current_computing_count, do_average);
+			cumulate_average_fields[i]->kernel(cumulate_average_fields[i]->mem_info_dst->get_chunk_buf(j), cumulate_average_fields[i]->mem_info_src->get_chunk_buf(j), cumulate_average_fields[i]->mem_info_src->get_chunk_data_buf_size(j), cumulate_average_fields[i]->current_computing_count, do_average);
 		}
         if (do_average) {
             EXECUTION_REPORT_LOG(REPORT_LOG, comp_id, true, "do average at computing count is %d", cumulate_average_fields[i]->current_computing_count);
@@ -130,6 +122,8 @@ void Runtime_cumulate_average_algorithm::cumulate_or_average(bool do_average)
 			cumulate_average_fields[i]->original_mem_info_src->use_field_values(NULL);
         else cumulate_average_fields[i]->mem_info_src->use_field_values(NULL);
         cumulate_average_fields[i]->mem_info_dst->define_field_values(false);
+		if (mem_info_transformed != NULL)
+			cumulate_average_fields[i]->mem_info_dst->use_field_values("");
     }
 
     EXECUTION_REPORT_LOG(REPORT_LOG, comp_id, true, "after cumulate or average");
@@ -137,6 +131,8 @@ void Runtime_cumulate_average_algorithm::cumulate_or_average(bool do_average)
 		if (cumulate_average_fields[i]->original_mem_info_src != NULL)
 			cumulate_average_fields[i]->original_mem_info_src->get_field_data()->generate_grid_info(cumulate_average_fields[i]->original_mem_info_src->get_field_data()->get_coord_value_grid());
         cumulate_average_fields[i]->mem_info_dst->check_field_sum(report_internal_log_enabled, true, "(dst value) after cumulate or average");
+		if (do_average && cumulate_average_fields[i]->mem_info_transformed != NULL)
+			cumulate_average_fields[i]->mem_info_transformed->check_field_sum(report_internal_log_enabled, true, "(dst value) after data type transformation");
     }
 }
 
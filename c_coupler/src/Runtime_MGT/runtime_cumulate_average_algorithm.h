@@ -14,6 +14,8 @@
 #include "memory_mgt.h"
 #include "common_utils.h"
 #include "restart_mgt.h"
+#include "runtime_fused_kernels.h"
+#include "runtime_datatype_transformer.h"
 #include <vector>
 
 
@@ -29,6 +31,9 @@ struct cumulate_average_field_info
     Field_mem_info *mem_info_dst;
     Coupling_timer *timer;
     int current_computing_count;
+    Cumulate_average_kernel kernel;
+    Field_mem_info *mem_info_transformed;
+    Average_and_datatype_transformation_kernel average_and_transformation_kernel;
 };
 
 
@@ -39,11 +44,11 @@ class Runtime_cumulate_average_algorithm
         std::vector<cumulate_average_field_info*> cumulate_average_fields;
         Connection_coupling_procedure *coupling_procedure;
         void cumulate_or_average(bool);
-		void handler_cumulate_or_average(const char *, void *, const void *, const int, const int, const bool);
         
     public:
         Runtime_cumulate_average_algorithm(Connection_coupling_procedure *, Field_mem_info*, Field_mem_info*);
         ~Runtime_cumulate_average_algorithm();
+        bool fuse_datatype_transformer(Runtime_datatype_transformer*);
         void restart_write(Restart_buffer_container*, const char *);
         void restart_read(Restart_buffer_container*, const char *);
         bool run(bool);
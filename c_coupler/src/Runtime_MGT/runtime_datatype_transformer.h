@@ -12,6 +12,7 @@
 
 #include <vector>
 #include "memory_mgt.h"
+#include "runtime_fused_kernels.h"
 
 
 class Runtime_datatype_transformer
@@ -19,13 +20,17 @@ class Runtime_datatype_transformer
     private:
         std::vector<Field_mem_info*> src_fields;
         std::vector<Field_mem_info*> dst_fields;
+        std::vector<Datatype_transformation_kernel> transformation_kernels;
+        bool fused_into_average;
 
     public:
-        Runtime_datatype_transformer() {}
+        Runtime_datatype_transformer() { fused_into_average = false; }
         Runtime_datatype_transformer(Field_mem_info*, Field_mem_info*);
         ~Runtime_datatype_transformer() {}
         void transform_fields_datatype();		
-		void handler_datatype_transformation_of_array(const char *, const char *, void *, const void *, const int);
+        Field_mem_info *get_src_field() { return src_fields.size() == 1? src_fields[0] : NULL; }
+        Field_mem_info *get_dst_field() { return dst_fields.size() == 1? dst_fields[0] : NULL; }
+        void mark_fused_into_average() { fused_into_average = true; }
         bool run(bool);
 };
 
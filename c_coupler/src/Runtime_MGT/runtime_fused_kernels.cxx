@@ -0,0 +1,113 @@
+/***************************************************************
+  *  Copyright (c) 2017, Tsinghua University.
+  *  This is a source file of C-Coupler.
+  *  This file was initially finished by Dr. Li Liu. 
+  *  If you have any problem, 
+  *  please contact Dr. Li Liu via liuli-cess@tsinghua.edu.cn
+  ***************************************************************/
+
+
+#include "global_data.h"
+#include "runtime_fused_kernels.h"
+
+
+Cumulate_average_kernel get_cumulate_average_kernel(const char *data_type)
+{
+    if (words_are_the_same(data_type, DATA_TYPE_FLOAT))
+        return cumulate_or_average_kernel<float>;
+    if (words_are_the_same(data_type, DATA_TYPE_DOUBLE))
+        return cumulate_or_average_kernel<double>;
+    if (words_are_the_same(data_type, DATA_TYPE_INT))
+        return cumulate_or_average_kernel<int>;
+    if (words_are_the_same(data_type, DATA_TYPE_SHORT))
+        return cumulate_or_average_kernel<short>;
+    EXECUTION_REPORT(REPORT_ERROR, -1, false, "error data type in cumulate_average algorithm\n");
+    return NULL;
+}
+
+
+template<typename T1> Datatype_transformation_kernel get_datatype_transformation_kernel_from(const char *data_type_dst)
+{
+    if (words_are_the_same(data_type_dst, DATA_TYPE_DOUBLE))
+        return datatype_transformation_kernel<T1, double>;
+    if (words_are_the_same(data_type_dst, DATA_TYPE_FLOAT))
+        return datatype_transformation_kernel<T1, float>;
+    if (words_are_the_same(data_type_dst, DATA_TYPE_LONG))
+        return datatype_transformation_kernel<T1, long>;
+    if (words_are_the_same(data_type_dst, DATA_TYPE_INT))
+        return datatype_transformation_kernel<T1, int>;
+    if (words_are_the_same(data_type_dst, DATA_TYPE_SHORT))
+        return datatype_transformation_kernel<T1, short>;
+    if (words_are_the_same(data_type_dst, DATA_TYPE_BOOL))
+        return datatype_transformation_kernel<T1, bool>;
+    return NULL;
+}
+
+
+/* Only the transformations between floating-point data types or between integer (including bool)
+   data types are supported */
+Datatype_transformation_kernel get_datatype_transformation_kernel(const char *data_type_src, const char *data_type_dst)
+{
+    Datatype_transformation_kernel kernel = NULL;
+    bool is_src_floating = words_are_the_same(data_type_src, DATA_TYPE_DOUBLE) || words_are_the_same(data_type_src, DATA_TYPE_FLOAT);
+    bool is_dst_floating = words_are_the_same(data_type_dst, DATA_TYPE_DOUBLE) || words_are_the_same(data_type_dst, DATA_TYPE_FLOAT);
+
+
+    if (!words_are_the_same(data_type_src, data_type_dst) && is_src_floating == is_dst_floating) {
+        if (words_are_the_same(data_type_src, DATA_TYPE_DOUBLE))
+            kernel = get_datatype_transformation_kernel_from<double>(data_type_dst);
+        else if (words_are_the_same(data_type_src, DATA_TYPE_FLOAT))
+            kernel = get_datatype_transformation_kernel_from<float>(data_type_dst);
+        else if (words_are_the_same(data_type_src, DATA_TYPE_LONG))
+            kernel = get_datatype_transformation_kernel_from<long>(data_type_dst);
+        else if (words_are_the_same(data_type_src, DATA_TYPE_INT))
+            kernel = get_datatype_transformation_kernel_from<int>(data_type_dst);
+        else if (words_are_the_same(data_type_src, DATA_TYPE_SHORT))
+            kernel = get_datatype_transformation_kernel_from<short>(data_type_dst);
+        else if (words_are_the_same(data_type_src, DATA_TYPE_BOOL))
+            kernel = get_datatype_transformation_kernel_from<bool>(data_type_dst);
+    }
+    EXECUTION_REPORT(REPORT_ERROR, -1, kernel != NULL, "C-Coupler software error in get_datatype_transformation_kernel: data type transformation from %s to %s is not supported", data_type_src, data_type_dst);
+
+    return kernel;
+}
+
+
+template<typename T1> Average_and_datatype_transformation_kernel get_average_and_datatype_transformation_kernel_from(const char *data_type_dst)
+{
+    if (words_are_the_same(data_type_dst, DATA_TYPE_DOUBLE))
+        return average_and_datatype_transformation_kernel<T1, double>;
+    if (words_are_the_same(data_type_dst, DATA_TYPE_FLOAT))
+        return average_and_datatype_transformation_kernel<T1, float>;
+    if (words_are_the_same(data_type_dst, DATA_TYPE_LONG))
+        return average_and_datatype_transformation_kernel<T1, long>;
+    if (words_are_the_same(data_type_dst, DATA_TYPE_INT))
+        return average_and_datatype_transformation_kernel<T1, int>;
+    if (words_are_the_same(data_type_dst, DATA_TYPE_SHORT))
+        return average_and_datatype_transformation_kernel<T1, short>;
+    if (words_are_the_same(data_type_dst, DATA_TYPE_BOOL))
+        return average_and_datatype_transformation_kernel<T1, bool>;
+    return NULL;
+}
+
+
+/* Returns NULL when the average and the data type transformation cannot be fused, so that the
+   caller keeps them as two separate runtime algorithms */
+Average_and_datatype_transformation_kernel get_average_and_datatype_transformation_kernel(const char *data_type_src, const char *data_type_dst)
+{
+    bool is_src_floating = words_are_the_same(data_type_src, DATA_TYPE_DOUBLE) || words_are_the_same(data_type_src, DATA_TYPE_FLOAT);
+    bool is_dst_floating = words_are_the_same(data_type_dst, DATA_TYPE_DOUBLE) || words_are_the_same(data_type_dst, DATA_TYPE_FLOAT);
+
+
+    if (words_are_the_same(data_type_src, data_type_dst) || is_src_floating != is_dst_floating)
+        return NULL;
+    if (words_are_the_same(data_type_src, DATA_TYPE_DOUBLE))
+        return get_average_and_datatype_transformation_kernel_from<double>(data_type_dst);
+    if (words_are_the_same(data_type_src, DATA_TYPE_FLOAT))
+        return get_average_and_datatype_transformation_kernel_from<float>(data_type_dst);
+    if (words_are_the_same(data_type_src, DATA_TYPE_INT))
+        return get_average_and_datatype_transformation_kernel_from<int>(data_type_dst);
+    if (words_are_the_same(data_type_src, DATA_TYPE_SHORT))
+        return get_average_and_datatype_transformation_kernel_from<short>(data_type_dst);
+    return NULL;
+}
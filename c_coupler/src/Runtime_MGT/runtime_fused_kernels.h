@@ -0,0 +1,107 @@
+/***************************************************************
+  *  Copyright (c) 2017, Tsinghua University.
+  *  This is a source file of C-Coupler.
+  *  This file was initially finished by Dr. Li Liu. 
+  *  If you have any problem, 
+  *  please contact Dr. Li Liu via liuli-cess@tsinghua.edu.cn
+  ***************************************************************/
+
+
+#ifndef RUNTIME_FUSED_KERNELS
+#define RUNTIME_FUSED_KERNELS
+
+
+#include "common_utils.h"
+
+
+/* Elementwise kernels of the runtime algorithms on a field (or on a chunk of a field). The kernels
+   are selected according to the data types once when a runtime algorithm is constructed, so that
+   the data types are not compared as strings when the algorithm runs */
+typedef void (*Cumulate_average_kernel)(void *, const void *, long, int, bool);
+typedef void (*Datatype_transformation_kernel)(const void *, void *, long);
+typedef void (*Average_and_datatype_transformation_kernel)(void *, const void *, void *, long, int);
+
+
+template<typename T> void cumulate_or_average_kernel(void *data_dst, const void *data_src, long length, int computing_count, bool do_average)
+{
+    T *dst = (T*) data_dst;
+    const T *src = (const T*) data_src;
+
+
+    if (computing_count == 1) {
+        for (long i = 0; i < length; i ++)
+            dst[i] = src[i];
+        return;
+    }
+    if (!do_average) {
+        for (long i = 0; i < length; i ++)
+            dst[i] += src[i];
+        return;
+    }
+    /// a trick
+    T frac = 1 / ((T)computing_count);
+    if (frac == 0) {
+        /// not a float number
+        for (long i = 0; i < length; i ++) {
+            T value = dst[i] + src[i];
+            dst[i] = value / computing_count;
+        }
+    }
+    else {
+        /// float number
+        for (long i = 0; i < length; i ++) {
+            T value = dst[i] + src[i];
+            dst[i] = value * frac;
+        }
+    }
+}
+
+
+template<typename T1, typename T2> void datatype_transformation_kernel(const void *data_src, void *data_dst, long length)
+{
+    transform_datatype_of_arrays((const T1*) data_src, (T2*) data_dst, length);
+}
+
+
+/* Finishes an average (the same as cumulate_or_average_kernel with do_average) and transforms the
+   averaged values into another data type in the same pass over the field */
+template<typename T1, typename T2> void average_and_datatype_transformation_kernel(void *data_dst, const void *data_src, void *data_transformed, long length, int computing_count)
+{
+    T1 *dst = (T1*) data_dst;
+    const T1 *src = (const T1*) data_src;
+    T2 *transformed = (T2*) data_transformed;
+
+
+    if (computing_count == 1) {
+        for (long i = 0; i < length; i ++) {
+            dst[i] = src[i];
+            transformed[i] = (T2) src[i];
+        }
+        return;
+    }
+    T1 frac = 1 / ((T1)computing_count);
+    if (frac == 0) {
+        for (long i = 0; i < length; i ++) {
+            T1 value = dst[i] + src[i];
+            value = value / computing_count;
+            dst[i] = value;
+            transformed[i] = (T2) value;
+        }
+    }
+    else {
+        for (long i = 0; i < length; i ++) {
+            T1 value = dst[i] + src[i];
+            value = value * frac;
+            dst[i] = value;
+            transformed[i] = (T2) value;
+        }
+    }
+}
+
+
+extern Cumulate_average_kernel get_cumulate_average_kernel(const char *);
+extern Datatype_transformation_kernel get_datatype_transformation_kernel(const char *, const char *);
+extern Average_and_datatype_transformation_kernel get_average_and_datatype_transformation_kernel(const char *, const char *);
+
+
+#endif
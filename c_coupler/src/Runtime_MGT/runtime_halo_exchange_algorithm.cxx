@@ -0,0 +1,181 @@
+/***************************************************************
+  *  Copyright (c) 2017, Tsinghua University.
+  *  This is a source file of C-Coupler.
+  *  This file was initially finished by Dr. Li Liu.
+  *  If you have any problem,
+  *  please contact Dr. Li Liu via liuli-cess@tsinghua.edu.cn
+  ***************************************************************/
+
+#include "global_data.h"
+#include "runtime_halo_exchange_algorithm.h"
+#include <string.h>
+
+
+#define HALO_EXCHANGE_MESSAGE_TAG     1000
+
+
+Runtime_halo_exchange_algorithm::Runtime_halo_exchange_algorithm(int comp_id, std::vector<Field_mem_info*> &host_fields_mem, std::vector<Field_mem_info*> &halo_fields_mem, std::vector<Decomp_info*> &halo_regions)
+{
+    int total_dim_size_before_H2D, total_dim_size_after_H2D, num_procs;
+    long message_size;
+
+
+    EXECUTION_REPORT(REPORT_ERROR, -1, host_fields_mem.size() == halo_fields_mem.size() && host_fields_mem.size() == halo_regions.size(), "Software error in Runtime_halo_exchange_algorithm::Runtime_halo_exchange_algorithm: wrong number of fields");
+    this->comp_id = comp_id;
+    this->exchange_in_flight = false;
+    MPI_Comm_dup(comp_comm_group_mgt_mgr->get_comm_group_of_local_comp(comp_id, "in Runtime_halo_exchange_algorithm::Runtime_halo_exchange_algorithm"), &halo_comm);
+    num_procs = comp_comm_group_mgt_mgr->get_global_node_of_local_comp(comp_id, false, "in Runtime_halo_exchange_algorithm::Runtime_halo_exchange_algorithm")->get_num_procs();
+
+    for (int i = 0; i < host_fields_mem.size(); i ++) {
+        EXECUTION_REPORT(REPORT_ERROR, -1, halo_regions[i]->get_halo_host_decomp() != NULL && host_fields_mem[i]->get_decomp_id() == halo_regions[i]->get_halo_host_decomp()->get_decomp_id() && halo_fields_mem[i]->get_decomp_id() == halo_regions[i]->get_decomp_id(), "Software error in Runtime_halo_exchange_algorithm::Runtime_halo_exchange_algorithm: wrong halo region");
+        this->host_fields_mem.push_back(host_fields_mem[i]);
+        this->halo_fields_mem.push_back(halo_fields_mem[i]);
+        fields_routers.push_back(routing_info_mgr->search_or_add_router(comp_id, comp_id, host_fields_mem[i]->get_decomp_name(), halo_fields_mem[i]->get_decomp_name()));
+        host_fields_mem[i]->get_total_dim_size_before_and_after_H2D(total_dim_size_before_H2D, total_dim_size_after_H2D);
+        fields_element_sizes.push_back(total_dim_size_before_H2D*get_data_type_size(host_fields_mem[i]->get_data_type()));
+        fields_total_dim_size_after_H2D.push_back(total_dim_size_after_H2D);
+    }
+
+    send_displs.push_back(0);
+    recv_displs.push_back(0);
+    for (int j = 0; j < num_procs; j ++) {
+        if ((message_size = get_message_size(true, j)) > 0) {
+            send_procs.push_back(j);
+            send_displs.push_back(send_displs[send_displs.size()-1]+message_size);
+        }
+        if ((message_size = get_message_size(false, j)) > 0) {
+            recv_procs.push_back(j);
+            recv_displs.push_back(recv_displs[recv_displs.size()-1]+message_size);
+        }
+    }
+    send_buf = new char [send_displs[send_procs.size()]+1];
+    recv_buf = new char [recv_displs[recv_procs.size()]+1];
+
+    // receives are posted before sends when the persistent requests are started
+    requests.resize(recv_procs.size()+send_procs.size());
+    for (int k = 0; k < recv_procs.size(); k ++)
+        MPI_Recv_init(recv_buf+recv_displs[k], recv_displs[k+1]-recv_displs[k], MPI_CHAR, recv_procs[k], HALO_EXCHANGE_MESSAGE_TAG, halo_comm, &requests[k]);
+    for (int k = 0; k < send_procs.size(); k ++)
+        MPI_Send_init(send_buf+send_displs[k], send_displs[k+1]-send_displs[k], MPI_CHAR, send_procs[k], HALO_EXCHANGE_MESSAGE_TAG, halo_comm, &requests[recv_procs.size()+k]);
+
+    EXECUTION_REPORT_LOG(REPORT_LOG, comp_id, true, "The halo exchange of %d fields sends to %d processes and receives from %d processes", host_fields_mem.size(), send_procs.size(), recv_procs.size());
+}
+
+
+Runtime_halo_exchange_algorithm::~Runtime_halo_exchange_algorithm()
+{
+    int finalized;
+
+
+    MPI_Finalized(&finalized);
+    if (!finalized) {
+        if (exchange_in_flight && requests.size() > 0)
+            MPI_Waitall(requests.size(), &requests[0], MPI_STATUSES_IGNORE);
+        for (int k = 0; k < requests.size(); k ++)
+            MPI_Request_free(&requests[k]);
+        MPI_Comm_free(&halo_comm);
+    }
+    delete [] send_buf;
+    delete [] recv_buf;
+}
+
+
+long Runtime_halo_exchange_algorithm::get_message_size(bool is_send, int remote_proc)
+{
+    long message_size = 0;
+
+
+    for (int i = 0; i < fields_routers.size(); i ++)
+        message_size += ((long)fields_routers[i]->get_num_elements_transferred_with_remote_proc(is_send, remote_proc)) * fields_element_sizes[i] * fields_total_dim_size_after_H2D[i];
+
+    return message_size;
+}
+
+
+/* Packs (is_send is true) the halo values that the current process provides to remote_proc into
+   message_buf, or unpacks (is_send is false) the halo values received from remote_proc. The values
+   of each cell are copied together, so that the messages do not depend on how the sender and
+   receiver split the cells into segments */
+void Runtime_halo_exchange_algorithm::copy_segments_of_field(bool is_send, int field_index, int remote_proc, char *message_buf, long &offset)
+{
+    Routing_info *router = fields_routers[field_index];
+    Field_mem_info *field_inst = is_send? host_fields_mem[field_index] : halo_fields_mem[field_index];
+    Decomp_info *decomp_info = is_send? router->get_src_decomp_info() : router->get_dst_decomp_info();
+    int num_segments = router->get_num_local_indx_segments_with_remote_proc(is_send, remote_proc);
+    int *segment_starts, *segment_lengths, segment_start, field_2D_size;
+    long element_size = fields_element_sizes[field_index], field_offset;
+    char *field_data_buf;
+
+
+    if (num_segments == 0)
+        return;
+
+    segment_starts = router->get_local_indx_segment_starts_with_remote_proc(is_send, remote_proc);
+    segment_lengths = router->get_local_indx_segment_lengths_with_remote_proc(is_send, remote_proc);
+    for (int i = 0; i < num_segments; i ++) {
+        segment_start = segment_starts[i];
+        field_data_buf = (char*) field_inst->get_data_buf();
+        field_2D_size = is_send? router->get_src_decomp_size() : router->get_dst_decomp_size();
+        if (field_inst->get_num_chunks() > 0) {
+            int chunk_id = decomp_info->get_local_cell_chunk_id()[segment_start];
+            EXECUTION_REPORT_ERROR_OPTIONALLY(REPORT_ERROR, -1, chunk_id == decomp_info->get_local_cell_chunk_id()[segment_start+segment_lengths[i]-1], "Software error in Runtime_halo_exchange_algorithm::copy_segments_of_field");
+            field_data_buf = (char*) field_inst->get_chunk_buf(chunk_id);
+            field_2D_size = decomp_info->get_chunk_size(chunk_id);
+            segment_start -= decomp_info->get_chunks_start()[chunk_id];
+        }
+        if (fields_total_dim_size_after_H2D[field_index] == 1) {
+            if (is_send)
+                memcpy(message_buf+offset, field_data_buf+segment_start*element_size, segment_lengths[i]*element_size);
+            else memcpy(field_data_buf+segment_start*element_size, message_buf+offset, segment_lengths[i]*element_size);
+            offset += segment_lengths[i]*element_size;
+            continue;
+        }
+        for (int j = segment_start; j < segment_start+segment_lengths[i]; j ++)
+            for (int k = 0; k < fields_total_dim_size_after_H2D[field_index]; k ++) {
+                field_offset = (((long)k)*field_2D_size+j)*element_size;
+                if (is_send)
+                    memcpy(message_buf+offset, field_data_buf+field_offset, element_size);
+                else memcpy(field_data_buf+field_offset, message_buf+offset, element_size);
+                offset += element_size;
+            }
+    }
+}
+
+
+void Runtime_halo_exchange_algorithm::start_exchange()
+{
+    long offset;
+
+
+    EXECUTION_REPORT_ERROR_OPTIONALLY(REPORT_ERROR, -1, !exchange_in_flight, "Software error in Runtime_halo_exchange_algorithm::start_exchange: the last halo exchange has not been finished");
+
+    for (int k = 0; k < send_procs.size(); k ++) {
+        offset = send_displs[k];
+        for (int i = 0; i < fields_routers.size(); i ++)
+            copy_segments_of_field(true, i, send_procs[k], send_buf, offset);
+        EXECUTION_REPORT_ERROR_OPTIONALLY(REPORT_ERROR, -1, offset == send_displs[k+1], "Software error in Runtime_halo_exchange_algorithm::start_exchange: wrong message size");
+    }
+    if (requests.size() > 0)
+        MPI_Startall(requests.size(), &requests[0]);
+    exchange_in_flight = true;
+}
+
+
+void Runtime_halo_exchange_algorithm::finish_exchange()
+{
+    long offset;
+
+
+    if (!exchange_in_flight)
+        return;
+
+    if (requests.size() > 0)
+        MPI_Waitall(requests.size(), &requests[0], MPI_STATUSES_IGNORE);
+    for (int k = 0; k < recv_procs.size(); k ++) {
+        offset = recv_displs[k];
+        for (int i = 0; i < fields_routers.size(); i ++)
+            copy_segments_of_field(false, i, recv_procs[k], recv_buf, offset);
+        EXECUTION_REPORT_ERROR_OPTIONALLY(REPORT_ERROR, -1, offset == recv_displs[k+1], "Software error in Runtime_halo_exchange_algorithm::finish_exchange: wrong message size");
+    }
+    exchange_in_flight = false;
+}
@@ -0,0 +1,54 @@
+/***************************************************************
+  *  Copyright (c) 2017, Tsinghua University.
+  *  This is a source file of C-Coupler.
+  *  This file was initially finished by Dr. Li Liu.
+  *  If you have any problem,
+  *  please contact Dr. Li Liu via liuli-cess@tsinghua.edu.cn
+  ***************************************************************/
+
+#ifndef RUNTIME_HALO_EXCHANGE_ALGORITHM
+#define RUNTIME_HALO_EXCHANGE_ALGORITHM
+
+
+#include "mpi.h"
+#include <vector>
+#include "memory_mgt.h"
+#include "routing_info_mgt.h"
+
+
+/* Exchanges the halo regions of the fields of a halo exchange interface between the processes of
+   a component model. The routers from the parallel decompositions to their halo regions, the
+   message buffers and the persistent MPI requests are built once, so that each halo exchange only
+   packs, starts the requests and, when finished, unpacks the halo values */
+class Runtime_halo_exchange_algorithm
+{
+    private:
+        int comp_id;
+        MPI_Comm halo_comm;
+        std::vector<Field_mem_info*> host_fields_mem;
+        std::vector<Field_mem_info*> halo_fields_mem;
+        std::vector<Routing_info*> fields_routers;
+        std::vector<int> fields_element_sizes;
+        std::vector<int> fields_total_dim_size_after_H2D;
+        std::vector<int> send_procs;
+        std::vector<int> recv_procs;
+        std::vector<long> send_displs;
+        std::vector<long> recv_displs;
+        std::vector<MPI_Request> requests;
+        char *send_buf;
+        char *recv_buf;
+        bool exchange_in_flight;
+
+        long get_message_size(bool, int);
+        void copy_segments_of_field(bool, int, int, char *, long &);
+
+    public:
+        Runtime_halo_exchange_algorithm(int, std::vector<Field_mem_info*> &, std::vector<Field_mem_info*> &, std::vector<Decomp_info*> &);
+        ~Runtime_halo_exchange_algorithm();
+        void start_exchange();
+        void finish_exchange();
+        bool is_exchange_in_flight() { return exchange_in_flight; }
+};
+
+
+#endif
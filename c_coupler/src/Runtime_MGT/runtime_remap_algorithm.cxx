@@ -22,7 +22,12 @@ Runtime_remap_algorithm::Runtime_remap_algorithm(Runtime_remapping_weights_conta
     specified_dst_field_instance = dst_field_instance;
     this->runtime_remapping_weights_container = runtime_remapping_weights_container;
     
-    if (words_are_the_same(src_field_instance->get_field_data()->get_grid_data_field()->data_type_in_application, DATA_TYPE_FLOAT)) {
+    if (words_are_the_same(src_field_instance->get_field_data()->get_grid_data_field()->data_type_in_application, DATA_TYPE_FLOAT) && runtime_remapping_weights_container != NULL && runtime_remapping_weights_container->is_float_remap_supported()) {
+        true_src_field_instance = specified_src_field_instance;
+        true_dst_field_instance = specified_dst_field_instance;
+        transform_data_type = false;
+    }
+    else if (words_are_the_same(src_field_instance->get_field_data()->get_grid_data_field()->data_type_in_application, DATA_TYPE_FLOAT)) {
         true_src_field_instance = memory_manager->alloc_mem(specified_src_field_instance, BUF_MARK_REMAP_DATATYPE_TRANS_SRC, connection_id, DATA_TYPE_DOUBLE, false, false);
         true_dst_field_instance = memory_manager->alloc_mem(specified_dst_field_instance, BUF_MARK_REMAP_DATATYPE_TRANS_DST, connection_id, DATA_TYPE_DOUBLE, false, false);
         transform_data_type = true;
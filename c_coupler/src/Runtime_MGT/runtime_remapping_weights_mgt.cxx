@@ -405,6 +405,15 @@ Runtime_remapping_weights_container::~Runtime_remapping_weights_container()
 }
 
 
+bool Runtime_remapping_weights_container::is_float_remap_supported()
+{
+	if (runtime_remapping_weights_Time1D != NULL || runtime_remapping_weights_under_V3D == NULL || runtime_remapping_weights_under_V3D->get_parallel_remapping_weights() == NULL)
+		return false;
+
+	return runtime_remapping_weights_under_V3D->get_parallel_remapping_weights()->is_float_remap_supported();
+}
+
+
 bool Runtime_remapping_weights_container::is_empty()
 {
 	if (runtime_remapping_weights_under_V3D != NULL && runtime_remapping_weights_under_V3D->get_parallel_remapping_weights() != NULL)
@@ -476,8 +485,8 @@ void Runtime_remapping_weights_container::do_remap(Remap_grid_data_class *src_fi
 			runtime_remapping_weights_under_V3D->renew_dynamic_V1D_remapping_weights();
 		comp_comm_group_mgt_mgr->get_global_node_of_local_comp(dst_original_grid->get_comp_id(),false,"")->get_performance_timing_mgr()->performance_timing_start(TIMING_TYPE_COMPUTATION, -1, -1, "remapping cal");
 		for (int i = 0; i < num_iterations; i ++) {
-			current_partial_data_field_for_src_remapping_under_V3D->get_grid_data_field()->data_buf = (double*)(current_src_field_data->get_grid_data_field()->data_buf) + i * src_size_sub_grid_under_V3D;
-			current_partial_data_field_for_dst_remapping_under_V3D->get_grid_data_field()->data_buf = (double*)(current_dst_field_data->get_grid_data_field()->data_buf) + i * dst_size_sub_grid_under_V3D;
+			current_partial_data_field_for_src_remapping_under_V3D->get_grid_data_field()->data_buf = (char*)(current_src_field_data->get_grid_data_field()->data_buf) + i * src_size_sub_grid_under_V3D * get_data_type_size(current_src_field_data->get_grid_data_field()->data_type_in_application);
+			current_partial_data_field_for_dst_remapping_under_V3D->get_grid_data_field()->data_buf = (char*)(current_dst_field_data->get_grid_data_field()->data_buf) + i * dst_size_sub_grid_under_V3D * get_data_type_size(current_dst_field_data->get_grid_data_field()->data_type_in_application);
 			runtime_remapping_weights_under_V3D->get_parallel_remapping_weights()->do_remap(dst_original_grid->get_comp_id(), current_partial_data_field_for_src_remapping_under_V3D, current_partial_data_field_for_dst_remapping_under_V3D);
 		}
 		comp_comm_group_mgt_mgr->get_global_node_of_local_comp(dst_original_grid->get_comp_id(),false,"")->get_performance_timing_mgr()->performance_timing_stop(TIMING_TYPE_COMPUTATION, -1, -1, "remapping cal");	
@@ -96,6 +96,7 @@ class Runtime_remapping_weights_container
         Original_grid_info *get_src_original_grid() { return src_original_grid; }
         Original_grid_info *get_dst_original_grid() { return dst_original_grid; }
 		bool is_empty();
+		bool is_float_remap_supported();
 };
 
 
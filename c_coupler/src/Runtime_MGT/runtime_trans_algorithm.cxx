@@ -16,29 +16,35 @@
 #include <unistd.h>
 
 
+/* The offsets into the MPI buffer and into the field are counted in long, because a segment of a 3-D field (or of the 
+   fields packed before it) may hold more than INT_MAX values or bytes */
 template <class T> void Runtime_trans_algorithm::pack_segment_data(T *mpi_buf, T *field_data_buf, int segment_start, int segment_size, int field_2D_size, int total_dim_size_before_H2D, int total_dim_size_after_H2D)
 {
-    int i, j, k, offset = 0;
+    long i, j, k, offset = 0;
 	T *current_field_data_buf;
 
 
 	EXECUTION_REPORT_ERROR_OPTIONALLY(REPORT_ERROR, -1, total_buf <= (char*)(mpi_buf+offset) && total_buf+total_buf_size >= (char*)(mpi_buf+offset), "Software error in Runtime_trans_algorithm::pack_segment_data");
 
 	if (total_dim_size_before_H2D == 1) {
-		if (total_dim_size_after_H2D == 1)
-			for (i = segment_start; i < segment_size+segment_start; i ++) {
-				mpi_buf[offset++] = field_data_buf[i];
-			}
+		if (total_dim_size_after_H2D == 1) {
+			memcpy(mpi_buf, field_data_buf+segment_start, ((long)segment_size)*sizeof(T));
+			offset += segment_size;
+		}
 		else {
 			for (i = segment_start; i < segment_size+segment_start; i ++)
 				for (j = 0; j < total_dim_size_after_H2D; j ++)
-					mpi_buf[offset++] = field_data_buf[i+j*field_2D_size];
+					mpi_buf[offset++] = field_data_buf[i+j*((long)field_2D_size)];
 		}
 	}
+	else if (total_dim_size_after_H2D == 1) {
+		memcpy(mpi_buf, field_data_buf+((long)segment_start)*total_dim_size_before_H2D, ((long)segment_size)*total_dim_size_before_H2D*sizeof(T));
+		offset += ((long)segment_size)*total_dim_size_before_H2D;
+	}
 	else {
 		for (i = segment_start; i < segment_size+segment_start; i ++) {
 			for (j = 0; j < total_dim_size_after_H2D; j ++) {
-				current_field_data_buf = field_data_buf + i * total_dim_size_before_H2D + j*field_2D_size*total_dim_size_before_H2D;
+				current_field_data_buf = field_data_buf + i*total_dim_size_before_H2D + j*((long)field_2D_size)*total_dim_size_before_H2D;
 				for (k = 0; k < total_dim_size_before_H2D; k ++)
 					mpi_buf[offset++] = current_field_data_buf[k];
 			}
@@ -50,24 +56,23 @@ template <class T> void Runtime_trans_algorithm::pack_segment_data(T *mpi_buf, T
 
 void Runtime_trans_algorithm::unpack_segment_data(char *mpi_buf, char *field_data_buf, int segment_start, int segment_size, int field_2D_size, int total_dim_size_before_H2D, int total_dim_size_after_H2D, long field_size)
 {
-    int i, j, k, offset = 0;
+    long i, j, k, offset = 0;
 	char *current_field_data_buf;
 	
 
 	if (total_dim_size_before_H2D == 1) {
 		if (total_dim_size_after_H2D == 1) 
-			for (i = segment_start; i < segment_size+segment_start; i ++) {
-//				EXECUTION_REPORT_ERROR_OPTIONALLY(REPORT_ERROR, -1, i >= 0 && i < field_size, "Runtime_trans_algorithm::unpack_segment_data: %d vs %ld", i, field_size);
-				field_data_buf[i] = mpi_buf[offset++];	 	
-		}
+			memcpy(field_data_buf+segment_start, mpi_buf, segment_size);
 		else {
 			for (i = segment_start; i < segment_size+segment_start; i ++) 
 				for (j = 0; j < total_dim_size_after_H2D; j ++) {
 //					EXECUTION_REPORT_ERROR_OPTIONALLY(REPORT_ERROR, -1, i+j*field_2D_size >= 0 && i+j*field_2D_size < field_size, "Runtime_trans_algorithm::unpack_segment_data: %d vs %ld", i+j*field_2D_size, field_size);
-					field_data_buf[i+j*field_2D_size] = mpi_buf[offset++];
+					field_data_buf[i+j*((long)field_2D_size)] = mpi_buf[offset++];
 				}
 		}
 	}
+	else if (total_dim_size_after_H2D == 1)
+		memcpy(field_data_buf+((long)segment_start)*total_dim_size_before_H2D, mpi_buf, ((long)segment_size)*total_dim_size_before_H2D);
 	else {
 		for (i = segment_start; i < segment_size+segment_start; i ++) {
 			current_field_data_buf = field_data_buf + i*total_dim_size_before_H2D;
@@ -75,7 +80,7 @@ void Runtime_trans_algorithm::unpack_segment_data(char *mpi_buf, char *field_dat
 //				EXECUTION_REPORT_ERROR_OPTIONALLY(REPORT_ERROR, -1, i*total_dim_size_before_H2D + j*field_2D_size*total_dim_size_before_H2D + total_dim_size_before_H2D <= field_size, "Runtime_trans_algorithm::unpack_segment_data: %d vs %ld", i*total_dim_size_before_H2D + j*field_2D_size*total_dim_size_before_H2D + total_dim_size_before_H2D, field_size);
 				for (k = 0; k < total_dim_size_before_H2D; k ++)
 					current_field_data_buf[k] = mpi_buf[offset++];
-				current_field_data_buf += field_2D_size*total_dim_size_before_H2D;
+				current_field_data_buf += ((long)field_2D_size)*total_dim_size_before_H2D;
 			}		
 		}
 	}
@@ -122,7 +127,10 @@ Runtime_trans_algorithm::Runtime_trans_algorithm(bool send_or_receive, int num_t
         remote_comp_node = fields_routers[0]->get_src_comp_node();
     }
     strcpy(remote_comp_full_name, remote_comp_node->get_comp_full_name());
-	EXECUTION_REPORT_ERROR_OPTIONALLY(REPORT_ERROR, -1, local_comp_node->get_current_proc_local_id() != -1, "Software error in Runtime_trans_algorithm::Runtime_trans_algorithm: %s", local_comp_node->get_full_name());
+    for (int i = 0; i < TIMING_COMMUNICATION_RECV-TIMING_COMMUNICATION_SEND_WAIT+1; i ++) {
+        communication_timing_units[i] = -1;
+    }
+    EXECUTION_REPORT_ERROR_OPTIONALLY(REPORT_ERROR, -1, local_comp_node->get_current_proc_local_id() != -1, "Software error in Runtime_trans_algorithm::Runtime_trans_algorithm: %s", local_comp_node->get_full_name());
     remote_comp_node_updated = false;
     timer_not_bypassed = false;
     comp_id = local_comp_node->get_comp_id();
@@ -137,10 +145,8 @@ Runtime_trans_algorithm::Runtime_trans_algorithm(bool send_or_receive, int num_t
     remote_proc_ranks_in_union_comm = new int [num_remote_procs];
     memcpy(remote_proc_ranks_in_union_comm, ranks, num_remote_procs*sizeof(int));
     sender_time_has_matched = false;
-
-#ifndef USE_ONE_SIDED_MPI
-    request = new MPI_Request[num_remote_procs];
-#endif
+    max_message_size = comp_comm_group_mgt_mgr->get_max_trans_message_size();
+    num_outstanding_requests = 0;
     is_first_run = true;
     transfer_size_with_remote_procs = new long [num_remote_procs];
     send_displs_in_remote_procs = new long [num_remote_procs];
@@ -168,7 +174,7 @@ Runtime_trans_algorithm::Runtime_trans_algorithm(bool send_or_receive, int num_t
             else {
                 field_grid_size_beyond_H2D[i] = original_grid_mgr->get_total_grid_size_beyond_H2D(fields_mem[i]->get_grid_id());
                 only_have_no_decomp_data = false;
-                transfer_size_with_remote_procs[j] += fields_routers[i]->get_num_elements_transferred_with_remote_proc(send_or_receive, j) * fields_data_type_sizes[i] * field_grid_size_beyond_H2D[i];
+                transfer_size_with_remote_procs[j] += ((long)fields_routers[i]->get_num_elements_transferred_with_remote_proc(send_or_receive, j)) * fields_data_type_sizes[i] * field_grid_size_beyond_H2D[i];
                 is_V1D_sub_grid_after_H2D_sub_grid[i] = original_grid_mgr->is_V1D_sub_grid_after_H2D_sub_grid(fields_mem[i]->get_grid_id());
 				fields_mem[i]->get_total_dim_size_before_and_after_H2D(field_total_dim_size_before_H2D[i], field_total_dim_size_after_H2D[i]);	
 				if (send_or_receive)
@@ -198,7 +204,7 @@ Runtime_trans_algorithm::Runtime_trans_algorithm(bool send_or_receive, int num_t
         for (int i = 0; i < num_remote_procs_related; i ++) {
             int remote_proc_idx = remote_proc_idx_begin + i * num_local_procs;
             for (int j = 0; j < num_transfered_fields; j ++)
-                transfer_size_with_remote_procs[remote_proc_idx] += fields_data_type_sizes[j]*fields_mem[j]->get_size_of_field();
+                transfer_size_with_remote_procs[remote_proc_idx] += ((long)fields_data_type_sizes[j])*fields_mem[j]->get_size_of_field();
             index_remote_procs_with_common_data.push_back(remote_proc_idx);
         }
     }
@@ -236,7 +242,14 @@ Runtime_trans_algorithm::Runtime_trans_algorithm(bool send_or_receive, int num_t
         data_buf_size += transfer_size_with_remote_procs[j];
 
     total_buf_size = data_buf_size + (4*num_remote_procs + 4) * sizeof(long);
-	EXECUTION_REPORT_ERROR_OPTIONALLY(REPORT_ERROR, -1, total_buf_size < ((long)0x7FFFFFFF) && total_buf_size > 0, "ERROR happens in Runtime_trans_algorithm::Runtime_trans_algorithm: the current data buffer size (%lx) is larger than 0x7FFFFFFF, which may be not well supported by MPI", total_buf_size);
+	EXECUTION_REPORT_ERROR_OPTIONALLY(REPORT_ERROR, -1, total_buf_size > 0, "Software error in Runtime_trans_algorithm::Runtime_trans_algorithm: wrong data buffer size (%ld)", total_buf_size);
+#ifndef USE_ONE_SIDED_MPI
+    int max_num_requests = 0;
+    for (int j = 0; j < num_remote_procs; j ++)
+        max_num_requests += get_num_message_chunks(4*sizeof(long)+transfer_size_with_remote_procs[j]);
+    request = new MPI_Request[max_num_requests];
+#endif
+    EXECUTION_REPORT_LOG(REPORT_LOG, comp_id, true, "Runtime_trans_algorithm with component \"%s\" has a data buffer of %ld bytes, transferred in MPI messages of at most %ld bytes", remote_comp_full_name, total_buf_size, max_message_size);
     total_buf = (char*) (new long[(total_buf_size+sizeof(long)-1)/sizeof(long)]);
     send_tag_buf = (long *) total_buf;
 	temp_receive_data_buffer = NULL;
@@ -274,6 +287,18 @@ Runtime_trans_algorithm::~Runtime_trans_algorithm()
 #ifndef USE_ONE_SIDED_MPI
     delete [] request;
 #endif
+    for (int i = 0; i < history_receive_zero_copy_types.size(); i ++)
+        release_zero_copy_receive_types(i);
+}
+
+
+int Runtime_trans_algorithm::get_communication_timing_unit(int unit_behavior)
+{
+    int &timing_unit = communication_timing_units[unit_behavior-TIMING_COMMUNICATION_SEND_WAIT];
+
+    if (timing_unit == -1)
+        timing_unit = local_comp_node->get_performance_timing_mgr()->get_timing_unit_handle(TIMING_TYPE_COMMUNICATION, unit_behavior, -1, remote_comp_full_name);
+    return timing_unit;
 }
 
 
@@ -338,7 +363,7 @@ bool Runtime_trans_algorithm::is_remote_data_buf_ready(bool bypass_timer)
     last_field_remote_recv_count ++;
 
     wtime(&time2);
-    local_comp_node->get_performance_timing_mgr()->performance_timing_add(TIMING_TYPE_COMMUNICATION, TIMING_COMMUNICATION_SEND_QUERRY, -1, remote_comp_full_name, time2-time1);
+    local_comp_node->get_performance_timing_mgr()->performance_timing_add(get_communication_timing_unit(TIMING_COMMUNICATION_SEND_QUERRY), time2-time1);
     
     return true;
 }
@@ -348,6 +373,8 @@ void Runtime_trans_algorithm::receive_data_in_temp_buffer()
 {
     bool is_ready = true;
     double time1, time2, time3;
+    int empty_history_receive_buffer_index;
+    char *remote_proc_data_buf;
 
 
     if (index_remote_procs_with_common_data.size() == 0)
@@ -362,7 +389,10 @@ void Runtime_trans_algorithm::receive_data_in_temp_buffer()
     }
 
 #ifndef USE_ONE_SIDED_MPI
-    local_comp_node->get_performance_timing_mgr()->performance_timing_start(TIMING_TYPE_COMMUNICATION, TIMING_COMMUNICATION_RECV, -1, remote_comp_full_name);
+    empty_history_receive_buffer_index = get_empty_history_receive_buffer_index();
+    prepare_zero_copy_receive_types(empty_history_receive_buffer_index);
+    local_comp_node->get_performance_timing_mgr()->performance_timing_start(get_communication_timing_unit(TIMING_COMMUNICATION_RECV));
+    num_outstanding_requests = 0;
     for (int i = 0; i < index_remote_procs_with_common_data.size(); i ++) {
         int remote_proc_index = index_remote_procs_with_common_data[i];
         if (transfer_size_with_remote_procs[remote_proc_index] == 0) 
@@ -370,18 +400,19 @@ void Runtime_trans_algorithm::receive_data_in_temp_buffer()
         data_buf = (void *) (total_buf + recv_displs_in_current_proc[remote_proc_index]);
         int remote_proc_id = remote_proc_ranks_in_union_comm[remote_proc_index];
 		EXECUTION_REPORT_ERROR_OPTIONALLY(REPORT_ERROR, -1, recv_displs_in_current_proc[remote_proc_index]+4*sizeof(long)+transfer_size_with_remote_procs[remote_proc_index] <= total_buf_size, "Software error in Runtime_trans_algorithm::receive_data_in_temp_buffer");
-        MPI_Irecv((char *)data_buf, 4*sizeof(long)+transfer_size_with_remote_procs[remote_proc_index], MPI_CHAR, remote_proc_id, comm_tag, union_comm, &request[i]);
+        if (history_receive_zero_copy_types[empty_history_receive_buffer_index][remote_proc_index] != MPI_DATATYPE_NULL)
+            MPI_Irecv(MPI_BOTTOM, 1, history_receive_zero_copy_types[empty_history_receive_buffer_index][remote_proc_index], remote_proc_id, comm_tag, union_comm, &request[num_outstanding_requests++]);
+        else {
+            long message_size = 4*sizeof(long)+transfer_size_with_remote_procs[remote_proc_index];
+            for (long chunk_start = 0; chunk_start < message_size; chunk_start += max_message_size)
+                MPI_Irecv((char *)data_buf+chunk_start, (int)(message_size-chunk_start < max_message_size? message_size-chunk_start : max_message_size), MPI_CHAR, remote_proc_id, comm_tag, union_comm, &request[num_outstanding_requests++]);
+        }
     }    
-    local_comp_node->get_performance_timing_mgr()->performance_timing_stop(TIMING_TYPE_COMMUNICATION, TIMING_COMMUNICATION_RECV, -1, remote_comp_full_name);
-    local_comp_node->get_performance_timing_mgr()->performance_timing_start(TIMING_TYPE_COMMUNICATION, TIMING_COMMUNICATION_RECV_WAIT, -1, remote_comp_full_name);
-    for (int i = 0; i < index_remote_procs_with_common_data.size(); i ++) {
-        int remote_proc_index = index_remote_procs_with_common_data[i];
-        if (transfer_size_with_remote_procs[remote_proc_index] == 0) 
-            continue;
-        MPI_Status state;
-        MPI_Wait(&request[i], &state);
-    }
-    local_comp_node->get_performance_timing_mgr()->performance_timing_stop(TIMING_TYPE_COMMUNICATION, TIMING_COMMUNICATION_RECV_WAIT, -1, remote_comp_full_name);
+    local_comp_node->get_performance_timing_mgr()->performance_timing_stop(get_communication_timing_unit(TIMING_COMMUNICATION_RECV));
+    local_comp_node->get_performance_timing_mgr()->performance_timing_start(get_communication_timing_unit(TIMING_COMMUNICATION_RECV_WAIT));
+    MPI_Waitall(num_outstanding_requests, request, MPI_STATUSES_IGNORE);
+    num_outstanding_requests = 0;
+    local_comp_node->get_performance_timing_mgr()->performance_timing_stop(get_communication_timing_unit(TIMING_COMMUNICATION_RECV_WAIT));
 #endif
 
     wtime(&time1);
@@ -432,65 +463,20 @@ void Runtime_trans_algorithm::receive_data_in_temp_buffer()
 
 #ifdef USE_ONE_SIDED_MPI
     wtime(&time2);    
-    local_comp_node->get_performance_timing_mgr()->performance_timing_add(TIMING_TYPE_COMMUNICATION, TIMING_COMMUNICATION_RECV_QUERRY, -1, remote_comp_full_name, time2-time1);
+    local_comp_node->get_performance_timing_mgr()->performance_timing_add(get_communication_timing_unit(TIMING_COMMUNICATION_RECV_QUERRY), time2-time1);
 #endif    
 
-    int empty_history_receive_buffer_index = -1;
-    if (last_history_receive_buffer_index != -1) {
-        for (int i = 0; i < history_receive_fields_mem.size(); i ++) {
-            int index_iter = (last_history_receive_buffer_index+i) % history_receive_fields_mem.size();
-            if (!history_receive_buffer_status[index_iter]) {
-                empty_history_receive_buffer_index = index_iter;
-                break;
-            }
-        }
-    }
-    if (empty_history_receive_buffer_index == -1) {
-        std::vector<bool> temp_history_receive_buffer_status;
-        std::vector<long> temp_history_receive_sender_time;
-        std::vector<long> temp_history_receive_usage_time;
-        std::vector<std::vector<Field_mem_info *> > temp_history_receive_fields_mem;
-        for (int i = 0; i < history_receive_fields_mem.size(); i ++) {
-            int index_iter = (last_history_receive_buffer_index+i) % history_receive_fields_mem.size();
-            temp_history_receive_buffer_status.push_back(history_receive_buffer_status[index_iter]);
-            temp_history_receive_sender_time.push_back(history_receive_sender_time[index_iter]);
-            temp_history_receive_usage_time.push_back(history_receive_usage_time[index_iter]);
-            temp_history_receive_fields_mem.push_back(history_receive_fields_mem[index_iter]);
-        }
-        history_receive_buffer_status.clear();
-        history_receive_sender_time.clear();
-        history_receive_usage_time.clear();
-        history_receive_fields_mem.clear();
-        for (int i = 0; i < temp_history_receive_fields_mem.size(); i ++) {
-            history_receive_buffer_status.push_back(temp_history_receive_buffer_status[i]);
-            history_receive_sender_time.push_back(temp_history_receive_sender_time[i]);
-            history_receive_usage_time.push_back(temp_history_receive_usage_time[i]);
-            history_receive_fields_mem.push_back(temp_history_receive_fields_mem[i]);
-        }
-        last_history_receive_buffer_index = 0;
-        empty_history_receive_buffer_index = history_receive_buffer_status.size();
-        history_receive_buffer_status.push_back(false);
-        history_receive_sender_time.push_back(-1);
-        history_receive_usage_time.push_back(-1);
-        std::vector<Field_mem_info *> new_receive_fields_mem;
-        for (int i = 0; i < num_transfered_fields; i ++) {
-			if (rearranging_intra_a_component)
-				new_receive_fields_mem.push_back(fields_mem[i]);
-			else new_receive_fields_mem.push_back(memory_manager->alloc_mem(fields_mem[i], BUF_MARK_DATA_TRANSFER, ((fields_mem[i]->get_buf_mark() & TYPE_ID_SUFFIX_MASK) << 8) | (history_receive_fields_mem.size()+1), fields_mem[i]->get_data_type(), false, true));
-        }
-		if (rearranging_intra_a_component)
-			EXECUTION_REPORT_ERROR_OPTIONALLY(REPORT_ERROR, -1, history_receive_fields_mem.size() == 0, "Software error in Runtime_trans_algorithm::receive_data_in_temp_buffer: for halo exchange");
-        history_receive_fields_mem.push_back(new_receive_fields_mem);
-    }
+#ifdef USE_ONE_SIDED_MPI
+    empty_history_receive_buffer_index = get_empty_history_receive_buffer_index();
+#endif
     history_receive_buffer_status[empty_history_receive_buffer_index] = true;
     history_receive_sender_time[empty_history_receive_buffer_index] = current_receive_field_sender_time;
     history_receive_usage_time[empty_history_receive_buffer_index] = current_receive_field_usage_time;
     last_receive_field_sender_time = current_receive_field_sender_time;
 
+    long offset = 0;
 #ifdef USE_ONE_SIDED_MPI
     MPI_Win_lock(MPI_LOCK_SHARED, current_proc_id_union_comm, 0, data_win);
-#endif
-    int offset = 0;
     for (int i = 0; i < index_remote_procs_with_common_data.size(); i ++) {
         int remote_proc_index = index_remote_procs_with_common_data[i];
         if (transfer_size_with_remote_procs[remote_proc_index] == 0) 
@@ -501,7 +487,6 @@ void Runtime_trans_algorithm::receive_data_in_temp_buffer()
         memcpy(temp_receive_data_buffer+offset, data_buf, transfer_size_with_remote_procs[remote_proc_index]);
         offset += transfer_size_with_remote_procs[remote_proc_index];
     }    
-#ifdef USE_ONE_SIDED_MPI
     MPI_Win_unlock(current_proc_id_union_comm, data_win);
 #endif
 
@@ -509,15 +494,32 @@ void Runtime_trans_algorithm::receive_data_in_temp_buffer()
     for (int i = 0; i < num_remote_procs; i ++) {
         if (transfer_size_with_remote_procs[i] == 0) 
             continue;
-        int old_offset = offset;
+#ifndef USE_ONE_SIDED_MPI
+        remote_proc_data_buf = total_buf + recv_displs_in_current_proc[i] + 4*sizeof(long);
+        offset = 0;
+        if (history_receive_zero_copy_types[empty_history_receive_buffer_index][i] != MPI_DATATYPE_NULL) {
+            for (int j = 0; j < num_transfered_fields; j ++) {
+                if (fields_routers[j]->get_num_dimensions() == 0) {
+                    memcpy(history_receive_fields_mem[empty_history_receive_buffer_index][j]->get_data_buf(), remote_proc_data_buf + offset, fields_data_type_sizes[j]*fields_mem[j]->get_size_of_field());
+                    offset += fields_data_type_sizes[j]*fields_mem[j]->get_size_of_field();
+                }
+                else offset += ((long)fields_routers[j]->get_num_elements_transferred_with_remote_proc(false, i)) * fields_data_type_sizes[j] * field_grid_size_beyond_H2D[j];
+            }
+            EXECUTION_REPORT_ERROR_OPTIONALLY(REPORT_ERROR, -1, offset == transfer_size_with_remote_procs[i], "C-Coupler software error in recv of runtime_trans_algorithm.");
+            continue;
+        }
+#else
+        remote_proc_data_buf = temp_receive_data_buffer;
+#endif
+        long old_offset = offset;
         //int offset = recv_displs_in_current_proc[i];
         for (int j = 0; j < num_transfered_fields; j ++) {
 			EXECUTION_REPORT_ERROR_OPTIONALLY(REPORT_ERROR, -1, fields_mem[j]->get_size_of_field() == history_receive_fields_mem[empty_history_receive_buffer_index][j]->get_size_of_field(), "Software error in Runtime_trans_algorithm::receive_data_in_temp_buffer");
             if (fields_routers[j]->get_num_dimensions() == 0) {
-                memcpy(history_receive_fields_mem[empty_history_receive_buffer_index][j]->get_data_buf(), temp_receive_data_buffer + offset, fields_data_type_sizes[j]*fields_mem[j]->get_size_of_field());
+                memcpy(history_receive_fields_mem[empty_history_receive_buffer_index][j]->get_data_buf(), remote_proc_data_buf + offset, fields_data_type_sizes[j]*fields_mem[j]->get_size_of_field());
                 offset += fields_data_type_sizes[j]*fields_mem[j]->get_size_of_field();
             }
-            else unpack_MD_data(temp_receive_data_buffer, i, j, history_receive_fields_mem[empty_history_receive_buffer_index][j], &offset);			
+            else unpack_MD_data(remote_proc_data_buf, i, j, history_receive_fields_mem[empty_history_receive_buffer_index][j], &offset);			
         }    
         EXECUTION_REPORT_ERROR_OPTIONALLY(REPORT_ERROR, -1, offset - old_offset == transfer_size_with_remote_procs[i], "C-Coupler software error in recv of runtime_trans_algorithm.");
     }
@@ -525,7 +527,7 @@ void Runtime_trans_algorithm::receive_data_in_temp_buffer()
 #ifdef USE_ONE_SIDED_MPI
     set_local_tags();
     wtime(&time3);
-    local_comp_node->get_performance_timing_mgr()->performance_timing_add(TIMING_TYPE_COMMUNICATION, TIMING_COMMUNICATION_RECV, -1, remote_comp_full_name, time3-time2);
+    local_comp_node->get_performance_timing_mgr()->performance_timing_add(get_communication_timing_unit(TIMING_COMMUNICATION_RECV), time3-time2);
 #endif    
 }
 
@@ -547,11 +549,8 @@ void Runtime_trans_algorithm::wait_sending_data()
 
 	EXECUTION_REPORT_ERROR_OPTIONALLY(REPORT_ERROR, -1, !current_send_have_been_waited, "Software error in Runtime_trans_algorithm::wait_sending_data");
 #ifndef USE_ONE_SIDED_MPI
-	for (int i = 0; i < index_remote_procs_with_common_data.size(); i ++) {
-		int remote_proc_index = index_remote_procs_with_common_data[i];
-		MPI_Status state;
-		MPI_Wait(&request[i], &state);
-	}
+	MPI_Waitall(num_outstanding_requests, request, MPI_STATUSES_IGNORE);
+	num_outstanding_requests = 0;
 #endif
 	current_send_have_been_waited = true;
 }
@@ -566,8 +565,8 @@ bool Runtime_trans_algorithm::send(bool bypass_timer)
     }
 
 #ifndef USE_ONE_SIDED_MPI
-    comp_comm_group_mgt_mgr->get_global_node_of_local_comp(comp_id,false,"")->get_performance_timing_mgr()->performance_timing_start(TIMING_TYPE_COMMUNICATION, TIMING_COMMUNICATION_SEND_WAIT, -1, remote_comp_full_name);
-    comp_comm_group_mgt_mgr->get_global_node_of_local_comp(comp_id,false,"")->get_performance_timing_mgr()->performance_timing_stop(TIMING_TYPE_COMMUNICATION, TIMING_COMMUNICATION_SEND_WAIT, -1, remote_comp_full_name);
+    local_comp_node->get_performance_timing_mgr()->performance_timing_start(get_communication_timing_unit(TIMING_COMMUNICATION_SEND_WAIT));
+    local_comp_node->get_performance_timing_mgr()->performance_timing_stop(get_communication_timing_unit(TIMING_COMMUNICATION_SEND_WAIT));
 #endif
 
     if (index_remote_procs_with_common_data.size() > 0) {
@@ -592,28 +591,16 @@ bool Runtime_trans_algorithm::send(bool bypass_timer)
     if (index_remote_procs_with_common_data.size() == 0)
         return true;
 
-    local_comp_node->get_performance_timing_mgr()->performance_timing_start(TIMING_TYPE_COMMUNICATION, TIMING_COMMUNICATION_SEND, -1, remote_comp_full_name);
+    local_comp_node->get_performance_timing_mgr()->performance_timing_start(get_communication_timing_unit(TIMING_COMMUNICATION_SEND));
 
+    EXECUTION_REPORT_ERROR_OPTIONALLY(REPORT_ERROR, -1, num_outstanding_requests == 0, "Software error in Runtime_trans_algorithm::send: the previous sending has not been waited");
     long current_full_time = time_mgr->get_current_full_time();
-    int offset = 0;
+    long offset = 0;
     //for (int i = 0; i < num_remote_procs; i ++) {
     for (int i = 0; i < index_remote_procs_with_common_data.size(); i ++) {
         int remote_proc_index = index_remote_procs_with_common_data[i];
         //if (transfer_size_with_remote_procs[remote_proc_index] == 0) continue;
 
-        offset = 0;
-        int old_offset = offset;
-        data_buf = (void *) (total_buf + recv_displs_in_current_proc[remote_proc_index] + 4*sizeof(long));
-        if (transfer_size_with_remote_procs[remote_proc_index] > 0)
-            for (int j = 0; j < num_transfered_fields; j ++) {
-				void *temp_data_buf = (char*)data_buf + offset;
-                if (fields_routers[j]->get_num_dimensions() == 0) {
-                    memcpy((char *)data_buf + offset, fields_data_buffers[j], fields_data_type_sizes[j]*fields_mem[j]->get_size_of_field());
-                    offset += fields_data_type_sizes[j] * fields_mem[j]->get_size_of_field();
-                }
-                else pack_MD_data(remote_proc_index, j, &offset);
-            }
-
         tag_buf = (long *) (total_buf + recv_displs_in_current_proc[remote_proc_index]);
         if (bypass_timer) {
             tag_buf[0] = current_full_time + (bypass_counter%8)*((long)10000000000000000);
@@ -626,20 +613,33 @@ bool Runtime_trans_algorithm::send(bool bypass_timer)
         tag_buf[2] = (long) time_mgr->get_runtype_mark();
         tag_buf[3] = time_mgr->get_restart_full_time();
 
-        int remote_proc_id = remote_proc_ranks_in_union_comm[remote_proc_index];
-
-#ifndef USE_ONE_SIDED_MPI
-        MPI_Isend(tag_buf, 4*sizeof(long)+transfer_size_with_remote_procs[remote_proc_index], MPI_CHAR, remote_proc_id, comm_tag, union_comm, &request[i]);
-#else
-        MPI_Win_lock(MPI_LOCK_SHARED, remote_proc_id, 0, data_win);
-        MPI_Put(tag_buf, 4*sizeof(long)+transfer_size_with_remote_procs[remote_proc_index], MPI_CHAR, remote_proc_id, send_displs_in_remote_procs[remote_proc_index], 4*sizeof(long)+transfer_size_with_remote_procs[remote_proc_index], MPI_CHAR, data_win);
-        MPI_Win_unlock(remote_proc_id, data_win);
+        current_send_remote_proc_index = remote_proc_index;
+        current_send_message_size = 4*sizeof(long)+transfer_size_with_remote_procs[remote_proc_index];
+        current_send_message_sent_size = 0;
+#ifdef USE_ONE_SIDED_MPI
+        MPI_Win_lock(MPI_LOCK_SHARED, remote_proc_ranks_in_union_comm[remote_proc_index], 0, data_win);
+#endif
+        offset = 0;
+        data_buf = (void *) (total_buf + recv_displs_in_current_proc[remote_proc_index] + 4*sizeof(long));
+        if (transfer_size_with_remote_procs[remote_proc_index] > 0)
+            for (int j = 0; j < num_transfered_fields; j ++) {
+                if (fields_routers[j]->get_num_dimensions() == 0) {
+                    memcpy((char *)data_buf + offset, fields_data_buffers[j], fields_data_type_sizes[j]*fields_mem[j]->get_size_of_field());
+                    offset += fields_data_type_sizes[j] * fields_mem[j]->get_size_of_field();
+                    send_packed_message_chunks(4*sizeof(long)+offset);
+                }
+                else pack_MD_data(remote_proc_index, j, &offset);
+            }
+        EXECUTION_REPORT_ERROR_OPTIONALLY(REPORT_ERROR, -1, 4*sizeof(long)+offset == current_send_message_size, "Software error in Runtime_trans_algorithm::send: wrong message size: %ld vs %ld", 4*sizeof(long)+offset, current_send_message_size);
+        send_packed_message_chunks(current_send_message_size);
+#ifdef USE_ONE_SIDED_MPI
+        MPI_Win_unlock(remote_proc_ranks_in_union_comm[remote_proc_index], data_win);
 #endif
     }
 
 	current_send_have_been_waited = false;
 
-    EXECUTION_REPORT_ERROR_OPTIONALLY(REPORT_ERROR, -1, offset <= data_buf_size, "Software error in Runtime_trans_algorithm::send: wrong data_buf_size: %d vs %d", offset, data_buf_size);
+    EXECUTION_REPORT_ERROR_OPTIONALLY(REPORT_ERROR, -1, offset <= data_buf_size, "Software error in Runtime_trans_algorithm::send: wrong data_buf_size: %ld vs %ld", offset, data_buf_size);
 
     if (bypass_timer)
         last_receive_sender_time = (bypass_counter%8)*((long)10000000000000000);
@@ -647,7 +647,7 @@ bool Runtime_trans_algorithm::send(bool bypass_timer)
 
     EXECUTION_REPORT_LOG(REPORT_LOG, comp_id, true, "Finish sending data to component \"%s\": %d", remote_comp_full_name, comm_tag);
 
-    local_comp_node->get_performance_timing_mgr()->performance_timing_stop(TIMING_TYPE_COMMUNICATION, TIMING_COMMUNICATION_SEND, -1, remote_comp_full_name);
+    local_comp_node->get_performance_timing_mgr()->performance_timing_stop(get_communication_timing_unit(TIMING_COMMUNICATION_SEND));
 
     return true;
 }
@@ -659,7 +659,7 @@ bool Runtime_trans_algorithm::recv(bool bypass_timer)
     
 
 #ifdef USE_ONE_SIDED_MPI
-    local_comp_node->get_performance_timing_mgr()->performance_timing_start(TIMING_TYPE_COMMUNICATION, TIMING_COMMUNICATION_RECV_WAIT, -1, remote_comp_full_name);
+    local_comp_node->get_performance_timing_mgr()->performance_timing_start(get_communication_timing_unit(TIMING_COMMUNICATION_RECV_WAIT));
 #endif
     if (bypass_timer) {
         EXECUTION_REPORT_LOG(REPORT_LOG, comp_id, true, "Proc %d bypass timer to begin to receive data from component \"%s\": %ld: %d: %d, %d", current_proc_id_union_comm, remote_comp_full_name, current_remote_fields_time, bypass_counter, comm_tag, data_buf_size);
@@ -714,7 +714,7 @@ bool Runtime_trans_algorithm::recv(bool bypass_timer)
     EXECUTION_REPORT_LOG(REPORT_LOG, comp_id, true, "Finish receiving data from component \"%s\" at the remote model time %ld vs %ld", remote_comp_full_name, last_receive_sender_time, current_remote_fields_time);
 
 #ifdef USE_ONE_SIDED_MPI
-    local_comp_node->get_performance_timing_mgr()->performance_timing_stop(TIMING_TYPE_COMMUNICATION, TIMING_COMMUNICATION_RECV_WAIT, -1, remote_comp_full_name);
+    local_comp_node->get_performance_timing_mgr()->performance_timing_stop(get_communication_timing_unit(TIMING_COMMUNICATION_RECV_WAIT));
 #endif
 
     return true;
@@ -737,13 +737,42 @@ void Runtime_trans_algorithm::preprocess()
             int remote_proc_index = index_remote_procs_with_common_data[j];
             if (fields_routers[i]->get_num_dimensions() == 0)
                 transfer_size_with_remote_procs[remote_proc_index] += fields_data_type_sizes[i] * fields_mem[i]->get_size_of_field();
-            else transfer_size_with_remote_procs[remote_proc_index] += fields_routers[i]->get_num_elements_transferred_with_remote_proc(send_or_receive, remote_proc_index) * fields_data_type_sizes[i] * field_grid_size_beyond_H2D[i];
+            else transfer_size_with_remote_procs[remote_proc_index] += ((long)fields_routers[i]->get_num_elements_transferred_with_remote_proc(send_or_receive, remote_proc_index)) * fields_data_type_sizes[i] * field_grid_size_beyond_H2D[i];
         }
     }
 }
 
 
-void Runtime_trans_algorithm::pack_MD_data(int remote_proc_index, int field_index, int * offset)
+int Runtime_trans_algorithm::get_num_message_chunks(long message_size)
+{
+    return (int) ((message_size+max_message_size-1) / max_message_size);
+}
+
+
+/* Transfer the chunks of the current message to the current remote process 
+   that have been completely packed, so that packing the remaining data 
+   overlaps with the transfer of the chunks before it. A message is split 
+   into chunks of max_message_size bytes, so that a message can be larger 
+   than 2GB; the last chunk is transferred once the whole message is packed. */
+void Runtime_trans_algorithm::send_packed_message_chunks(long packed_size)
+{
+    char *message_buf = total_buf + recv_displs_in_current_proc[current_send_remote_proc_index];
+    int remote_proc_id = remote_proc_ranks_in_union_comm[current_send_remote_proc_index];
+
+
+    while (current_send_message_sent_size < current_send_message_size && (packed_size - current_send_message_sent_size >= max_message_size || packed_size == current_send_message_size)) {
+        int chunk_size = (int) (packed_size - current_send_message_sent_size < max_message_size? packed_size - current_send_message_sent_size : max_message_size);
+#ifndef USE_ONE_SIDED_MPI
+        MPI_Isend(message_buf+current_send_message_sent_size, chunk_size, MPI_CHAR, remote_proc_id, comm_tag, union_comm, &request[num_outstanding_requests++]);
+#else
+        MPI_Put(message_buf+current_send_message_sent_size, chunk_size, MPI_CHAR, remote_proc_id, send_displs_in_remote_procs[current_send_remote_proc_index]+current_send_message_sent_size, chunk_size, MPI_CHAR, data_win);
+#endif
+        current_send_message_sent_size += chunk_size;
+    }
+}
+
+
+void Runtime_trans_algorithm::pack_MD_data(int remote_proc_index, int field_index, long * offset)
 {
     int num_segments;
     int *segment_starts, *num_elements_in_segments, current_segment_start;
@@ -789,11 +818,12 @@ void Runtime_trans_algorithm::pack_MD_data(int remote_proc_index, int field_inde
                 break;
         }
         (*offset) += num_elements_in_segments[i]*field_grid_size_beyond_H2D[field_index]*fields_data_type_sizes[field_index];
+        send_packed_message_chunks(4*sizeof(long)+(*offset));
     }
 }
 
 
-void Runtime_trans_algorithm::unpack_MD_data(void *data_buf, int remote_proc_index, int field_index, Field_mem_info *field_inst_mem, int * offset)
+void Runtime_trans_algorithm::unpack_MD_data(void *data_buf, int remote_proc_index, int field_index, Field_mem_info *field_inst_mem, long * offset)
 {
     int num_segments;
     int *segment_starts, *num_elements_in_segments, current_segment_start;
@@ -845,3 +875,184 @@ void Runtime_trans_algorithm::unpack_MD_data(void *data_buf, int remote_proc_ind
     }
 }
 
+
+int Runtime_trans_algorithm::get_empty_history_receive_buffer_index()
+{
+    int empty_history_receive_buffer_index = -1;
+
+
+    if (last_history_receive_buffer_index != -1) {
+        for (int i = 0; i < history_receive_fields_mem.size(); i ++) {
+            int index_iter = (last_history_receive_buffer_index+i) % history_receive_fields_mem.size();
+            if (!history_receive_buffer_status[index_iter]) {
+                empty_history_receive_buffer_index = index_iter;
+                break;
+            }
+        }
+    }
+    if (empty_history_receive_buffer_index == -1) {
+        std::vector<bool> temp_history_receive_buffer_status;
+        std::vector<long> temp_history_receive_sender_time;
+        std::vector<long> temp_history_receive_usage_time;
+        std::vector<std::vector<Field_mem_info *> > temp_history_receive_fields_mem;
+        std::vector<std::vector<MPI_Datatype> > temp_history_receive_zero_copy_types;
+        std::vector<std::vector<void*> > temp_history_receive_zero_copy_field_bufs;
+        for (int i = 0; i < history_receive_fields_mem.size(); i ++) {
+            int index_iter = (last_history_receive_buffer_index+i) % history_receive_fields_mem.size();
+            temp_history_receive_buffer_status.push_back(history_receive_buffer_status[index_iter]);
+            temp_history_receive_sender_time.push_back(history_receive_sender_time[index_iter]);
+            temp_history_receive_usage_time.push_back(history_receive_usage_time[index_iter]);
+            temp_history_receive_fields_mem.push_back(history_receive_fields_mem[index_iter]);
+            temp_history_receive_zero_copy_types.push_back(history_receive_zero_copy_types[index_iter]);
+            temp_history_receive_zero_copy_field_bufs.push_back(history_receive_zero_copy_field_bufs[index_iter]);
+        }
+        history_receive_buffer_status.clear();
+        history_receive_sender_time.clear();
+        history_receive_usage_time.clear();
+        history_receive_fields_mem.clear();
+        history_receive_zero_copy_types.clear();
+        history_receive_zero_copy_field_bufs.clear();
+        for (int i = 0; i < temp_history_receive_fields_mem.size(); i ++) {
+            history_receive_buffer_status.push_back(temp_history_receive_buffer_status[i]);
+            history_receive_sender_time.push_back(temp_history_receive_sender_time[i]);
+            history_receive_usage_time.push_back(temp_history_receive_usage_time[i]);
+            history_receive_fields_mem.push_back(temp_history_receive_fields_mem[i]);
+            history_receive_zero_copy_types.push_back(temp_history_receive_zero_copy_types[i]);
+            history_receive_zero_copy_field_bufs.push_back(temp_history_receive_zero_copy_field_bufs[i]);
+        }
+        last_history_receive_buffer_index = 0;
+        empty_history_receive_buffer_index = history_receive_buffer_status.size();
+        history_receive_buffer_status.push_back(false);
+        history_receive_sender_time.push_back(-1);
+        history_receive_usage_time.push_back(-1);
+        std::vector<Field_mem_info *> new_receive_fields_mem;
+        for (int i = 0; i < num_transfered_fields; i ++) {
+			if (rearranging_intra_a_component)
+				new_receive_fields_mem.push_back(fields_mem[i]);
+			else new_receive_fields_mem.push_back(memory_manager->alloc_mem(fields_mem[i], BUF_MARK_DATA_TRANSFER, ((fields_mem[i]->get_buf_mark() & TYPE_ID_SUFFIX_MASK) << 8) | (history_receive_fields_mem.size()+1), fields_mem[i]->get_data_type(), false, true));
+        }
+		if (rearranging_intra_a_component)
+			EXECUTION_REPORT_ERROR_OPTIONALLY(REPORT_ERROR, -1, history_receive_fields_mem.size() == 0, "Software error in Runtime_trans_algorithm::receive_data_in_temp_buffer: for halo exchange");
+        history_receive_fields_mem.push_back(new_receive_fields_mem);
+        history_receive_zero_copy_types.push_back(std::vector<MPI_Datatype>());
+        history_receive_zero_copy_field_bufs.push_back(std::vector<void*>());
+    }
+
+    return empty_history_receive_buffer_index;
+}
+
+
+void Runtime_trans_algorithm::get_history_receive_field_bufs(int history_buffer_index, std::vector<void*> &field_bufs)
+{
+    field_bufs.clear();
+    for (int j = 0; j < num_transfered_fields; j ++) {
+        Field_mem_info *field_inst_mem = history_receive_fields_mem[history_buffer_index][j];
+        field_bufs.push_back(field_inst_mem->get_data_buf());
+        for (int k = 0; k < field_inst_mem->get_num_chunks(); k ++)
+            field_bufs.push_back(field_inst_mem->get_chunk_buf(k));
+    }
+}
+
+
+void Runtime_trans_algorithm::release_zero_copy_receive_types(int history_buffer_index)
+{
+    for (int i = 0; i < history_receive_zero_copy_types[history_buffer_index].size(); i ++)
+        if (history_receive_zero_copy_types[history_buffer_index][i] != MPI_DATATYPE_NULL)
+            MPI_Type_free(&history_receive_zero_copy_types[history_buffer_index][i]);
+    history_receive_zero_copy_types[history_buffer_index].clear();
+    history_receive_zero_copy_field_bufs[history_buffer_index].clear();
+}
+
+
+void Runtime_trans_algorithm::prepare_zero_copy_receive_types(int history_buffer_index)
+{
+    std::vector<void*> field_bufs;
+
+
+    get_history_receive_field_bufs(history_buffer_index, field_bufs);
+    if (history_receive_zero_copy_types[history_buffer_index].size() > 0 && field_bufs == history_receive_zero_copy_field_bufs[history_buffer_index])
+        return;
+
+    release_zero_copy_receive_types(history_buffer_index);
+    history_receive_zero_copy_field_bufs[history_buffer_index] = field_bufs;
+    for (int i = 0; i < num_remote_procs; i ++)
+        history_receive_zero_copy_types[history_buffer_index].push_back(build_zero_copy_receive_type(history_buffer_index, i));
+}
+
+
+/* Build an MPI datatype that scatters the message from a remote process (the 
+   tag header followed by the packed fields) straight into the tag buffer and 
+   the fields of a history receive buffer, so that the receiver does not need 
+   to stage and unpack the data. Only the messages in which each routing 
+   segment of each field is a contiguous run of the local field are handled; 
+   MPI_DATATYPE_NULL is returned for the others. As each remote process sends 
+   the 0-D fields, they are received into the staging buffer of that process 
+   (so that the receive buffers of concurrent requests never overlap) and are 
+   copied into the fields after the receive. */
+MPI_Datatype Runtime_trans_algorithm::build_zero_copy_receive_type(int history_buffer_index, int remote_proc_index)
+{
+    std::vector<MPI_Aint> block_displs;
+    std::vector<int> block_lengths;
+    MPI_Datatype zero_copy_type = MPI_DATATYPE_NULL;
+    MPI_Aint block_displ;
+    long total_block_size = 0;
+
+
+    if (transfer_size_with_remote_procs[remote_proc_index] == 0 || 4*sizeof(long)+transfer_size_with_remote_procs[remote_proc_index] > max_message_size)
+        return MPI_DATATYPE_NULL;
+
+    for (int j = -1; j < num_transfered_fields; j ++) {
+        std::vector<char*> field_blocks;
+        std::vector<long> field_block_sizes;
+        if (j == -1) {
+            field_blocks.push_back(total_buf + recv_displs_in_current_proc[remote_proc_index]);
+            field_block_sizes.push_back(4*sizeof(long));
+        }
+        else {
+            Field_mem_info *field_inst_mem = history_receive_fields_mem[history_buffer_index][j];
+            if (fields_routers[j]->get_num_dimensions() == 0) {
+                field_blocks.push_back(total_buf + recv_displs_in_current_proc[remote_proc_index] + total_block_size);
+                field_block_sizes.push_back(fields_data_type_sizes[j]*field_inst_mem->get_size_of_field());
+            }
+            else {
+                int num_segments = fields_routers[j]->get_num_local_indx_segments_with_remote_proc(false, remote_proc_index);
+                if (num_segments > 0 && field_total_dim_size_after_H2D[j] != 1)
+                    return MPI_DATATYPE_NULL;
+                int *segment_starts = fields_routers[j]->get_local_indx_segment_starts_with_remote_proc(false, remote_proc_index);
+                int *num_elements_in_segments = fields_routers[j]->get_local_indx_segment_lengths_with_remote_proc(false, remote_proc_index);
+                Decomp_info *decomp_info = fields_routers[j]->get_dst_decomp_info();
+                long element_size = field_total_dim_size_before_H2D[j]*fields_data_type_sizes[j];
+                for (int i = 0; i < num_segments; i ++) {
+                    char *field_data_buf = (char*)field_inst_mem->get_data_buf();
+                    int current_segment_start = segment_starts[i];
+                    if (field_inst_mem->get_num_chunks() > 0) {
+                        int chunk_id = decomp_info->get_local_cell_chunk_id()[current_segment_start];
+                        field_data_buf = (char*)field_inst_mem->get_chunk_buf(chunk_id);
+                        current_segment_start -= decomp_info->get_chunks_start()[chunk_id];
+                    }
+                    field_blocks.push_back(field_data_buf+current_segment_start*element_size);
+                    field_block_sizes.push_back(num_elements_in_segments[i]*element_size);
+                }
+            }
+        }
+        for (int i = 0; i < field_blocks.size(); i ++) {
+            if (field_block_sizes[i] == 0)
+                continue;
+            MPI_Get_address(field_blocks[i], &block_displ);
+            if (block_displs.size() > 0 && block_displs[block_displs.size()-1]+block_lengths[block_lengths.size()-1] == block_displ)
+                block_lengths[block_lengths.size()-1] += field_block_sizes[i];
+            else {
+                block_displs.push_back(block_displ);
+                block_lengths.push_back(field_block_sizes[i]);
+            }
+            total_block_size += field_block_sizes[i];
+        }
+    }
+
+    EXECUTION_REPORT_ERROR_OPTIONALLY(REPORT_ERROR, -1, total_block_size == 4*sizeof(long)+transfer_size_with_remote_procs[remote_proc_index], "Software error in Runtime_trans_algorithm::build_zero_copy_receive_type: %ld vs %ld", total_block_size, 4*sizeof(long)+transfer_size_with_remote_procs[remote_proc_index]);
+    MPI_Type_create_hindexed(block_displs.size(), &block_lengths[0], &block_displs[0], MPI_CHAR, &zero_copy_type);
+    MPI_Type_commit(&zero_copy_type);
+    EXECUTION_REPORT_LOG(REPORT_LOG, comp_id, true, "Runtime_trans_algorithm receives %ld bytes from the process %d of component \"%s\" without staging, in %d contiguous blocks", total_block_size, remote_proc_index, remote_comp_full_name, block_displs.size());
+
+    return zero_copy_type;
+}
@@ -63,12 +63,15 @@ class Runtime_trans_algorithm
         std::vector<long> history_receive_usage_time;
         char *temp_receive_data_buffer;
         std::vector<std::vector<Field_mem_info *> > history_receive_fields_mem;
+        std::vector<std::vector<MPI_Datatype> > history_receive_zero_copy_types;
+        std::vector<std::vector<void*> > history_receive_zero_copy_field_bufs;
         long last_receive_sender_time;
         int last_history_receive_buffer_index;
         Comp_comm_group_mgt_node * local_comp_node;
         Comp_comm_group_mgt_node * remote_comp_node;
         bool remote_comp_node_updated;
         char remote_comp_full_name[NAME_STR_SIZE];
+        int communication_timing_units[TIMING_COMMUNICATION_RECV-TIMING_COMMUNICATION_SEND_WAIT+1];
         int current_proc_local_id;
         int current_proc_global_id;
         MPI_Comm union_comm;
@@ -79,6 +82,11 @@ class Runtime_trans_algorithm
         int bypass_counter;
         bool timer_not_bypassed;
         int comm_tag;
+        long max_message_size;
+        int num_outstanding_requests;
+        int current_send_remote_proc_index;
+        long current_send_message_size;
+        long current_send_message_sent_size;
 
         bool send(bool);
         bool recv(bool);
@@ -86,10 +94,18 @@ class Runtime_trans_algorithm
         bool is_remote_data_buf_ready(bool);
         bool set_local_tags();
         void preprocess();
-        void pack_MD_data(int, int, int *);
-        void unpack_MD_data(void *, int, int, Field_mem_info*, int *);
+        int get_communication_timing_unit(int);
+        void pack_MD_data(int, int, long *);
+        void unpack_MD_data(void *, int, int, Field_mem_info*, long *);
+        int get_num_message_chunks(long);
+        void send_packed_message_chunks(long);
         template <class T> void pack_segment_data(T *, T *, int, int, int, int, int);
         void unpack_segment_data(char *, char *, int, int, int, int, int, long);
+        int get_empty_history_receive_buffer_index();
+        void get_history_receive_field_bufs(int, std::vector<void*> &);
+        void prepare_zero_copy_receive_types(int);
+        MPI_Datatype build_zero_copy_receive_type(int, int);
+        void release_zero_copy_receive_types(int);
         MPI_Request * request;
         bool is_first_run;
 		bool current_send_have_been_waited;
@@ -101,8 +117,8 @@ class Runtime_trans_algorithm
         char * get_total_buf() {return total_buf;}
         void * get_data_buf() {return data_buf;}
         long * get_tag_buf() {return tag_buf;}
-        int get_total_buf_size() {return total_buf_size;}
-        int get_data_buf_size() {return data_buf_size;}
+        long get_total_buf_size() {return total_buf_size;}
+        long get_data_buf_size() {return data_buf_size;}
         int get_tag_buf_size() {return tag_buf_size;}
         void pass_transfer_parameters(long, int);
         void set_data_win(MPI_Win win) {data_win = win;}
@@ -0,0 +1,145 @@
+/***************************************************************
+  *  Copyright (c) 2017, Tsinghua University.
+  *  This is a source file of C-Coupler.
+  *  This file was initially finished by Dr. Li Liu.
+  *  If you have any problem,
+  *  please contact Dr. Li Liu via liuli-cess@tsinghua.edu.cn
+  ***************************************************************/
+
+
+/* Benchmark of the member-to-set ensemble operations. Each operation is run with every vector instruction set supported
+   by the processor, reporting the memory throughput in GB/s (counted in the same way as the log of
+   Member_to_set_operation::execute), and the results are checked to be bitwise identical to the scalar kernels. Then each
+   operation is run with 1, 2, 4, ... up to max_threads OpenMP threads, and the results are checked to be bitwise
+   identical to the serial one.
+
+   Usage: bench_ensemble_field_operation [num_members] [field_size] [num_repeats] [max_threads] */
+
+
+#include "ensemble_field_operation_kernels.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/time.h>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+
+static double get_wall_time()
+{
+	struct timeval tv;
+
+
+	gettimeofday(&tv, NULL);
+	return tv.tv_sec + tv.tv_usec * 1.0e-6;
+}
+
+
+static const char *operation_names[] = {"sum", "min", "max", "mean", "anomaly", "variance", "std", "spread", "covariance", "any"};
+
+
+template <class T> double run_ensemble_operation(T **member_fields, T **paired_member_fields, T *initial_set_field, T *set_field, int num_members, int field_size, int operation, int num_threads, int simd_level, int num_repeats)
+{
+	double best_time = -1;
+
+
+	for (int k = 0; k < num_repeats; k ++) {
+		memcpy(set_field, initial_set_field, field_size * sizeof(T));
+		double time1 = get_wall_time();
+		member_to_set_operation_kernel(member_fields, paired_member_fields, set_field, num_members, field_size, operation, 0, num_threads, 0, simd_level);
+		double time2 = get_wall_time();
+		if (best_time < 0 || time2 - time1 < best_time)
+			best_time = time2 - time1;
+	}
+
+	return best_time;
+}
+
+
+template <class T> int benchmark_ensemble_operations(const char *data_type, int num_members, int field_size, int num_repeats, int max_threads)
+{
+	T **member_fields = new T *[num_members], **paired_member_fields = new T *[num_members];
+	T *initial_set_field = new T [field_size], *set_field = new T [field_size], *scalar_set_field = new T [field_size];
+	unsigned long seed = 12345;
+	int num_errors = 0;
+
+
+	for (int j = 0; j < num_members; j ++) {
+		member_fields[j] = new T [field_size];
+		paired_member_fields[j] = new T [field_size];
+		for (int i = 0; i < field_size; i ++) {
+			seed = seed * 6364136223846793005UL + 1442695040888963407UL;
+			member_fields[j][i] = (T) ((seed >> 11) % 100000) / (T) 1000 - (T) 50;
+			paired_member_fields[j][i] = member_fields[j][i] * (T) 0.5 + (T) ((seed >> 40) % 1000) / (T) 100;
+		}
+	}
+	for (int i = 0; i < field_size; i ++)
+		initial_set_field[i] = member_fields[0][i];
+
+	for (int operation = ENSEMBLE_OP_TYPE_SUM; operation < ENSEMBLE_OP_TYPE_ANY; operation ++) {
+		long num_bytes = (long) field_size * sizeof(T) * (operation == ENSEMBLE_OP_TYPE_ANOMALY ? num_members + 2 : (operation == ENSEMBLE_OP_TYPE_COVARIANCE ? 2 * num_members + 1 : num_members + 1));
+		for (int simd_level = ENSEMBLE_OP_SIMD_SCALAR; simd_level <= get_ensemble_op_simd_level(); simd_level ++) {
+			double best_time = run_ensemble_operation(member_fields, paired_member_fields, initial_set_field, set_field, num_members, field_size, operation, 1, simd_level, num_repeats);
+			if (simd_level == ENSEMBLE_OP_SIMD_SCALAR)
+				memcpy(scalar_set_field, set_field, field_size * sizeof(T));
+			bool identical = memcmp(scalar_set_field, set_field, field_size * sizeof(T)) == 0;
+			if (!identical)
+				num_errors ++;
+			printf("%-7s %-11s %-7s %10.6lf s %8.2lf GB/s %s\n", data_type, operation_names[operation], get_ensemble_op_simd_level_name(simd_level), best_time, num_bytes / best_time / 1.0e9, identical ? "identical to scalar" : "DIFFERENT FROM SCALAR");
+		}
+	}
+
+	for (int operation = ENSEMBLE_OP_TYPE_SUM; operation < ENSEMBLE_OP_TYPE_ANY; operation ++) {
+		double serial_time = -1;
+		for (int num_threads = 1; num_threads <= max_threads; num_threads *= 2) {
+			double best_time = run_ensemble_operation(member_fields, paired_member_fields, initial_set_field, set_field, num_members, field_size, operation, num_threads, get_ensemble_op_simd_level(), num_repeats);
+			if (num_threads == 1) {
+				serial_time = best_time;
+				memcpy(scalar_set_field, set_field, field_size * sizeof(T));
+			}
+			bool identical = memcmp(scalar_set_field, set_field, field_size * sizeof(T)) == 0;
+			if (!identical)
+				num_errors ++;
+			printf("%-7s %-11s %3d threads %10.6lf s speedup %6.2lf %s\n", data_type, operation_names[operation], num_threads, best_time, serial_time / best_time, identical ? "identical to serial" : "DIFFERENT FROM SERIAL");
+		}
+	}
+
+	for (int j = 0; j < num_members; j ++) {
+		delete [] member_fields[j];
+		delete [] paired_member_fields[j];
+	}
+	delete [] member_fields;
+	delete [] paired_member_fields;
+	delete [] initial_set_field;
+	delete [] set_field;
+	delete [] scalar_set_field;
+
+	return num_errors;
+}
+
+
+int main(int argc, char **argv)
+{
+	int num_members = argc > 1 ? atoi(argv[1]) : 40;
+	int field_size = argc > 2 ? atoi(argv[2]) : 1036800;
+	int num_repeats = argc > 3 ? atoi(argv[3]) : 5;
+	int max_threads = argc > 4 ? atoi(argv[4]) : 64;
+	int num_errors = 0;
+
+
+	if (num_members <= 0 || field_size <= 0 || num_repeats <= 0 || max_threads <= 0) {
+		fprintf(stderr, "Usage: %s [num_members] [field_size] [num_repeats] [max_threads]\n", argv[0]);
+		return 2;
+	}
+#ifdef _OPENMP
+	printf("%d members, %d grid points, best of %d runs, highest vector instruction set: %s, %d processors available to OpenMP\n", num_members, field_size, num_repeats, get_ensemble_op_simd_level_name(get_ensemble_op_simd_level()), omp_get_num_procs());
+#else
+	printf("%d members, %d grid points, best of %d runs, highest vector instruction set: %s, built without OpenMP\n", num_members, field_size, num_repeats, get_ensemble_op_simd_level_name(get_ensemble_op_simd_level()));
+	max_threads = 1;
+#endif
+	num_errors += benchmark_ensemble_operations<float>("real4", num_members, field_size, num_repeats, max_threads);
+	num_errors += benchmark_ensemble_operations<double>("real8", num_members, field_size, num_repeats, max_threads);
+
+	return num_errors == 0 ? 0 : 1;
+}
@@ -0,0 +1,312 @@
+/***************************************************************
+  *  Copyright (c) 2017, Tsinghua University.
+  *  This is a source file of C-Coupler.
+  *  This file was initially finished by Dr. Li Liu.
+  *  If you have any problem,
+  *  please contact Dr. Li Liu via liuli-cess@tsinghua.edu.cn
+  ***************************************************************/
+
+
+/* Benchmark of the kernels applying remapping weights. A bilinear-like sparse matrix (4 weights per dst cell) from a src
+   lat-lon grid to a dst lat-lon grid is first applied to a single level with the COO weights (64-bit indexes) and with the
+   CSR weights (32-bit indexes). It is then applied to fields of several numbers of levels: level by level, by blocks of
+   levels in the layout of the fields (strided) and by blocks of levels transposed into a level-contiguous layout. The
+   results are checked to be bitwise identical to those of the COO weights and of the level-by-level kernel respectively.
+   The two block kernels are only kept here, because Remap_weight_sparse_matrix applies the levels one by one, which was 
+   measured to be faster.
+
+   Usage: bench_remap_weight_sparse_matrix [num_src_lons] [num_src_lats] [num_dst_lons] [num_dst_lats] [num_repeats] */
+
+
+#include "remap_weight_kernels.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/time.h>
+
+
+#define REMAP_LEVELS_BLOCK_SIZE              128
+#define REMAP_TRANSPOSE_TILE_SIZE            32
+#define REMAP_ROWS_TILE_SIZE                 32
+
+
+/* out[j*out_row_stride+i] = in[i*in_row_stride+j] for num_rows x num_cols values, tile by tile so that both the reads
+   and the writes of a tile stay in the cache */
+template <typename T1, typename T2> void transpose_values_blocked(const T1 *in, T2 *out, long num_rows, long num_cols, long in_row_stride, long out_row_stride)
+{
+    for (long row_beg = 0; row_beg < num_rows; row_beg += REMAP_TRANSPOSE_TILE_SIZE) {
+        long row_end = num_rows - row_beg < REMAP_TRANSPOSE_TILE_SIZE ? num_rows : row_beg + REMAP_TRANSPOSE_TILE_SIZE;
+        for (long col_beg = 0; col_beg < num_cols; col_beg += REMAP_TRANSPOSE_TILE_SIZE) {
+            long col_end = num_cols - col_beg < REMAP_TRANSPOSE_TILE_SIZE ? num_cols : col_beg + REMAP_TRANSPOSE_TILE_SIZE;
+            for (long i = row_beg; i < row_end; i ++)
+                for (long j = col_beg; j < col_end; j ++)
+                    out[j*out_row_stride+i] = (T2) in[i*in_row_stride+j];
+        }
+    }
+}
+
+
+/* Applies the CSR weights to the levels in the layout of the fields (the grid is innermost), so that the innermost loop
+   over the levels of a block strides by a whole level */
+template <typename T, typename W> void remap_levels_with_csr_weights_strided(int num_rows, const int *rows_dst_index, const int *rows_offset, const int *cells_indexes_src, const W *weight_values,
+                                                                              const T *data_values_src, T *data_values_dst, int num_levels, long src_level_stride, long dst_level_stride)
+{
+    double dst_values[REMAP_LEVELS_BLOCK_SIZE];
+
+
+    for (int level_beg = 0; level_beg < num_levels; level_beg += REMAP_LEVELS_BLOCK_SIZE) {
+        int num_block_levels = num_levels - level_beg < REMAP_LEVELS_BLOCK_SIZE ? num_levels - level_beg : REMAP_LEVELS_BLOCK_SIZE;
+        const T *block_values_src = data_values_src + level_beg*src_level_stride;
+        T *block_values_dst = data_values_dst + level_beg*dst_level_stride;
+        for (int i = 0; i < num_rows; i ++) {
+            for (int k = 0; k < num_block_levels; k ++)
+                dst_values[k] = 0.0;
+            for (int j = rows_offset[i]; j < rows_offset[i+1]; j ++) {
+                const T *values_src = block_values_src + cells_indexes_src[j];
+                double weight_value = weight_values[j];
+                for (int k = 0; k < num_block_levels; k ++)
+                    dst_values[k] += ((double) values_src[k*src_level_stride]) * weight_value;
+            }
+            for (int k = 0; k < num_block_levels; k ++)
+                block_values_dst[k*dst_level_stride+rows_dst_index[i]] = (T) dst_values[k];
+        }
+    }
+}
+
+
+/* Applies the CSR weights to the levels in a level-contiguous layout: each block of levels of the src field is transposed
+   into src_buf (num_src_cells x REMAP_LEVELS_BLOCK_SIZE values), so that the levels of a src cell are read contiguously by
+   the innermost loop, and the dst values of a tile of rows are accumulated in dst_buf (REMAP_ROWS_TILE_SIZE x
+   REMAP_LEVELS_BLOCK_SIZE doubles) before being transposed back into the dst field. The values of each level are summed
+   in the same order as by remap_levels_with_csr_weights_strided, so that the results are bitwise identical */
+template <typename T, typename W> void remap_levels_with_csr_weights_level_contiguous(int num_rows, const int *rows_dst_index, const int *rows_offset, const int *cells_indexes_src, const W *weight_values,
+                                                                                      const T *data_values_src, T *data_values_dst, int num_levels, long src_level_stride, long dst_level_stride,
+                                                                                      long num_src_cells, T *src_buf, double *dst_buf)
+{
+    for (int level_beg = 0; level_beg < num_levels; level_beg += REMAP_LEVELS_BLOCK_SIZE) {
+        int num_block_levels = num_levels - level_beg < REMAP_LEVELS_BLOCK_SIZE ? num_levels - level_beg : REMAP_LEVELS_BLOCK_SIZE;
+        T *block_values_dst = data_values_dst + level_beg*dst_level_stride;
+        transpose_values_blocked(data_values_src + level_beg*src_level_stride, src_buf, num_block_levels, num_src_cells, src_level_stride, num_block_levels);
+        for (int row_beg = 0; row_beg < num_rows; row_beg += REMAP_ROWS_TILE_SIZE) {
+            int num_tile_rows = num_rows - row_beg < REMAP_ROWS_TILE_SIZE ? num_rows - row_beg : REMAP_ROWS_TILE_SIZE;
+            for (int i = 0; i < num_tile_rows; i ++) {
+                double *__restrict dst_values = dst_buf + i*num_block_levels;
+                for (int k = 0; k < num_block_levels; k ++)
+                    dst_values[k] = 0.0;
+                for (int j = rows_offset[row_beg+i]; j < rows_offset[row_beg+i+1]; j ++) {
+                    const T *__restrict values_src = src_buf + ((long)cells_indexes_src[j])*num_block_levels;
+                    double weight_value = weight_values[j];
+                    for (int k = 0; k < num_block_levels; k ++)
+                        dst_values[k] += ((double) values_src[k]) * weight_value;
+                }
+            }
+            for (int k = 0; k < num_block_levels; k ++)
+                for (int i = 0; i < num_tile_rows; i ++)
+                    block_values_dst[k*dst_level_stride+rows_dst_index[row_beg+i]] = (T) dst_buf[i*num_block_levels+k];
+        }
+    }
+}
+
+
+static double get_wall_time()
+{
+    struct timeval tv;
+
+
+    gettimeofday(&tv, NULL);
+    return tv.tv_sec + tv.tv_usec * 1.0e-6;
+}
+
+
+struct Csr_weights
+{
+    int num_rows;
+    int *rows_dst_index;
+    int *rows_offset;
+    int *cells_indexes_src;
+    double *weight_values;
+};
+
+
+static void build_bilinear_weights(int num_src_lons, int num_src_lats, int num_dst_lons, int num_dst_lats, Csr_weights *weights)
+{
+    weights->num_rows = num_dst_lons * num_dst_lats;
+    weights->rows_dst_index = new int [weights->num_rows];
+    weights->rows_offset = new int [weights->num_rows+1];
+    weights->cells_indexes_src = new int [weights->num_rows*4];
+    weights->weight_values = new double [weights->num_rows*4];
+    weights->rows_offset[0] = 0;
+    for (int j = 0; j < num_dst_lats; j ++)
+        for (int i = 0; i < num_dst_lons; i ++) {
+            int row = j*num_dst_lons + i;
+            double x = (i + 0.5) * num_src_lons / num_dst_lons - 0.5, y = (j + 0.5) * num_src_lats / num_dst_lats - 0.5;
+            int i0 = x < 0 ? num_src_lons - 1 : (int) x, j0 = y < 0 ? 0 : (int) y;
+            int i1 = (i0 + 1) % num_src_lons, j1 = j0 + 1 < num_src_lats ? j0 + 1 : j0;
+            double fx = x < 0 ? x + 1 : x - i0, fy = y < 0 ? 0 : y - j0;
+            weights->rows_dst_index[row] = row;
+            weights->cells_indexes_src[row*4+0] = j0*num_src_lons + i0;
+            weights->cells_indexes_src[row*4+1] = j0*num_src_lons + i1;
+            weights->cells_indexes_src[row*4+2] = j1*num_src_lons + i0;
+            weights->cells_indexes_src[row*4+3] = j1*num_src_lons + i1;
+            weights->weight_values[row*4+0] = (1-fx)*(1-fy);
+            weights->weight_values[row*4+1] = fx*(1-fy);
+            weights->weight_values[row*4+2] = (1-fx)*fy;
+            weights->weight_values[row*4+3] = fx*fy;
+            weights->rows_offset[row+1] = (row+1)*4;
+        }
+}
+
+
+static void remap_values_with_coo_weights(const Csr_weights *weights, const long *remaped_dst_cells_indexes, const long *cells_indexes_src, const long *cells_indexes_dst, const double *values_src, double *values_dst, double *temp_values_dst)
+{
+    remap_values_with_coo_weights(weights->num_rows, remaped_dst_cells_indexes, weights->rows_offset[weights->num_rows], cells_indexes_src, cells_indexes_dst, weights->weight_values, values_src, values_dst);
+}
+
+
+static void remap_values_with_coo_weights(const Csr_weights *weights, const long *remaped_dst_cells_indexes, const long *cells_indexes_src, const long *cells_indexes_dst, const float *values_src, float *values_dst, double *temp_values_dst)
+{
+    remap_values_with_coo_weights(weights->num_rows, remaped_dst_cells_indexes, weights->rows_offset[weights->num_rows], cells_indexes_src, cells_indexes_dst, weights->weight_values, values_src, values_dst, temp_values_dst);
+}
+
+
+template <class T> int benchmark_single_level_kernels(const char *data_type, const Csr_weights *weights, long src_grid_size, long dst_grid_size, int num_repeats)
+{
+    long num_weights = weights->rows_offset[weights->num_rows];
+    long *remaped_dst_cells_indexes = new long [weights->num_rows], *cells_indexes_src = new long [num_weights], *cells_indexes_dst = new long [num_weights];
+    T *values_src = new T [src_grid_size], *values_dst = new T [dst_grid_size], *values_dst_ref = new T [dst_grid_size];
+    double *temp_values_dst = new double [dst_grid_size];
+    double times[2];
+    unsigned long seed = 12345;
+    int num_errors = 0;
+
+
+    for (int i = 0; i < weights->num_rows; i ++) {
+        remaped_dst_cells_indexes[i] = weights->rows_dst_index[i];
+        for (int j = weights->rows_offset[i]; j < weights->rows_offset[i+1]; j ++) {
+            cells_indexes_src[j] = weights->cells_indexes_src[j];
+            cells_indexes_dst[j] = weights->rows_dst_index[i];
+        }
+    }
+    for (long i = 0; i < src_grid_size; i ++) {
+        seed = seed * 6364136223846793005UL + 1442695040888963407UL;
+        values_src[i] = (T) ((seed >> 11) % 100000) / (T) 1000 - (T) 50;
+    }
+
+    for (int kernel = 0; kernel < 2; kernel ++) {
+        times[kernel] = -1;
+        for (int r = 0; r < num_repeats; r ++) {
+            memset(values_dst, 0, dst_grid_size*sizeof(T));
+            double time1 = get_wall_time();
+            if (kernel == 0)
+                remap_values_with_coo_weights(weights, remaped_dst_cells_indexes, cells_indexes_src, cells_indexes_dst, values_src, values_dst, temp_values_dst);
+            else remap_values_with_csr_weights(weights->num_rows, weights->rows_dst_index, weights->rows_offset, weights->cells_indexes_src, weights->weight_values, values_src, values_dst);
+            double time2 = get_wall_time();
+            if (times[kernel] < 0 || time2 - time1 < times[kernel])
+                times[kernel] = time2 - time1;
+        }
+        if (kernel == 0)
+            memcpy(values_dst_ref, values_dst, dst_grid_size*sizeof(T));
+        else if (memcmp(values_dst_ref, values_dst, dst_grid_size*sizeof(T)) != 0)
+            num_errors ++;
+    }
+    printf("%-7s    1 level:  COO %10.6lf s (%6.2lf GB/s of weights), CSR %10.6lf s (%6.2lf GB/s of weights) %s\n", data_type,
+           times[0], num_weights*(2*sizeof(long)+sizeof(double))/times[0]/1.0e9, times[1], (num_weights*(sizeof(int)+sizeof(double))+weights->num_rows*2*sizeof(int))/times[1]/1.0e9, num_errors == 0 ? "identical" : "DIFFERENT");
+
+    delete [] remaped_dst_cells_indexes;
+    delete [] cells_indexes_src;
+    delete [] cells_indexes_dst;
+    delete [] values_src;
+    delete [] values_dst;
+    delete [] values_dst_ref;
+    delete [] temp_values_dst;
+
+    return num_errors;
+}
+
+
+template <class T> int benchmark_multi_level_kernels(const char *data_type, const Csr_weights *weights, long src_grid_size, long dst_grid_size, int num_levels, int num_repeats)
+{
+    T *values_src = new T [src_grid_size*num_levels];
+    T *values_dst = new T [dst_grid_size*num_levels];
+    T *values_dst_ref = new T [dst_grid_size*num_levels];
+    T *src_buf = new T [src_grid_size*REMAP_LEVELS_BLOCK_SIZE];
+    double *dst_buf = new double [REMAP_ROWS_TILE_SIZE*REMAP_LEVELS_BLOCK_SIZE];
+    double times[3];
+    long num_bytes = (src_grid_size + dst_grid_size) * num_levels * sizeof(T);
+    unsigned long seed = 12345;
+    int num_errors = 0;
+
+
+    for (long i = 0; i < src_grid_size*num_levels; i ++) {
+        seed = seed * 6364136223846793005UL + 1442695040888963407UL;
+        values_src[i] = (T) ((seed >> 11) % 100000) / (T) 1000 - (T) 50;
+    }
+
+    for (int kernel = 0; kernel < 3; kernel ++) {
+        times[kernel] = -1;
+        for (int r = 0; r < num_repeats; r ++) {
+            memset(values_dst, 0, dst_grid_size*num_levels*sizeof(T));
+            double time1 = get_wall_time();
+            if (kernel == 0)
+                for (int k = 0; k < num_levels; k ++)
+                    remap_values_with_csr_weights(weights->num_rows, weights->rows_dst_index, weights->rows_offset, weights->cells_indexes_src, weights->weight_values, values_src+k*src_grid_size, values_dst+k*dst_grid_size);
+            else if (kernel == 1)
+                remap_levels_with_csr_weights_strided(weights->num_rows, weights->rows_dst_index, weights->rows_offset, weights->cells_indexes_src, weights->weight_values, values_src, values_dst, num_levels, src_grid_size, dst_grid_size);
+            else remap_levels_with_csr_weights_level_contiguous(weights->num_rows, weights->rows_dst_index, weights->rows_offset, weights->cells_indexes_src, weights->weight_values, values_src, values_dst, num_levels, src_grid_size, dst_grid_size, src_grid_size, src_buf, dst_buf);
+            double time2 = get_wall_time();
+            if (times[kernel] < 0 || time2 - time1 < times[kernel])
+                times[kernel] = time2 - time1;
+        }
+        if (kernel == 0)
+            memcpy(values_dst_ref, values_dst, dst_grid_size*num_levels*sizeof(T));
+        else if (memcmp(values_dst_ref, values_dst, dst_grid_size*num_levels*sizeof(T)) != 0)
+            num_errors ++;
+    }
+    printf("%-7s %4d levels: per level %10.6lf s (%6.2lf GB/s), strided block %10.6lf s (%6.2lf GB/s), level-contiguous block %10.6lf s (%6.2lf GB/s) %s\n", data_type, num_levels,
+           times[0], num_bytes/times[0]/1.0e9, times[1], num_bytes/times[1]/1.0e9, times[2], num_bytes/times[2]/1.0e9, num_errors == 0 ? "identical" : "DIFFERENT");
+
+    delete [] values_src;
+    delete [] values_dst;
+    delete [] values_dst_ref;
+    delete [] src_buf;
+    delete [] dst_buf;
+
+    return num_errors;
+}
+
+
+int main(int argc, char **argv)
+{
+    int num_src_lons = argc > 1 ? atoi(argv[1]) : 720;
+    int num_src_lats = argc > 2 ? atoi(argv[2]) : 360;
+    int num_dst_lons = argc > 3 ? atoi(argv[3]) : 1024;
+    int num_dst_lats = argc > 4 ? atoi(argv[4]) : 512;
+    int num_repeats = argc > 5 ? atoi(argv[5]) : 3;
+    int levels[] = {2, 8, 16, 30, 64, 128};
+    long src_grid_size, dst_grid_size;
+    Csr_weights weights;
+    int num_errors = 0;
+
+
+    if (num_src_lons <= 1 || num_src_lats <= 1 || num_dst_lons <= 0 || num_dst_lats <= 0 || num_repeats <= 0) {
+        fprintf(stderr, "Usage: %s [num_src_lons] [num_src_lats] [num_dst_lons] [num_dst_lats] [num_repeats]\n", argv[0]);
+        return 2;
+    }
+    src_grid_size = (long) num_src_lons * num_src_lats;
+    dst_grid_size = (long) num_dst_lons * num_dst_lats;
+    build_bilinear_weights(num_src_lons, num_src_lats, num_dst_lons, num_dst_lats, &weights);
+    printf("%ld src cells, %ld dst cells, %d weights, best of %d runs\n", src_grid_size, dst_grid_size, weights.rows_offset[weights.num_rows], num_repeats);
+    num_errors += benchmark_single_level_kernels<float>("real4", &weights, src_grid_size, dst_grid_size, num_repeats*5);
+    num_errors += benchmark_single_level_kernels<double>("real8", &weights, src_grid_size, dst_grid_size, num_repeats*5);
+    for (int i = 0; i < (int) (sizeof(levels)/sizeof(int)); i ++) {
+        num_errors += benchmark_multi_level_kernels<float>("real4", &weights, src_grid_size, dst_grid_size, levels[i], num_repeats);
+        num_errors += benchmark_multi_level_kernels<double>("real8", &weights, src_grid_size, dst_grid_size, levels[i], num_repeats);
+    }
+
+    delete [] weights.rows_dst_index;
+    delete [] weights.rows_offset;
+    delete [] weights.cells_indexes_src;
+    delete [] weights.weight_values;
+
+    return num_errors == 0 ? 0 : 1;
+}
@@ -0,0 +1,158 @@
+/***************************************************************
+  *  Copyright (c) 2017, Tsinghua University.
+  *  This is a source file of C-Coupler.
+  *  This file was initially finished by Dr. Li Liu.
+  *  If you have any problem,
+  *  please contact Dr. Li Liu via liuli-cess@tsinghua.edu.cn
+  ***************************************************************/
+
+
+/* Test of the closed-form search of the times when a periodical timer is on. For both calendars (with and without leap
+   years), each frequency unit, frequency count, lag, time step, start time and current time, the next time and the last
+   time within a number of steps when the timer is on are searched in closed form and compared with the ones obtained by
+   checking the timer at each time step. Advancing a time by a number of seconds at once is also compared with advancing
+   it step by step.
+
+   Usage: test_timer_closed_form */
+
+
+#include "timer_calendar_kernels.h"
+#include <stdio.h>
+
+
+static const char *unit_names[] = {"seconds", "days", "months", "years"};
+static long num_errors = 0;
+
+
+static void report_error(const Calendar_timer *timer, const char *search_name, int current_date, int current_second, int time_step_in_second, long num_steps, bool found, int date, int second, bool stepping_found, int stepping_date, int stepping_second)
+{
+	num_errors ++;
+	if (num_errors > 20)
+		return;
+	printf("MISMATCH %s: leap year %d, %d %s with lag %d from %08d-%05d, current time %08d-%05d, time step %d, %ld steps: closed form %s %08d-%05d, stepping %s %08d-%05d\n",
+	       search_name, timer->leap_year_on, timer->frequency_count, unit_names[timer->unit], timer->local_lag_count, timer->start_year*10000+timer->start_month*100+timer->start_day,
+	       timer->start_second, current_date, current_second, time_step_in_second, num_steps, found ? "found" : "not found", found ? date : 0, found ? second : 0,
+	       stepping_found ? "found" : "not found", stepping_found ? stepping_date : 0, stepping_found ? stepping_second : 0);
+}
+
+
+/* Returns the number of the searches that have been given up by the closed form, for which C-Coupler falls back to stepping */
+static long test_timer(const Calendar_timer *timer, int current_year, int current_month, int current_day, int current_second, int current_num_elapsed_day, int time_step_in_second, long *num_searches)
+{
+	long num_steps_of_last_search[5], unit_seconds[4] = {1, SECONDS_PER_DAY, 31*SECONDS_PER_DAY, 366*SECONDS_PER_DAY};
+	int num_elapsed_days, date, second, stepping_num_elapsed_days, stepping_date, stepping_second;
+	long num_given_up_searches = 0;
+	bool found, stepping_found;
+
+
+	found = calendar_search_time_of_timer_on(timer, current_year, current_month, current_day, current_second, current_num_elapsed_day, time_step_in_second, -1, false, num_elapsed_days, date, second);
+	(*num_searches) ++;
+	if (found) {
+		/* The stepping search is bounded by the number of steps to the time found in closed form, so that it cannot run forever when they differ. When
+		   this time is too far away (e.g., the timer is on at the beginning of a month only once in centuries at the times reached with the time step),
+		   stepping only checks that the timer is not on before the bound, and the timer is checked at the time found in closed form */
+		long num_elapsed_seconds = ((long)(num_elapsed_days - current_num_elapsed_day)) * SECONDS_PER_DAY + second - current_second, num_steps = num_elapsed_seconds / time_step_in_second + 1;
+		bool bounded = num_steps > 200000;
+		int timer_year = current_year, timer_month = current_month, timer_day = current_day, timer_second = current_second, timer_num_elapsed_day = current_num_elapsed_day;
+		calendar_advance_time_by_seconds(timer->leap_year_on, timer_year, timer_month, timer_day, timer_second, timer_num_elapsed_day, num_elapsed_seconds);
+		stepping_found = calendar_search_time_of_timer_on_by_stepping(timer, current_year, current_month, current_day, current_second, current_num_elapsed_day, time_step_in_second, bounded ? 200000 : num_steps, false, stepping_num_elapsed_days, stepping_date, stepping_second);
+		if (bounded) {
+			if (stepping_found || num_elapsed_seconds % time_step_in_second != 0 || !calendar_is_timer_on(timer, timer_year, timer_month, timer_day, timer_second, timer_num_elapsed_day))
+				report_error(timer, "next", current_year*10000+current_month*100+current_day, current_second, time_step_in_second, -1, found, date, second, stepping_found, stepping_date, stepping_second);
+		}
+		else if (!stepping_found || stepping_num_elapsed_days != num_elapsed_days || stepping_date != date || stepping_second != second)
+			report_error(timer, "next", current_year*10000+current_month*100+current_day, current_second, time_step_in_second, -1, found, date, second, stepping_found, stepping_date, stepping_second);
+	}
+	else {
+		/* The closed form only gives up when the timer is never on at the times reached by stepping, or, for months and years, after a calendar cycle */
+		num_given_up_searches ++;
+		stepping_found = calendar_search_time_of_timer_on_by_stepping(timer, current_year, current_month, current_day, current_second, current_num_elapsed_day, time_step_in_second, 20000, false, stepping_num_elapsed_days, stepping_date, stepping_second);
+		if (stepping_found)
+			report_error(timer, "next", current_year*10000+current_month*100+current_day, current_second, time_step_in_second, -1, found, 0, 0, stepping_found, stepping_date, stepping_second);
+	}
+
+	num_steps_of_last_search[0] = 1;
+	num_steps_of_last_search[1] = 2;
+	num_steps_of_last_search[2] = 97;
+	num_steps_of_last_search[3] = 1000;
+	num_steps_of_last_search[4] = 2 * timer->frequency_count * unit_seconds[timer->unit] / time_step_in_second + 3;
+	if (num_steps_of_last_search[4] > 50000)
+		num_steps_of_last_search[4] = 50000;
+	for (int i = 0; i < 5; i ++) {
+		found = calendar_search_time_of_timer_on(timer, current_year, current_month, current_day, current_second, current_num_elapsed_day, time_step_in_second, num_steps_of_last_search[i], true, num_elapsed_days, date, second);
+		stepping_found = calendar_search_time_of_timer_on_by_stepping(timer, current_year, current_month, current_day, current_second, current_num_elapsed_day, time_step_in_second, num_steps_of_last_search[i], true, stepping_num_elapsed_days, stepping_date, stepping_second);
+		(*num_searches) ++;
+		if (found != stepping_found || (found && (stepping_num_elapsed_days != num_elapsed_days || stepping_date != date || stepping_second != second)))
+			report_error(timer, "last", current_year*10000+current_month*100+current_day, current_second, time_step_in_second, num_steps_of_last_search[i], found, date, second, stepping_found, stepping_date, stepping_second);
+	}
+
+	return num_given_up_searches;
+}
+
+
+static void test_advance_time_by_seconds(bool leap_year_on, int year, int month, int day, int second, int num_elapsed_day, int time_step_in_second, long num_steps)
+{
+	int stepping_year = year, stepping_month = month, stepping_day = day, stepping_second = second, stepping_num_elapsed_day = num_elapsed_day;
+
+
+	calendar_advance_time_by_seconds(leap_year_on, year, month, day, second, num_elapsed_day, num_steps * time_step_in_second);
+	for (long i = 0; i < num_steps; i ++)
+		calendar_advance_time(leap_year_on, stepping_year, stepping_month, stepping_day, stepping_second, stepping_num_elapsed_day, time_step_in_second);
+	if (year != stepping_year || month != stepping_month || day != stepping_day || second != stepping_second || num_elapsed_day != stepping_num_elapsed_day ||
+	    num_elapsed_day - calendar_calculate_elapsed_day(leap_year_on, year, month, day) != stepping_num_elapsed_day - calendar_calculate_elapsed_day(leap_year_on, stepping_year, stepping_month, stepping_day)) {
+		num_errors ++;
+		if (num_errors <= 20)
+			printf("MISMATCH advance: leap year %d, %ld steps of %d seconds: at once %04d-%02d-%02d-%05d (%d days), stepping %04d-%02d-%02d-%05d (%d days)\n", leap_year_on, num_steps, time_step_in_second,
+			       year, month, day, second, num_elapsed_day, stepping_year, stepping_month, stepping_day, stepping_second, stepping_num_elapsed_day);
+	}
+}
+
+
+int main(int argc, char **argv)
+{
+	int start_times[4][4] = {{1999, 12, 31, 0}, {2000, 2, 28, 3600}, {2001, 1, 1, 0}, {2099, 11, 15, 450}};
+	int time_steps[8] = {60, 450, 1337, 1800, 3600, 5400, 86400, 172800};
+	int frequency_counts[4] = {1, 2, 3, 7};
+	int lag_counts[3] = {0, 1, 3};
+	long num_advances_of_current_time[3] = {0, 5, 1001};
+	long num_searches = 0, num_given_up_searches = 0;
+	Calendar_timer timer;
+
+
+	for (int leap_year_on = 0; leap_year_on < 2; leap_year_on ++) {
+		for (int unit = CALENDAR_TIMER_UNIT_SECOND; unit <= CALENDAR_TIMER_UNIT_YEAR; unit ++) {
+			long unit_num_searches = 0, unit_num_given_up_searches = 0, unit_num_errors = num_errors;
+			timer.leap_year_on = leap_year_on == 1;
+			timer.unit = unit;
+			for (int s = 0; s < 4; s ++) {
+				timer.start_year = start_times[s][0];
+				timer.start_month = start_times[s][1];
+				timer.start_day = start_times[s][2];
+				timer.start_second = start_times[s][3];
+				timer.start_num_elapsed_day = calendar_calculate_elapsed_day(timer.leap_year_on, timer.start_year, timer.start_month, timer.start_day);
+				for (int t = 0; t < 8; t ++) {
+					for (int a = 0; a < 3; a ++) {
+						int current_year = timer.start_year, current_month = timer.start_month, current_day = timer.start_day, current_second = timer.start_second, current_num_elapsed_day = timer.start_num_elapsed_day;
+						for (long i = 0; i < num_advances_of_current_time[a]; i ++)
+							calendar_advance_time(timer.leap_year_on, current_year, current_month, current_day, current_second, current_num_elapsed_day, time_steps[t]);
+						if (unit == CALENDAR_TIMER_UNIT_SECOND)
+							test_advance_time_by_seconds(timer.leap_year_on, current_year, current_month, current_day, current_second, current_num_elapsed_day, time_steps[t], 40000);
+						for (int f = 0; f < 4; f ++) {
+							for (int l = 0; l < 3; l ++) {
+								timer.frequency_count = frequency_counts[f] * (unit == CALENDAR_TIMER_UNIT_SECOND ? 900 : 1);
+								timer.local_lag_count = lag_counts[l] * (unit == CALENDAR_TIMER_UNIT_SECOND ? 600 : 1);
+								unit_num_given_up_searches += test_timer(&timer, current_year, current_month, current_day, current_second, current_num_elapsed_day, time_steps[t], &unit_num_searches);
+							}
+						}
+					}
+				}
+			}
+			printf("leap year %s, timers in %-7s: %6ld searches, %4ld given up to stepping, %s\n", leap_year_on == 1 ? "on " : "off", unit_names[unit], unit_num_searches, unit_num_given_up_searches, num_errors == unit_num_errors ? "identical to stepping" : "DIFFERENT FROM STEPPING");
+			num_searches += unit_num_searches;
+			num_given_up_searches += unit_num_given_up_searches;
+		}
+	}
+	printf("%ld searches, %ld given up to stepping, %ld mismatches\n", num_searches, num_given_up_searches, num_errors);
+
+	return num_errors == 0 ? 0 : 1;
+}